@@ -0,0 +1,128 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <benchmark/benchmark.h>
+#include "Core/Components/Instancing/InstanceSlotCache.h"
+#include "Core/Components/Instancing/InstanceFactory.h"
+
+#include <random>
+
+using namespace MxEngine;
+
+namespace
+{
+    constexpr size_t InstanceCount = 100000;
+    constexpr size_t LODCount = 4;
+    constexpr size_t UploadedInstanceSize = sizeof(InstanceFactory::InstanceData);
+
+    struct InstanceScene
+    {
+        MxVector<size_t> Keys;
+        MxVector<size_t> LODs;
+        MxVector<uint64_t> Versions;
+        MxVector<size_t> LODCounts;
+        MxVector<size_t> Slots;
+        // versions are unique among all instances, as transform versions are
+        uint64_t NextVersion = 0;
+
+        InstanceScene()
+            : Keys(InstanceCount), LODs(InstanceCount), Versions(InstanceCount), LODCounts(LODCount, 0), Slots(InstanceCount)
+        {
+            for (size_t i = 0; i < InstanceCount; i++)
+            {
+                Keys[i] = i;
+                LODs[i] = i % LODCount;
+                Versions[i] = NextVersion++;
+            }
+        }
+
+        void Update(InstanceSlotCache& cache)
+        {
+            std::fill(LODCounts.begin(), LODCounts.end(), 0);
+            for (size_t lod : LODs)
+                LODCounts[lod]++;
+            cache.BeginUpdate(InstanceCount, LODCounts);
+
+            for (size_t i = 0; i < InstanceCount; i++)
+                Slots[i] = cache.TryKeepSlot(Keys[i], LODs[i]);
+            for (size_t i = 0; i < InstanceCount; i++)
+            {
+                if (Slots[i] == InstanceSlotCache::InvalidSlot)
+                    Slots[i] = cache.AcquireSlot(Keys[i], LODs[i]);
+                cache.UpdateSlotState(Slots[i], Versions[i], MakeVector3(1.0f));
+            }
+        }
+    };
+
+    void RunDirtyUpdates(benchmark::State& state, bool changeLODs)
+    {
+        size_t dirtyCount = InstanceCount * (size_t)state.range(0) / 100;
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<size_t> distribution(0, InstanceCount - 1);
+
+        InstanceScene scene;
+        InstanceSlotCache cache;
+        scene.Update(cache);
+
+        MxVector<InstanceSlotCache::SlotRange> ranges;
+        size_t uploadedInstances = 0;
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            for (size_t i = 0; i < dirtyCount; i++)
+            {
+                size_t instance = dirtyCount == InstanceCount ? i : distribution(generator);
+                if (changeLODs) scene.LODs[instance] = (scene.LODs[instance] + 1) % LODCount;
+                else scene.Versions[instance] = scene.NextVersion++;
+            }
+            state.ResumeTiming();
+
+            scene.Update(cache);
+            cache.CollectDirtyRanges(InstanceFactory::DirtyRangeMergeDistance, ranges);
+            for (const auto& range : ranges)
+                uploadedInstances += range.End - range.Begin;
+            benchmark::DoNotOptimize(ranges.data());
+        }
+        state.counters["ranges"] = (double)ranges.size();
+        state.counters["upload bytes"] = benchmark::Counter((double)(uploadedInstances * UploadedInstanceSize), benchmark::Counter::kAvgIterations);
+    }
+}
+
+// instances which moved, i.e. changed their transform version
+static void BM_InstanceSlotCacheMovedInstances(benchmark::State& state)
+{
+    RunDirtyUpdates(state, false);
+}
+BENCHMARK(BM_InstanceSlotCacheMovedInstances)->Arg(1)->Arg(10)->Arg(100);
+
+// instances which switched to other LOD bucket, without being moved
+static void BM_InstanceSlotCacheLODChanges(benchmark::State& state)
+{
+    RunDirtyUpdates(state, true);
+}
+BENCHMARK(BM_InstanceSlotCacheLODChanges)->Arg(1)->Arg(10)->Arg(100);
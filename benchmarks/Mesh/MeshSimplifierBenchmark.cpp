@@ -0,0 +1,57 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <benchmark/benchmark.h>
+#include "Library/Mesh/MeshSimplifier.h"
+#include "TestMeshes.h"
+
+using namespace MxEngine;
+
+static void BM_MeshSimplifySphere(benchmark::State& state)
+{
+    // sphere with rings x 2 * rings quads, so triangle count grows quadratically with argument
+    size_t rings = (size_t)state.range(0);
+    MeshData::VertexData vertecies;
+    MeshData::IndexData indicies;
+    Tests::MakeSphereMesh(rings, 2 * rings, vertecies, indicies);
+
+    size_t targetIndexCount = indicies.size() / 4 / 3 * 3;
+    float error = 0.0f;
+    size_t resultCount = 0;
+    for (auto _ : state)
+    {
+        auto result = MeshSimplifier::Simplify(vertecies, indicies, targetIndexCount, 1.0f, &error);
+        resultCount = result.size();
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.counters["triangles"] = double(indicies.size() / 3);
+    state.counters["result"] = double(resultCount / 3);
+    state.counters["error"] = error;
+    state.SetItemsProcessed(state.iterations() * (indicies.size() / 3));
+}
+BENCHMARK(BM_MeshSimplifySphere)->Arg(32)->Arg(64)->Arg(128)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,73 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <benchmark/benchmark.h>
+#include "Core/Rendering/RenderUtilities/LightClusterBuilder.h"
+
+#include <random>
+
+using namespace MxEngine;
+
+static void BM_LightClusterBuild(benchmark::State& state)
+{
+    auto view = MakeViewMatrix(MakeVector3(0.0f), MakeVector3(0.0f, 0.0f, -1.0f), MakeVector3(0.0f, 1.0f, 0.0f));
+    auto projection = MakePerspectiveMatrix(Radians(65.0f), 16.0f / 9.0f, 0.1f, 200.0f);
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> xy(-80.0f, 80.0f);
+    std::uniform_real_distribution<float> z(-190.0f, 0.0f);
+    std::uniform_real_distribution<float> radius(1.0f, 10.0f);
+
+    // three quarters of lights are point lights, the rest are spot lights, as in typical scene
+    size_t lightCount = (size_t)state.range(0);
+    MxVector<ClusteredPointLight> pointLights;
+    MxVector<ClusteredSpotLight> spotLights;
+    for (size_t i = 0; i < lightCount * 3 / 4; i++)
+        pointLights.push_back(ClusteredPointLight{ MakeVector3(xy(generator), xy(generator), z(generator)), radius(generator), MakeVector3(1.0f), 0.0f });
+    for (size_t i = pointLights.size(); i < lightCount; i++)
+    {
+        ClusteredSpotLight light{ };
+        light.Position = MakeVector3(xy(generator), xy(generator), z(generator));
+        light.Direction = MakeVector3(0.0f, -4.0f * radius(generator), 0.0f);
+        light.InnerCos = 0.9f;
+        light.OuterCos = 0.8f;
+        spotLights.push_back(light);
+    }
+
+    LightClusterBuilder builder;
+    LightClusterGrid grid;
+    builder.SetCamera(projection * view, 0.1f, 200.0f);
+    for (auto _ : state)
+    {
+        builder.Build(pointLights, spotLights, grid);
+        benchmark::DoNotOptimize(grid.LightIndices.data());
+    }
+    state.counters["indices"] = (double)grid.LightIndices.size();
+    state.SetItemsProcessed(state.iterations() * lightCount);
+}
+BENCHMARK(BM_LightClusterBuild)->Arg(256)->Arg(1024)->Arg(4096)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,114 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <benchmark/benchmark.h>
+#include "Core/Rendering/RenderUtilities/OcclusionCuller.h"
+
+#include <random>
+
+using namespace MxEngine;
+
+namespace
+{
+    // camera at origin looking along -Z, occluders are tessellated walls scattered in front of it
+    struct OcclusionScene
+    {
+        Matrix4x4 ViewProjection;
+        OccluderGeometry Wall;
+        MxVector<OccluderInstance> Occluders;
+        MxVector<Vector3> BoxCenters;
+
+        OcclusionScene(size_t occluderCount, size_t boxCount)
+        {
+            auto view = MakeViewMatrix(MakeVector3(0.0f), MakeVector3(0.0f, 0.0f, -1.0f), MakeVector3(0.0f, 1.0f, 0.0f));
+            this->ViewProjection = MakePerspectiveMatrix(Radians(65.0f), 16.0f / 9.0f, 0.1f, 1000.0f) * view;
+
+            // 16x16 quads, 512 triangles per wall
+            const size_t cells = 16;
+            for (size_t y = 0; y <= cells; y++)
+            {
+                for (size_t x = 0; x <= cells; x++)
+                    this->Wall.Positions.push_back(MakeVector3(float(x) / cells - 0.5f, float(y) / cells - 0.5f, 0.0f) * 4.0f);
+            }
+            for (uint32_t y = 0; y < cells; y++)
+            {
+                for (uint32_t x = 0; x < cells; x++)
+                {
+                    uint32_t i0 = y * (cells + 1) + x, i1 = i0 + 1, i2 = i0 + cells + 1, i3 = i2 + 1;
+                    this->Wall.Indicies.insert(this->Wall.Indicies.end(), { i0, i1, i3, i0, i3, i2 });
+                }
+            }
+
+            std::mt19937 generator(42);
+            std::uniform_real_distribution<float> xy(-30.0f, 30.0f);
+            std::uniform_real_distribution<float> z(-60.0f, -5.0f);
+            for (size_t i = 0; i < occluderCount; i++)
+            {
+                Matrix4x4 transform(1.0f);
+                transform[3] = Vector4(xy(generator), xy(generator), z(generator), 1.0f);
+                this->Occluders.push_back(OccluderInstance{ &this->Wall, transform });
+            }
+            for (size_t i = 0; i < boxCount; i++)
+                this->BoxCenters.push_back(MakeVector3(xy(generator), xy(generator), z(generator) - 20.0f));
+        }
+    };
+}
+
+static void BM_OcclusionRasterize(benchmark::State& state)
+{
+    OcclusionScene scene((size_t)state.range(0), 0);
+    OcclusionCuller culler;
+    culler.Init(320, 180);
+    for (auto _ : state)
+    {
+        culler.RenderOccluders(scene.ViewProjection, 0.1f, scene.Occluders);
+        benchmark::DoNotOptimize(culler.GetDepthBuffer().data());
+    }
+    state.counters["triangles"] = (double)culler.GetRasterizedTriangleCount();
+}
+BENCHMARK(BM_OcclusionRasterize)->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
+
+static void BM_OcclusionQuery(benchmark::State& state)
+{
+    OcclusionScene scene(64, (size_t)state.range(0));
+    OcclusionCuller culler;
+    culler.Init(320, 180);
+    culler.RenderOccluders(scene.ViewProjection, 0.1f, scene.Occluders);
+
+    size_t visibleCount = 0;
+    for (auto _ : state)
+    {
+        visibleCount = 0;
+        for (const auto& center : scene.BoxCenters)
+            visibleCount += culler.IsAABBVisible(center - MakeVector3(0.5f), center + MakeVector3(0.5f));
+        benchmark::DoNotOptimize(visibleCount);
+    }
+    state.counters["visible"] = (double)visibleCount;
+    state.SetItemsProcessed(state.iterations() * scene.BoxCenters.size());
+}
+BENCHMARK(BM_OcclusionQuery)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,128 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <benchmark/benchmark.h>
+#include "Utilities/Sort/DepthSort.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace MxEngine;
+
+namespace
+{
+    // mirrors render draw command, which is the main user of radix sort
+    struct SortedCommand
+    {
+        uint64_t SortKey;
+        uint32_t UnitIndex;
+        uint32_t GroupIndex;
+    };
+
+    MxVector<SortedCommand> MakeCommands(size_t count)
+    {
+        std::mt19937_64 generator(42);
+        MxVector<SortedCommand> commands(count);
+        for (size_t i = 0; i < count; i++)
+            commands[i] = SortedCommand{ generator(), (uint32_t)i, 0 };
+        return commands;
+    }
+}
+
+static void BM_RadixSort(benchmark::State& state)
+{
+    auto source = MakeCommands((size_t)state.range(0));
+    MxVector<SortedCommand> values, scratch;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        values = source;
+        state.ResumeTiming();
+        RadixSort(values, scratch, [](const SortedCommand& command) { return command.SortKey; });
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_RadixSort)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_StdSort(benchmark::State& state)
+{
+    auto source = MakeCommands((size_t)state.range(0));
+    MxVector<SortedCommand> values;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        values = source;
+        state.ResumeTiming();
+        std::sort(values.begin(), values.end(), [](const SortedCommand& c1, const SortedCommand& c2) { return c1.SortKey < c2.SortKey; });
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_StdSort)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_StdStableSort(benchmark::State& state)
+{
+    auto source = MakeCommands((size_t)state.range(0));
+    MxVector<SortedCommand> values;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        values = source;
+        state.ResumeTiming();
+        std::stable_sort(values.begin(), values.end(), [](const SortedCommand& c1, const SortedCommand& c2) { return c1.SortKey < c2.SortKey; });
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_StdStableSort)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// depths change slightly each iteration, as they do between frames of moving camera
+static void BM_DepthSortCoherent(benchmark::State& state)
+{
+    size_t count = (size_t)state.range(0);
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> distribution(0.0f, 100.0f);
+    std::uniform_real_distribution<float> jitter(-0.01f, 0.01f);
+    MxVector<float> depths(count);
+    for (auto& depth : depths)
+        depth = distribution(generator);
+
+    DepthSorter sorter;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (auto& depth : depths)
+            depth += jitter(generator);
+        state.ResumeTiming();
+        const auto& order = sorter.SortBackToFront(count, [&depths](size_t i) { return depths[i]; });
+        benchmark::DoNotOptimize(order.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_DepthSortCoherent)->Arg(1000)->Arg(10000)->Arg(100000);
@@ -156,15 +156,27 @@ namespace MxEngine
     void Application::DrawObjects()
     {
         MAKE_SCOPE_PROFILER("Application::DrawObjects");
-        this->GetRenderAdaptor().SetWindowSize({ this->GetWindow().GetWidth(), this->GetWindow().GetHeight() });
-        this->GetRenderAdaptor().RenderFrame();
+        auto& renderAdaptor = this->GetRenderAdaptor();
+        if (renderAdaptor.GetRenderLatency() == RenderLatency::NONE)
+        {
+            renderAdaptor.SetWindowSize({ this->GetWindow().GetWidth(), this->GetWindow().GetHeight() });
+            renderAdaptor.CollectFrame();
+        }
+        renderAdaptor.ExecuteFrame();
 
         // invoke render event and application main callback
         RenderEvent renderEvent;
         Event::Invoke(renderEvent);
         this->OnRender();
 
-        this->GetRenderAdaptor().SubmitRenderedFrame();
+        renderAdaptor.SubmitRenderedFrame();
+
+        // with one frame latency frame is executed on next iteration, after its draw commands are built during simulation
+        if (renderAdaptor.GetRenderLatency() == RenderLatency::ONE_FRAME)
+        {
+            renderAdaptor.SetWindowSize({ this->GetWindow().GetWidth(), this->GetWindow().GetHeight() });
+            renderAdaptor.CollectFrame();
+        }
     }
 
     void Application::UpdateComponents()
@@ -316,9 +328,13 @@ namespace MxEngine
         MAKE_SCOPE_PROFILER("Application::CreateContext");
 
         this->InitializeConfig(this->config);
+        // glfw may be restarted, so it must happen before any window settings are applied
+        GraphicModule::UseHeadlessMode(this->config.HeadlessMode);
 
         this->GetWindow()
             .UseEventDispatcher(this->dispatcher)
+            .UseHeadlessMode(this->config.HeadlessMode)
+            .UseGraphicContext(!this->config.UseNullGraphicAPI)
             .UseProfile((int)this->config.GraphicAPIMajorVersion, (int)this->config.GraphicAPIMinorVersion, this->config.GraphicAPIProfile)
             .UseCursorMode(this->config.Cursor)
             .UseDoubleBuffering(this->config.DoubleBuffering)
@@ -372,6 +388,7 @@ namespace MxEngine
             {
                 MAKE_SCOPE_PROFILER("Application::Frame()");
                 this->UpdateTimeDelta(frameEnd, secondEnd, frameCount);
+                this->GetRenderAdaptor().PrepareFrameAsync();
                 this->InvokeUpdate();
                 this->DrawObjects();
                 this->GetWindow().PullEvents();
@@ -441,12 +458,16 @@ namespace MxEngine
     void Application::InitializeRenderAdaptor(RenderAdaptor& adaptor)
     {
         BufferAllocator::AllocateBuffers();
+        StreamBufferAllocator::AllocateBuffers();
         adaptor.InitRendererEnvironment();
     }
 
     void Application::DestroyRenderAdaptor(RenderAdaptor& adaptor)
     {
+        // background frame preparation references renderer, so it must be stopped before adaptor is destroyed
+        adaptor.SetRenderLatency(RenderLatency::NONE);
         adaptor = RenderAdaptor{ };
+        StreamBufferAllocator::Destroy();
         BufferAllocator::Destroy();
     }
 
@@ -548,6 +569,10 @@ namespace MxEngine
 
         FileManager::InitializeRootDirectory(FileManager::GetWorkingDirectory());
 
+        // null graphic api has nothing to present, so it always runs without window
+        if (config.UseNullGraphicAPI)
+            config.HeadlessMode = true;
+
         #if defined(MXENGINE_SHIPPING)
         config.GraphicAPIDebug = false;
         config.EditorOpenKey = KeyCode::UNKNOWN;
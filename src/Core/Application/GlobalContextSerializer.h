@@ -33,6 +33,7 @@
 #include "Core/MxObject/MxObject.h"
 #include "Core/Resources/AssetManager.h"
 #include "Core/Resources/BufferAllocator.h"
+#include "Core/Resources/StreamBufferAllocator.h"
 #include "Core/Runtime/RuntimeCompiler.h"
 #include "Core/Serialization/SceneSerializer.h"
 #include "Utilities/FileSystem/FileManager.h"
@@ -60,6 +61,7 @@ namespace MxEngine
         Factory<VertexArray>,
         Factory<VertexBuffer>,
         Factory<ShaderStorageBuffer>,
+        Factory<IndirectBuffer>,
         Factory<ComputeShader>,
         ComponentFactory,
         Factory<Material>,
@@ -75,6 +77,7 @@ namespace MxEngine
         Factory<MxObject>,
         RuntimeCompiler,
         SceneSerializer,
-        BufferAllocator
+        BufferAllocator,
+        StreamBufferAllocator
     >;
 }
\ No newline at end of file
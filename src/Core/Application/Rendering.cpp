@@ -103,6 +103,56 @@ namespace MxEngine
         return FWD(IsRenderedToDefaultFrameBuffer);
     }
 
+    void Rendering::SetShadowMapCaching(bool value)
+    {
+        FWD(SetShadowMapCaching, value);
+    }
+
+    bool Rendering::IsShadowMapCachingEnabled()
+    {
+        return FWD(IsShadowMapCachingEnabled);
+    }
+
+    void Rendering::SetStaticShadowCasterSplit(bool value)
+    {
+        FWD(SetStaticShadowCasterSplit, value);
+    }
+
+    bool Rendering::IsStaticShadowCasterSplit()
+    {
+        return FWD(IsStaticShadowCasterSplit);
+    }
+
+    void Rendering::SetClusteredLighting(bool value)
+    {
+        FWD(SetClusteredLighting, value);
+    }
+
+    bool Rendering::IsClusteredLightingEnabled()
+    {
+        return FWD(IsClusteredLightingEnabled);
+    }
+
+    void Rendering::SetOcclusionCulling(bool value)
+    {
+        FWD(SetOcclusionCulling, value);
+    }
+
+    bool Rendering::IsOcclusionCullingEnabled()
+    {
+        return FWD(IsOcclusionCullingEnabled);
+    }
+
+    void Rendering::SetLODPixelError(float pixels)
+    {
+        FWD(SetLODPixelError, pixels);
+    }
+
+    float Rendering::GetLODPixelError()
+    {
+        return FWD(GetLODPixelError);
+    }
+
     #define DRW Application::GetImpl()->GetRenderAdaptor().DebugDrawer
 
     void Rendering::Draw(const Line& line, const Vector4& color)
@@ -53,6 +53,16 @@ namespace MxEngine
         static void SetDebugOverlay(bool value = true);
         static void SetRenderToDefaultFrameBuffer(bool value = true);
         static bool IsRenderedToDefaultFrameBuffer();
+        static void SetShadowMapCaching(bool value = true);
+        static bool IsShadowMapCachingEnabled();
+        static void SetStaticShadowCasterSplit(bool value = true);
+        static bool IsStaticShadowCasterSplit();
+        static void SetClusteredLighting(bool value = true);
+        static bool IsClusteredLightingEnabled();
+        static void SetOcclusionCulling(bool value = true);
+        static bool IsOcclusionCullingEnabled();
+        static void SetLODPixelError(float pixels);
+        static float GetLODPixelError();
         static void Draw(const Line& line, const Vector4& color);
         static void Draw(const AABB& box, const Vector4& color);
         static void Draw(const BoundingBox& box, const Vector4& color);
@@ -46,6 +46,7 @@ namespace MxEngine
         bool IsAABBVisible(const Vector3& minp, const Vector3& maxp) const;
         // useful for shadow maps where z should not be culled, but clamped instead
         bool IsAABBVisibleXY(const Vector3& minp, const Vector3& maxp) const;
+        bool IsSphereVisible(const Vector3& center, float radius) const;
 
     private:
         enum Planes
@@ -150,6 +151,17 @@ namespace MxEngine
         return true;
     }
 
+    inline bool FrustrumCuller::IsSphereVisible(const Vector3& center, float radius) const
+    {
+        // planes are not normalized, so radius is scaled by plane normal length instead
+        for (const auto& plane : this->planes)
+        {
+            if (Dot(plane, Vector4(center, 1.0f)) < -radius * Length(Vector3(plane)))
+                return false;
+        }
+        return true;
+    }
+
     inline bool FrustrumCuller::IsAABBVisibleXY(const Vector3& minp, const Vector3& maxp) const
     {
         for (size_t i = 0; i < Planes::COUNT; i++)
@@ -50,6 +50,7 @@ namespace MxEngine
     TEMPLATE_INSTANCIATE_RESOURCE(VertexArray        );
     TEMPLATE_INSTANCIATE_RESOURCE(VertexBuffer       );
     TEMPLATE_INSTANCIATE_RESOURCE(ShaderStorageBuffer);
+    TEMPLATE_INSTANCIATE_RESOURCE(IndirectBuffer     );
     TEMPLATE_INSTANCIATE_RESOURCE(ComputeShader      );
     TEMPLATE_INSTANCIATE_RESOURCE(Material           );
     TEMPLATE_INSTANCIATE_RESOURCE(Mesh               );
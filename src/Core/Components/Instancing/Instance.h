@@ -38,6 +38,7 @@ namespace MxEngine
 
         Vector3 color{ 1.0f };
         MxObject::Handle parent;
+        uint8_t lod = 0;
     public:
         Instance(const MxObject::Handle& parent) : parent(parent) { }
 
@@ -52,6 +53,16 @@ namespace MxEngine
         {
             return this->color;
         }
+
+        void SetLOD(size_t lod)
+        {
+            this->lod = (uint8_t)Min(lod, (size_t)std::numeric_limits<uint8_t>::max());
+        }
+
+        size_t GetLOD() const
+        {
+            return (size_t)this->lod;
+        }
     };
 
     bool IsInstanced(const MxObject& object);
@@ -3,6 +3,14 @@
 #include "Utilities/Profiler/Profiler.h"
 #include "Core/Runtime/Reflection.h"
 #include "Core/Resources/BufferAllocator.h"
+#include "Core/Resources/StreamBufferAllocator.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MXENGINE_INSTANCING_USE_SSE
+#include <emmintrin.h>
+#endif
 
 namespace MxEngine
 {
@@ -19,18 +27,27 @@ namespace MxEngine
     {
         this->RemoveDanglingHandles();
         if (!this->IsStatic) 
-            this->SendInstancesToGPU();
+            this->isUploadPending = true;
     }
 
     void InstanceFactory::SubmitInstances()
     {
         this->RemoveDanglingHandles();
+        this->isUploadPending = true;
+    }
+
+    void InstanceFactory::UploadPendingInstances()
+    {
+        if (!this->isUploadPending) return;
+
+        this->isUploadPending = false;
         this->SendInstancesToGPU();
     }
 
     void InstanceFactory::DestroyInstances()
     {
         this->FreeInstancePool();
+        this->lightweightInstances.Clear();
     }
 
     // see SceneSerializer.cpp
@@ -42,7 +59,7 @@ namespace MxEngine
         auto object = MxObject::GetHandleByComponent(*this);
 
         this->pool.Allocate(instance);
-        this->ReserveInstanceAllocation(this->pool.Capacity());
+        this->ReserveInstanceAllocation(this->GetInstanceCapacity());
 
         auto instanceComponent = instance->AddComponent<Instance>(object);
         CloneInstanceInternal(object, instance);
@@ -50,20 +67,143 @@ namespace MxEngine
         return instance;
     }
 
+    void InstanceFactory::PackInstanceData(const Matrix4x4& model, const Vector3& color, InstanceData& result)
+    {
+        #if defined(MXENGINE_INSTANCING_USE_SSE)
+        // matrix is stored by columns, so after transpose first three registers hold rows of its affine part
+        __m128 c0 = _mm_loadu_ps(&model[0][0]);
+        __m128 c1 = _mm_loadu_ps(&model[1][0]);
+        __m128 c2 = _mm_loadu_ps(&model[2][0]);
+        __m128 c3 = _mm_loadu_ps(&model[3][0]);
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps(&result.Model[0][0], c0);
+        _mm_storeu_ps(&result.Model[1][0], c1);
+        _mm_storeu_ps(&result.Model[2][0], c2);
+
+        __m128 rgba = _mm_setr_ps(color.r, color.g, color.b, 1.0f);
+        rgba = _mm_min_ps(_mm_max_ps(rgba, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+        __m128i bytes = _mm_cvtps_epi32(_mm_mul_ps(rgba, _mm_set1_ps(255.0f)));
+        bytes = _mm_packs_epi32(bytes, bytes);
+        bytes = _mm_packus_epi16(bytes, bytes);
+        int32_t packedColor = _mm_cvtsi128_si32(bytes);
+        std::memcpy(&result.Color, &packedColor, sizeof(packedColor));
+        #else
+        for (size_t row = 0; row < 3; row++)
+        {
+            for (size_t column = 0; column < 4; column++)
+                result.Model[row][column] = model[column][row];
+        }
+
+        Vector4 rgba = Clamp(Vector4(color, 1.0f), MakeVector4(0.0f), MakeVector4(1.0f));
+        for (size_t i = 0; i < 4; i++)
+            result.Color[i] = (uint8_t)std::nearbyint(rgba[i] * 255.0f);
+        #endif
+    }
+
+    void InstanceFactory::UnpackInstanceData(const InstanceData& data, Matrix4x4& model, Vector3& color)
+    {
+        model = Transpose(Matrix4x4(data.Model[0], data.Model[1], data.Model[2], MakeVector4(0.0f, 0.0f, 0.0f, 1.0f)));
+        color = Vector3(data.Color.r, data.Color.g, data.Color.b) / 255.0f;
+    }
+
     void InstanceFactory::UpdateInstanceCache()
     {
         MAKE_SCOPE_PROFILER("Instancing::UpdateInstanceCache");
 
-        this->instances.resize(this->GetInstanceCount());
-        auto instanceData = this->instances.begin();
-        auto instance = this->GetInstancePool().begin();
+        // hidden lightweight instances are not written to instance buffer at all
+        size_t visibleCount = this->GetVisibleInstanceCount();
+        this->instances.resize(visibleCount);
+
+        auto& pool = this->GetInstancePool();
+        const auto& lightweight = this->lightweightInstances;
+        // lightweight instances are keyed after all pool slots, so keys of both kinds never collide
+        size_t lightweightKeyOffset = pool.Capacity();
 
-        for (; instanceData != this->instances.end(); instanceData++, instance++)
+        // count instances of each LOD bucket. Without LODs all instances go to single bucket
+        if (!this->lodInstanceCounts.empty())
         {
-            instance->GetUnchecked()->LocalTransform.GetMatrix(instanceData->Model);
-            instance->GetUnchecked()->LocalTransform.GetNormalMatrix(instanceData->Model, instanceData->Normal);
-            instanceData->Color = instance->GetUnchecked()->GetComponent<Instance>()->GetColor();
+            std::fill(this->lodInstanceCounts.begin(), this->lodInstanceCounts.end(), 0);
+            for (auto& instance : pool)
+            {
+                size_t lod = Min(instance.GetUnchecked()->GetComponent<Instance>()->GetLOD(), this->lodInstanceCounts.size() - 1);
+                this->lodInstanceCounts[lod]++;
+            }
+            for (size_t i = 0; i < lightweight.Size(); i++)
+            {
+                if (!lightweight.IsVisibleAt(i)) continue;
+                size_t lod = Min(lightweight.GetLODAt(i), this->lodInstanceCounts.size() - 1);
+                this->lodInstanceCounts[lod]++;
+            }
         }
+        this->slotCache.BeginUpdate(visibleCount, this->lodInstanceCounts);
+
+        // first all instances which stayed in their bucket keep their slots, so only moved ones are written to new place
+        this->pendingSlots.clear();
+        for (auto& instance : pool)
+        {
+            size_t lod = instance.GetUnchecked()->GetComponent<Instance>()->GetLOD();
+            this->pendingSlots.push_back(this->slotCache.TryKeepSlot(pool.IndexOf(instance), lod));
+        }
+        for (size_t i = 0; i < lightweight.Size(); i++)
+        {
+            if (!lightweight.IsVisibleAt(i)) continue;
+            this->pendingSlots.push_back(this->slotCache.TryKeepSlot(lightweightKeyOffset + i, lightweight.GetLODAt(i)));
+        }
+
+        Matrix4x4 model;
+        size_t pending = 0;
+        for (auto& instance : pool)
+        {
+            auto& object = *instance.GetUnchecked();
+            auto instanceComponent = object.GetComponent<Instance>();
+            size_t slot = this->pendingSlots[pending++];
+            if (slot == InstanceSlotCache::InvalidSlot)
+                slot = this->slotCache.AcquireSlot(pool.IndexOf(instance), instanceComponent->GetLOD());
+
+            const auto& color = instanceComponent->GetColor();
+            if (!this->slotCache.UpdateSlotState(slot, object.LocalTransform.GetVersion(), color)) continue;
+
+            object.LocalTransform.GetMatrix(model);
+            PackInstanceData(model, color, this->instances[slot]);
+        }
+
+        for (size_t i = 0; i < lightweight.Size(); i++)
+        {
+            if (!lightweight.IsVisibleAt(i)) continue;
+            size_t slot = this->pendingSlots[pending++];
+            if (slot == InstanceSlotCache::InvalidSlot)
+                slot = this->slotCache.AcquireSlot(lightweightKeyOffset + i, lightweight.GetLODAt(i));
+
+            const auto& color = lightweight.GetColorAt(i);
+            if (!this->slotCache.UpdateSlotState(slot, lightweight.GetVersionAt(i), color)) continue;
+
+            lightweight.GetMatrixAt(i, model);
+            PackInstanceData(model, color, this->instances[slot]);
+        }
+    }
+
+    size_t InstanceFactory::GetLODInstanceCount(size_t lod) const
+    {
+        if (this->lodInstanceCounts.empty())
+            return lod == 0 ? this->GetVisibleInstanceCount() : 0;
+
+        MX_ASSERT(lod < this->lodInstanceCounts.size());
+        return this->lodInstanceCounts[lod];
+    }
+
+    size_t InstanceFactory::GetLODInstanceOffset(size_t lod) const
+    {
+        size_t offset = 0;
+        for (size_t i = 0; i < lod && i < this->lodInstanceCounts.size(); i++)
+            offset += this->lodInstanceCounts[i];
+        return offset;
+    }
+
+    void InstanceFactory::SetLODCount(size_t count)
+    {
+        // single LOD does not require any sorting of instances
+        if (count <= 1) this->lodInstanceCounts.clear();
+        else this->lodInstanceCounts.resize(count);
     }
 
     void InstanceFactory::FreeInstancePool()
@@ -95,15 +235,53 @@ namespace MxEngine
         auto meshSource = object.GetComponent<MeshSource>();
         if (meshSource.IsValid() && meshSource->Mesh.IsValid())
         {
+            // lightweight instances are added directly to their storage, so buffer may not be reserved for them yet
+            this->ReserveInstanceAllocation(this->GetInstanceCapacity());
             this->UpdateInstanceCache();
+            this->UploadDirtyInstances();
+        }
+    }
+
+    void InstanceFactory::UploadDirtyInstances()
+    {
+        MAKE_SCOPE_PROFILER("Instancing::UploadDirtyInstances");
+        this->uploadedInstanceCount = 0;
+
+        this->slotCache.CollectDirtyRanges(DirtyRangeMergeDistance, this->dirtyRanges);
+        for (const auto& range : this->dirtyRanges)
+        {
+            this->UploadInstanceRange(range.Begin, range.End);
+        }
+    }
+
+    void InstanceFactory::UploadInstanceRange(size_t begin, size_t end)
+    {
+        this->uploadedInstanceCount += end - begin;
+
+        // instance buffer may still be read by previous frames, so data is staged in stream buffer and copied on GPU
+        size_t byteSize = (end - begin) * sizeof(InstanceData);
+        size_t byteOffset = (this->instanceAllocation.Offset + begin) * sizeof(InstanceData);
+        auto staging = StreamBufferAllocator::Allocate(byteSize);
+        if (staging.IsValid())
+        {
+            std::memcpy(staging.Data, this->instances.data() + begin, byteSize);
+            StreamBufferAllocator::CopyToBuffer(staging, *BufferAllocator::GetInstanceVBO(), byteOffset);
+        }
+        else
+        {
             BufferAllocator::GetInstanceVBO()->BufferSubData(
-                (float*)this->instances.data(),
-                this->instances.size() * InstanceDataSize,
-                this->instanceAllocation.Offset * InstanceDataSize
+                (float*)(this->instances.data() + begin),
+                (end - begin) * InstanceDataSize,
+                (this->instanceAllocation.Offset + begin) * InstanceDataSize
             );
         }
     }
 
+    size_t InstanceFactory::GetInstanceCapacity() const
+    {
+        return this->pool.Capacity() + this->lightweightInstances.Capacity();
+    }
+
     void InstanceFactory::ReserveInstanceAllocation(size_t count)
     {
         if (count <= this->instanceAllocation.Size) return;
@@ -113,6 +291,8 @@ namespace MxEngine
         auto allocation = BufferAllocator::AllocateInInstanceVBO(count * InstanceDataSize);
         this->instanceAllocation.Offset = allocation.Offset / InstanceDataSize;
         this->instanceAllocation.Size = allocation.Size / InstanceDataSize;
+        // new allocation does not contain any instance data yet
+        this->slotCache.Invalidate();
     }
 
     bool IsInstanced(const MxObject& object)
@@ -199,6 +379,14 @@ namespace MxEngine
             (
                 rttr::metadata(MetaInfo::FLAGS, MetaInfo::EDITABLE)
             )
+            .property_readonly("lightweight instance count", &InstanceFactory::GetLightweightInstanceCount)
+            (
+                rttr::metadata(MetaInfo::FLAGS, MetaInfo::EDITABLE)
+            )
+            .property_readonly("uploaded instances", &InstanceFactory::GetUploadedInstanceCount)
+            (
+                rttr::metadata(MetaInfo::FLAGS, MetaInfo::EDITABLE)
+            )
             .property_readonly("instances", (GetPoolFunc)&InstanceFactory::GetInstancePool)
             (
                 rttr::metadata(MetaInfo::FLAGS, MetaInfo::SERIALIZABLE | MetaInfo::EDITABLE),
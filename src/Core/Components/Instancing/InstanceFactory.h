@@ -29,6 +29,8 @@
 #pragma once
 
 #include "Core/Components/Instancing/Instance.h"
+#include "Core/Components/Instancing/LightweightInstanceStorage.h"
+#include "Core/Components/Instancing/InstanceSlotCache.h"
 #include "Core/Resources/Mesh.h"
 #include "Utilities/String/String.h"
 
@@ -136,20 +138,35 @@ namespace MxEngine
     public:
         struct InstanceData
         {
-            Matrix4x4 Model{ 1.0f };
-            Matrix3x3 Normal{ 1.0f };
-            Vector3 Color{ 1.0f };
+            // rows of affine model matrix, last row is always (0, 0, 0, 1). Normal matrix is derived in vertex shader
+            Matrix3x4 Model{ 1.0f };
+            VectorByte4 Color{ 255 };
         };
 
         constexpr static size_t InstanceDataSize = sizeof(InstanceData) / sizeof(float);
+        static_assert(sizeof(InstanceData) == InstanceDataSize * sizeof(float), "instance buffer is allocated in floats");
+        // maximal number of clean instances between two dirty ones which are uploaded together in one range
+        constexpr static size_t DirtyRangeMergeDistance = 8;
         using InstancePool = VectorPool<MxObject::Handle>;
     private:
         mutable InstancePool pool;
+        LightweightInstanceStorage lightweightInstances;
         MxVector<InstanceData> instances;
+        InstanceSlotCache slotCache;
+        // slot of each visible instance in iteration order, reused between updates to avoid allocations
+        MxVector<size_t> pendingSlots;
+        MxVector<InstanceSlotCache::SlotRange> dirtyRanges;
+        size_t uploadedInstanceCount = 0;
+        bool isUploadPending = false;
+        // if not empty, instances are sorted by their LOD, with bucket of each LOD following previous one
+        MxVector<size_t> lodInstanceCounts;
         MoveOnlyAllocation instanceAllocation;
 
         void RemoveDanglingHandles();
         void SendInstancesToGPU();
+        void UploadDirtyInstances();
+        void UploadInstanceRange(size_t begin, size_t end);
+        size_t GetInstanceCapacity() const;
         void ReserveInstanceAllocation(size_t count);
         void UpdateInstanceCache();
 
@@ -163,14 +180,28 @@ namespace MxEngine
 
         const InstancePool& GetInstancePool() const { return this->pool; }
         InstancePool& GetInstancePool() { return this->pool; };
-        size_t GetInstanceCount() const { return this->GetInstancePool().Allocated(); }
+        const LightweightInstanceStorage& GetLightweightInstances() const { return this->lightweightInstances; }
+        LightweightInstanceStorage& GetLightweightInstances() { return this->lightweightInstances; }
+        size_t GetInstanceCount() const { return this->GetInstancePool().Allocated() + this->lightweightInstances.Size(); }
+        size_t GetVisibleInstanceCount() const { return this->GetInstancePool().Allocated() + this->lightweightInstances.GetVisibleCount(); }
+        size_t GetLightweightInstanceCount() const { return this->lightweightInstances.Size(); }
         size_t GetInstanceBufferSize() const { return this->instanceAllocation.Size; }
         size_t GetInstanceBufferOffset() const { return this->instanceAllocation.Offset; }
+        size_t GetUploadedInstanceCount() const { return this->uploadedInstanceCount; }
         auto GetInstances() const { return InstanceView{ this->pool }; }
+        size_t GetLODCount() const { return Max(this->lodInstanceCounts.size(), (size_t)1); }
+        size_t GetLODInstanceCount(size_t lod) const;
+        size_t GetLODInstanceOffset(size_t lod) const;
+        void SetLODCount(size_t count);
+
+        static void PackInstanceData(const Matrix4x4& model, const Vector3& color, InstanceData& result);
+        static void UnpackInstanceData(const InstanceData& data, Matrix4x4& model, Vector3& color);
 
         void OnUpdate(float timeDelta);
         MxObject::Handle Instanciate();
+        // instances are uploaded only when frame is collected, as previous frame may still be pending (see RenderLatency)
         void SubmitInstances();
+        void UploadPendingInstances();
         void DestroyInstances();
     };
 }
\ No newline at end of file
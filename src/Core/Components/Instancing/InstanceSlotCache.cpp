@@ -0,0 +1,145 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "InstanceSlotCache.h"
+#include "Core/Macro/Macro.h"
+
+namespace MxEngine
+{
+    size_t InstanceSlotCache::GetBucket(size_t lod) const
+    {
+        return Min(lod, this->bucketBegins.size() - 1);
+    }
+
+    void InstanceSlotCache::BeginUpdate(size_t slotCount, const MxVector<size_t>& lodCounts)
+    {
+        size_t bucketCount = Max(lodCounts.size(), (size_t)1);
+        this->bucketBegins.resize(bucketCount);
+        this->bucketEnds.resize(bucketCount);
+
+        size_t offset = 0;
+        for (size_t i = 0; i < bucketCount; i++)
+        {
+            this->bucketBegins[i] = offset;
+            offset += lodCounts.empty() ? slotCount : lodCounts[i];
+            this->bucketEnds[i] = offset;
+        }
+        MX_ASSERT(offset == slotCount);
+        this->freeSlots = this->bucketBegins;
+
+        this->states.resize(slotCount, SlotState{ InvalidVersion, MakeVector3(0.0f) });
+        this->dirtySlots.assign(slotCount, false);
+        this->takenSlots.assign(slotCount, false);
+        this->dirtySlotCount = 0;
+    }
+
+    size_t InstanceSlotCache::TryKeepSlot(size_t key, size_t lod)
+    {
+        if (key >= this->keySlots.size())
+            this->keySlots.resize(key + 1, InvalidSlot);
+
+        size_t bucket = this->GetBucket(lod);
+        size_t slot = this->keySlots[key];
+        if (slot < this->bucketBegins[bucket] || slot >= this->bucketEnds[bucket] || this->takenSlots[slot])
+            return InvalidSlot;
+
+        this->takenSlots[slot] = true;
+        return slot;
+    }
+
+    size_t InstanceSlotCache::AcquireSlot(size_t key, size_t lod)
+    {
+        size_t bucket = this->GetBucket(lod);
+        size_t& slot = this->freeSlots[bucket];
+        while (slot < this->bucketEnds[bucket] && this->takenSlots[slot])
+            slot++;
+        MX_ASSERT(slot < this->bucketEnds[bucket]);
+
+        this->takenSlots[slot] = true;
+        this->keySlots[key] = slot;
+        return slot++;
+    }
+
+    bool InstanceSlotCache::UpdateSlotState(size_t slot, uint64_t version, const Vector3& color)
+    {
+        // equal versions mean equal transforms, even if slot is now taken by other instance
+        auto& state = this->states[slot];
+        if (state.Version == version && state.Color == color) return false;
+
+        state.Version = version;
+        state.Color = color;
+        this->dirtySlots[slot] = true;
+        this->dirtySlotCount++;
+        return true;
+    }
+
+    void InstanceSlotCache::Invalidate()
+    {
+        this->states.clear();
+    }
+
+    void InstanceSlotCache::CollectDirtyRanges(size_t mergeDistance, MxVector<SlotRange>& ranges) const
+    {
+        ranges.clear();
+        size_t count = this->dirtySlots.size();
+        size_t current = 0;
+        while (current < count)
+        {
+            if (!this->dirtySlots[current])
+            {
+                current++;
+                continue;
+            }
+
+            size_t begin = current;
+            size_t end = current + 1;
+            for (size_t i = end; i < count && i - end <= mergeDistance; i++)
+            {
+                if (this->dirtySlots[i]) end = i + 1;
+            }
+
+            ranges.push_back(SlotRange{ begin, end });
+            current = end;
+        }
+    }
+
+    size_t InstanceSlotCache::GetSlotCount() const
+    {
+        return this->takenSlots.size();
+    }
+
+    size_t InstanceSlotCache::GetDirtySlotCount() const
+    {
+        return this->dirtySlotCount;
+    }
+
+    bool InstanceSlotCache::IsSlotDirty(size_t slot) const
+    {
+        return this->dirtySlots[slot];
+    }
+}
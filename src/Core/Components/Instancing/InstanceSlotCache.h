@@ -0,0 +1,94 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Utilities/Math/Math.h"
+#include "Utilities/STL/MxVector.h"
+
+#include <limits>
+
+namespace MxEngine
+{
+    /*!
+    assigns instances of one factory to slots of its instance buffer range and tracks which slots must be uploaded.
+    instances are grouped into contiguous LOD buckets, but keep their slots between updates while they stay inside of
+    their bucket, so LOD changes and removals dirty only slots of instances which were actually moved.
+    each update has two passes: first every instance tries to keep its previous slot, then the rest take free ones
+    */
+    class InstanceSlotCache
+    {
+    public:
+        constexpr static size_t InvalidSlot = std::numeric_limits<size_t>::max();
+
+        struct SlotRange
+        {
+            size_t Begin;
+            size_t End;
+        };
+    private:
+        struct SlotState
+        {
+            uint64_t Version;
+            Vector3 Color;
+        };
+
+        constexpr static uint64_t InvalidVersion = std::numeric_limits<uint64_t>::max();
+
+        // state of each slot at the moment of its last upload
+        MxVector<SlotState> states;
+        MxVector<bool> dirtySlots;
+        MxVector<bool> takenSlots;
+        // slot of each instance key at the last update. Keys of removed instances are never cleared, as they are only a hint
+        MxVector<size_t> keySlots;
+        MxVector<size_t> bucketBegins;
+        MxVector<size_t> bucketEnds;
+        // first slot of each bucket which may still be free
+        MxVector<size_t> freeSlots;
+        size_t dirtySlotCount = 0;
+
+        size_t GetBucket(size_t lod) const;
+    public:
+        // lodCounts contains number of instances in each LOD bucket. If it is empty, all slots form a single bucket
+        void BeginUpdate(size_t slotCount, const MxVector<size_t>& lodCounts);
+        // returns InvalidSlot if previous slot of instance is outside of its bucket or was already taken in this update
+        size_t TryKeepSlot(size_t key, size_t lod);
+        // must be called only after TryKeepSlot() was called for every instance
+        size_t AcquireSlot(size_t key, size_t lod);
+        // returns true and marks slot dirty if its contents differ from the last uploaded ones
+        bool UpdateSlotState(size_t slot, uint64_t version, const Vector3& color);
+        // forgets uploaded states, i.e. when instances are moved to new buffer allocation
+        void Invalidate();
+        // dirty slots separated by at most mergeDistance clean ones are merged, as each range is a separate copy command
+        void CollectDirtyRanges(size_t mergeDistance, MxVector<SlotRange>& ranges) const;
+
+        size_t GetSlotCount() const;
+        size_t GetDirtySlotCount() const;
+        bool IsSlotDirty(size_t slot) const;
+    };
+}
@@ -0,0 +1,236 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "LightweightInstanceStorage.h"
+
+namespace MxEngine
+{
+    size_t LightweightInstanceStorage::GetDenseIndex(Handle handle) const
+    {
+        MX_ASSERT(this->IsValid(handle));
+        return (size_t)this->handleToDense[handle.Index];
+    }
+
+    void LightweightInstanceStorage::Invalidate(size_t index)
+    {
+        this->versions[index] = Transform::GenerateVersion();
+    }
+
+    LightweightInstanceStorage::Handle LightweightInstanceStorage::Add(const Vector3& position, const Quaternion& rotation, const Vector3& scale, const Vector3& color)
+    {
+        Handle handle;
+        if (!this->freeHandles.empty())
+        {
+            handle.Index = this->freeHandles.back();
+            this->freeHandles.pop_back();
+        }
+        else
+        {
+            handle.Index = (uint32_t)this->handleToDense.size();
+            this->handleToDense.push_back(0);
+            this->generations.push_back(0);
+        }
+        handle.Generation = this->generations[handle.Index];
+
+        this->handleToDense[handle.Index] = (uint32_t)this->positions.size();
+        this->denseToHandle.push_back(handle.Index);
+        this->positions.push_back(position);
+        this->rotations.push_back(rotation);
+        this->scales.push_back(scale);
+        this->colors.push_back(Clamp(color, MakeVector3(0.0f), MakeVector3(1.0f)));
+        this->versions.push_back(Transform::GenerateVersion());
+        this->lods.push_back(0);
+        this->visible.push_back(1);
+        this->visibleCount++;
+        return handle;
+    }
+
+    LightweightInstanceStorage::Handle LightweightInstanceStorage::Add(const Transform& transform, const Vector3& color)
+    {
+        // transform matrix rotates in Y * X * Z order, which differs from order of Transform::GetRotationQuaternion()
+        auto rotation = MakeQuaternion(MakeRotationMatrix(RadiansVec(transform.GetRotation())));
+        return this->Add(transform.GetPosition(), rotation, transform.GetScale(), color);
+    }
+
+    void LightweightInstanceStorage::Remove(Handle handle)
+    {
+        size_t index = this->GetDenseIndex(handle);
+        size_t last = this->positions.size() - 1;
+        if (this->visible[index] != 0) this->visibleCount--;
+
+        if (index != last)
+        {
+            this->positions[index] = this->positions[last];
+            this->rotations[index] = this->rotations[last];
+            this->scales[index] = this->scales[last];
+            this->colors[index] = this->colors[last];
+            this->versions[index] = this->versions[last];
+            this->lods[index] = this->lods[last];
+            this->visible[index] = this->visible[last];
+            this->denseToHandle[index] = this->denseToHandle[last];
+            this->handleToDense[this->denseToHandle[index]] = (uint32_t)index;
+        }
+
+        this->positions.pop_back();
+        this->rotations.pop_back();
+        this->scales.pop_back();
+        this->colors.pop_back();
+        this->versions.pop_back();
+        this->lods.pop_back();
+        this->visible.pop_back();
+        this->denseToHandle.pop_back();
+
+        this->generations[handle.Index]++;
+        this->freeHandles.push_back(handle.Index);
+    }
+
+    bool LightweightInstanceStorage::IsValid(Handle handle) const
+    {
+        return handle.Index < this->generations.size() && this->generations[handle.Index] == handle.Generation &&
+            this->handleToDense[handle.Index] < this->denseToHandle.size() && this->denseToHandle[this->handleToDense[handle.Index]] == handle.Index;
+    }
+
+    void LightweightInstanceStorage::Reserve(size_t count)
+    {
+        this->positions.reserve(count);
+        this->rotations.reserve(count);
+        this->scales.reserve(count);
+        this->colors.reserve(count);
+        this->versions.reserve(count);
+        this->lods.reserve(count);
+        this->visible.reserve(count);
+        this->denseToHandle.reserve(count);
+        this->handleToDense.reserve(count);
+        this->generations.reserve(count);
+    }
+
+    void LightweightInstanceStorage::Clear()
+    {
+        // all alive handles must become invalid, so their generations are advanced before reuse
+        for (uint32_t handleIndex : this->denseToHandle)
+        {
+            this->generations[handleIndex]++;
+            this->freeHandles.push_back(handleIndex);
+        }
+
+        this->positions.clear();
+        this->rotations.clear();
+        this->scales.clear();
+        this->colors.clear();
+        this->versions.clear();
+        this->lods.clear();
+        this->visible.clear();
+        this->denseToHandle.clear();
+        this->visibleCount = 0;
+    }
+
+    void LightweightInstanceStorage::SetPosition(Handle handle, const Vector3& position)
+    {
+        size_t index = this->GetDenseIndex(handle);
+        this->positions[index] = position;
+        this->Invalidate(index);
+    }
+
+    void LightweightInstanceStorage::SetRotation(Handle handle, const Quaternion& rotation)
+    {
+        size_t index = this->GetDenseIndex(handle);
+        this->rotations[index] = rotation;
+        this->Invalidate(index);
+    }
+
+    void LightweightInstanceStorage::SetScale(Handle handle, const Vector3& scale)
+    {
+        size_t index = this->GetDenseIndex(handle);
+        this->scales[index] = scale;
+        this->Invalidate(index);
+    }
+
+    void LightweightInstanceStorage::SetColor(Handle handle, const Vector3& color)
+    {
+        size_t index = this->GetDenseIndex(handle);
+        this->colors[index] = Clamp(color, MakeVector3(0.0f), MakeVector3(1.0f));
+    }
+
+    void LightweightInstanceStorage::SetVisible(Handle handle, bool isVisible)
+    {
+        size_t index = this->GetDenseIndex(handle);
+        if ((this->visible[index] != 0) == isVisible) return;
+
+        this->visible[index] = (uint8_t)isVisible;
+        if (isVisible) this->visibleCount++;
+        else this->visibleCount--;
+    }
+
+    void LightweightInstanceStorage::Translate(Handle handle, const Vector3& distance)
+    {
+        size_t index = this->GetDenseIndex(handle);
+        this->positions[index] += distance;
+        this->Invalidate(index);
+    }
+
+    const Vector3& LightweightInstanceStorage::GetPosition(Handle handle) const
+    {
+        return this->positions[this->GetDenseIndex(handle)];
+    }
+
+    const Quaternion& LightweightInstanceStorage::GetRotation(Handle handle) const
+    {
+        return this->rotations[this->GetDenseIndex(handle)];
+    }
+
+    const Vector3& LightweightInstanceStorage::GetScale(Handle handle) const
+    {
+        return this->scales[this->GetDenseIndex(handle)];
+    }
+
+    const Vector3& LightweightInstanceStorage::GetColor(Handle handle) const
+    {
+        return this->colors[this->GetDenseIndex(handle)];
+    }
+
+    bool LightweightInstanceStorage::IsVisible(Handle handle) const
+    {
+        return this->visible[this->GetDenseIndex(handle)] != 0;
+    }
+
+    void LightweightInstanceStorage::SetLODAt(size_t index, size_t lod)
+    {
+        this->lods[index] = (uint8_t)Min(lod, (size_t)std::numeric_limits<uint8_t>::max());
+    }
+
+    void LightweightInstanceStorage::GetMatrixAt(size_t index, Matrix4x4& model) const
+    {
+        // same as Translate * Rotate * Scale, but without full matrix multiplications
+        const auto& scale = this->scales[index];
+        model = ToMatrix(this->rotations[index]);
+        model[0] *= scale.x;
+        model[1] *= scale.y;
+        model[2] *= scale.z;
+        model[3] = Vector4(this->positions[index], 1.0f);
+    }
+}
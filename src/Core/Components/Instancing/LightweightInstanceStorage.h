@@ -0,0 +1,103 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Core/Components/Transform.h"
+#include "Utilities/STL/MxVector.h"
+
+#include <limits>
+
+namespace MxEngine
+{
+    struct LightweightInstanceHandle
+    {
+        uint32_t Index = std::numeric_limits<uint32_t>::max();
+        uint32_t Generation = 0;
+    };
+
+    /*!
+    stores instances without MxObject as plain arrays of their data. Instances are accessed by handles, which stay valid until instance is removed.
+    Internally instances are kept packed, so removing one moves the last instance into its place
+    */
+    class LightweightInstanceStorage
+    {
+    public:
+        using Handle = LightweightInstanceHandle;
+    private:
+        MxVector<Vector3> positions;
+        MxVector<Quaternion> rotations;
+        MxVector<Vector3> scales;
+        MxVector<Vector3> colors;
+        MxVector<uint64_t> versions;
+        MxVector<uint8_t> lods;
+        MxVector<uint8_t> visible;
+        MxVector<uint32_t> denseToHandle;
+
+        // indirection from handle index to packed index, generation is incremented each time handle is freed
+        MxVector<uint32_t> handleToDense;
+        MxVector<uint32_t> generations;
+        MxVector<uint32_t> freeHandles;
+        size_t visibleCount = 0;
+
+        size_t GetDenseIndex(Handle handle) const;
+        void Invalidate(size_t index);
+    public:
+        Handle Add(const Vector3& position, const Quaternion& rotation, const Vector3& scale, const Vector3& color = MakeVector3(1.0f));
+        Handle Add(const Transform& transform, const Vector3& color = MakeVector3(1.0f));
+        void Remove(Handle handle);
+        bool IsValid(Handle handle) const;
+        void Reserve(size_t count);
+        void Clear();
+
+        void SetPosition(Handle handle, const Vector3& position);
+        void SetRotation(Handle handle, const Quaternion& rotation);
+        void SetScale(Handle handle, const Vector3& scale);
+        void SetColor(Handle handle, const Vector3& color);
+        void SetVisible(Handle handle, bool isVisible);
+        void Translate(Handle handle, const Vector3& distance);
+
+        const Vector3& GetPosition(Handle handle) const;
+        const Quaternion& GetRotation(Handle handle) const;
+        const Vector3& GetScale(Handle handle) const;
+        const Vector3& GetColor(Handle handle) const;
+        bool IsVisible(Handle handle) const;
+
+        size_t Size() const { return this->positions.size(); }
+        size_t Capacity() const { return this->positions.capacity(); }
+        size_t GetVisibleCount() const { return this->visibleCount; }
+
+        // access by packed index in range [0, Size()). Indices are invalidated by Remove()
+        bool IsVisibleAt(size_t index) const { return this->visible[index] != 0; }
+        uint64_t GetVersionAt(size_t index) const { return this->versions[index]; }
+        const Vector3& GetColorAt(size_t index) const { return this->colors[index]; }
+        size_t GetLODAt(size_t index) const { return (size_t)this->lods[index]; }
+        void SetLODAt(size_t index, size_t lod);
+        void GetMatrixAt(size_t index, Matrix4x4& model) const;
+    };
+}
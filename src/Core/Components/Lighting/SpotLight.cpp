@@ -27,34 +27,19 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "SpotLight.h"
-#include "Core/Config/GlobalConfig.h"
 #include "Core/Runtime/Reflection.h"
 
 namespace MxEngine
 {
     bool SpotLight::IsCastingShadows() const
     {
-        return this->DepthMap.IsValid();
+        return this->castsShadows;
     }
 
     void SpotLight::ToggleShadowCast(bool value)
     {
-        if (value && !this->IsCastingShadows())
-        {
-            this->LoadDepthTexture();
-        }
-        else if (!value && this->IsCastingShadows())
-        {
-            this->DepthMap = { };
-        }
-    }
-
-    void SpotLight::LoadDepthTexture()
-    {
-        auto depthTextureSize = (int)GlobalConfig::GetSpotLightTextureSize();
-        this->DepthMap = Factory<Texture>::Create();
-        this->DepthMap->LoadDepth(depthTextureSize, depthTextureSize);
-        this->DepthMap->SetInternalEngineTag(MXENGINE_MAKE_INTERNAL_TAG("spot light"));
+        // spot light shadows are allocated in the shared shadow atlas by the renderer
+        this->castsShadows = value;
     }
 
     float SpotLight::GetInnerAngle() const
@@ -175,11 +160,6 @@ namespace MxEngine
             .property("casts shadows", &SpotLight::IsCastingShadows, &SpotLight::ToggleShadowCast)
             (
                 rttr::metadata(MetaInfo::FLAGS, MetaInfo::SERIALIZABLE | MetaInfo::EDITABLE)
-            )
-            .property_readonly("depth map", &SpotLight::DepthMap)
-            (
-                rttr::metadata(MetaInfo::FLAGS, MetaInfo::EDITABLE),
-                rttr::metadata(MetaInfo::CONDITION, +([](rttr::instance& obj) { return obj.try_convert<SpotLight>()->IsCastingShadows(); }))
             );
     }
 }
\ No newline at end of file
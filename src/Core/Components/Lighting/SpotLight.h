@@ -43,11 +43,8 @@ namespace MxEngine
         float outerAngle  = 45.0f;
         float outerCos    = std::cos(Radians(outerAngle));
         float maxDistance = 1000.0f;
-
-        void LoadDepthTexture();
+        bool castsShadows = false;
     public:
-        TextureHandle DepthMap;
-
         SpotLight() = default;
 
         [[nodiscard]] bool IsCastingShadows() const;
@@ -28,42 +28,147 @@
 
 #include "MeshLOD.h"
 #include "Core/MxObject/MxObject.h"
+#include "Core/Components/Instancing/InstanceFactory.h"
 #include "Core/Runtime/Reflection.h"
 
 namespace MxEngine
 {
-    void MeshLOD::FixBestLOD(const Vector3& viewportPosition, float viewportZoom)
+    float EstimateLODError(const Mesh& source, const Mesh& lod)
+    {
+        if (lod.LODError > 0.0f) return lod.LODError;
+
+        // assume triangles are evenly spread over bounding sphere, so error grows as their edges become longer
+        auto AverageEdgeLength = [](const Mesh& mesh)
+        {
+            float triangleCount = (float)Max(mesh.GetTotalIndiciesCount() / 3, (size_t)1);
+            return mesh.MeshBoundingSphere.Radius * std::sqrt(16.0f * Pi<float>() / (std::sqrt(3.0f) * triangleCount));
+        };
+        return Max(AverageEdgeLength(lod) - AverageEdgeLength(source), 0.0f);
+    }
+
+    void MeshLOD::UpdateLODErrors(const Mesh& mesh)
+    {
+        const auto& lods = this->GetActiveLODs();
+        this->lodErrors.resize(lods.size() + 1);
+        this->lodErrors[0] = 0.0f;
+        for (size_t i = 0; i < lods.size(); i++)
+        {
+            float error = lods[i].IsValid() ? EstimateLODError(mesh, *lods[i]) : 0.0f;
+            // less detailed LOD is never considered more precise than previous one
+            this->lodErrors[i + 1] = Max(this->lodErrors[i], error);
+        }
+    }
+
+    size_t MeshLOD::SelectLOD(const MxVector<float>& lodErrors, size_t currentLOD, const AABB& objectAABB, const AABB& worldAABB, const LODSelectionInfo& info)
+    {
+        MX_ASSERT(!lodErrors.empty());
+        auto sphere = ToSphere(worldAABB);
+        float objectSize = ComponentMax(objectAABB.Length());
+        float worldScale = objectSize > 0.0f ? ComponentMax(worldAABB.Length()) / objectSize : 1.0f;
+
+        float pixelsPerError = info.PixelsPerUnit * worldScale;
+        if (info.IsPerspective)
+        {
+            float distance = Length(sphere.Center - info.ViewPosition) - sphere.Radius;
+            // viewer is inside object bounds, so it should be as detailed as possible
+            if (distance <= 0.0f) return 0;
+            pixelsPerError /= distance;
+        }
+
+        // refine while current LOD is noticeably above budget, then coarsen while next LOD is noticeably below it
+        size_t lod = Min(currentLOD, lodErrors.size() - 1);
+        float refineThreshold = info.PixelErrorBudget * (1.0f + info.Hysteresis);
+        float coarsenThreshold = info.PixelErrorBudget * (1.0f - info.Hysteresis);
+        while (lod > 0 && lodErrors[lod] * pixelsPerError > refineThreshold)
+            lod--;
+        while (lod + 1 < lodErrors.size() && lodErrors[lod + 1] * pixelsPerError <= coarsenThreshold)
+            lod++;
+        return lod;
+    }
+
+    void MeshLOD::FixBestLOD(const LODSelectionInfo& info)
     {
         if (!this->AutoLODSelection) return;
         auto& object = MxObject::GetByComponent(*this);
         auto meshSource = object.GetComponent<MeshSource>();
-        if (!meshSource.IsValid()) 
+        if (!meshSource.IsValid() || !meshSource->Mesh.IsValid())
         {
-            this->SetCurrentLOD(0); 
+            this->SetCurrentLOD(0);
             return;
         }
 
-        auto box = meshSource->Mesh->MeshAABB * object.LocalTransform.GetMatrix();
+        auto& mesh = *meshSource->Mesh;
+        this->UpdateLODErrors(mesh);
+        auto worldAABB = mesh.MeshAABB * object.LocalTransform.GetMatrix();
+        this->SetCurrentLOD(SelectLOD(this->lodErrors, this->currentLOD, mesh.MeshAABB, worldAABB, info));
+    }
 
-        float distance = Length(box.GetCenter() - viewportPosition);
-        Vector3 length = box.Length();
-        float maxLength = ComponentMax(length);
-        float scaledDistance = maxLength / (distance * viewportZoom);
+    void MeshLOD::FixInstanceLODs(InstanceFactory& instances, const LODSelectionInfo& info)
+    {
+        auto& object = MxObject::GetByComponent(*this);
+        auto meshSource = object.GetComponent<MeshSource>();
+        if (!meshSource.IsValid() || !meshSource->Mesh.IsValid()) return;
 
-        // magic numbers which were measured in game to find best distance for each LOD peek
-        constexpr static std::array lodDistance = {
-            0.21f, 0.15f, 0.10f, 0.06f, 0.03f, 0.01f
-        };
-        this->SetCurrentLOD(0);
-        while (this->currentLOD < lodDistance.size() && scaledDistance < lodDistance[this->currentLOD])
-            this->currentLOD++;
+        auto& mesh = *meshSource->Mesh;
+        this->UpdateLODErrors(mesh);
+        size_t lodCount = this->GetLODCount();
+
+        bool isChanged = instances.GetLODCount() != lodCount;
+        if (this->AutoLODSelection)
+        {
+            const auto& parentMatrix = object.LocalTransform.GetMatrix();
+            for (auto& instance : instances.GetInstancePool())
+            {
+                if (!instance.IsValid()) continue;
+                auto instanceComponent = instance->GetComponent<Instance>();
+                if (!instanceComponent.IsValid()) continue;
+
+                auto worldAABB = mesh.MeshAABB * (parentMatrix * instance->LocalTransform.GetMatrix());
+                size_t currentLOD = Min(instanceComponent->GetLOD(), lodCount - 1);
+                size_t lod = SelectLOD(this->lodErrors, currentLOD, mesh.MeshAABB, worldAABB, info);
+
+                isChanged |= lod != instanceComponent->GetLOD();
+                instanceComponent->SetLOD(lod);
+            }
+
+            auto& lightweight = instances.GetLightweightInstances();
+            Matrix4x4 model;
+            for (size_t i = 0; i < lightweight.Size(); i++)
+            {
+                if (!lightweight.IsVisibleAt(i)) continue;
 
-        this->SetCurrentLOD(Min(this->currentLOD, this->LODs.size()));
+                lightweight.GetMatrixAt(i, model);
+                auto worldAABB = mesh.MeshAABB * (parentMatrix * model);
+                size_t currentLOD = Min(lightweight.GetLODAt(i), lodCount - 1);
+                size_t lod = SelectLOD(this->lodErrors, currentLOD, mesh.MeshAABB, worldAABB, info);
+
+                isChanged |= lod != lightweight.GetLODAt(i);
+                lightweight.SetLODAt(i, lod);
+            }
+        }
+
+        // instances must be resorted into LOD buckets. Only instances which changed their bucket are moved and uploaded again
+        if (isChanged)
+        {
+            instances.SetLODCount(lodCount);
+            instances.SubmitInstances();
+        }
+    }
+
+    const MxVector<MeshHandle>& MeshLOD::GetActiveLODs() const
+    {
+        static const MxVector<MeshHandle> empty;
+        if (!this->LODs.empty()) return this->LODs;
+
+        auto meshSource = MxObject::GetByComponent(*this).GetComponent<MeshSource>();
+        if (!meshSource.IsValid() || !meshSource->Mesh.IsValid()) return empty;
+        return meshSource->Mesh->GetLODs();
     }
 
     void MeshLOD::SetCurrentLOD(size_t lod)
     {
-        this->currentLOD = (uint8_t)Min(lod, (size_t)Max((int)this->LODs.size() - 1, 0));
+        // LOD 0 is mesh of MeshSource, others are taken from LODs list
+        this->currentLOD = (uint8_t)Min(lod, this->GetActiveLODs().size());
     }
 
     size_t MeshLOD::GetCurrentLOD() const
@@ -71,12 +176,23 @@ namespace MxEngine
         return (size_t)this->currentLOD;
     }
 
+    size_t MeshLOD::GetLODCount() const
+    {
+        return this->GetActiveLODs().size() + 1;
+    }
+
     MeshHandle MeshLOD::GetMeshLOD() const
     {
-        if (this->currentLOD == 0 || this->currentLOD >= this->LODs.size())
+        return this->GetMeshLOD(this->currentLOD);
+    }
+
+    MeshHandle MeshLOD::GetMeshLOD(size_t lod) const
+    {
+        const auto& lods = this->GetActiveLODs();
+        if (lod == 0 || lod > lods.size())
             return MxObject::GetByComponent(*this).GetComponent<MeshSource>()->Mesh;
         else
-            return this->LODs[this->currentLOD - 1];
+            return lods[lod - 1];
     }
 
     MXENGINE_REFLECT_TYPE
@@ -34,21 +34,45 @@
 
 namespace MxEngine
 {
+    class InstanceFactory;
+
+    struct LODSelectionInfo
+    {
+        Vector3 ViewPosition{ 0.0f };
+        // pixels covered by one world unit at distance 1 for perspective projection, or at any distance for orthographic one
+        float PixelsPerUnit = 0.0f;
+        bool IsPerspective = true;
+        // max screen-space error of selected LOD in pixels
+        float PixelErrorBudget = 1.0f;
+        // relative margin around budget which LOD error must cross before LOD is switched, to avoid popping
+        float Hysteresis = 0.25f;
+    };
 
     class MeshLOD
     {
         MAKE_COMPONENT(MeshLOD);
 
         uint8_t currentLOD = 0;
+        MxVector<float> lodErrors;
+
+        const MxVector<MeshHandle>& GetActiveLODs() const;
+        void UpdateLODErrors(const Mesh& mesh);
     public:
         MeshLOD() = default;
 
         bool AutoLODSelection = true;
 
+        // if empty, LODs generated for mesh of MeshSource are used
         MxVector<MeshHandle> LODs;
-        void FixBestLOD(const Vector3& viewportPosition, float viewportZoom = 1.0f);
+        void FixBestLOD(const LODSelectionInfo& info);
+        void FixInstanceLODs(InstanceFactory& instances, const LODSelectionInfo& info);
         void SetCurrentLOD(size_t lod);
         size_t GetCurrentLOD() const;
+        size_t GetLODCount() const;
         MeshHandle GetMeshLOD() const;
+        MeshHandle GetMeshLOD(size_t lod) const;
+
+        // lodErrors[i] is object-space error of i-th LOD, non-decreasing and starting from 0 for source mesh
+        static size_t SelectLOD(const MxVector<float>& lodErrors, size_t currentLOD, const AABB& objectAABB, const AABB& worldAABB, const LODSelectionInfo& info);
     };
 }
\ No newline at end of file
@@ -41,6 +41,8 @@ namespace MxEngine
         bool IsDrawn = true;
         bool CastsShadow = true;
         bool IsStatic = false;
+        // object is rasterized into software occlusion buffer. Large static objects are used as occluders automatically
+        bool IsOccluder = false;
 
         MeshSource() : Mesh(Factory<MxEngine::Mesh>::Create()) { }
         MeshSource(const MeshHandle& mesh) : Mesh(mesh) { }
@@ -0,0 +1,218 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "ParticleSimulator.h"
+#include "Utilities/Threading/WorkerPool.h"
+#include "Utilities/Profiler/Profiler.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MXENGINE_PARTICLES_USE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace MxEngine
+{
+    void ParticleSimulator::Load(const MxVector<Particle>& particles)
+    {
+        this->particleCount = particles.size();
+        size_t paddedCount = (this->particleCount + SimdWidth - 1) / SimdWidth * SimdWidth;
+
+        // padding lanes are simulated together with real particles, but never read back
+        for (auto* array : { &this->positionX, &this->positionY, &this->positionZ, &this->timeAlive,
+                             &this->velocityX, &this->velocityY, &this->velocityZ, &this->size,
+                             &this->angularX,  &this->angularY,  &this->angularZ,  &this->spawnDistance })
+        {
+            array->assign(paddedCount, 0.0f);
+        }
+
+        for (size_t i = 0; i < particles.size(); i++)
+        {
+            const auto& particle = particles[i];
+            this->positionX[i]     = particle.Position.x;
+            this->positionY[i]     = particle.Position.y;
+            this->positionZ[i]     = particle.Position.z;
+            this->timeAlive[i]     = particle.TimeAlive;
+            this->velocityX[i]     = particle.Velocity.x;
+            this->velocityY[i]     = particle.Velocity.y;
+            this->velocityZ[i]     = particle.Velocity.z;
+            this->size[i]          = particle.Size;
+            this->angularX[i]      = particle.AngularParams.x;
+            this->angularY[i]      = particle.AngularParams.y;
+            this->angularZ[i]      = particle.AngularParams.z;
+            this->spawnDistance[i] = particle.SpawnDistance;
+        }
+    }
+
+    void ParticleSimulator::Store(MxVector<Particle>& particles) const
+    {
+        particles.resize(this->particleCount);
+        for (size_t i = 0; i < particles.size(); i++)
+        {
+            auto& particle = particles[i];
+            particle.Position      = MakeVector3(this->positionX[i], this->positionY[i], this->positionZ[i]);
+            particle.TimeAlive     = this->timeAlive[i];
+            particle.Velocity      = MakeVector3(this->velocityX[i], this->velocityY[i], this->velocityZ[i]);
+            particle.Size          = this->size[i];
+            particle.AngularParams = MakeVector3(this->angularX[i], this->angularY[i], this->angularZ[i]);
+            particle.SpawnDistance = this->spawnDistance[i];
+        }
+    }
+
+    void ParticleSimulator::Clear()
+    {
+        this->Load({ });
+    }
+
+    #if defined(MXENGINE_PARTICLES_USE_SSE)
+    static inline __m128 Select(__m128 mask, __m128 ifTrue, __m128 ifFalse)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+    }
+
+    static inline __m128 Dot(__m128 x, __m128 y, __m128 z)
+    {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+    }
+    #endif
+
+    void ParticleSimulator::SimulateRange(size_t begin, size_t end, float dt, float lifetime, const Vector3& spawnpoint)
+    {
+        // angular params store speed * axis, so speed * cross(n, axis) from compute shader is computed as cross(n, angular)
+        #if defined(MXENGINE_PARTICLES_USE_SSE)
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 timeDelta = _mm_set1_ps(dt);
+        const __m128 maxTimeAlive = _mm_set1_ps(lifetime);
+        const __m128 spawnX = _mm_set1_ps(spawnpoint.x);
+        const __m128 spawnY = _mm_set1_ps(spawnpoint.y);
+        const __m128 spawnZ = _mm_set1_ps(spawnpoint.z);
+
+        for (size_t i = begin; i < end; i += SimdWidth)
+        {
+            __m128 vx = _mm_loadu_ps(&this->velocityX[i]);
+            __m128 vy = _mm_loadu_ps(&this->velocityY[i]);
+            __m128 vz = _mm_loadu_ps(&this->velocityZ[i]);
+            __m128 ax = _mm_loadu_ps(&this->angularX[i]);
+            __m128 ay = _mm_loadu_ps(&this->angularY[i]);
+            __m128 az = _mm_loadu_ps(&this->angularZ[i]);
+
+            __m128 t = _mm_add_ps(_mm_loadu_ps(&this->timeAlive[i]), timeDelta);
+            __m128 px = _mm_add_ps(_mm_loadu_ps(&this->positionX[i]), _mm_mul_ps(vx, timeDelta));
+            __m128 py = _mm_add_ps(_mm_loadu_ps(&this->positionY[i]), _mm_mul_ps(vy, timeDelta));
+            __m128 pz = _mm_add_ps(_mm_loadu_ps(&this->positionZ[i]), _mm_mul_ps(vz, timeDelta));
+
+            __m128 rx = _mm_sub_ps(px, spawnX);
+            __m128 ry = _mm_sub_ps(py, spawnY);
+            __m128 rz = _mm_sub_ps(pz, spawnZ);
+            __m128 invRadius = _mm_div_ps(one, _mm_sqrt_ps(Dot(rx, ry, rz)));
+            __m128 nx = _mm_mul_ps(rx, invRadius);
+            __m128 ny = _mm_mul_ps(ry, invRadius);
+            __m128 nz = _mm_mul_ps(rz, invRadius);
+
+            __m128 cx = _mm_sub_ps(_mm_mul_ps(ny, az), _mm_mul_ps(nz, ay));
+            __m128 cy = _mm_sub_ps(_mm_mul_ps(nz, ax), _mm_mul_ps(nx, az));
+            __m128 cz = _mm_sub_ps(_mm_mul_ps(nx, ay), _mm_mul_ps(ny, ax));
+            px = _mm_add_ps(px, _mm_mul_ps(cx, timeDelta));
+            py = _mm_add_ps(py, _mm_mul_ps(cy, timeDelta));
+            pz = _mm_add_ps(pz, _mm_mul_ps(cz, timeDelta));
+
+            __m128 respawn = _mm_cmpgt_ps(t, maxTimeAlive);
+            __m128 offset = _mm_div_ps(_mm_loadu_ps(&this->spawnDistance[i]), _mm_sqrt_ps(Dot(vx, vy, vz)));
+            px = Select(respawn, _mm_add_ps(spawnX, _mm_mul_ps(vx, offset)), px);
+            py = Select(respawn, _mm_add_ps(spawnY, _mm_mul_ps(vy, offset)), py);
+            pz = Select(respawn, _mm_add_ps(spawnZ, _mm_mul_ps(vz, offset)), pz);
+            t = _mm_andnot_ps(respawn, t);
+
+            _mm_storeu_ps(&this->positionX[i], px);
+            _mm_storeu_ps(&this->positionY[i], py);
+            _mm_storeu_ps(&this->positionZ[i], pz);
+            _mm_storeu_ps(&this->timeAlive[i], t);
+        }
+        #else
+        for (size_t i = begin; i < end; i++)
+        {
+            float vx = this->velocityX[i], vy = this->velocityY[i], vz = this->velocityZ[i];
+            float ax = this->angularX[i],  ay = this->angularY[i],  az = this->angularZ[i];
+
+            float t = this->timeAlive[i] + dt;
+            float px = this->positionX[i] + vx * dt;
+            float py = this->positionY[i] + vy * dt;
+            float pz = this->positionZ[i] + vz * dt;
+
+            float rx = px - spawnpoint.x;
+            float ry = py - spawnpoint.y;
+            float rz = pz - spawnpoint.z;
+            float invRadius = 1.0f / std::sqrt(rx * rx + ry * ry + rz * rz);
+            float nx = rx * invRadius;
+            float ny = ry * invRadius;
+            float nz = rz * invRadius;
+
+            px += (ny * az - nz * ay) * dt;
+            py += (nz * ax - nx * az) * dt;
+            pz += (nx * ay - ny * ax) * dt;
+
+            if (t > lifetime)
+            {
+                float offset = this->spawnDistance[i] / std::sqrt(vx * vx + vy * vy + vz * vz);
+                px = spawnpoint.x + vx * offset;
+                py = spawnpoint.y + vy * offset;
+                pz = spawnpoint.z + vz * offset;
+                t = 0.0f;
+            }
+
+            this->positionX[i] = px;
+            this->positionY[i] = py;
+            this->positionZ[i] = pz;
+            this->timeAlive[i] = t;
+        }
+        #endif
+    }
+
+    void ParticleSimulator::Simulate(float dt, float lifetime, const Vector3& spawnpoint, bool multithreaded)
+    {
+        MAKE_SCOPE_PROFILER("ParticleSimulator::Simulate()");
+
+        // tasks operate on whole SIMD groups, so padding is never shared between them
+        size_t groupCount = (this->particleCount + SimdWidth - 1) / SimdWidth;
+        auto simulateGroups = [this, dt, lifetime, &spawnpoint](size_t begin, size_t end)
+        {
+            this->SimulateRange(begin * SimdWidth, end * SimdWidth, dt, lifetime, spawnpoint);
+        };
+
+        if (multithreaded)
+            ParallelFor(groupCount, ParallelGrainSize / SimdWidth, simulateGroups);
+        else
+            simulateGroups(0, groupCount);
+    }
+
+    size_t ParticleSimulator::GetParticleCount() const
+    {
+        return this->particleCount;
+    }
+}
@@ -0,0 +1,75 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/Math/Math.h"
+
+namespace MxEngine
+{
+    /*!
+    CPU backend of particle simulation. Follows particle_compute.glsl step by step, so systems simulated on CPU behave the same as GPU ones
+    particle state is kept as structure of arrays padded to SIMD width. Work is split into chunks which are processed by WorkerPool,
+    particles do not depend on each other, so result does not depend on number of threads
+    */
+    class ParticleSimulator
+    {
+    public:
+        // layout matches Particle struct of particle shaders
+        struct Particle
+        {
+            Vector3 Position;
+            float TimeAlive;
+            Vector3 Velocity;
+            float Size;
+            Vector3 AngularParams;
+            float SpawnDistance;
+        };
+
+        constexpr static size_t SimdWidth = 4;
+        constexpr static size_t ParallelGrainSize = 1024;
+    private:
+        MxVector<float> positionX, positionY, positionZ, timeAlive;
+        MxVector<float> velocityX, velocityY, velocityZ, size;
+        MxVector<float> angularX, angularY, angularZ, spawnDistance;
+        size_t particleCount = 0;
+
+        void SimulateRange(size_t begin, size_t end, float dt, float lifetime, const Vector3& spawnpoint);
+    public:
+        void Load(const MxVector<Particle>& particles);
+        void Store(MxVector<Particle>& particles) const;
+        void Clear();
+        /*!
+        advances all particles by dt. Particles which lived longer than lifetime are respawned around spawnpoint
+        \param multithreaded if false, all particles are processed by calling thread
+        */
+        void Simulate(float dt, float lifetime, const Vector3& spawnpoint, bool multithreaded = true);
+        size_t GetParticleCount() const;
+    };
+}
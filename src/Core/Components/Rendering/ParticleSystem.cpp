@@ -30,6 +30,10 @@
 #include "Core/MxObject/MxObject.h"
 #include "Core/Runtime/Reflection.h"
 #include "Core/Resources/BufferAllocator.h"
+#include "Core/Resources/StreamBufferAllocator.h"
+#include "Core/Config/GlobalConfig.h"
+
+#include <cstring>
 
 namespace MxEngine
 {
@@ -44,7 +48,7 @@ namespace MxEngine
         }
     }
 
-    void ParticleSystem::OnUpdate(float)
+    void ParticleSystem::OnUpdate(float dt)
     {
         if (this->isDirty)
         {
@@ -61,10 +65,55 @@ namespace MxEngine
             auto [offset, count] = BufferAllocator::AllocateInSSBO(initialState.size() * sizeof(ParticleGPU));
             this->particleAllocationCount = count / sizeof(ParticleGPU);
             this->particleAllocationOffset = offset / sizeof(ParticleGPU);
-            BufferAllocator::GetSSBO()->BufferSubData((uint8_t*)initialState.data(), count, offset);
+
+            if (this->IsSimulatedOnCPU())
+            {
+                this->simulator.Load(initialState);
+            }
+            else
+            {
+                this->simulator.Clear();
+                this->pendingParticles = std::move(initialState);
+                this->isUploadPending = true;
+            }
 
             this->isDirty = false;
         }
+
+        if (this->IsSimulatedOnCPU())
+        {
+            // same time step and spawnpoint as used by RenderController::ComputeParticles()
+            auto spawnpoint = this->IsRelative() ? MakeVector3(0.0f) : MxObject::GetByComponent(*this).LocalTransform.GetPosition();
+            this->simulator.Simulate(Min(dt, 1.0f / 60.0f), this->GetParticleLifetime(), spawnpoint);
+
+            this->simulator.Store(this->pendingParticles);
+            this->isUploadPending = true;
+        }
+    }
+
+    void ParticleSystem::UploadPendingParticles()
+    {
+        if (!this->isUploadPending) return;
+
+        this->isUploadPending = false;
+        this->UploadParticleData(this->pendingParticles);
+    }
+
+    void ParticleSystem::UploadParticleData(const MxVector<ParticleGPU>& particles)
+    {
+        // storage buffer may still be read by previous frames, so data is staged in stream buffer and copied on GPU
+        size_t byteSize = Min(particles.size(), this->particleAllocationCount) * sizeof(ParticleGPU);
+        size_t byteOffset = this->particleAllocationOffset * sizeof(ParticleGPU);
+        auto staging = StreamBufferAllocator::Allocate(byteSize);
+        if (staging.IsValid())
+        {
+            std::memcpy(staging.Data, particles.data(), byteSize);
+            StreamBufferAllocator::CopyToBuffer(staging, *BufferAllocator::GetSSBO(), byteOffset);
+        }
+        else
+        {
+            BufferAllocator::GetSSBO()->BufferSubData((uint8_t*)particles.data(), byteSize, byteOffset);
+        }
     }
 
     void ParticleSystem::Invalidate()
@@ -298,6 +347,36 @@ namespace MxEngine
         return this->maxParticleCount;
     }
 
+    ParticleSystem::SimulationMode ParticleSystem::GetSimulationMode() const
+    {
+        return this->simulationMode;
+    }
+
+    void ParticleSystem::SetSimulationMode(SimulationMode mode)
+    {
+        this->simulationMode = mode;
+        this->Invalidate();
+    }
+
+    bool ParticleSystem::IsSimulatedOnCPU() const
+    {
+        switch (this->simulationMode)
+        {
+        case SimulationMode::CPU:
+            return true;
+        case SimulationMode::GPU:
+            return false;
+        default:
+            // compute shaders are not available without graphic API
+            return GlobalConfig::HasCPUParticleSimulation() || GlobalConfig::HasNullGraphicAPI();
+        }
+    }
+
+    const ParticleSimulator& ParticleSystem::GetSimulator() const
+    {
+        return this->simulator;
+    }
+
     MXENGINE_REFLECT_TYPE
     {
         rttr::registration::enumeration<ParticleSystem::Shape>("ParticleSystemShape")
@@ -311,6 +390,13 @@ namespace MxEngine
             rttr::value("AXIS", ParticleSystem::Shape::AXIS)
         );
 
+        rttr::registration::enumeration<ParticleSystem::SimulationMode>("ParticleSimulationMode")
+        (
+            rttr::value("DEFAULT", ParticleSystem::SimulationMode::DEFAULT),
+            rttr::value("GPU", ParticleSystem::SimulationMode::GPU),
+            rttr::value("CPU", ParticleSystem::SimulationMode::CPU)
+        );
+
         rttr::registration::class_<ParticleSystem>("ParticleSystem")
             (
                 rttr::metadata(MetaInfo::FLAGS, MetaInfo::CLONE_COPY | MetaInfo::CLONE_INSTANCE)
@@ -328,6 +414,10 @@ namespace MxEngine
             (
                 rttr::metadata(MetaInfo::FLAGS, MetaInfo::SERIALIZABLE | MetaInfo::EDITABLE)
             )
+            .property("simulation mode", &ParticleSystem::GetSimulationMode, &ParticleSystem::SetSimulationMode)
+            (
+                rttr::metadata(MetaInfo::FLAGS, MetaInfo::SERIALIZABLE | MetaInfo::EDITABLE)
+            )
             .property("particle lifetime", &ParticleSystem::GetParticleLifetime, &ParticleSystem::SetParticleLifetime)
             (
                 rttr::metadata(MetaInfo::FLAGS, MetaInfo::SERIALIZABLE | MetaInfo::EDITABLE),
@@ -30,21 +30,14 @@
 
 #include "Utilities/ECS/Component.h"
 #include "Platform/GraphicAPI.h"
+#include "ParticleSimulator.h"
 
 namespace MxEngine
 {
     class ParticleSystem
     {
     public:
-        struct ParticleGPU
-        {
-            Vector3 Position;
-            float TimeAlive;
-            Vector3 Velocity;
-            float Size;
-            Vector3 AngularParams;
-            float SpawnDistance;
-        };
+        using ParticleGPU = ParticleSimulator::Particle;
 
         enum class Shape
         {
@@ -56,6 +49,13 @@ namespace MxEngine
             CROSS,
             AXIS,
         };
+
+        enum class SimulationMode
+        {
+            DEFAULT,
+            GPU,
+            CPU,
+        };
     private:
         MAKE_COMPONENT(ParticleSystem);
 
@@ -72,15 +72,25 @@ namespace MxEngine
         float maxSpawnDistance = 0.0f;
         float fading = 0.0f;
         Shape shape = Shape::SPHERE;
+        SimulationMode simulationMode = SimulationMode::DEFAULT;
         bool isDirty = true;
         bool isRelative = false;
+        bool isUploadPending = false;
+
+        // used only if system is simulated on CPU
+        ParticleSimulator simulator;
+        // initial state or result of CPU simulation, which is uploaded at next frame collection
+        MxVector<ParticleGPU> pendingParticles;
 
         void FillParticleData(MxVector<ParticleGPU>& particles) const;
+        void UploadParticleData(const MxVector<ParticleGPU>& particles);
     public:
         ParticleSystem() = default;
         ~ParticleSystem();
 
         void OnUpdate(float dt);
+        // particles are uploaded only when frame is collected, as previous frame may still be pending (see RenderLatency)
+        void UploadPendingParticles();
         void Invalidate();
 
         size_t GetParticleAllocationOffset() const;
@@ -118,5 +128,10 @@ namespace MxEngine
 
         Shape GetShape() const;
         void SetShape(Shape shape);
+
+        SimulationMode GetSimulationMode() const;
+        void SetSimulationMode(SimulationMode mode);
+        bool IsSimulatedOnCPU() const;
+        const ParticleSimulator& GetSimulator() const;
     };
 }
\ No newline at end of file
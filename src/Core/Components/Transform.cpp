@@ -29,8 +29,29 @@
 #include "Transform.h"
 #include "Core/Runtime/Reflection.h"
 
+#include <atomic>
+
 namespace MxEngine
 {
+    static std::atomic<uint64_t> TransformVersionCounter{ 0 };
+
+    void Transform::Invalidate()
+    {
+        this->needTransformUpdate = true;
+        // versions are unique among all transforms, so copied transform keeps version of its source state
+        this->version = GenerateVersion();
+    }
+
+    uint64_t Transform::GenerateVersion()
+    {
+        return ++TransformVersionCounter;
+    }
+
+    uint64_t Transform::GetVersion() const
+    {
+        return this->version;
+    }
+
     bool Transform::operator==(const Transform& other) const
     {
         return this->position == other.position && this->rotation == other.rotation && this->scale == other.scale;
@@ -47,6 +68,7 @@ namespace MxEngine
         result.scale = this->scale * other.scale;
         result.position = this->position + other.position;
         result.rotation = this->rotation + other.rotation;
+        result.Invalidate();
         return result;
     }
 
@@ -118,7 +140,7 @@ namespace MxEngine
     Transform& Transform::SetScale(Vector3 scale)
     {
         this->scale = scale;
-        this->needTransformUpdate = true;
+        this->Invalidate();
         return *this;
     }
 
@@ -130,7 +152,7 @@ namespace MxEngine
     Transform& Transform::SetPosition(Vector3 position)
     {
         this->position = position;
-        this->needTransformUpdate = true;
+        this->Invalidate();
         return *this;
     }
 
@@ -142,7 +164,7 @@ namespace MxEngine
     Transform& Transform::Scale(Vector3 scale)
     {
         this->scale *= scale;
-        this->needTransformUpdate = true;
+        this->Invalidate();
         return *this;
     }
 
@@ -172,7 +194,7 @@ namespace MxEngine
         this->rotation.x = std::fmod(this->rotation.x + 360.0f, 360.0f);
         this->rotation.y = std::fmod(this->rotation.y + 360.0f, 360.0f);
         this->rotation.z = std::fmod(this->rotation.z + 360.0f, 360.0f);
-        this->needTransformUpdate = true;
+        this->Invalidate();
         return *this;
     }
 
@@ -194,7 +216,7 @@ namespace MxEngine
     Transform& Transform::Translate(Vector3 dist)
     {
         this->position += dist;
-        this->needTransformUpdate = true;
+        this->Invalidate();
         return *this;
     }
 
@@ -40,11 +40,22 @@ namespace MxEngine
         mutable Matrix4x4 transform{ 0.0f };
         mutable Matrix3x3 normalMatrix{ 0.0f };
         mutable bool needTransformUpdate = true;
+        uint64_t version = 0;
+
+        void Invalidate();
     public:
         bool operator==(const Transform& other) const;
         bool operator!=(const Transform& other) const;
         Transform operator*(const Transform& other) const;
 
+        /*!
+        version changes each time transform is modified. Transforms with equal versions are guaranteed to be equal
+        */
+        uint64_t GetVersion() const;
+        /*!
+        generates new unique version. Can be used by storages which keep transform data outside of Transform
+        */
+        static uint64_t GenerateVersion();
         const Matrix4x4& GetMatrix() const;
         const Matrix3x3& GetNormalMatrix() const;
         void GetMatrix(Matrix4x4& inPlaceMatrix) const;
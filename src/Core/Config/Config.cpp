@@ -85,6 +85,19 @@ namespace MxEngine
         }
     }
 
+    const char* EnumToString(RenderLatency latency)
+    {
+        switch (latency)
+        {
+        case RenderLatency::NONE:
+            return "NONE";
+        case RenderLatency::ONE_FRAME:
+            return "ONE_FRAME";
+        default:
+            return "NONE";
+        }
+    }
+
     void Deserialize(Config& config, const JsonFile& json)
     {
         FromJson(config.WindowPosition,         json["window"],      "position"                );
@@ -92,14 +105,29 @@ namespace MxEngine
         FromJson(config.WindowTitle,            json["window"],      "title"                   );
         FromJson(config.Cursor,                 json["window"],      "cursor-mode"             );
         FromJson(config.DoubleBuffering,        json["window"],      "double-buffering"        );
+        FromJson(config.HeadlessMode,           json["window"],      "headless"                );
         FromJson(config.GraphicAPIProfile,      json["renderer"],    "profile"                 );
         FromJson(config.GraphicAPIMajorVersion, json["renderer"],    "major-version"           );
         FromJson(config.GraphicAPIMinorVersion, json["renderer"],    "minor-version"           );
+        FromJson(config.UseNullGraphicAPI,      json["renderer"],    "null-graphic-api"        );
         FromJson(config.AnisothropicFiltering,  json["renderer"],    "anisothropic-filtering"  );
         FromJson(config.DirLightTextureSize,    json["renderer"],    "dir-light-texture-size"  );
         FromJson(config.PointLightTextureSize,  json["renderer"],    "point-light-texture-size");
         FromJson(config.SpotLightTextureSize,   json["renderer"],    "spot-light-texture-size" );
         FromJson(config.EngineTextureSize,      json["renderer"],    "engine-texture-size"     );
+        FromJson(config.ShadowAtlasSize,        json["renderer"],    "shadow-atlas-size"       );
+        FromJson(config.ShadowUpdateBudget,     json["renderer"],    "shadow-update-budget"    );
+        FromJson(config.FarShadowUpdatePeriod,  json["renderer"],    "far-shadow-update-period");
+        FromJson(config.LODPixelError,          json["renderer"],    "lod-pixel-error"         );
+        FromJson(config.LODHysteresis,          json["renderer"],    "lod-hysteresis"          );
+        FromJson(config.FrameLatency,           json["renderer"],    "render-latency"          );
+        FromJson(config.VertexBufferSize,       json["renderer"],    "vertex-buffer-size"      );
+        FromJson(config.IndexBufferSize,        json["renderer"],    "index-buffer-size"       );
+        FromJson(config.InstanceBufferSize,     json["renderer"],    "instance-buffer-size"    );
+        FromJson(config.StorageBufferSize,      json["renderer"],    "storage-buffer-size"     );
+        FromJson(config.StreamBufferSize,       json["renderer"],    "stream-buffer-size"      );
+        FromJson(config.CompressedVertices,     json["renderer"],    "compressed-vertices"     );
+        FromJson(config.CPUParticleSimulation,  json["renderer"],    "cpu-particles"           );
         FromJson(config.IgnoredFolders,         json["filesystem" ], "ignored-folders"         );
         FromJson(config.CachePrimitiveModels,   json["filesystem" ], "cache-primitives"        );
         FromJson(config.ShaderSourceDirectory,  json["debug-build"], "shader-source-directory" );
@@ -118,14 +146,29 @@ namespace MxEngine
         json["window"     ]["title"                   ] = config.WindowTitle;
         json["window"     ]["cursor-mode"             ] = config.Cursor;
         json["window"     ]["double-buffering"        ] = config.DoubleBuffering;
+        json["window"     ]["headless"                ] = config.HeadlessMode;
         json["renderer"   ]["profile"                 ] = config.GraphicAPIProfile;
         json["renderer"   ]["major-version"           ] = config.GraphicAPIMajorVersion;
         json["renderer"   ]["minor-version"           ] = config.GraphicAPIMinorVersion;
+        json["renderer"   ]["null-graphic-api"        ] = config.UseNullGraphicAPI;
         json["renderer"   ]["anisothropic-filtering"  ] = config.AnisothropicFiltering;
         json["renderer"   ]["dir-light-texture-size"  ] = config.DirLightTextureSize;
         json["renderer"   ]["point-light-texture-size"] = config.PointLightTextureSize;
         json["renderer"   ]["spot-light-texture-size" ] = config.SpotLightTextureSize;
         json["renderer"   ]["engine-texture-size"     ] = config.EngineTextureSize;
+        json["renderer"   ]["shadow-atlas-size"       ] = config.ShadowAtlasSize;
+        json["renderer"   ]["shadow-update-budget"    ] = config.ShadowUpdateBudget;
+        json["renderer"   ]["far-shadow-update-period"] = config.FarShadowUpdatePeriod;
+        json["renderer"   ]["lod-pixel-error"         ] = config.LODPixelError;
+        json["renderer"   ]["lod-hysteresis"          ] = config.LODHysteresis;
+        json["renderer"   ]["render-latency"          ] = config.FrameLatency;
+        json["renderer"   ]["vertex-buffer-size"      ] = config.VertexBufferSize;
+        json["renderer"   ]["index-buffer-size"       ] = config.IndexBufferSize;
+        json["renderer"   ]["instance-buffer-size"    ] = config.InstanceBufferSize;
+        json["renderer"   ]["storage-buffer-size"     ] = config.StorageBufferSize;
+        json["renderer"   ]["stream-buffer-size"      ] = config.StreamBufferSize;
+        json["renderer"   ]["compressed-vertices"     ] = config.CompressedVertices;
+        json["renderer"   ]["cpu-particles"           ] = config.CPUParticleSimulation;
         json["filesystem" ]["ignored-folders"         ] = config.IgnoredFolders;
         json["filesystem" ]["cache-primitives"        ] = config.CachePrimitiveModels;
         json["debug-build"]["shader-source-directory" ] = config.ShaderSourceDirectory;
@@ -320,4 +363,18 @@ namespace MxEngine
         else
             style = EditorStyle::MXENGINE;
     }
+
+    void to_json(JsonFile& j, RenderLatency latency)
+    {
+        j = EnumToString(latency);
+    }
+
+    void from_json(const JsonFile& j, RenderLatency& latency)
+    {
+        auto val = j.get<MxString>();
+        if (val == "ONE_FRAME")
+            latency = RenderLatency::ONE_FRAME;
+        else
+            latency = RenderLatency::NONE;
+    }
 }
\ No newline at end of file
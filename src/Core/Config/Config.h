@@ -65,10 +65,20 @@ namespace MxEngine
         MXENGINE,
     };
 
+    // number of frames between simulation of a frame and execution of its draw commands
+    enum class RenderLatency : uint8_t
+    {
+        // frame is collected and drawn right after it is simulated
+        NONE,
+        // frame is drawn at the next iteration, so its draw commands are prepared in background while next frame is simulated
+        ONE_FRAME,
+    };
+
     const char* EnumToString(CursorMode mode);
     const char* EnumToString(RenderProfile profile);
     const char* EnumToString(BuildType mode);
     const char* EnumToString(EditorStyle style);
+    const char* EnumToString(RenderLatency latency);
 
     struct Config
     {
@@ -78,16 +88,34 @@ namespace MxEngine
         MxString WindowTitle = "MxEngine Application";
         CursorMode Cursor = CursorMode::DISABLED;
         bool DoubleBuffering = false;
+        bool HeadlessMode = false;
 
         // Renderer settings
         RenderProfile GraphicAPIProfile = RenderProfile::CORE;
         size_t GraphicAPIMajorVersion = 4;
         size_t GraphicAPIMinorVersion = 6;
+        bool UseNullGraphicAPI = false;
         size_t AnisothropicFiltering = 16;
         size_t DirLightTextureSize = 2048;
         size_t PointLightTextureSize = 512;
         size_t SpotLightTextureSize = 512;
         size_t EngineTextureSize = 512;
+        size_t ShadowAtlasSize = 4096;
+        size_t ShadowUpdateBudget = 4;
+        size_t FarShadowUpdatePeriod = 8;
+        float LODPixelError = 1.0f;
+        float LODHysteresis = 0.25f;
+        RenderLatency FrameLatency = RenderLatency::NONE;
+        // initial sizes of shared geometry buffers in bytes. Buffers grow on demand, so zero is valid
+        size_t VertexBufferSize = 0;
+        size_t IndexBufferSize = 0;
+        size_t InstanceBufferSize = 0;
+        size_t StorageBufferSize = 0;
+        // size of per-frame region of persistently mapped upload buffer in bytes
+        size_t StreamBufferSize = 4 * 1024 * 1024;
+        bool CompressedVertices = false;
+        // simulate particle systems on CPU instead of compute shaders. Systems may override it individually
+        bool CPUParticleSimulation = false;
 
         // Filesystem settings
         MxVector<MxString> IgnoredFolders = { "MxEngine", "out", "build", ".git", ".vs" };
@@ -114,4 +142,6 @@ namespace MxEngine
     void from_json(const JsonFile& j, KeyCode& key);
     void to_json(JsonFile& j, EditorStyle style);
     void from_json(const JsonFile& j, EditorStyle& style);
+    void to_json(JsonFile& j, RenderLatency latency);
+    void from_json(const JsonFile& j, RenderLatency& latency);
 }
\ No newline at end of file
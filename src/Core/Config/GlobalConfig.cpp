@@ -71,6 +71,11 @@ namespace MxEngine
         return CFG(DoubleBuffering);
     }
 
+    bool GlobalConfig::IsHeadless()
+    {
+        return CFG(HeadlessMode);
+    }
+
     RenderProfile GlobalConfig::GetGraphicAPIProfile()
     {
         return CFG(GraphicAPIProfile);
@@ -86,6 +91,11 @@ namespace MxEngine
         return CFG(GraphicAPIMinorVersion);
     }
 
+    bool GlobalConfig::HasNullGraphicAPI()
+    {
+        return CFG(UseNullGraphicAPI);
+    }
+
     size_t GlobalConfig::GetAnisothropicFiltering()
     {
         return CFG(AnisothropicFiltering);
@@ -111,6 +121,71 @@ namespace MxEngine
         return CFG(EngineTextureSize);
     }
 
+    size_t GlobalConfig::GetShadowAtlasSize()
+    {
+        return CFG(ShadowAtlasSize);
+    }
+
+    size_t GlobalConfig::GetShadowUpdateBudget()
+    {
+        return CFG(ShadowUpdateBudget);
+    }
+
+    size_t GlobalConfig::GetFarShadowUpdatePeriod()
+    {
+        return CFG(FarShadowUpdatePeriod);
+    }
+
+    float GlobalConfig::GetLODPixelError()
+    {
+        return CFG(LODPixelError);
+    }
+
+    float GlobalConfig::GetLODHysteresis()
+    {
+        return CFG(LODHysteresis);
+    }
+
+    RenderLatency GlobalConfig::GetRenderLatency()
+    {
+        return CFG(FrameLatency);
+    }
+
+    size_t GlobalConfig::GetVertexBufferSize()
+    {
+        return CFG(VertexBufferSize);
+    }
+
+    size_t GlobalConfig::GetIndexBufferSize()
+    {
+        return CFG(IndexBufferSize);
+    }
+
+    size_t GlobalConfig::GetInstanceBufferSize()
+    {
+        return CFG(InstanceBufferSize);
+    }
+
+    size_t GlobalConfig::GetStorageBufferSize()
+    {
+        return CFG(StorageBufferSize);
+    }
+
+    size_t GlobalConfig::GetStreamBufferSize()
+    {
+        return CFG(StreamBufferSize);
+    }
+
+    bool GlobalConfig::HasCompressedVertices()
+    {
+        return CFG(CompressedVertices);
+    }
+
+    bool GlobalConfig::HasCPUParticleSimulation()
+    {
+        return CFG(CPUParticleSimulation);
+    }
+
     const MxVector<MxString>& GlobalConfig::GetIgnoredFolders()
     {
         return CFG(IgnoredFolders);
@@ -41,14 +41,29 @@ namespace MxEngine
         static const MxString& GetWindowTitle();
         static CursorMode GetCursorMode();
         static bool HasDoubleBuffering();
+        static bool IsHeadless();
         static RenderProfile GetGraphicAPIProfile();
         static size_t GetGraphicAPIMajorVersion();
         static size_t GetGraphicAPIMinorVersion();
+        static bool HasNullGraphicAPI();
         static size_t GetAnisothropicFiltering();;
         static size_t GetDirectionalLightTextureSize();
         static size_t GetPointLightTextureSize();
         static size_t GetSpotLightTextureSize();
         static size_t GetEngineTextureSize();
+        static size_t GetShadowAtlasSize();
+        static size_t GetShadowUpdateBudget();
+        static size_t GetFarShadowUpdatePeriod();
+        static float GetLODPixelError();
+        static float GetLODHysteresis();
+        static RenderLatency GetRenderLatency();
+        static size_t GetVertexBufferSize();
+        static size_t GetIndexBufferSize();
+        static size_t GetInstanceBufferSize();
+        static size_t GetStorageBufferSize();
+        static size_t GetStreamBufferSize();
+        static bool HasCompressedVertices();
+        static bool HasCPUParticleSimulation();
         static const MxVector<MxString>& GetIgnoredFolders();
         static const MxString& GetShaderSourceDirectory();
         static EditorStyle GetEditorStyle();
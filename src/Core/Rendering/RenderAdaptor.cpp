@@ -32,6 +32,7 @@
 #include "Library/Noise/NoiseGenerator.h"
 #include "Core/Config/GlobalConfig.h"
 #include "Core/Resources/BufferAllocator.h"
+#include "Core/Resources/StreamBufferAllocator.h"
 #include "Core/Components/Rendering/MeshSource.h"
 #include "Core/Components/Rendering/MeshRenderer.h"
 #include "Core/Components/Rendering/Skybox.h"
@@ -50,6 +51,8 @@
 #include "Core/Components/Instancing/InstanceFactory.h"
 #include "Core/Rendering/DebugDataSubmitter.h"
 #include "Utilities/Profiler/Profiler.h"
+#include "Platform/GPUDebug/GPUTimer.h"
+#include "Platform/NullAPI/NullGraphicAPI.h"
 #include "Utilities/FileSystem/FileManager.h"
 
 namespace MxEngine
@@ -59,43 +62,65 @@ namespace MxEngine
         MAKE_SCOPE_PROFILER("RenderAdaptor::InitEnvironment()");
         auto& environment = this->Renderer.GetEnvironment();
 
-        this->SetRenderToDefaultFrameBuffer();
+        // in headless mode frames are only rendered to camera textures
+        environment.HasDefaultFrameBuffer = !GlobalConfig::IsHeadless();
+        this->SetRenderToDefaultFrameBuffer(environment.HasDefaultFrameBuffer);
 
         environment.RenderVAO = BufferAllocator::GetVAO();
         environment.RenderSSBO = BufferAllocator::GetSSBO();
 
+        // gl_DrawID is only available in core profile since OpenGL 4.6
+        environment.UseIndirectDrawing = GlobalConfig::GetGraphicAPIMajorVersion() * 10 + GlobalConfig::GetGraphicAPIMinorVersion() >= 46;
+        environment.IndirectCommandBuffer = Factory<IndirectBuffer>::Create(nullptr, 0, UsageType::STREAM_DRAW);
+        environment.IndirectDrawSSBO = Factory<ShaderStorageBuffer>::Create((uint8_t*)nullptr, 0, UsageType::STREAM_DRAW);
+        environment.IndirectMaterialSSBO = Factory<ShaderStorageBuffer>::Create((uint8_t*)nullptr, 0, UsageType::STREAM_DRAW);
+
+        // shader storage buffers are only available since OpenGL 4.3
+        environment.UseClusteredLighting = GlobalConfig::GetGraphicAPIMajorVersion() * 10 + GlobalConfig::GetGraphicAPIMinorVersion() >= 43;
+        environment.ClusteredPointLightSSBO = Factory<ShaderStorageBuffer>::Create((uint8_t*)nullptr, 0, UsageType::STREAM_DRAW);
+        environment.ClusteredSpotLightSSBO = Factory<ShaderStorageBuffer>::Create((uint8_t*)nullptr, 0, UsageType::STREAM_DRAW);
+        environment.LightClusterSSBO = Factory<ShaderStorageBuffer>::Create((uint8_t*)nullptr, 0, UsageType::STREAM_DRAW);
+        environment.LightIndexSSBO = Factory<ShaderStorageBuffer>::Create((uint8_t*)nullptr, 0, UsageType::STREAM_DRAW);
+
+        environment.UseOcclusionCulling = true;
+        this->Renderer.GetOcclusionInformation().Culler.Init(OcclusionBufferWidth, OcclusionBufferHeight);
+
         // helper objects
         environment.RectangularObject.Init(1.0f);
         environment.SkyboxCubeObject.Init();
         this->DebugDrawer.Init();
         environment.DebugBufferObject.VAO = this->DebugDrawer.GetVAO();
+        environment.DebugBufferObject.InstancedVAO = this->DebugDrawer.GetInstancedVAO();
+        environment.DebugBufferObject.VertexOffset = 0;
 
         // light bounding objects
         auto pyramidInstanced = Primitives::CreatePyramid();
         pyramidInstanced.MakeStatic();
         this->Renderer.GetLightInformation().SpotLightsInstanced = SpotLightInstancedObject(
             pyramidInstanced->GetBaseVerteciesOffset(), pyramidInstanced->GetTotalVerteciesCount(),
-            pyramidInstanced->GetBaseIndiciesOffset(),  pyramidInstanced->GetTotalIndiciesCount());
+            pyramidInstanced->GetBaseIndiciesOffset(),  pyramidInstanced->GetTotalIndiciesCount(),
+            pyramidInstanced->GetIndexFormat());
 
         auto sphereInstanced = Primitives::CreateSphere(8);
         sphereInstanced.MakeStatic();
         this->Renderer.GetLightInformation().PointLightsInstanced = PointLightInstancedObject(
             sphereInstanced->GetBaseVerteciesOffset(), sphereInstanced->GetTotalVerteciesCount(),
-            sphereInstanced->GetBaseIndiciesOffset(),  sphereInstanced->GetTotalIndiciesCount());
+            sphereInstanced->GetBaseIndiciesOffset(),  sphereInstanced->GetTotalIndiciesCount(),
+            sphereInstanced->GetIndexFormat());
 
         auto pyramid = Primitives::CreatePyramid();
         pyramid.MakeStatic();
         this->Renderer.GetLightInformation().SpotLight = RenderHelperObject(
             pyramid->GetBaseVerteciesOffset(), pyramid->GetTotalVerteciesCount(),
             pyramid->GetBaseIndiciesOffset(), pyramid->GetTotalIndiciesCount(),
-            environment.RenderVAO);
+            pyramid->GetIndexFormat(), environment.RenderVAO);
 
         auto sphere = Primitives::CreateSphere(8);
         sphere.MakeStatic();
         this->Renderer.GetLightInformation().PointLight = RenderHelperObject(
             sphere->GetBaseVerteciesOffset(), sphere->GetTotalVerteciesCount(),
             sphere->GetBaseIndiciesOffset(), sphere->GetTotalIndiciesCount(),
-            environment.RenderVAO);
+            sphere->GetIndexFormat(), environment.RenderVAO);
 
         auto textureFolder = FileManager::GetEngineTextureDirectory();
         int internalTextureSize = (int)GlobalConfig::GetEngineTextureSize();
@@ -127,6 +152,23 @@ namespace MxEngine
         environment.DownSampleTexture->SetWrapType(TextureWrap::CLAMP_TO_EDGE);
         environment.DownSampleTexture->GenerateMipmaps();
 
+        // shadow atlas shared by all shadowed spot lights
+        size_t shadowAtlasSize = FloorToPow2(GlobalConfig::GetShadowAtlasSize());
+        size_t maxShadowTileSize = Min(FloorToPow2(GlobalConfig::GetSpotLightTextureSize()), shadowAtlasSize);
+        size_t minShadowTileSize = Max(maxShadowTileSize / 16, (size_t)16);
+        environment.ShadowAtlas = Factory<Texture>::Create();
+        environment.ShadowAtlas->LoadDepth((int)shadowAtlasSize, (int)shadowAtlasSize);
+        environment.ShadowAtlas->SetInternalEngineTag(MXENGINE_MAKE_INTERNAL_TAG("shadow atlas"));
+
+        auto& shadowScheduler = this->Renderer.GetLightInformation().ShadowScheduler;
+        shadowScheduler.Init(shadowAtlasSize, Min(minShadowTileSize, maxShadowTileSize), maxShadowTileSize);
+        shadowScheduler.UpdateBudget = GlobalConfig::GetShadowUpdateBudget();
+        shadowScheduler.FarLightUpdatePeriod = GlobalConfig::GetFarShadowUpdatePeriod();
+
+        this->SetLODPixelError(GlobalConfig::GetLODPixelError());
+        this->LODHysteresis = Clamp(GlobalConfig::GetLODHysteresis(), 0.0f, 1.0f);
+        this->SetRenderLatency(GlobalConfig::GetRenderLatency());
+
         // TODO: use RG16
         environment.EnvironmentBRDFLUT = AssetManager::LoadTexture(textureFolder / "env_brdf_lut.png", TextureFormat::RG);
         environment.EnvironmentBRDFLUT->SetInternalEngineTag(MXENGINE_MAKE_INTERNAL_TAG("BRDF LUT"));
@@ -143,6 +185,11 @@ namespace MxEngine
             shaderFolder / "gbuffer_fragment.glsl"
         );
 
+        environment.Shaders["GBufferIndirect"_id] = AssetManager::LoadShader(
+            shaderFolder / "gbuffer_indirect_vertex.glsl",
+            shaderFolder / "gbuffer_indirect_fragment.glsl"
+        );
+
         environment.Shaders["GBufferMask"_id] = AssetManager::LoadShader(
             shaderFolder / "gbuffer_vertex.glsl",
             shaderFolder / "gbuffer_mask_fragment.glsl"
@@ -158,6 +205,11 @@ namespace MxEngine
             shaderFolder / "dirlight_fragment.glsl"
         );
 
+        environment.Shaders["ClusteredLighting"_id] = AssetManager::LoadShader(
+            shaderFolder / "rect_vertex.glsl",
+            shaderFolder / "clustered_lighting_fragment.glsl"
+        );
+
         environment.Shaders["SpotLightShadow"_id] = AssetManager::LoadShader(
             shaderFolder / "spotlight_shadow_vertex.glsl",
             shaderFolder / "spotlight_fragment.glsl"
@@ -250,6 +302,12 @@ namespace MxEngine
             shaderFolder / "debug_fragment.glsl"
         );
 
+        environment.Shaders["DebugDrawInstanced"_id] = AssetManager::LoadShader(
+            shaderFolder / "debug_instanced_vertex.glsl",
+            shaderFolder / "debug_geometry.glsl",
+            shaderFolder / "debug_fragment.glsl"
+        );
+
         environment.Shaders["VRCamera"_id] = AssetManager::LoadShader(
             shaderFolder / "rect_vertex.glsl",
             shaderFolder / "vr_fragment.glsl"
@@ -358,14 +416,29 @@ namespace MxEngine
 
     void RenderAdaptor::RenderFrame()
     {
+        this->CollectFrame();
+        this->ExecuteFrame();
+    }
+
+    void RenderAdaptor::CollectFrame()
+    {
+        this->HasPendingFrame = true;
+        // shared buffer ranges freed during simulation may still be drawn by collected frame
+        BufferAllocator::BeginDeferredDeallocation();
         auto& environment = this->Renderer.GetEnvironment();
         environment.MainCameraIndex = std::numeric_limits<decltype(environment.MainCameraIndex)>::max();
-        auto viewportPosition = MakeVector3(0.0f);
-        float viewportZoom = 0.0f;
+        LODSelectionInfo lodSelection;
+        lodSelection.PixelErrorBudget = this->LODPixelError;
+        lodSelection.Hysteresis = this->LODHysteresis;
         if (this->Viewport.IsValid())
         {
-            viewportPosition = MxObject::GetByComponent(*this->Viewport).LocalTransform.GetPosition();
-            viewportZoom = this->Viewport->Camera.GetZoom();
+            const auto& projection = this->Viewport->GetProjectionMatrix();
+            auto renderTexture = this->Viewport->GetRenderTexture();
+            float viewportHeight = renderTexture.IsValid() ? (float)renderTexture->GetHeight() : 0.0f;
+
+            lodSelection.ViewPosition = MxObject::GetByComponent(*this->Viewport).LocalTransform.GetPosition();
+            lodSelection.PixelsPerUnit = 0.5f * projection[1][1] * viewportHeight;
+            lodSelection.IsPerspective = projection[3][3] == 0.0f;
         }
 
         auto TrackMainCameraIndex = [this, mainCameraIndex = 0, &environment](const CameraController& camera) mutable
@@ -409,10 +482,25 @@ namespace MxEngine
             }
         }
 
+        if (this->Viewport.IsValid())
+        {
+            MAKE_SCOPE_PROFILER("RenderAdaptor::SelectMeshLODs()");
+            auto meshLODView = ComponentFactory::GetView<MeshLOD>();
+            for (auto& meshLOD : meshLODView)
+            {
+                auto instances = MxObject::GetByComponent(meshLOD).GetComponent<InstanceFactory>();
+                if (instances.IsValid())
+                    meshLOD.FixInstanceLODs(*instances, lodSelection);
+                else
+                    meshLOD.FixBestLOD(lodSelection);
+            }
+        }
+
         // submit render units
         auto meshSourceView = ComponentFactory::GetView<MeshSource>();
         {
             MAKE_SCOPE_PROFILER("RenderAdaptor::SubmitMeshPrimitives()");
+            this->Occluders.BeginFrame();
             for (const auto& meshSource : meshSourceView)
             {
                 auto& object = MxObject::GetByComponent(meshSource);
@@ -424,31 +512,64 @@ namespace MxEngine
                 size_t instanceCount = 0, instanceOffset = 0;
                 if (instances.IsValid())
                 {
-                    instanceCount = instances->GetInstanceCount();
+                    // instance data is uploaded only here, so it is never changed while pending frame still references it
+                    instances->UploadPendingInstances();
+                    instanceCount = instances->GetVisibleInstanceCount();
                     instanceOffset = instances->GetInstanceBufferOffset();
                     if (instanceCount == 0) continue; // skip objects without instances
                 }
 
                 auto mesh = meshSource.Mesh;
                 bool castsShadow = meshSource.CastsShadow;
+                // instances are static only if both their positions and parent object do not change
+                bool isStatic = meshSource.IsStatic && (!instances.IsValid() || instances->IsStatic);
 
                 if (!meshSource.IsDrawn || !meshRenderer.IsValid() || !mesh.IsValid()) continue;
 
-                // we do not try to use LODs for instanced objects, as its quite hard and time consuming. TODO: fix this
-                if (meshLOD.IsValid() && instanceCount == 0)
+                // instances are sorted by their LOD, so each LOD bucket is submitted as separate render group
+                size_t lodCount = instances.IsValid() && meshLOD.IsValid() ? instances->GetLODCount() : 1;
+                for (size_t lod = 0; lod < lodCount; lod++)
                 {
-                    meshLOD->FixBestLOD(viewportPosition, viewportZoom);
-                    mesh = meshLOD->GetMeshLOD();
+                    size_t lodInstanceOffset = instanceOffset, lodInstanceCount = instanceCount;
+                    if (lodCount > 1)
+                    {
+                        lodInstanceOffset += instances->GetLODInstanceOffset(lod);
+                        lodInstanceCount = instances->GetLODInstanceCount(lod);
+                        if (lodInstanceCount == 0) continue;
+                    }
+                    if (meshLOD.IsValid())
+                    {
+                        mesh = instances.IsValid() ? meshLOD->GetMeshLOD(lod) : meshLOD->GetMeshLOD();
+                        if (!mesh.IsValid()) continue;
+                    }
+
+                    size_t renderGroupIndex = this->Renderer.SubmitRenderGroup(*mesh, lodInstanceOffset, lodInstanceCount);
+                    for (const auto& submesh : mesh->GetSubMeshes())
+                    {
+                        auto materialId = submesh.GetMaterialId();
+                        if (materialId >= meshRenderer->Materials.size()) continue;
+                        auto material = meshRenderer->Materials[materialId];
+
+                        this->Renderer.SubmitRenderUnit(renderGroupIndex, submesh, *material, transform, castsShadow, isStatic, object.Name.c_str());
+                    }
                 }
 
-                size_t renderGroupIndex = this->Renderer.SubmitRenderGroup(*mesh, instanceOffset, instanceCount);
-                for (const auto& submesh : mesh->GetSubMeshes())
+                // occluders are always built from source mesh, as simplified LODs may come in front of its surface
+                bool isOccluder = environment.UseOcclusionCulling && !instances.IsValid() && (meshSource.IsOccluder ||
+                    (isStatic && ComponentMax((meshSource.Mesh->MeshAABB * transform.GetMatrix()).Length()) >= AutoOccluderSize));
+                if (isOccluder)
                 {
-                    auto materialId = submesh.GetMaterialId();
-                    if (materialId >= meshRenderer->Materials.size()) continue;
-                    auto material = meshRenderer->Materials[materialId];
-
-                    this->Renderer.SubmitRenderUnit(renderGroupIndex, submesh, *material, transform, castsShadow, object.Name.c_str());
+                    const auto& occluders = this->Occluders.GetOccluders(meshSource.Mesh);
+                    const auto& submeshes = meshSource.Mesh->GetSubMeshes();
+                    for (size_t i = 0; i < submeshes.size(); i++)
+                    {
+                        auto materialId = submeshes[i].GetMaterialId();
+                        if (materialId >= meshRenderer->Materials.size()) continue;
+                        // only opaque surfaces can hide objects behind them
+                        if (meshRenderer->Materials[materialId]->AlphaMode != AlphaModeGroup::OPAQUE) continue;
+
+                        this->Renderer.SubmitOccluder(occluders[i], transform.GetMatrix() * submeshes[i].GetTransform().GetMatrix());
+                    }
                 }
             }
         }
@@ -456,8 +577,11 @@ namespace MxEngine
         {
             MAKE_SCOPE_PROFILER("RenderAdaptor::SubmitParticleSystems()");
             auto particleSystemView = ComponentFactory::GetView<ParticleSystem>();
-            for (const auto& particleSystem : particleSystemView)
+            for (auto& particleSystem : particleSystemView)
             {
+                // particle data is uploaded only here, so it is never changed while pending frame still references it
+                particleSystem.UploadPendingParticles();
+
                 auto& object = MxObject::GetByComponent(particleSystem);
                 auto meshRenderer = (IsInstance(object) ? *GetInstanceParent(object) : object).GetComponent<MeshRenderer>();
                 if (!meshRenderer.IsValid() || meshRenderer->Materials.empty())
@@ -504,23 +628,85 @@ namespace MxEngine
                 debugProcessor.ProcessObject(object);
             }
                 
-            environment.DebugBufferObject.VertexCount = this->DebugDrawer.GetSize();
             environment.OverlayDebugDraws = this->DebugDrawer.DrawAsScreenOverlay;
             this->DebugDrawer.SubmitBuffer();
+            environment.DebugBufferObject.VAO = this->DebugDrawer.GetVAO();
+            environment.DebugBufferObject.VertexCount = this->DebugDrawer.GetSize();
+            environment.DebugBufferObject.VertexOffset = this->DebugDrawer.GetVertexOffset();
+            environment.DebugBufferObject.InstancedVAO = this->DebugDrawer.GetInstancedVAO();
+            auto shapeBatches = this->DebugDrawer.GetShapeBatches();
+            environment.DebugBufferObject.ShapeBatches.assign(shapeBatches.begin(), shapeBatches.end());
             this->DebugDrawer.ClearBuffer();
 
             environment.TimeDelta = Time::Delta();
         }
+    }
+
+    void RenderAdaptor::PrepareFrameAsync()
+    {
+        if (this->GetRenderLatency() == RenderLatency::NONE || !this->HasPendingFrame) return;
+
+        // collected frame is not modified until it is executed, so it can be read by other thread
+        auto& renderer = this->Renderer;
+        this->FramePreparation->Submit([&renderer]() { renderer.PreparePipeline(); });
+    }
+
+    void RenderAdaptor::WaitForPreparedFrame()
+    {
+        if (this->FramePreparation != nullptr)
+            this->FramePreparation->Wait();
+    }
+
+    void RenderAdaptor::ExecuteFrame()
+    {
+        this->WaitForPreparedFrame();
 
         this->Renderer.GetRenderStatistics().ResetAll();
+        GPUTimer::BeginFrame();
+        NullGraphicAPI::BeginFrame();
         this->Renderer.StartPipeline();
     }
 
     void RenderAdaptor::SubmitRenderedFrame()
     {
         this->Renderer.EndPipeline();
+        GPUTimer::EndFrame();
         this->Renderer.Render();
+        // fence is placed after all commands which read stream buffer data of this frame
+        StreamBufferAllocator::EndFrame();
         this->Renderer.ResetPipeline();
+        // occluder geometry is referenced by pipeline until it is reset
+        this->Occluders.EndFrame();
+        BufferAllocator::EndDeferredDeallocation();
+        this->HasPendingFrame = false;
+    }
+
+    void RenderAdaptor::SetRenderLatency(RenderLatency latency)
+    {
+        if (latency == this->GetRenderLatency()) return;
+
+        if (latency == RenderLatency::ONE_FRAME)
+        {
+            this->FramePreparation = MakeUnique<TaskThread>();
+        }
+        else
+        {
+            this->WaitForPreparedFrame();
+            this->FramePreparation.reset();
+            // frame collected for the next iteration is dropped, as it would be collected again
+            if (this->HasPendingFrame)
+            {
+                this->Renderer.ResetPipeline();
+                this->Occluders.EndFrame();
+                BufferAllocator::EndDeferredDeallocation();
+                this->HasPendingFrame = false;
+            }
+        }
+    }
+
+    RenderLatency RenderAdaptor::GetRenderLatency() const
+    {
+        return this->FramePreparation != nullptr ? RenderLatency::ONE_FRAME : RenderLatency::NONE;
     }
 
     void RenderAdaptor::SetWindowSize(const VectorInt2& size)
@@ -530,11 +716,64 @@ namespace MxEngine
 
     void RenderAdaptor::SetRenderToDefaultFrameBuffer(bool value)
     {
-        this->Renderer.GetEnvironment().RenderToDefaultFrameBuffer = value;
+        auto& environment = this->Renderer.GetEnvironment();
+        environment.RenderToDefaultFrameBuffer = value && environment.HasDefaultFrameBuffer;
     }
 
     bool RenderAdaptor::IsRenderedToDefaultFrameBuffer() const
     {
         return this->Renderer.GetEnvironment().RenderToDefaultFrameBuffer;
     }
+
+    void RenderAdaptor::SetShadowMapCaching(bool value)
+    {
+        auto& cache = this->Renderer.GetLightInformation().ShadowCache;
+        if (!value) cache.Invalidate();
+        cache.IsEnabled = value;
+    }
+
+    bool RenderAdaptor::IsShadowMapCachingEnabled() const
+    {
+        return this->Renderer.GetLightInformation().ShadowCache.IsEnabled;
+    }
+
+    void RenderAdaptor::SetStaticShadowCasterSplit(bool value)
+    {
+        this->Renderer.GetLightInformation().ShadowCache.SplitStaticCasters = value;
+    }
+
+    bool RenderAdaptor::IsStaticShadowCasterSplit() const
+    {
+        return this->Renderer.GetLightInformation().ShadowCache.SplitStaticCasters;
+    }
+
+    void RenderAdaptor::SetClusteredLighting(bool value)
+    {
+        this->Renderer.GetEnvironment().UseClusteredLighting = value;
+    }
+
+    bool RenderAdaptor::IsClusteredLightingEnabled() const
+    {
+        return this->Renderer.GetEnvironment().UseClusteredLighting;
+    }
+
+    void RenderAdaptor::SetOcclusionCulling(bool value)
+    {
+        this->Renderer.GetEnvironment().UseOcclusionCulling = value;
+    }
+
+    bool RenderAdaptor::IsOcclusionCullingEnabled() const
+    {
+        return this->Renderer.GetEnvironment().UseOcclusionCulling;
+    }
+
+    void RenderAdaptor::SetLODPixelError(float pixels)
+    {
+        this->LODPixelError = Max(pixels, 0.0f);
+    }
+
+    float RenderAdaptor::GetLODPixelError() const
+    {
+        return this->LODPixelError;
+    }
 }
\ No newline at end of file
@@ -30,6 +30,9 @@
 
 #include "Core/Rendering/RenderController.h"
 #include "Core/Components/Camera/CameraController.h"
+#include "Core/Config/Config.h"
+#include "Utilities/Threading/TaskThread.h"
+#include "Utilities/Memory/Memory.h"
 
 namespace MxEngine
 {
@@ -37,14 +40,40 @@ namespace MxEngine
     {
         RenderController Renderer;
         DebugBuffer DebugDrawer;
+        OccluderCache Occluders;
         CameraController::Handle Viewport;
+        float LODPixelError = 1.0f;
+        float LODHysteresis = 0.25f;
+        // present only if render latency is ONE_FRAME. Builds draw commands of collected frame while next one is simulated
+        UniqueRef<TaskThread> FramePreparation;
+        bool HasPendingFrame = false;
 
         constexpr static TextureFormat HDRTextureFormat = TextureFormat::RGBA16F;
+        // static objects with world-space extent larger than this value are used as occluders even if not marked explicitly
+        constexpr static float AutoOccluderSize = 10.0f;
+        constexpr static size_t OcclusionBufferWidth = 256;
+        constexpr static size_t OcclusionBufferHeight = 128;
         void InitRendererEnvironment();
         void RenderFrame();
+        void CollectFrame();
+        void PrepareFrameAsync();
+        void WaitForPreparedFrame();
+        void ExecuteFrame();
         void SubmitRenderedFrame();
+        void SetRenderLatency(RenderLatency latency);
+        RenderLatency GetRenderLatency() const;
         void SetWindowSize(const VectorInt2& size);
         void SetRenderToDefaultFrameBuffer(bool value = true);
         bool IsRenderedToDefaultFrameBuffer() const;
+        void SetShadowMapCaching(bool value = true);
+        bool IsShadowMapCachingEnabled() const;
+        void SetStaticShadowCasterSplit(bool value = true);
+        bool IsStaticShadowCasterSplit() const;
+        void SetClusteredLighting(bool value = true);
+        bool IsClusteredLightingEnabled() const;
+        void SetOcclusionCulling(bool value = true);
+        bool IsOcclusionCullingEnabled() const;
+        void SetLODPixelError(float pixels);
+        float GetLODPixelError() const;
     };
 }
\ No newline at end of file
@@ -41,18 +41,268 @@
 #include "Core/Components/Lighting/SpotLight.h"
 #include "Core/Components/Lighting/PointLight.h"
 #include "Core/Components/Rendering/Skybox.h"
+#include "Core/MxObject/MxObject.h"
 #include "Utilities/Profiler/Profiler.h"
 #include "Platform/Compute/Compute.h"
 #include "Platform/GPUDebug/DebugGroup.h"
+#include "Platform/GPUDebug/GPUTimer.h"
 #include "RenderUtilities/ShadowMapGenerator.h"
+#include "Utilities/Sort/RadixSort.h"
+#include "Utilities/Threading/WorkerPool.h"
 
 namespace MxEngine
 {
-    #define MAKE_RENDER_PASS_SCOPE(name) MAKE_SCOPE_PROFILER(name); MAKE_GPU_DEBUG_GROUP(name)
+    #define MAKE_RENDER_PASS_SCOPE(name) MAKE_SCOPE_PROFILER(name); MAKE_GPU_DEBUG_GROUP(name); MAKE_GPU_TIMER_SCOPE(name)
 
     constexpr size_t MaxDirLightCount = 4;
     constexpr size_t ParticleComputeGroupSize = 64;
     constexpr int DefaultLinearBlurSampleCount = 5;
+    constexpr float DepthBucketsPerOctave = 256.0f;
+
+    uint64_t ComputeDepthBucket(const Vector3& viewPosition, const Vector3& minAABB, const Vector3& maxAABB)
+    {
+        // logarithmic distribution gives more precision to nearby objects, which occlude the most
+        auto center = 0.5f * (minAABB + maxAABB);
+        float bucket = std::log2(1.0f + Length(center - viewPosition)) * DepthBucketsPerOctave;
+        return (uint64_t)Min(bucket, (float)RenderSortKey::MaxDepthBucket);
+    }
+
+    uint64_t MakeMaterialSortId(const Material& material)
+    {
+        uint64_t hash = 0;
+        hash = RenderSortKey::HashCombine(hash, material.AlbedoMap.GetHandle());
+        hash = RenderSortKey::HashCombine(hash, material.MetallicMap.GetHandle());
+        hash = RenderSortKey::HashCombine(hash, material.RoughnessMap.GetHandle());
+        hash = RenderSortKey::HashCombine(hash, material.EmissiveMap.GetHandle());
+        hash = RenderSortKey::HashCombine(hash, material.NormalMap.GetHandle());
+        hash = RenderSortKey::HashCombine(hash, material.HeightMap.GetHandle());
+        hash = RenderSortKey::HashCombine(hash, material.AmbientOcclusionMap.GetHandle());
+        return hash >> (64 - RenderSortKey::MaterialBits);
+    }
+
+    uint64_t MakeMeshSortId(const RenderUnit& unit)
+    {
+        uint64_t hash = 0;
+        hash = RenderSortKey::HashCombine(hash, unit.VertexOffset);
+        hash = RenderSortKey::HashCombine(hash, unit.IndexOffset);
+        hash = RenderSortKey::HashCombine(hash, (uint64_t)unit.IndexType);
+        return hash >> (64 - RenderSortKey::MeshBits);
+    }
+
+    uint64_t MakeShaderSortId(const ShaderHandle& shader)
+    {
+        // program ids are small sequential integers, so low bits are enough to tell programs apart
+        return (uint64_t)shader->GetNativeHandle() & RenderSortKey::Mask(RenderSortKey::ShaderBits);
+    }
+
+    bool HasSameMaterialParameters(const Material& m1, const Material& m2)
+    {
+        return m1.RoughnessFactor == m2.RoughnessFactor &&
+            m1.MetallicFactor == m2.MetallicFactor &&
+            m1.Emission == m2.Emission &&
+            m1.Transparency == m2.Transparency &&
+            m1.Displacement == m2.Displacement &&
+            m1.UVMultipliers == m2.UVMultipliers &&
+            m1.BaseColor == m2.BaseColor;
+    }
+
+    template<typename LightUnits>
+    void UpdateShadowCacheStates(LightUnits& lights, ShadowMapCache& cache, const ShadowMapGenerator& generatorOpaque, const ShadowMapGenerator& generatorMasked, RenderStatistics& statistics)
+    {
+        for (auto& light : lights)
+        {
+            ShadowCasterHash casters;
+            generatorOpaque.HashCastersFor(light, casters);
+            generatorMasked.HashCastersFor(light, casters);
+
+            light.ShadowState = cache.Update(light.ShadowMap, ShadowMapGenerator::HashLight(light), casters, light.StaticShadowMap);
+            statistics.AddEntry(light.ShadowState == ShadowCacheState::CLEAN ? RenderCounter::CACHED_SHADOW_MAPS : RenderCounter::RENDERED_SHADOW_MAPS, 1);
+        }
+    }
+
+    Matrix4x4 MakeAtlasTileBiasMatrix(const ShadowAtlasTile& tile, size_t atlasSize)
+    {
+        float scale = float(tile.Size) / float(atlasSize);
+        float offsetX = float(tile.X) / float(atlasSize);
+        float offsetY = float(tile.Y) / float(atlasSize);
+
+        Matrix4x4 Result(
+            0.5f * scale,           0.0f,                   0.0f, 0.0f,
+            0.0f,                   0.5f * scale,           0.0f, 0.0f,
+            0.0f,                   0.0f,                   0.5f, 0.0f,
+            0.5f * scale + offsetX, 0.5f * scale + offsetY, 0.5f, 1.0f
+        );
+        return Result;
+    }
+
+    void UpdateShadowCacheStates(MxVector<SpotLightUnit>& lights, ArrayView<ShadowAtlasDecision> decisions, ShadowMapCache& cache, const ShadowMapGenerator& generatorOpaque, const ShadowMapGenerator& generatorMasked)
+    {
+        for (size_t i = 0; i < lights.size(); i++)
+        {
+            auto& light = lights[i];
+            light.ShadowTile = decisions[i].Tile;
+            // atlas is full, light is drawn without shadows (see DrawShadowedSpotLights)
+            if (!light.ShadowTile.IsValid())
+            {
+                light.ShadowState = ShadowCacheState::CLEAN;
+                continue;
+            }
+            light.BiasedProjectionMatrix = MakeAtlasTileBiasMatrix(light.ShadowTile, light.ShadowMap->GetWidth()) * light.ProjectionMatrix;
+
+            ShadowCasterHash casters;
+            generatorOpaque.HashCastersFor(light, casters);
+            generatorMasked.HashCastersFor(light, casters);
+
+            light.ShadowState = cache.Update(light.LightKey, light.ShadowMap, light.ShadowTile, ShadowMapGenerator::HashLight(light), casters, light.StaticShadowMap);
+        }
+    }
+
+    void UpdateShadowCacheStates(MxVector<PointLightUnit>& lights, ShadowMapCache& cache, const ShadowMapGenerator& generatorOpaque, const ShadowMapGenerator& generatorMasked)
+    {
+        for (auto& light : lights)
+        {
+            ShadowCasterHash casters;
+            generatorOpaque.HashCastersFor(light, casters);
+            generatorMasked.HashCastersFor(light, casters);
+
+            light.ShadowState = cache.Update(light.ShadowMap, ShadowMapGenerator::HashLight(light), casters, light.StaticShadowMap);
+        }
+    }
+
+    template<typename LightUnit>
+    float ComputeScreenCoverage(const LightUnit& light, float lightRadius, const Vector3& viewPosition)
+    {
+        // approximate fraction of screen covered by light bounding sphere. Camera inside bounds sees light on whole screen
+        auto distance = light.Position - viewPosition;
+        float distanceSquared = Dot(distance, distance);
+        float radiusSquared = lightRadius * lightRadius;
+        if (distanceSquared <= radiusSquared) return 1.0f;
+        return Clamp(radiusSquared / distanceSquared, 0.0f, 1.0f);
+    }
+
+    template<typename LightUnits, typename RadiusFunc>
+    void AddShadowAtlasRequests(const LightUnits& lights, MxVector<ShadowAtlasRequest>& requests, const Vector3& viewPosition, bool needsTile, RadiusFunc&& radius)
+    {
+        for (const auto& light : lights)
+        {
+            auto& request = requests.emplace_back();
+            request.LightKey = light.LightKey;
+            request.ScreenCoverage = ComputeScreenCoverage(light, radius(light), viewPosition);
+            request.NeedsTile = needsTile;
+            request.IsDirty = false;
+        }
+    }
+
+    void PostponeShadowUpdate(const SpotLightUnit& light, ShadowMapCache& cache)
+    {
+        cache.Postpone(light.LightKey, light.ShadowState);
+    }
+
+    void PostponeShadowUpdate(const PointLightUnit& light, ShadowMapCache& cache)
+    {
+        cache.Postpone(light.ShadowMap, light.ShadowState);
+    }
+
+    template<typename LightUnits>
+    void ApplyShadowUpdateDecisions(LightUnits& lights, ShadowMapCache& cache, ArrayView<ShadowAtlasDecision> decisions, RenderStatistics& statistics)
+    {
+        for (size_t i = 0; i < lights.size(); i++)
+        {
+            auto& light = lights[i];
+            if (decisions[i].IsUpdated)
+            {
+                // shadow map content is undefined (i.e. tile was just allocated), so cached state can not be trusted
+                if (light.ShadowState == ShadowCacheState::CLEAN)
+                    light.ShadowState = ShadowCacheState::DIRTY;
+            }
+            else if (light.ShadowState != ShadowCacheState::CLEAN)
+            {
+                // light is out of budget this frame: previous shadow map is used and update is retried later
+                PostponeShadowUpdate(light, cache);
+                light.ShadowState = ShadowCacheState::CLEAN;
+                statistics.AddEntry(RenderCounter::POSTPONED_SHADOW_MAPS, 1);
+            }
+            statistics.AddEntry(light.ShadowState == ShadowCacheState::CLEAN ? RenderCounter::CACHED_SHADOW_MAPS : RenderCounter::RENDERED_SHADOW_MAPS, 1);
+        }
+    }
+
+    void CopyStaticShadowLayer(DirectionalLightUnit& light)
+    {
+        light.StaticShadowMap->CopyTo(*light.ShadowMap);
+    }
+
+    void CopyStaticShadowLayer(PointLightUnit& light)
+    {
+        light.StaticShadowMap->CopyTo(*light.ShadowMap);
+    }
+
+    void CopyStaticShadowLayer(SpotLightUnit& light)
+    {
+        light.StaticShadowMap->CopyTo(*light.ShadowMap, light.ShadowTile.X, light.ShadowTile.Y);
+    }
+
+    template<typename LightUnits>
+    void GenerateShadowMaps(LightUnits& lights, ShadowMapGenerator& generatorOpaque, ShadowMapGenerator& generatorMasked, const Shader& opaqueShader, const Shader& maskedShader, bool splitStaticCasters)
+    {
+        using Options = ShadowMapGenerator::LoadStoreOptions;
+        if (splitStaticCasters)
+        {
+            generatorOpaque.GenerateFor(opaqueShader, lights, Options::CLEAR | Options::STATIC_LAYER);
+            generatorMasked.GenerateFor(maskedShader, lights, Options::LOAD | Options::STATIC_LAYER);
+
+            for (auto& light : lights)
+            {
+                if (light.ShadowState != ShadowCacheState::CLEAN)
+                    CopyStaticShadowLayer(light);
+            }
+
+            generatorOpaque.GenerateFor(opaqueShader, lights, Options::LOAD | Options::DYNAMIC_OVERLAY);
+            generatorMasked.GenerateFor(maskedShader, lights, Options::LOAD | Options::DYNAMIC_OVERLAY);
+        }
+        else
+        {
+            generatorOpaque.GenerateFor(opaqueShader, lights, Options::CLEAR);
+            generatorMasked.GenerateFor(maskedShader, lights, Options::LOAD);
+        }
+    }
+
+    void RenderController::ScheduleShadowMapUpdates(const ShadowMapGenerator& generatorOpaque, const ShadowMapGenerator& generatorMasked)
+    {
+        auto& lighting = this->Pipeline.Lighting;
+        auto& requests = lighting.ShadowRequests;
+        auto& decisions = lighting.ShadowDecisions;
+        auto& scheduler = lighting.ShadowScheduler;
+        auto& cache = lighting.ShadowCache;
+
+        const auto& cameras = this->Pipeline.Cameras;
+        size_t mainCameraIndex = this->Pipeline.Environment.MainCameraIndex;
+        Vector3 viewPosition = (mainCameraIndex < cameras.size() ? cameras[mainCameraIndex] : cameras.front()).ViewportPosition;
+
+        // spot lights go first and point lights after them, so decisions can be mapped back by index
+        requests.clear();
+        AddShadowAtlasRequests(lighting.SpotLights, requests, viewPosition, true, 
+            [](const SpotLightUnit& light) { return Length(light.Direction); });
+        AddShadowAtlasRequests(lighting.PointLights, requests, viewPosition, false, 
+            [](const PointLightUnit& light) { return light.Radius; });
+
+        scheduler.AllocateTiles(requests, decisions);
+
+        ArrayView<ShadowAtlasDecision> spotDecisions(decisions.data(), lighting.SpotLights.size());
+        ArrayView<ShadowAtlasDecision> pointDecisions(decisions.data() + lighting.SpotLights.size(), lighting.PointLights.size());
+
+        UpdateShadowCacheStates(lighting.SpotLights, spotDecisions, cache, generatorOpaque, generatorMasked);
+        UpdateShadowCacheStates(lighting.PointLights, cache, generatorOpaque, generatorMasked);
+
+        for (size_t i = 0; i < lighting.SpotLights.size(); i++)
+            requests[i].IsDirty = lighting.SpotLights[i].ShadowState != ShadowCacheState::CLEAN;
+        for (size_t i = 0; i < lighting.PointLights.size(); i++)
+            requests[i + lighting.SpotLights.size()].IsDirty = lighting.PointLights[i].ShadowState != ShadowCacheState::CLEAN;
+
+        scheduler.ScheduleUpdates(requests, decisions);
+
+        ApplyShadowUpdateDecisions(lighting.SpotLights, cache, spotDecisions, this->Pipeline.Statistics);
+        ApplyShadowUpdateDecisions(lighting.PointLights, cache, pointDecisions, this->Pipeline.Statistics);
+    }
 
     void RenderController::PrepareShadowMaps()
     {
@@ -67,50 +317,46 @@ namespace MxEngine
         ShadowMapGenerator generatorOpaque(this->Pipeline.ShadowCasters, this->Pipeline.RenderUnits, this->Pipeline.MaterialUnits);
         ShadowMapGenerator generatorMasked(this->Pipeline.MaskedShadowCasters, this->Pipeline.RenderUnits, this->Pipeline.MaterialUnits);
 
+        auto& lighting = this->Pipeline.Lighting;
+        auto& cache = lighting.ShadowCache;
+        bool splitStaticCasters = cache.IsEnabled && cache.SplitStaticCasters;
+        {
+            MAKE_RENDER_PASS_SCOPE("RenderController::UpdateShadowCache()");
+            cache.BeginFrame();
+            UpdateShadowCacheStates(lighting.DirectionalLights, cache, generatorOpaque, generatorMasked, this->Pipeline.Statistics);
+            this->ScheduleShadowMapUpdates(generatorOpaque, generatorMasked);
+            cache.EndFrame();
+        }
+
         this->Pipeline.Environment.RenderVAO->Bind();
 
         if (hasDirectionalLights)
         {
             MAKE_RENDER_PASS_SCOPE("RenderController::PrepareDirectionalLightMaps()");
-            generatorOpaque.GenerateFor(
-                *this->Pipeline.Environment.Shaders["DirLightDepthMap"_id], 
-                this->Pipeline.Lighting.DirectionalLights,
-                ShadowMapGenerator::LoadStoreOptions::CLEAR
-            );
-            generatorMasked.GenerateFor(
+            GenerateShadowMaps(lighting.DirectionalLights, generatorOpaque, generatorMasked,
+                *this->Pipeline.Environment.Shaders["DirLightDepthMap"_id],
                 *this->Pipeline.Environment.Shaders["DirLightMaskDepthMap"_id],
-                this->Pipeline.Lighting.DirectionalLights,
-                ShadowMapGenerator::LoadStoreOptions::LOAD
+                splitStaticCasters
             );
         }
 
         if (hasSpotLights)
         {
             MAKE_RENDER_PASS_SCOPE("RenderController::PrepareSpotLightMaps()");
-            generatorOpaque.GenerateFor(
-                *this->Pipeline.Environment.Shaders["SpotLightDepthMap"_id], 
-                this->Pipeline.Lighting.SpotLights,
-                ShadowMapGenerator::LoadStoreOptions::CLEAR
-            );
-            generatorMasked.GenerateFor(
+            GenerateShadowMaps(lighting.SpotLights, generatorOpaque, generatorMasked,
+                *this->Pipeline.Environment.Shaders["SpotLightDepthMap"_id],
                 *this->Pipeline.Environment.Shaders["SpotLightMaskDepthMap"_id],
-                this->Pipeline.Lighting.SpotLights,
-                ShadowMapGenerator::LoadStoreOptions::LOAD
+                splitStaticCasters
             );
         }
 
         if (hasPointLights)
         {
             MAKE_RENDER_PASS_SCOPE("RenderController::PreparePointLightMaps()");
-            generatorOpaque.GenerateFor(
-                *this->Pipeline.Environment.Shaders["PointLightDepthMap"_id], 
-                this->Pipeline.Lighting.PointLights,
-                ShadowMapGenerator::LoadStoreOptions::CLEAR
-            );
-            generatorMasked.GenerateFor(
+            GenerateShadowMaps(lighting.PointLights, generatorOpaque, generatorMasked,
                 *this->Pipeline.Environment.Shaders["PointLightDepthMap"_id],
-                this->Pipeline.Lighting.PointLights,
-                ShadowMapGenerator::LoadStoreOptions::LOAD
+                *this->Pipeline.Environment.Shaders["PointLightDepthMap"_id],
+                splitStaticCasters
             );
         }
     }
@@ -127,6 +373,9 @@ namespace MxEngine
         this->Pipeline.Environment.RenderSSBO->BindBase(0);
         for (const auto& particleSystem : particleSystems)
         {
+            // already simulated and uploaded in ParticleSystem::OnUpdate()
+            if (particleSystem.IsSimulatedOnCPU) continue;
+
             computeShader->SetUniform("bufferOffset", (int)particleSystem.ParticleBufferOffset);
             computeShader->SetUniform("lifetime", particleSystem.ParticleLifetime);
             computeShader->SetUniform("spawnpoint", particleSystem.IsRelative ? Vector3(0.0f) : Vector3(particleSystem.Transform[3]));
@@ -135,22 +384,21 @@ namespace MxEngine
         }
     }
 
-    void RenderController::SortParticles(const CameraUnit& camera, MxVector<ParticleSystemUnit>& particleSystems)
+    void RenderController::SortParticles(const CameraUnit& camera, MxVector<ParticleSystemUnit>& particleSystems, DepthSorter& sorter)
     {
-        std::sort(particleSystems.begin(), particleSystems.end(), 
-            [&camera](const ParticleSystemUnit& p1, const ParticleSystemUnit& p2)
+        sorter.SortBackToFront(particleSystems, this->Pipeline.ParticleSortScratch,
+            [&camera](const ParticleSystemUnit& particleSystem)
             {
-                auto dist1 = camera.ViewportPosition - Vector3(p1.Transform[3]);
-                auto dist2 = camera.ViewportPosition - Vector3(p2.Transform[3]);
-                return Dot(dist1, dist1) > Dot(dist2, dist2);
+                auto distance = camera.ViewportPosition - Vector3(particleSystem.Transform[3]);
+                return Dot(distance, distance);
             });
     }
 
-    void RenderController::DrawParticles(const CameraUnit& camera, MxVector<ParticleSystemUnit>& particleSystems, const Shader& shader)
+    void RenderController::DrawParticles(const CameraUnit& camera, MxVector<ParticleSystemUnit>& particleSystems, DepthSorter& sorter, const Shader& shader)
     {
         if (particleSystems.empty()) return;
         MAKE_RENDER_PASS_SCOPE("RenderController::DrawParticles()");
-        this->SortParticles(camera, particleSystems);
+        this->SortParticles(camera, particleSystems, sorter);
 
         shader.Bind();
         shader.IgnoreNonExistingUniform("viewportSize");
@@ -214,11 +462,108 @@ namespace MxEngine
         }
     }
 
-    void RenderController::DrawObjects(const CameraUnit& camera, const Shader& shader, const RenderList& objects)
+    void RenderController::PrepareRenderLists()
+    {
+        MAKE_RENDER_PASS_SCOPE("RenderController::PrepareRenderLists()");
+
+        if (!this->Pipeline.IsPrepared)
+            this->PreparePipeline();
+
+        if (this->Pipeline.Environment.UseIndirectDrawing)
+        {
+            // materials are shared by all cameras, so they are uploaded once per frame
+            auto& materials = this->Pipeline.IndirectMaterials;
+            this->Pipeline.Environment.IndirectMaterialSSBO->BufferSubDataWithResize(materials.data(), materials.size());
+        }
+    }
+
+    void RenderController::PreparePipeline()
+    {
+        // can be called from non-render thread, so no graphic api calls or profiler scopes are allowed here
+        if (this->Pipeline.IsPrepared || this->Pipeline.Cameras.empty()) return;
+
+        // depth bucket is computed relative to main camera, other cameras reuse the same order
+        const auto& cameras = this->Pipeline.Cameras;
+        size_t mainCameraIndex = this->Pipeline.Environment.MainCameraIndex;
+        Vector3 viewPosition = (mainCameraIndex < cameras.size() ? cameras[mainCameraIndex] : cameras.front()).ViewportPosition;
+
+        this->BuildDrawCommands(this->Pipeline.OpaqueObjects, viewPosition, true);
+        this->BuildDrawCommands(this->Pipeline.MaskedObjects, viewPosition, true);
+        this->BuildDrawCommands(this->Pipeline.ShadowCasters, viewPosition, true);
+        this->BuildDrawCommands(this->Pipeline.MaskedShadowCasters, viewPosition, true);
+        // transparent objects are blended, so their order can not be changed to reduce state switches
+        this->BuildDrawCommands(this->Pipeline.TransparentObjects, viewPosition, false);
+
+        // packed even if indirect drawing is disabled, as it may be toggled while pipeline is prepared in background
+        IndirectCommandBuilder::PackMaterials(this->Pipeline.MaterialUnits, this->Pipeline.IndirectMaterials);
+
+        this->Pipeline.IsPrepared = true;
+    }
+
+    void RenderController::BuildDrawCommands(RenderList& objects, const Vector3& viewPosition, bool sortByState)
+    {
+        auto& commands = objects.DrawCommands;
+        commands.clear();
+        commands.reserve(objects.UnitsIndex.size());
+
+        size_t currentUnit = 0;
+        for (size_t groupIndex = 0; groupIndex < objects.Groups.size(); groupIndex++)
+        {
+            const auto& group = objects.Groups[groupIndex];
+            for (size_t i = 0; i < group.UnitCount; i++, currentUnit++)
+            {
+                size_t unitIndex = objects.UnitsIndex[currentUnit];
+                const auto& unit = this->Pipeline.RenderUnits[unitIndex];
+
+                auto& command = commands.emplace_back();
+                command.UnitIndex = (uint32_t)unitIndex;
+                command.GroupIndex = (uint32_t)groupIndex;
+                command.SortKey = RenderSortKey::WithDepth(unit.SortKey, ComputeDepthBucket(viewPosition, unit.MinAABB, unit.MaxAABB));
+            }
+        }
+
+        if (sortByState)
+        {
+            RadixSort(commands, this->Pipeline.SortScratch, [](const RenderDrawCommand& command) { return command.SortKey; });
+        }
+    }
+
+    void RenderController::PrepareOcclusionCulling(const CameraUnit& camera)
+    {
+        auto& occlusion = this->Pipeline.Occlusion;
+        occlusion.OccludedUnits.clear();
+
+        // depth is stored as 1 / w, which is constant for orthographic projection
+        bool useOcclusionCulling = this->Pipeline.Environment.UseOcclusionCulling && camera.IsPerspective;
+        if (!useOcclusionCulling || occlusion.Occluders.empty()) return;
+
+        MAKE_SCOPE_PROFILER("RenderController::PrepareOcclusionCulling()");
+        occlusion.Culler.RenderOccluders(camera.ViewProjectionMatrix, camera.ZNear, occlusion.Occluders);
+        this->Pipeline.Statistics.AddEntry(RenderCounter::OCCLUDER_TRIANGLES, occlusion.Culler.GetRasterizedTriangleCount());
+
+        const auto& renderUnits = this->Pipeline.RenderUnits;
+        occlusion.OccludedUnits.resize(renderUnits.size());
+        ParallelFor(renderUnits.size(), 64, [&occlusion, &renderUnits](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                const auto& unit = renderUnits[i];
+                occlusion.OccludedUnits[i] = !occlusion.Culler.IsAABBVisible(unit.MinAABB, unit.MaxAABB);
+            }
+        });
+    }
+
+    bool RenderController::IsUnitOccluded(size_t unitIndex) const
+    {
+        const auto& occludedUnits = this->Pipeline.Occlusion.OccludedUnits;
+        return unitIndex < occludedUnits.size() && occludedUnits[unitIndex];
+    }
+
+    void RenderController::DrawObjects(const CameraUnit& camera, const Shader& shader, const RenderList& objects, bool useMeshletCulling)
     {
         MAKE_RENDER_PASS_SCOPE("RenderController::DrawObjects()");
 
-        if (objects.UnitsIndex.empty()) return;
+        if (objects.DrawCommands.empty()) return;
         shader.Bind();
         shader.IgnoreNonExistingUniform("camera.position");
         shader.IgnoreNonExistingUniform("camera.invViewProjMatrix");
@@ -227,58 +572,155 @@ namespace MxEngine
         this->BindCameraInformation(camera, shader);
         shader.SetUniform("gamma", camera.Gamma);
 
-        size_t currentUnit = 0;
+        // material textures always occupy the same slots (see BindMaterialTextures), so samplers are set once per pass
+        shader.SetUniform("map_albedo", 0);
+        shader.SetUniform("map_metallic", 1);
+        shader.SetUniform("map_roughness", 2);
+        shader.SetUniform("map_emmisive", 3);
+        shader.SetUniform("map_normal", 4);
+        shader.SetUniform("map_height", 5);
+        shader.SetUniform("map_occlusion", 6);
+
+        const Material* previousMaterial = nullptr;
         this->Pipeline.Environment.RenderVAO->Bind();
-        for (const auto& group : objects.Groups)
+        for (const auto& command : objects.DrawCommands)
         {
-            if (group.UnitCount == 0) continue;
+            const auto& group = objects.Groups[command.GroupIndex];
+            const auto& unit = this->Pipeline.RenderUnits[command.UnitIndex];
             bool isInstanced = group.InstanceCount > 0;
 
-            for (size_t i = 0; i < group.UnitCount; i++, currentUnit++)
-            {
-                const auto& unit = this->Pipeline.RenderUnits[objects.UnitsIndex[currentUnit]];
-                bool isUnitVisible = isInstanced || camera.Culler.IsAABBVisible(unit.MinAABB, unit.MaxAABB);
-                this->Pipeline.Statistics.AddEntry(isUnitVisible ? "drawn objects" : "culled objects", 1);
+            bool isUnitVisible = isInstanced || camera.Culler.IsAABBVisible(unit.MinAABB, unit.MaxAABB);
+            bool isUnitOccluded = !isInstanced && isUnitVisible && this->IsUnitOccluded(command.UnitIndex);
+            this->Pipeline.Statistics.AddEntry(isUnitOccluded ? RenderCounter::OCCLUDED_OBJECTS : (isUnitVisible ? RenderCounter::DRAWN_OBJECTS : RenderCounter::CULLED_OBJECTS), 1);
 
-                if (isUnitVisible) this->DrawObject(unit, group.InstanceCount, group.BaseInstance, shader);
+            if (!isUnitVisible || isUnitOccluded) continue;
+
+            // dense meshes are drawn only by their visible clusters
+            ArrayView<MeshletDrawRange> meshletRanges;
+            if (useMeshletCulling && !isInstanced && unit.MeshletCount > 0)
+            {
+                ArrayView<Meshlet> meshlets(this->Pipeline.MeshletUnits.data() + unit.MeshletOffset, unit.MeshletCount);
+                size_t culledMeshlets = MeshletCuller::Cull(meshlets, unit.ModelMatrix, unit.IndexOffset, camera.Culler, camera.ViewportPosition, this->Pipeline.MeshletRanges);
+                this->Pipeline.Statistics.AddEntry(RenderCounter::CULLED_MESHLETS, culledMeshlets);
+                if (this->Pipeline.MeshletRanges.empty()) continue;
+                meshletRanges = this->Pipeline.MeshletRanges;
             }
+
+            this->DrawObject(unit, group.InstanceCount, group.BaseInstance, shader, previousMaterial, meshletRanges);
+            previousMaterial = &this->Pipeline.MaterialUnits[unit.MaterialIndex];
+        }
+    }
+
+    void RenderController::DrawObjectsIndirect(const CameraUnit& camera, const Shader& shader, const RenderList& objects)
+    {
+        MAKE_RENDER_PASS_SCOPE("RenderController::DrawObjectsIndirect()");
+
+        if (objects.DrawCommands.empty()) return;
+
+        auto& environment = this->Pipeline.Environment;
+        auto& drawList = this->Pipeline.IndirectDraws;
+        IndirectCommandBuilder builder(objects, this->Pipeline.RenderUnits, this->Pipeline.MaterialUnits, this->Pipeline.MeshletUnits);
+        builder.Build(camera.Culler, camera.ViewportPosition, this->Pipeline.Occlusion.OccludedUnits, drawList);
+
+        this->Pipeline.Statistics.AddEntry(RenderCounter::CULLED_OBJECTS, drawList.CulledCount);
+        this->Pipeline.Statistics.AddEntry(RenderCounter::OCCLUDED_OBJECTS, drawList.OccludedCount);
+        this->Pipeline.Statistics.AddEntry(RenderCounter::CULLED_MESHLETS, drawList.CulledMeshletCount);
+        if (drawList.Commands.empty()) return;
+
+        environment.IndirectCommandBuffer->BufferDataWithResize(drawList.Commands.data(), drawList.Commands.size());
+        environment.IndirectDrawSSBO->BufferSubDataWithResize(drawList.DrawData.data(), drawList.DrawData.size());
+
+        shader.Bind();
+        shader.IgnoreNonExistingUniform("camera.position");
+        shader.IgnoreNonExistingUniform("camera.invViewProjMatrix");
+
+        this->BindCameraInformation(camera, shader);
+        shader.SetUniform("gamma", camera.Gamma);
+
+        shader.SetUniform("map_albedo", 0);
+        shader.SetUniform("map_metallic", 1);
+        shader.SetUniform("map_roughness", 2);
+        shader.SetUniform("map_emmisive", 3);
+        shader.SetUniform("map_normal", 4);
+        shader.SetUniform("map_height", 5);
+        shader.SetUniform("map_occlusion", 6);
+
+        environment.IndirectDrawSSBO->BindBase(1);
+        environment.IndirectMaterialSSBO->BindBase(2);
+        environment.IndirectCommandBuffer->Bind();
+        environment.RenderVAO->Bind();
+
+        const Material* previousMaterial = nullptr;
+        for (const auto& batch : drawList.Batches)
+        {
+            const auto& material = this->Pipeline.MaterialUnits[batch.MaterialIndex];
+            this->BindMaterialTextures(material, previousMaterial);
+            previousMaterial = &material;
+
+            shader.SetUniform("drawOffset", (int)batch.CommandOffset);
+            this->DrawIndicesIndirect(RenderPrimitive::TRIANGLES, batch.CommandOffset, batch.CommandCount, batch.IndexType);
         }
     }
 
-    void RenderController::DrawObject(const RenderUnit& unit, size_t instanceCount, size_t baseInstance, const Shader& shader)
+    void RenderController::BindMaterialTextures(const Material& material, const Material* previousMaterial)
+    {
+        std::array textures = {
+            &material.AlbedoMap, &material.MetallicMap, &material.RoughnessMap, &material.EmissiveMap,
+            &material.NormalMap, &material.HeightMap, &material.AmbientOcclusionMap,
+        };
+        static_assert(textures.size() == Material::TextureCount);
+
+        std::array<const TextureHandle*, Material::TextureCount> previousTextures = { };
+        if (previousMaterial != nullptr)
+        {
+            previousTextures = {
+                &previousMaterial->AlbedoMap, &previousMaterial->MetallicMap, &previousMaterial->RoughnessMap, &previousMaterial->EmissiveMap,
+                &previousMaterial->NormalMap, &previousMaterial->HeightMap, &previousMaterial->AmbientOcclusionMap,
+            };
+        }
+
+        for (size_t i = 0; i < textures.size(); i++)
+        {
+            this->Pipeline.Statistics.AddEntry(RenderCounter::TEXTURE_BINDS_REQUESTED, 1);
+            // texture slots are not touched between consecutive draws, so same texture is still bound
+            if (previousTextures[i] != nullptr && *previousTextures[i] == *textures[i]) continue;
+
+            (*textures[i])->Bind((Texture::TextureBindId)i);
+            this->Pipeline.Statistics.AddEntry(RenderCounter::TEXTURE_BINDS, 1);
+        }
+    }
+
+    void RenderController::DrawObject(const RenderUnit& unit, size_t instanceCount, size_t baseInstance, const Shader& shader, const Material* previousMaterial, ArrayView<MeshletDrawRange> meshletRanges)
     {
-        Texture::TextureBindId textureBindIndex = 0;
         const auto& material = this->Pipeline.MaterialUnits[unit.MaterialIndex];
 
-        material.AlbedoMap->Bind(textureBindIndex++);
-        material.MetallicMap->Bind(textureBindIndex++);
-        material.RoughnessMap->Bind(textureBindIndex++);
-        material.EmissiveMap->Bind(textureBindIndex++);
-        material.NormalMap->Bind(textureBindIndex++);
-        material.HeightMap->Bind(textureBindIndex++);
-        material.AmbientOcclusionMap->Bind(textureBindIndex++);
-
-        shader.SetUniform("map_albedo", material.AlbedoMap->GetBoundId());
-        shader.SetUniform("map_metallic", material.MetallicMap->GetBoundId());
-        shader.SetUniform("map_roughness", material.RoughnessMap->GetBoundId());
-        shader.SetUniform("map_emmisive", material.EmissiveMap->GetBoundId());
-        shader.SetUniform("map_normal", material.NormalMap->GetBoundId());
-        shader.SetUniform("map_height", material.HeightMap->GetBoundId());
-        shader.SetUniform("map_occlusion", material.AmbientOcclusionMap->GetBoundId());
-
-        shader.SetUniform("material.roughness", material.RoughnessFactor);
-        shader.SetUniform("material.metallic", material.MetallicFactor);
-        shader.SetUniform("material.emmisive", material.Emission);
-        shader.SetUniform("material.transparency", material.Transparency);
-
-        shader.SetUniform("displacement", material.Displacement);
-        shader.SetUniform("uvMultipliers", material.UVMultipliers);
+        this->BindMaterialTextures(material, previousMaterial);
+
+        this->Pipeline.Statistics.AddEntry(RenderCounter::MATERIAL_SWITCHES_REQUESTED, 1);
+        if (previousMaterial == nullptr || !HasSameMaterialParameters(material, *previousMaterial))
+        {
+            shader.SetUniform("material.roughness", material.RoughnessFactor);
+            shader.SetUniform("material.metallic", material.MetallicFactor);
+            shader.SetUniform("material.emmisive", material.Emission);
+            shader.SetUniform("material.transparency", material.Transparency);
+
+            shader.SetUniform("displacement", material.Displacement);
+            shader.SetUniform("uvMultipliers", material.UVMultipliers);
+            shader.SetUniform("parentColor", material.BaseColor);
+            this->Pipeline.Statistics.AddEntry(RenderCounter::MATERIAL_SWITCHES, 1);
+        }
 
         shader.SetUniform("parentModel", unit.ModelMatrix); //-V807
         shader.SetUniform("parentNormal", unit.NormalMatrix);
-        shader.SetUniform("parentColor", material.BaseColor);
         
-        this->DrawIndices(RenderPrimitive::TRIANGLES, unit.IndexCount, unit.IndexOffset, unit.VertexOffset, instanceCount, baseInstance);
+        if (meshletRanges.empty())
+        {
+            this->DrawIndices(RenderPrimitive::TRIANGLES, unit.IndexCount, unit.IndexOffset, unit.VertexOffset, instanceCount, baseInstance, unit.IndexType);
+        }
+        for (const auto& range : meshletRanges)
+        {
+            this->DrawIndices(RenderPrimitive::TRIANGLES, range.IndexCount, range.IndexOffset, unit.VertexOffset, instanceCount, baseInstance, unit.IndexType);
+        }
     }
 
     void RenderController::ComputeBloomEffect(CameraUnit& camera, const TextureHandle& output)
@@ -401,7 +843,7 @@ namespace MxEngine
         this->ToggleFaceCulling(false);
 
         this->DrawTransparentObjects(camera);
-        this->DrawParticles(camera, this->Pipeline.TransparentParticleSystems, *this->Pipeline.Environment.Shaders["ParticleTransparent"_id]);
+        this->DrawParticles(camera, this->Pipeline.TransparentParticleSystems, this->Pipeline.TransparentParticlesOrder, *this->Pipeline.Environment.Shaders["ParticleTransparent"_id]);
         this->DrawDebugBuffer(camera);
 
         this->ToggleFaceCulling(true);
@@ -456,16 +898,38 @@ namespace MxEngine
         // swap culling for light bounds
         this->ToggleFaceCulling(true, true, false);
         
+        bool useClusteredLighting = this->Pipeline.Environment.UseClusteredLighting && camera.IsPerspective;
+
         this->DrawShadowedSpotLights(camera, camera.HDRTexture);
-        this->DrawNonShadowedSpotLights(camera, camera.HDRTexture);
         this->DrawShadowedPointLights(camera, camera.HDRTexture);
-        this->DrawNonShadowedPointLights(camera, camera.HDRTexture);
+        if (!useClusteredLighting)
+        {
+            this->DrawNonShadowedSpotLights(camera, camera.HDRTexture);
+            this->DrawNonShadowedPointLights(camera, camera.HDRTexture);
+        }
         
         this->ToggleFaceCulling(true, true, true);
 
+        // lights without shadows are shaded in one fullscreen pass, each pixel iterates only lights of its cluster
+        if (useClusteredLighting)
+            this->DrawClusteredLights(camera, camera.HDRTexture);
+
         this->GetRenderEngine().UseBlendFactors(BlendFactor::ONE, BlendFactor::ZERO);
     }
 
+    void RenderController::SortTransparentObjects(const CameraUnit& camera)
+    {
+        // transparent objects are blended, so they must be drawn from back to front
+        const auto& renderUnits = this->Pipeline.RenderUnits;
+        this->Pipeline.TransparentObjectsOrder.SortBackToFront(this->Pipeline.TransparentObjects.DrawCommands, this->Pipeline.SortScratch,
+            [&camera, &renderUnits](const RenderDrawCommand& command)
+            {
+                const auto& unit = renderUnits[command.UnitIndex];
+                auto distance = camera.ViewportPosition - 0.5f * (unit.MinAABB + unit.MaxAABB);
+                return Dot(distance, distance);
+            });
+    }
+
     void RenderController::DrawTransparentObjects(CameraUnit& camera)
     {
         if (this->Pipeline.TransparentObjects.UnitsIndex.empty()) return;
@@ -508,7 +972,8 @@ namespace MxEngine
             shader->SetUniform(MxFormat("lightDepthMaps[{}]", i), this->Pipeline.Environment.DefaultShadowMap->GetBoundId());
         }
 
-        this->DrawObjects(camera, *shader, this->Pipeline.TransparentObjects);
+        this->SortTransparentObjects(camera);
+        this->DrawObjects(camera, *shader, this->Pipeline.TransparentObjects, false);
     }
 
     void RenderController::DrawIBL(CameraUnit& camera, TextureHandle& output)
@@ -862,22 +1327,32 @@ namespace MxEngine
         auto viewportSize = MakeVector2((float)camera.OutputTexture->GetWidth(), (float)camera.OutputTexture->GetHeight());
 
         shader->SetUniform("viewportSize", viewportSize);
-        shader->SetUniform("castsShadows", true);
 
         Texture::TextureBindId textureId = 0;
         this->BindGBuffer(camera, *shader, textureId);
         this->BindCameraInformation(camera, *shader);
         
         shader->SetUniform("lightDepthMap", textureId);
+        // all shadowed spot lights share the same atlas
+        this->Pipeline.Environment.ShadowAtlas->Bind(textureId);
 
         pyramid.GetVAO()->Bind();
 
+        float atlasSize = (float)this->Pipeline.Environment.ShadowAtlas->GetWidth();
         for (size_t i = 0; i < spotLights.size(); i++)
         {
             const auto& spotLight = spotLights[i];
+            const auto& tile = spotLight.ShadowTile;
 
-            spotLight.ShadowMap->Bind(textureId);
+            // shadow filtering samples neighbour texels, so limits are moved inside tile to not read other lights
+            constexpr float TileBorderTexels = 1.5f;
+            Vector4 shadowMapLimits{
+                (tile.X + TileBorderTexels) / atlasSize, (tile.X + tile.Size - TileBorderTexels) / atlasSize,
+                (tile.Y + TileBorderTexels) / atlasSize, (tile.Y + tile.Size - TileBorderTexels) / atlasSize,
+            };
 
+            shader->SetUniform("castsShadows", tile.IsValid());
+            shader->SetUniform("shadowMapLimits", shadowMapLimits);
             shader->SetUniform("worldToLightTransform", spotLight.BiasedProjectionMatrix);
 
             shader->SetUniform("transform", spotLight.Transform);
@@ -885,7 +1360,7 @@ namespace MxEngine
             shader->SetUniform("lightDirection", Vector4(spotLight.Direction, spotLight.OuterAngle));
             shader->SetUniform("colorParameters", Vector4(spotLight.Color, spotLight.AmbientIntensity));
 
-            this->DrawIndices(RenderPrimitive::TRIANGLES, pyramid.GetIndexCount(), pyramid.GetIndexOffset(), pyramid.GetVertexOffset(), 0, 0);
+            this->DrawIndices(RenderPrimitive::TRIANGLES, pyramid.GetIndexCount(), pyramid.GetIndexOffset(), pyramid.GetVertexOffset(), 0, 0, pyramid.GetIndexFormat());
         }
     }
 
@@ -925,10 +1400,50 @@ namespace MxEngine
             shader->SetUniform("sphereParameters", Vector4(pointLight.Position, pointLight.Radius));
             shader->SetUniform("colorParameters", Vector4(pointLight.Color, pointLight.AmbientIntensity));
 
-            this->DrawIndices(RenderPrimitive::TRIANGLES, sphere.GetIndexCount(), sphere.GetIndexOffset(), sphere.GetVertexOffset(), 0, 0);
+            this->DrawIndices(RenderPrimitive::TRIANGLES, sphere.GetIndexCount(), sphere.GetIndexOffset(), sphere.GetVertexOffset(), 0, 0, sphere.GetIndexFormat());
         }
     }
 
+    void RenderController::DrawClusteredLights(CameraUnit& camera, TextureHandle& output)
+    {
+        auto& lighting = this->Pipeline.Lighting;
+        if (lighting.ClusteredPointLights.empty() && lighting.ClusteredSpotLights.empty()) return;
+        MAKE_RENDER_PASS_SCOPE("RenderController::DrawClusteredLights()");
+
+        auto& environment = this->Pipeline.Environment;
+        {
+            MAKE_SCOPE_PROFILER("LightClusterBuilder::Build()");
+            lighting.ClusterBuilder.SetCamera(camera.ViewProjectionMatrix, camera.ZNear, camera.ZFar);
+            lighting.ClusterBuilder.Build(lighting.ClusteredPointLights, lighting.ClusteredSpotLights, lighting.Clusters);
+        }
+        environment.LightClusterSSBO->BufferSubDataWithResize(lighting.Clusters.Clusters.data(), lighting.Clusters.Clusters.size());
+        environment.LightIndexSSBO->BufferSubDataWithResize(lighting.Clusters.LightIndices.data(), lighting.Clusters.LightIndices.size());
+
+        this->Pipeline.Statistics.AddEntry(RenderCounter::CLUSTERED_LIGHTS, lighting.Clusters.VisibleLightCount);
+        this->Pipeline.Statistics.AddEntry(RenderCounter::CLUSTER_LIGHT_INDICES, lighting.Clusters.LightIndices.size());
+
+        auto& shader = environment.Shaders["ClusteredLighting"_id];
+        shader->Bind();
+        shader->IgnoreNonExistingUniform("albedoTex");
+        shader->IgnoreNonExistingUniform("materialTex");
+
+        Texture::TextureBindId textureId = 0;
+        this->BindGBuffer(camera, *shader, textureId);
+        this->BindCameraInformation(camera, *shader);
+
+        shader->SetUniform("clusterCount", VectorInt3(
+            (int)LightClusterBuilder::ClusterCountX, (int)LightClusterBuilder::ClusterCountY, (int)LightClusterBuilder::ClusterCountZ
+        ));
+        shader->SetUniform("clusterSliceParameters", Vector2(lighting.Clusters.SliceScale, lighting.Clusters.SliceBias));
+
+        environment.ClusteredPointLightSSBO->BindBase(3);
+        environment.ClusteredSpotLightSSBO->BindBase(4);
+        environment.LightClusterSSBO->BindBase(5);
+        environment.LightIndexSSBO->BindBase(6);
+
+        this->RenderToTextureNoClear(output, shader);
+    }
+
     void RenderController::DrawNonShadowedPointLights(CameraUnit& camera, TextureHandle& output)
     {
         auto& instancedPointLights = this->Pipeline.Lighting.PointLightsInstanced;
@@ -956,7 +1471,8 @@ namespace MxEngine
 
         this->DrawIndices(RenderPrimitive::TRIANGLES, 
             instancedPointLights.GetIndexCount(), instancedPointLights.GetIndexOffset(), 
-            instancedPointLights.GetVertexOffset(), instancedPointLights.Instances.size(), 0
+            instancedPointLights.GetVertexOffset(), instancedPointLights.Instances.size(), 0,
+            instancedPointLights.GetIndexFormat()
         );
     }
 
@@ -987,14 +1503,50 @@ namespace MxEngine
 
         this->DrawIndices(RenderPrimitive::TRIANGLES, 
             instancedSpotLights.GetIndexCount(), instancedSpotLights.GetIndexOffset(), 
-            instancedSpotLights.GetVertexOffset(), instancedSpotLights.Instances.size(), 0
+            instancedSpotLights.GetVertexOffset(), instancedSpotLights.Instances.size(), 0,
+            instancedSpotLights.GetIndexFormat()
         );
     }
 
     void RenderController::SubmitInstancedLights()
     {
-        this->Pipeline.Lighting.PointLightsInstanced.SubmitToVBO();
-        this->Pipeline.Lighting.SpotLightsInstanced.SubmitToVBO();
+        auto& lighting = this->Pipeline.Lighting;
+        if (!this->Pipeline.Environment.UseClusteredLighting)
+        {
+            lighting.PointLightsInstanced.SubmitToVBO();
+            lighting.SpotLightsInstanced.SubmitToVBO();
+        }
+        else
+        {
+            // orthographic cameras can not be clustered by depth, so light volumes are still used for them
+            bool hasOrthographicCameras = std::any_of(this->Pipeline.Cameras.begin(), this->Pipeline.Cameras.end(),
+                [](const CameraUnit& camera) { return !camera.IsPerspective; });
+            if (hasOrthographicCameras)
+            {
+                lighting.PointLightsInstanced.SubmitToVBO();
+                lighting.SpotLightsInstanced.SubmitToVBO();
+            }
+
+            lighting.ClusteredPointLights.resize(lighting.PointLightsInstanced.Instances.size());
+            for (size_t i = 0; i < lighting.ClusteredPointLights.size(); i++)
+            {
+                const auto& instance = lighting.PointLightsInstanced.Instances[i];
+                lighting.ClusteredPointLights[i] = ClusteredPointLight{ instance.Position, instance.Radius, instance.Color, instance.AmbientIntensity };
+            }
+
+            lighting.ClusteredSpotLights.resize(lighting.SpotLightsInstanced.Instances.size());
+            for (size_t i = 0; i < lighting.ClusteredSpotLights.size(); i++)
+            {
+                const auto& instance = lighting.SpotLightsInstanced.Instances[i];
+                lighting.ClusteredSpotLights[i] = ClusteredSpotLight{ 
+                    instance.Position, instance.InnerAngle, instance.Direction, instance.OuterAngle, instance.Color, instance.AmbientIntensity
+                };
+            }
+
+            auto& environment = this->Pipeline.Environment;
+            environment.ClusteredPointLightSSBO->BufferSubDataWithResize(lighting.ClusteredPointLights.data(), lighting.ClusteredPointLights.size());
+            environment.ClusteredSpotLightSSBO->BufferSubDataWithResize(lighting.ClusteredSpotLights.data(), lighting.ClusteredSpotLights.size());
+        }
     }
 
     void RenderController::BindFogInformation(const CameraUnit& camera, const Shader& shader)
@@ -1092,6 +1644,20 @@ namespace MxEngine
         this->AttachFrameBufferNoClear(framebuffer);
     }
 
+    void RenderController::AttachDepthMapTile(const TextureHandle& texture, const ShadowAtlasTile& tile, bool clearTile)
+    {
+        this->AttachDepthMapNoClear(texture);
+        this->SetViewport((int)tile.X, (int)tile.Y, (int)tile.Size, (int)tile.Size);
+        if (clearTile)
+        {
+            // other tiles of atlas may be cached, so only region of this tile is cleared
+            this->GetRenderEngine().UseScissorTest(true);
+            this->GetRenderEngine().SetScissor((int)tile.X, (int)tile.Y, (int)tile.Size, (int)tile.Size);
+            this->Clear();
+            this->GetRenderEngine().UseScissorTest(false);
+        }
+    }
+
     void RenderController::AttachFrameBuffer(const FrameBufferHandle& framebuffer)
     {
         this->AttachFrameBufferNoClear(framebuffer);
@@ -1110,12 +1676,14 @@ namespace MxEngine
         // doing this allows us to render to application window
         this->Pipeline.Environment.DepthFrameBuffer->Unbind();
         this->SetViewport(0, 0, this->Pipeline.Environment.Viewport.x, this->Pipeline.Environment.Viewport.y);
-        this->Clear();
+        // offscreen context may be surfaceless, so clearing default framebuffer is an error
+        if (this->Pipeline.Environment.HasDefaultFrameBuffer)
+            this->Clear();
     }
 
     void RenderController::RenderToAttachedFrameBuffer(const Shader& shader)
     {
-        this->Pipeline.Statistics.AddEntry("renders to framebuffer", 1);
+        this->Pipeline.Statistics.AddEntry(RenderCounter::RENDERS_TO_FRAMEBUFFER, 1);
         auto& rectangle = this->Pipeline.Environment.RectangularObject;
         shader.Bind();
 
@@ -1182,8 +1750,10 @@ namespace MxEngine
 
     void RenderController::DrawVertices(RenderPrimitive primitive, size_t vertexCount, size_t vertexOffset, size_t instanceCount, size_t baseInstance)
     {
-        this->Pipeline.Statistics.AddEntry("draw calls", 1);
-        this->Pipeline.Statistics.AddEntry("drawn vertecies", vertexCount * Max(baseInstance, 1));
+        this->Pipeline.Statistics.AddEntry(RenderCounter::DRAW_CALLS, 1);
+        this->Pipeline.Statistics.AddEntry(RenderCounter::DRAWN_VERTECIES, vertexCount * Max(instanceCount, 1));
+        if (primitive == RenderPrimitive::TRIANGLES)
+            this->Pipeline.Statistics.AddEntry(RenderCounter::DRAWN_TRIANGLES, vertexCount / 3 * Max(instanceCount, 1));
         if (instanceCount == 0)
         {
             this->GetRenderEngine().DrawVertices(primitive, vertexCount, vertexOffset);
@@ -1194,20 +1764,38 @@ namespace MxEngine
         }
     }
 
-    void RenderController::DrawIndices(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t baseVertex, size_t instanceCount, size_t baseInstance)
+    void RenderController::DrawIndices(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t baseVertex, size_t instanceCount, size_t baseInstance, IndexFormat indexFormat)
     {
-        this->Pipeline.Statistics.AddEntry("draw calls", 1);
-        this->Pipeline.Statistics.AddEntry("drawn vertecies", indexCount * Max(instanceCount, 1));
+        this->Pipeline.Statistics.AddEntry(RenderCounter::DRAW_CALLS, 1);
+        this->Pipeline.Statistics.AddEntry(RenderCounter::DRAWN_VERTECIES, indexCount * Max(instanceCount, 1));
+        if (primitive == RenderPrimitive::TRIANGLES)
+            this->Pipeline.Statistics.AddEntry(RenderCounter::DRAWN_TRIANGLES, indexCount / 3 * Max(instanceCount, 1));
         if (instanceCount == 0)
         {
-            this->GetRenderEngine().DrawIndicesBaseVertex(primitive, indexCount, indexOffset, baseVertex);
+            this->GetRenderEngine().DrawIndicesBaseVertex(primitive, indexCount, indexOffset, baseVertex, indexFormat);
         }
         else
         {
-            this->GetRenderEngine().DrawIndicesBaseVertexInstanced(primitive, indexCount, indexOffset, baseVertex, instanceCount, baseInstance);
+            this->GetRenderEngine().DrawIndicesBaseVertexInstanced(primitive, indexCount, indexOffset, baseVertex, instanceCount, baseInstance, indexFormat);
         }
     }
 
+    void RenderController::DrawIndicesIndirect(RenderPrimitive primitive, size_t commandOffset, size_t commandCount, IndexFormat indexFormat)
+    {
+        const auto& commands = this->Pipeline.IndirectDraws.Commands;
+        size_t vertexCount = 0;
+        for (size_t i = commandOffset; i < commandOffset + commandCount; i++)
+            vertexCount += (size_t)commands[i].IndexCount * commands[i].InstanceCount;
+
+        this->Pipeline.Statistics.AddEntry(RenderCounter::DRAW_CALLS, 1);
+        this->Pipeline.Statistics.AddEntry(RenderCounter::INDIRECT_DRAWS, commandCount);
+        this->Pipeline.Statistics.AddEntry(RenderCounter::DRAWN_OBJECTS, commandCount);
+        this->Pipeline.Statistics.AddEntry(RenderCounter::DRAWN_VERTECIES, vertexCount);
+        if (primitive == RenderPrimitive::TRIANGLES)
+            this->Pipeline.Statistics.AddEntry(RenderCounter::DRAWN_TRIANGLES, vertexCount / 3);
+        this->GetRenderEngine().DrawIndicesIndirect(primitive, commandOffset, commandCount, indexFormat);
+    }
+
     void RenderController::ToggleDepthOnlyMode(bool value)
     {
         bool useColor = !value;
@@ -1268,18 +1856,35 @@ namespace MxEngine
 
     void RenderController::DrawDebugBuffer(const CameraUnit& camera)
     {
-        if (this->Pipeline.Environment.DebugBufferObject.VertexCount == 0) return;
+        auto& debugBuffer = this->Pipeline.Environment.DebugBufferObject;
+        bool hasShapes = std::any_of(debugBuffer.ShapeBatches.begin(), debugBuffer.ShapeBatches.end(),
+            [](const DebugShapeBatch& batch) { return batch.InstanceCount > 0; });
+        if (debugBuffer.VertexCount == 0 && !hasShapes) return;
         MAKE_RENDER_PASS_SCOPE("RenderController::DrawDebugBuffer()");
 
-        auto& shader = *this->Pipeline.Environment.Shaders["DebugDraw"_id];
-        shader.Bind();
-        shader.SetUniform("ViewProjMatrix", camera.ViewProjectionMatrix);
+        if (debugBuffer.VertexCount > 0)
+        {
+            auto& shader = *this->Pipeline.Environment.Shaders["DebugDraw"_id];
+            shader.Bind();
+            shader.SetUniform("ViewProjMatrix", camera.ViewProjectionMatrix);
 
-        // TODO: refactor
-        auto& VAO = *this->Pipeline.Environment.DebugBufferObject.VAO;
-        VAO.Bind();
+            debugBuffer.VAO->Bind();
+            this->DrawVertices(RenderPrimitive::LINES, debugBuffer.VertexCount, debugBuffer.VertexOffset, 0, 0);
+        }
+
+        if (hasShapes)
+        {
+            auto& shader = *this->Pipeline.Environment.Shaders["DebugDrawInstanced"_id];
+            shader.Bind();
+            shader.SetUniform("ViewProjMatrix", camera.ViewProjectionMatrix);
 
-        this->DrawVertices(RenderPrimitive::LINES, this->Pipeline.Environment.DebugBufferObject.VertexCount, 0, 0, 0);
+            debugBuffer.InstancedVAO->Bind();
+            for (const auto& batch : debugBuffer.ShapeBatches)
+            {
+                if (batch.InstanceCount == 0) continue;
+                this->DrawVertices(RenderPrimitive::LINES, batch.VertexCount, batch.VertexOffset, batch.InstanceCount, batch.BaseInstance);
+            }
+        }
     }
 
     EnvironmentUnit& RenderController::GetEnvironment()
@@ -1302,6 +1907,16 @@ namespace MxEngine
         return this->Pipeline.Lighting;
     }
 
+    OcclusionSystem& RenderController::GetOcclusionInformation()
+    {
+        return this->Pipeline.Occlusion;
+    }
+
+    const OcclusionSystem& RenderController::GetOcclusionInformation() const
+    {
+        return this->Pipeline.Occlusion;
+    }
+
     const RenderStatistics& RenderController::GetRenderStatistics() const
     {
         return this->Pipeline.Statistics;
@@ -1322,19 +1937,28 @@ namespace MxEngine
         this->Pipeline.Lighting.SpotLights.clear();
         this->Pipeline.ShadowCasters.Groups.clear();
         this->Pipeline.ShadowCasters.UnitsIndex.clear();
+        this->Pipeline.ShadowCasters.DrawCommands.clear();
         this->Pipeline.MaskedShadowCasters.Groups.clear();
         this->Pipeline.MaskedShadowCasters.UnitsIndex.clear();
+        this->Pipeline.MaskedShadowCasters.DrawCommands.clear();
         this->Pipeline.TransparentObjects.Groups.clear();
         this->Pipeline.TransparentObjects.UnitsIndex.clear();
+        this->Pipeline.TransparentObjects.DrawCommands.clear();
         this->Pipeline.MaskedObjects.Groups.clear();
         this->Pipeline.MaskedObjects.UnitsIndex.clear();
+        this->Pipeline.MaskedObjects.DrawCommands.clear();
         this->Pipeline.OpaqueObjects.Groups.clear();
         this->Pipeline.OpaqueObjects.UnitsIndex.clear();
+        this->Pipeline.OpaqueObjects.DrawCommands.clear();
         this->Pipeline.RenderUnits.clear();
+        this->Pipeline.Occlusion.Occluders.clear();
+        this->Pipeline.Occlusion.OccludedUnits.clear();
         this->Pipeline.OpaqueParticleSystems.clear();
         this->Pipeline.TransparentParticleSystems.clear();
         this->Pipeline.MaterialUnits.clear();
+        this->Pipeline.MeshletUnits.clear();
         this->Pipeline.Cameras.clear();
+        this->Pipeline.IsPrepared = false;
     }
 
     void RenderController::SubmitParticleSystem(const ParticleSystem& system, const Material& material, const Transform& parentTransform)
@@ -1347,6 +1971,7 @@ namespace MxEngine
         particleSystem.ParticleLifetime = system.GetParticleLifetime();
         particleSystem.Fading = system.GetFading();
         particleSystem.IsRelative = system.IsRelative();
+        particleSystem.IsSimulatedOnCPU = system.IsSimulatedOnCPU();
         particleSystem.InvocationCount = system.GetMaxParticleCount() / ParticleComputeGroupSize;
         particleSystem.MaterialIndex = this->Pipeline.MaterialUnits.size();
 
@@ -1356,6 +1981,13 @@ namespace MxEngine
         if (!materialCopy.AlbedoMap.IsValid()) materialCopy.AlbedoMap = this->Pipeline.Environment.DefaultMaterialMap;
     }
 
+    template<typename LightComponent>
+    size_t MakeShadowLightKey(const LightComponent& light, bool isSpotLight)
+    {
+        // object may own both spot and point light, so light type is encoded into key
+        return MxObject::GetByComponent(light).GetNativeHandle() * 2 + (isSpotLight ? 1 : 0);
+    }
+
     void RenderController::SubmitLightSource(const DirectionalLight& light, const Transform& parentTransform)
     {
         auto& dirLight = this->Pipeline.Lighting.DirectionalLights.emplace_back();
@@ -1398,6 +2030,7 @@ namespace MxEngine
             baseLightData = &pointLight;
 
             pointLight.ShadowMap = light.DepthMap;
+            pointLight.LightKey = MakeShadowLightKey(light, false);
             for (size_t i = 0; i < std::size(pointLight.ProjectionMatrices); i++)
                 pointLight.ProjectionMatrices[i] = light.GetMatrix(i, parentTransform.GetPosition());
         }
@@ -1422,9 +2055,10 @@ namespace MxEngine
             auto& spotLight = this->Pipeline.Lighting.SpotLights.emplace_back();
             baseLightData = &spotLight;
 
+            // biased matrix depends on atlas tile, so it is computed when tiles are allocated (see ScheduleShadowMapUpdates)
             spotLight.ProjectionMatrix = light.GetMatrix(parentTransform.GetPosition());
-            spotLight.BiasedProjectionMatrix = MakeBiasMatrix() * light.GetMatrix(parentTransform.GetPosition());
-            spotLight.ShadowMap = light.DepthMap;
+            spotLight.ShadowMap = this->Pipeline.Environment.ShadowAtlas;
+            spotLight.LightKey = MakeShadowLightKey(light, true);
         }
         else
         {
@@ -1461,6 +2095,8 @@ namespace MxEngine
 
         camera.ViewportPosition           = parentTransform.GetPosition();
         camera.AspectRatio                = controller.Camera.GetAspectRatio();
+        camera.ZNear                      = controller.Camera.GetZNear();
+        camera.ZFar                       = controller.Camera.GetZFar();
         camera.StaticViewProjectionMatrix = controller.GetMatrix(MakeVector3(0.0f));
         camera.ViewProjectionMatrix       = controller.GetMatrix(parentTransform.GetPosition());
         camera.InverseViewProjMatrix      = Inverse(camera.ViewProjectionMatrix);
@@ -1512,7 +2148,7 @@ namespace MxEngine
         return renderGroupIndex;
     }
 
-    void RenderController::SubmitRenderUnit(size_t renderGroupIndex, const SubMesh& submesh, const Material& material, const Transform& parentTransform, bool castsShadow, const char* debugName)
+    void RenderController::SubmitRenderUnit(size_t renderGroupIndex, const SubMesh& submesh, const Material& material, const Transform& parentTransform, bool castsShadow, bool isStatic, const char* debugName)
     {
         bool isInvisible = material.Transparency == 0.0f;
         bool isTransparent = material.AlphaMode == AlphaModeGroup::TRANSPARENT;
@@ -1525,10 +2161,16 @@ namespace MxEngine
         renderUnit.MaterialIndex = this->Pipeline.MaterialUnits.size();
         renderUnit.IndexCount = submesh.Data.GetIndiciesCount();
         renderUnit.IndexOffset = submesh.Data.GetIndiciesOffset();
+        renderUnit.IndexType = submesh.Data.GetIndexFormat();
+        const auto& meshlets = submesh.Data.GetMeshlets();
+        renderUnit.MeshletOffset = this->Pipeline.MeshletUnits.size();
+        renderUnit.MeshletCount = meshlets.size();
+        this->Pipeline.MeshletUnits.insert(this->Pipeline.MeshletUnits.end(), meshlets.begin(), meshlets.end());
         renderUnit.VertexCount = submesh.Data.GetVerteciesCount();
         renderUnit.VertexOffset = submesh.Data.GetVerteciesOffset();
         renderUnit.ModelMatrix = parentTransform.GetMatrix() * submesh.GetTransform().GetMatrix(); //-V807
         renderUnit.NormalMatrix = parentTransform.GetNormalMatrix() * submesh.GetTransform().GetNormalMatrix();
+        renderUnit.IsStatic = isStatic;
 
         #if defined(MXENGINE_DEBUG)
         renderUnit.DebugName = debugName;
@@ -1582,6 +2224,19 @@ namespace MxEngine
         if (!renderMaterial.AmbientOcclusionMap.IsValid()) renderMaterial.AmbientOcclusionMap = this->Pipeline.Environment.DefaultMaterialMap;
         if (!renderMaterial.NormalMap.IsValid())           renderMaterial.NormalMap = this->Pipeline.Environment.DefaultNormalMap;
         if (!renderMaterial.HeightMap.IsValid())           renderMaterial.HeightMap = this->Pipeline.Environment.DefaultBlackMap;
+
+        // depth bucket is filled later, when camera position is known (see BuildDrawCommands)
+        auto& environment = this->Pipeline.Environment;
+        StringId shaderName = isTransparent ? "Transparent"_id : (isMasked ? "GBufferMask"_id : (environment.UseIndirectDrawing ? "GBufferIndirect"_id : "GBuffer"_id));
+        uint64_t pass = isTransparent ? 2 : (isMasked ? 1 : 0);
+        uint64_t shader = MakeShaderSortId(environment.Shaders[shaderName]);
+        renderUnit.SortKey = RenderSortKey::Make(pass, shader, MakeMaterialSortId(renderMaterial), MakeMeshSortId(renderUnit), 0);
+    }
+
+    void RenderController::SubmitOccluder(const OccluderGeometry& geometry, const Matrix4x4& transform)
+    {
+        if (geometry.Indicies.empty()) return;
+        this->Pipeline.Occlusion.Occluders.push_back(OccluderInstance{ &geometry, transform });
     }
 
     void RenderController::SubmitImage(const TextureHandle& texture, int lod)
@@ -1612,6 +2267,7 @@ namespace MxEngine
         this->ComputeParticles(this->Pipeline.OpaqueParticleSystems);
         this->ComputeParticles(this->Pipeline.TransparentParticleSystems);
 
+        this->PrepareRenderLists();
         this->PrepareShadowMaps();
 
         for (auto& camera : this->Pipeline.Cameras)
@@ -1622,13 +2278,17 @@ namespace MxEngine
             this->GetRenderEngine().UseBlendFactors(BlendFactor::ONE, BlendFactor::ZERO);
             this->ToggleReversedDepth(camera.IsPerspective);
             this->AttachFrameBuffer(camera.GBuffer);
+            this->PrepareOcclusionCulling(camera);
 
-            this->DrawObjects(camera, *this->Pipeline.Environment.Shaders["GBuffer"_id], this->Pipeline.OpaqueObjects);
-            this->DrawObjects(camera, *this->Pipeline.Environment.Shaders["GBufferMask"_id], this->Pipeline.MaskedObjects);
+            if (this->Pipeline.Environment.UseIndirectDrawing)
+                this->DrawObjectsIndirect(camera, *this->Pipeline.Environment.Shaders["GBufferIndirect"_id], this->Pipeline.OpaqueObjects);
+            else
+                this->DrawObjects(camera, *this->Pipeline.Environment.Shaders["GBuffer"_id], this->Pipeline.OpaqueObjects, true);
+            this->DrawObjects(camera, *this->Pipeline.Environment.Shaders["GBufferMask"_id], this->Pipeline.MaskedObjects, true);
 
             this->GenerateDepthPyramid(camera.DepthTexture);
 
-            this->DrawParticles(camera, this->Pipeline.OpaqueParticleSystems, *this->Pipeline.Environment.Shaders["ParticleOpaque"_id]);
+            this->DrawParticles(camera, this->Pipeline.OpaqueParticleSystems, this->Pipeline.OpaqueParticlesOrder, *this->Pipeline.Environment.Shaders["ParticleOpaque"_id]);
 
             this->PerformLightPass(camera);
             this->PerformPostProcessing(camera);
@@ -46,25 +46,35 @@ namespace MxEngine
     class Mesh;
     class ParticleSystem;
     class Transform;
+    class ShadowMapGenerator;
 
     class RenderController
     {
         Renderer renderer;
         RenderPipeline Pipeline;
 
+        void ScheduleShadowMapUpdates(const ShadowMapGenerator& generatorOpaque, const ShadowMapGenerator& generatorMasked);
         void PrepareShadowMaps();
         void DrawSkybox(const CameraUnit& camera);
         void ComputeParticles(const MxVector<ParticleSystemUnit>& particleSystems);
-        void SortParticles(const CameraUnit& camera, MxVector<ParticleSystemUnit>& particleSystems);
-        void DrawParticles(const CameraUnit& camera, MxVector<ParticleSystemUnit>& particleSystems, const Shader& shader);
-        void DrawObjects(const CameraUnit& camera, const Shader& shader, const RenderList& objects);
+        void SortParticles(const CameraUnit& camera, MxVector<ParticleSystemUnit>& particleSystems, DepthSorter& sorter);
+        void DrawParticles(const CameraUnit& camera, MxVector<ParticleSystemUnit>& particleSystems, DepthSorter& sorter, const Shader& shader);
+        void PrepareRenderLists();
+        void PrepareOcclusionCulling(const CameraUnit& camera);
+        bool IsUnitOccluded(size_t unitIndex) const;
+        void BuildDrawCommands(RenderList& objects, const Vector3& viewPosition, bool sortByState);
+        // meshlet culling includes back-face cone test, so it must be disabled for passes without face culling
+        void DrawObjects(const CameraUnit& camera, const Shader& shader, const RenderList& objects, bool useMeshletCulling);
+        void DrawObjectsIndirect(const CameraUnit& camera, const Shader& shader, const RenderList& objects);
         void DrawDebugBuffer(const CameraUnit& camera);
-        void DrawObject(const RenderUnit& unit, size_t instanceCount, size_t baseInstance, const Shader& shader);
+        void DrawObject(const RenderUnit& unit, size_t instanceCount, size_t baseInstance, const Shader& shader, const Material* previousMaterial, ArrayView<MeshletDrawRange> meshletRanges);
+        void BindMaterialTextures(const Material& material, const Material* previousMaterial);
         void ComputeBloomEffect(CameraUnit& camera, const TextureHandle& output);
         TextureHandle ComputeAverageWhite(CameraUnit& camera);
         void GenerateDepthPyramid(TextureHandle& depth);
         void PerformPostProcessing(CameraUnit& camera);
         void PerformLightPass(CameraUnit& camera);
+        void SortTransparentObjects(const CameraUnit& camera);
         void DrawTransparentObjects(CameraUnit& camera);
         void ApplyFogEffect(CameraUnit& camera, TextureHandle& input, TextureHandle& output); 
         void ApplyGodRayEffect(CameraUnit& camera, TextureHandle& input, TextureHandle& output);
@@ -81,6 +91,7 @@ namespace MxEngine
         void DrawDirectionalLights(CameraUnit& camera, TextureHandle& output);
         void DrawShadowedPointLights(CameraUnit& camera, TextureHandle& output);
         void DrawShadowedSpotLights(CameraUnit& camera, TextureHandle& output);
+        void DrawClusteredLights(CameraUnit& camera, TextureHandle& output);
         void DrawNonShadowedPointLights(CameraUnit& camera, TextureHandle& output);
         void DrawNonShadowedSpotLights(CameraUnit& camera, TextureHandle& output);
         void SubmitInstancedLights();
@@ -110,6 +121,7 @@ namespace MxEngine
         void AttachDepthMap(const CubeMapHandle& cubemap);
         void AttachDepthMapNoClear(const TextureHandle& texture);
         void AttachDepthMapNoClear(const CubeMapHandle& cubemap);
+        void AttachDepthMapTile(const TextureHandle& texture, const ShadowAtlasTile& tile, bool clearTile);
         void RenderToFrameBuffer(const FrameBufferHandle& framebuffer, const ShaderHandle& shader);
         void RenderToFrameBufferNoClear(const FrameBufferHandle& framebuffer, const ShaderHandle& shader);
         void RenderToTexture(const TextureHandle& texture, const ShaderHandle& shader, Attachment attachment = Attachment::COLOR_ATTACHMENT0);
@@ -117,12 +129,15 @@ namespace MxEngine
         void CopyTexture(const TextureHandle& input, const TextureHandle& output, int lod = 0);
         void ApplyGaussianBlur(const TextureHandle& inputOutput, const TextureHandle& temporary, size_t iterations, float sampleInterval = 1.0f);
         void DrawVertices(RenderPrimitive primitive, size_t vertexCount, size_t vertexOffset, size_t instanceCount, size_t baseInstance);
-        void DrawIndices(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t baseVertex, size_t instanceCount, size_t baseInstance);
+        void DrawIndices(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t baseVertex, size_t instanceCount, size_t baseInstance, IndexFormat indexFormat = IndexFormat::UINT32);
+        void DrawIndicesIndirect(RenderPrimitive primitive, size_t commandOffset, size_t commandCount, IndexFormat indexFormat);
 
         EnvironmentUnit& GetEnvironment();
         const EnvironmentUnit& GetEnvironment() const;
         LightingSystem& GetLightInformation();
         const LightingSystem& GetLightInformation() const;
+        OcclusionSystem& GetOcclusionInformation();
+        const OcclusionSystem& GetOcclusionInformation() const;
         const RenderStatistics& GetRenderStatistics() const;
         RenderStatistics& GetRenderStatistics();
         void ResetPipeline();
@@ -134,8 +149,10 @@ namespace MxEngine
             const Skybox* skybox, const CameraEffects* effects, const CameraToneMapping* toneMapping,
             const CameraSSR* ssr, const CameraSSGI* ssgi, const CameraSSAO* ssao,const CameraGodRay* godRay);
         size_t SubmitRenderGroup(const Mesh& mesh, size_t instanceOffset, size_t instanceCount);
-        void SubmitRenderUnit(size_t renderGroupIndex, const SubMesh& object, const Material& material, const Transform& parentTransform, bool castsShadow, const char* debugName = nullptr);
+        void SubmitRenderUnit(size_t renderGroupIndex, const SubMesh& object, const Material& material, const Transform& parentTransform, bool castsShadow, bool isStatic, const char* debugName = nullptr);
+        void SubmitOccluder(const OccluderGeometry& geometry, const Matrix4x4& transform);
         void SubmitImage(const TextureHandle& texture, int lod = 0);
+        void PreparePipeline();
         void StartPipeline();
         void EndPipeline();
     };
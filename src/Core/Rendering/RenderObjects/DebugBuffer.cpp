@@ -37,66 +37,58 @@
 #include "Core/BoundingObjects/Line.h"
 #include "Core/BoundingObjects/Rectangle.h"
 #include "Core/BoundingObjects/Circle.h"
+#include "Core/Resources/StreamBufferAllocator.h"
+
+#include <cstring>
 
 namespace MxEngine
 {
-    void DebugBuffer::Init()
+    static std::array<VertexAttribute, 2> GetDebugVertexLayout()
     {
-        std::array vertexLayout = {
+        return {
             VertexAttribute::Entry<Vector3>(),
             VertexAttribute::Entry<Vector4>(),
         };
+    }
 
-        this->VBO = Factory<VertexBuffer>::Create(nullptr, 0, UsageType::STATIC_DRAW);
-        this->VAO = Factory<VertexArray>::Create();
-        VAO->AddVertexLayout(*this->VBO, vertexLayout, VertexAttributeInputRate::PER_VERTEX);
+    static std::array<VertexAttribute, 1> GetDebugShapeLayout()
+    {
+        return {
+            VertexAttribute::Entry<Vector3>(),
+        };
     }
 
-    void DebugBuffer::Submit(const Line& line, const Vector4& color)
+    static std::array<VertexAttribute, 2> GetDebugInstanceLayout()
     {
-        this->storage.push_back({ line.p1, color });
-        this->storage.push_back({ line.p2, color });
+        return {
+            VertexAttribute::Entry<Matrix3x4>(), // model rows
+            VertexAttribute::Entry<Vector4>(),   // color
+        };
     }
 
-    void DebugBuffer::Submit(const AABB& box, const Vector4& color)
+    template<typename Points>
+    static void PushLineLoop(std::vector<Vector3>& linesData, const Points& points)
     {
-        this->storage.push_back({ MakeVector3(box.Min.x, box.Min.y, box.Min.z), color });
-        this->storage.push_back({ MakeVector3(box.Max.x, box.Min.y, box.Min.z), color });
-        this->storage.push_back({ MakeVector3(box.Min.x, box.Min.y, box.Min.z), color });
-        this->storage.push_back({ MakeVector3(box.Min.x, box.Max.y, box.Min.z), color });
-        this->storage.push_back({ MakeVector3(box.Min.x, box.Min.y, box.Min.z), color });
-        this->storage.push_back({ MakeVector3(box.Min.x, box.Min.y, box.Max.z), color });
-        this->storage.push_back({ MakeVector3(box.Max.x, box.Max.y, box.Max.z), color });
-        this->storage.push_back({ MakeVector3(box.Min.x, box.Max.y, box.Max.z), color });
-        this->storage.push_back({ MakeVector3(box.Max.x, box.Max.y, box.Max.z), color });
-        this->storage.push_back({ MakeVector3(box.Max.x, box.Min.y, box.Max.z), color });
-        this->storage.push_back({ MakeVector3(box.Max.x, box.Max.y, box.Max.z), color });
-        this->storage.push_back({ MakeVector3(box.Max.x, box.Max.y, box.Min.z), color });
-        this->storage.push_back({ MakeVector3(box.Min.x, box.Max.y, box.Min.z), color });
-        this->storage.push_back({ MakeVector3(box.Min.x, box.Max.y, box.Max.z), color });
-        this->storage.push_back({ MakeVector3(box.Min.x, box.Max.y, box.Min.z), color });
-        this->storage.push_back({ MakeVector3(box.Max.x, box.Max.y, box.Min.z), color });
-        this->storage.push_back({ MakeVector3(box.Max.x, box.Min.y, box.Max.z), color });
-        this->storage.push_back({ MakeVector3(box.Max.x, box.Min.y, box.Min.z), color });
-        this->storage.push_back({ MakeVector3(box.Max.x, box.Min.y, box.Max.z), color });
-        this->storage.push_back({ MakeVector3(box.Min.x, box.Min.y, box.Max.z), color });
-        this->storage.push_back({ MakeVector3(box.Min.x, box.Min.y, box.Max.z), color });
-        this->storage.push_back({ MakeVector3(box.Min.x, box.Max.y, box.Max.z), color });
-        this->storage.push_back({ MakeVector3(box.Max.x, box.Min.y, box.Min.z), color });
-        this->storage.push_back({ MakeVector3(box.Max.x, box.Max.y, box.Min.z), color });
+        for (size_t i = 1; i < points.size(); i++)
+        {
+            linesData.push_back(points[i - 1]);
+            linesData.push_back(points[i]);
+        }
+        linesData.push_back(points.back());
+        linesData.push_back(points.front());
     }
 
-    void DebugBuffer::Submit(const BoundingBox& box, const Vector4 color)
+    static std::vector<Vector3> InitializeBox()
     {
         std::array points = {
-            MakeVector3(box.Min.x, box.Min.y, box.Min.z),
-            MakeVector3(box.Max.x, box.Min.y, box.Min.z),
-            MakeVector3(box.Min.x, box.Max.y, box.Min.z),
-            MakeVector3(box.Min.x, box.Min.y, box.Max.z),
-            MakeVector3(box.Max.x, box.Max.y, box.Max.z),
-            MakeVector3(box.Min.x, box.Max.y, box.Max.z),
-            MakeVector3(box.Max.x, box.Min.y, box.Max.z),
-            MakeVector3(box.Max.x, box.Max.y, box.Min.z),
+            MakeVector3(-1.0f, -1.0f, -1.0f),
+            MakeVector3( 1.0f, -1.0f, -1.0f),
+            MakeVector3(-1.0f,  1.0f, -1.0f),
+            MakeVector3(-1.0f, -1.0f,  1.0f),
+            MakeVector3( 1.0f,  1.0f,  1.0f),
+            MakeVector3(-1.0f,  1.0f,  1.0f),
+            MakeVector3( 1.0f, -1.0f,  1.0f),
+            MakeVector3( 1.0f,  1.0f, -1.0f),
         };
 
         std::array lines = {
@@ -113,14 +105,17 @@ namespace MxEngine
             Line{ points[3], points[5] },
             Line{ points[1], points[7] },
         };
+
+        std::vector<Vector3> linesData;
         for (auto& line : lines)
         {
-            this->storage.push_back({ box.Rotation * line.p1 + box.Center, color });
-            this->storage.push_back({ box.Rotation * line.p2 + box.Center, color });
+            linesData.push_back(line.p1);
+            linesData.push_back(line.p2);
         }
+        return linesData;
     }
 
-    auto InitializeSphere()
+    static std::vector<Vector3> InitializeSphere()
     {
         std::vector<Vector3> linesData;
         std::vector<Vector3> vertecies;
@@ -170,34 +165,12 @@ namespace MxEngine
         return linesData;
     }
 
-    void DebugBuffer::Submit(const BoundingSphere& sphere, const Vector4 color)
+    static std::vector<Vector3> InitializeCone()
     {
-        static const auto sphereData = InitializeSphere();
-
-        for (const Vector3& v : sphereData)
-        {
-            this->storage.push_back({ sphere.Radius * v * 1.1f + sphere.Center, color });
-        }
-    }
-
-    void DebugBuffer::Submit(const Cone& cone, const Vector4& color)
-    {
-        auto radius = std::tan(Radians(cone.GetAngle() * 0.5f)) * cone.GetLength();
-        auto normDir = Normalize(cone.Direction);
-        if (cone.GetAngle() > 180.0f) normDir = -normDir;   
-        auto direction = normDir * cone.GetLength();
-
-        Vector3 v{ 0.0f };
-        Vector3 u{ 0.0f };
-        if (direction.y != 0.0f)
-            v = MakeVector3(-normDir.y, normDir.x, 0.0f);
-        else if (direction.z != 0.0f)
-            v = MakeVector3(0.0f, -normDir.z, normDir.y);
-        else
-            v = MakeVector3(-normDir.z, 0.0f, normDir.x);
-
-        v = Normalize(v);
-        u = Normalize(Cross(normDir, v)); //-V519
+        // apex at origin, base circle of radius 1 at z = 1
+        const Vector3 v = MakeVector3(1.0f, 0.0f, 0.0f);
+        const Vector3 u = MakeVector3(0.0f, 1.0f, 0.0f);
+        const Vector3 direction = MakeVector3(0.0f, 0.0f, 1.0f);
 
         std::array circle = {
              v,
@@ -216,57 +189,42 @@ namespace MxEngine
 
         for (auto& point : circle)
         {
-            point = radius * point + direction + cone.Origin;
+            point = point + direction;
         }
 
+        std::vector<Vector3> linesData;
         for (size_t i = 0; i < circle.size(); i += 2)
         {
-            this->storage.push_back({ cone.Origin, color });
-            this->storage.push_back({ circle[i],   color });
-        }
-        for (size_t i = 1; i < circle.size(); i++)
-        {
-            this->storage.push_back({circle[i - 1], color});
-            this->storage.push_back({circle[i],     color});
+            linesData.push_back(MakeVector3(0.0f));
+            linesData.push_back(circle[i]);
         }
-        this->storage.push_back({ circle.back(),  color });
-        this->storage.push_back({ circle.front(), color });
+        PushLineLoop(linesData, circle);
+        return linesData;
     }
 
-    void DebugBuffer::Submit(const Frustrum& frustrum, const Vector4& color)
+    static std::vector<Vector3> InitializeFrustrum()
     {
-        auto normDir = Normalize(frustrum.Direction);
-        auto normUp = Normalize(frustrum.Up);
-
-        auto normRight = Normalize(Cross(normDir, normUp)); //-V537
-        auto right = normRight * frustrum.AspectRatio;
-        auto scale = 2.0f;
-
+        // apex at origin, far plane corners at (+-1, +-1, 1)
         std::array plane = {
-           scale * (std::tan(Radians(frustrum.GetAngle() * 0.5f)) * ( 2.0f * right + 2.0f * normUp) + normDir) + frustrum.Origin,
-           scale * (std::tan(Radians(frustrum.GetAngle() * 0.5f)) * ( 2.0f * right - 2.0f * normUp) + normDir) + frustrum.Origin,
-           scale * (std::tan(Radians(frustrum.GetAngle() * 0.5f)) * (-2.0f * right - 2.0f * normUp) + normDir) + frustrum.Origin,
-           scale * (std::tan(Radians(frustrum.GetAngle() * 0.5f)) * (-2.0f * right + 2.0f * normUp) + normDir) + frustrum.Origin,
+            MakeVector3( 1.0f,  1.0f, 1.0f),
+            MakeVector3( 1.0f, -1.0f, 1.0f),
+            MakeVector3(-1.0f, -1.0f, 1.0f),
+            MakeVector3(-1.0f,  1.0f, 1.0f),
         };
 
+        std::vector<Vector3> linesData;
         for (size_t i = 0; i < plane.size(); i++)
         {
-            this->storage.push_back({ frustrum.Origin, color });
-            this->storage.push_back({ plane[i],   color });
+            linesData.push_back(MakeVector3(0.0f));
+            linesData.push_back(plane[i]);
         }
-        for (size_t i = 1; i < plane.size(); i++)
-        {
-            this->storage.push_back({ plane[i - 1], color });
-            this->storage.push_back({ plane[i],     color });
-        }
-        this->storage.push_back({ plane.back(),  color });
-        this->storage.push_back({ plane.front(), color });
+        PushLineLoop(linesData, plane);
+        return linesData;
     }
 
-    void DebugBuffer::Submit(const Cylinder& cylinder, const Vector4& color)
+    static constexpr std::array<Vector2, 16> GetCirclePoints()
     {
-        constexpr std::array circle =
-        {
+        return {
             Vector2(0.0f, 1.0f),
             Vector2(0.5f, RootThree<float>() * 0.5f),
             Vector2(OneOverRootTwo<float>(), OneOverRootTwo<float>()),
@@ -284,51 +242,215 @@ namespace MxEngine
             Vector2(-OneOverRootTwo<float>(), OneOverRootTwo<float>()),
             Vector2(-0.5f, RootThree<float>() * 0.5f),
         };
+    }
 
+    static std::vector<Vector3> InitializeCylinder()
+    {
+        // circles of radius 1 in XZ plane at y = +-1
+        constexpr auto circle = GetCirclePoints();
         std::array<Vector3, circle.size()> upper;
         std::array<Vector3, circle.size()> lower;
-
-        Vector3 center{ 0.0f };
-        Vector3 offset{ 0.0f };
         for (size_t i = 0; i < circle.size(); i++)
         {
-            switch (cylinder.Orientation)
-            {
-            case Cylinder::Axis::X:
-                center = MakeVector3(0.0f, circle[i].x * cylinder.RadiusX, circle[i].y * cylinder.RadiusZ);
-                offset.x = cylinder.Height * 0.5f;
-                break;
-            case Cylinder::Axis::Y:
-                center = MakeVector3(circle[i].x * cylinder.RadiusX, 0.0f, circle[i].y * cylinder.RadiusZ);
-                offset.y = cylinder.Height * 0.5f;
-                break;
-            case Cylinder::Axis::Z:
-                center = MakeVector3(circle[i].x * cylinder.RadiusX, circle[i].y, 0.0f * cylinder.RadiusZ);
-                offset.z = cylinder.Height * 0.5f;
-                break;
-            }
-            upper[i] = center - offset;
-            lower[i] = center + offset;
+            upper[i] = MakeVector3(circle[i].x, -1.0f, circle[i].y);
+            lower[i] = MakeVector3(circle[i].x,  1.0f, circle[i].y);
+        }
 
-            upper[i] = cylinder.Rotation * upper[i] + cylinder.Center;
-            lower[i] = cylinder.Rotation * lower[i] + cylinder.Center;
+        std::vector<Vector3> linesData;
+        for (size_t i = 0; i < circle.size(); i++)
+        {
+            linesData.push_back(lower[i]);
+            linesData.push_back(upper[i]);
         }
+        PushLineLoop(linesData, lower);
+        PushLineLoop(linesData, upper);
+        return linesData;
+    }
+
+    static std::vector<Vector3> InitializeRectangle()
+    {
+        std::array points = {
+            MakeVector3(-1.0f, 0.0f,  1.0f), // Left top
+            MakeVector3( 1.0f, 0.0f,  1.0f), // Right top
+            MakeVector3( 1.0f, 0.0f, -1.0f), // Right bottom
+            MakeVector3(-1.0f, 0.0f, -1.0f), // Left bottom
+        };
+
+        std::vector<Vector3> linesData;
+        PushLineLoop(linesData, points);
+        return linesData;
+    }
+
+    static std::vector<Vector3> InitializeCircle()
+    {
+        // circle of radius 1 in XZ plane
+        constexpr auto circle = GetCirclePoints();
+        std::array<Vector3, circle.size()> points;
         for (size_t i = 0; i < circle.size(); i++)
         {
-            this->storage.push_back({ lower[i], color });
-            this->storage.push_back({ upper[i], color });
+            points[i] = MakeVector3(circle[i].x, 0.0f, circle[i].y);
         }
-        for (size_t i = 1; i < circle.size(); i++)
+
+        std::vector<Vector3> linesData;
+        PushLineLoop(linesData, points);
+        return linesData;
+    }
+
+    void DebugBuffer::Init()
+    {
+        auto vertexLayout = GetDebugVertexLayout();
+
+        this->VBO = Factory<VertexBuffer>::Create(nullptr, 0, UsageType::STATIC_DRAW);
+        this->VAO = Factory<VertexArray>::Create();
+        VAO->AddVertexLayout(*this->VBO, vertexLayout, VertexAttributeInputRate::PER_VERTEX);
+        this->streamVAO = Factory<VertexArray>::Create();
+
+        // order must match Shape enum
+        std::array shapes = {
+            InitializeBox(),
+            InitializeSphere(),
+            InitializeCone(),
+            InitializeFrustrum(),
+            InitializeCylinder(),
+            InitializeRectangle(),
+            InitializeCircle(),
+        };
+        static_assert(std::tuple_size_v<decltype(shapes)> == ShapeCount);
+
+        MxVector<Vector3> shapeVertecies;
+        for (size_t i = 0; i < shapes.size(); i++)
         {
-            this->storage.push_back({ lower[i - 1], color });
-            this->storage.push_back({ lower[i],     color });
-            this->storage.push_back({ upper[i - 1], color });
-            this->storage.push_back({ upper[i],     color });
+            this->shapeBatches[i].VertexOffset = shapeVertecies.size();
+            this->shapeBatches[i].VertexCount = shapes[i].size();
+            shapeVertecies.insert(shapeVertecies.end(), shapes[i].begin(), shapes[i].end());
         }
-        this->storage.push_back({ lower.front(), color });
-        this->storage.push_back({ lower.back(),  color });
-        this->storage.push_back({ upper.front(), color });
-        this->storage.push_back({ upper.back(),  color });
+
+        auto shapeLayout = GetDebugShapeLayout();
+        auto instanceLayout = GetDebugInstanceLayout();
+
+        this->shapeVBO = Factory<VertexBuffer>::Create((float*)shapeVertecies.data(), shapeVertecies.size() * 3, UsageType::STATIC_DRAW);
+        this->instanceVBO = Factory<VertexBuffer>::Create(nullptr, 0, UsageType::STATIC_DRAW);
+        this->shapeVAO = Factory<VertexArray>::Create();
+        this->shapeVAO->AddVertexLayout(*this->shapeVBO, shapeLayout, VertexAttributeInputRate::PER_VERTEX);
+        this->shapeVAO->AddVertexLayout(*this->instanceVBO, instanceLayout, VertexAttributeInputRate::PER_INSTANCE);
+        this->shapeStreamVAO = Factory<VertexArray>::Create();
+    }
+
+    void DebugBuffer::LinkStreamBuffer()
+    {
+        auto streamBuffer = StreamBufferAllocator::GetBuffer();
+        if (this->streamBufferId == streamBuffer->GetNativeHandle()) return;
+
+        auto vertexLayout = GetDebugVertexLayout();
+        *this->streamVAO = VertexArray();
+        this->streamVAO->AddVertexLayout(*streamBuffer, vertexLayout, VertexAttributeInputRate::PER_VERTEX);
+
+        auto shapeLayout = GetDebugShapeLayout();
+        auto instanceLayout = GetDebugInstanceLayout();
+        *this->shapeStreamVAO = VertexArray();
+        this->shapeStreamVAO->AddVertexLayout(*this->shapeVBO, shapeLayout, VertexAttributeInputRate::PER_VERTEX);
+        this->shapeStreamVAO->AddVertexLayout(*streamBuffer, instanceLayout, VertexAttributeInputRate::PER_INSTANCE);
+
+        this->streamBufferId = streamBuffer->GetNativeHandle();
+    }
+
+    void DebugBuffer::SubmitShape(Shape shape, const Matrix3x3& basis, const Vector3& origin, const Vector4& color)
+    {
+        ShapeInstance instance;
+        for (size_t row = 0; row < 3; row++)
+        {
+            instance.ModelRows[row] = MakeVector4(basis[0][row], basis[1][row], basis[2][row], origin[row]);
+        }
+        instance.Color = color;
+        this->instances[(size_t)shape].push_back(instance);
+    }
+
+    void DebugBuffer::Submit(const Line& line, const Vector4& color)
+    {
+        this->storage.push_back({ line.p1, color });
+        this->storage.push_back({ line.p2, color });
+    }
+
+    void DebugBuffer::Submit(const AABB& box, const Vector4& color)
+    {
+        auto halfSize = (box.Max - box.Min) * 0.5f;
+        auto center = (box.Max + box.Min) * 0.5f;
+        this->SubmitShape(Shape::BOX, Matrix3x3(Scale(Matrix4x4(1.0f), halfSize)), center, color);
+    }
+
+    void DebugBuffer::Submit(const BoundingBox& box, const Vector4 color)
+    {
+        auto rotation = Matrix3x3(ToMatrix(box.Rotation));
+        auto halfSize = (box.Max - box.Min) * 0.5f;
+        auto center = (box.Max + box.Min) * 0.5f;
+        this->SubmitShape(Shape::BOX, rotation * Matrix3x3(Scale(Matrix4x4(1.0f), halfSize)), rotation * center + box.Center, color);
+    }
+
+    void DebugBuffer::Submit(const BoundingSphere& sphere, const Vector4 color)
+    {
+        this->SubmitShape(Shape::SPHERE, Matrix3x3(sphere.Radius * 1.1f), sphere.Center, color);
+    }
+
+    void DebugBuffer::Submit(const Cone& cone, const Vector4& color)
+    {
+        auto radius = std::tan(Radians(cone.GetAngle() * 0.5f)) * cone.GetLength();
+        auto normDir = Normalize(cone.Direction);
+        if (cone.GetAngle() > 180.0f) normDir = -normDir;   
+        auto direction = normDir * cone.GetLength();
+
+        Vector3 v{ 0.0f };
+        Vector3 u{ 0.0f };
+        if (direction.y != 0.0f)
+            v = MakeVector3(-normDir.y, normDir.x, 0.0f);
+        else if (direction.z != 0.0f)
+            v = MakeVector3(0.0f, -normDir.z, normDir.y);
+        else
+            v = MakeVector3(-normDir.z, 0.0f, normDir.x);
+
+        v = Normalize(v);
+        u = Normalize(Cross(normDir, v)); //-V519
+
+        this->SubmitShape(Shape::CONE, Matrix3x3(radius * v, radius * u, direction), cone.Origin, color);
+    }
+
+    void DebugBuffer::Submit(const Frustrum& frustrum, const Vector4& color)
+    {
+        auto normDir = Normalize(frustrum.Direction);
+        auto normUp = Normalize(frustrum.Up);
+
+        auto normRight = Normalize(Cross(normDir, normUp)); //-V537
+        auto right = normRight * frustrum.AspectRatio;
+        auto scale = 2.0f;
+        auto extent = 2.0f * scale * std::tan(Radians(frustrum.GetAngle() * 0.5f));
+
+        this->SubmitShape(Shape::FRUSTRUM, Matrix3x3(extent * right, extent * normUp, scale * normDir), frustrum.Origin, color);
+    }
+
+    void DebugBuffer::Submit(const Cylinder& cylinder, const Vector4& color)
+    {
+        // unit cylinder is aligned with Y axis, so other orientations swap axes
+        auto halfHeight = cylinder.Height * 0.5f;
+        Matrix3x3 axes{ 0.0f };
+        switch (cylinder.Orientation)
+        {
+        case Cylinder::Axis::X:
+            axes[0] = MakeVector3(0.0f, cylinder.RadiusX, 0.0f);
+            axes[1] = MakeVector3(halfHeight, 0.0f, 0.0f);
+            axes[2] = MakeVector3(0.0f, 0.0f, cylinder.RadiusZ);
+            break;
+        case Cylinder::Axis::Y:
+            axes[0] = MakeVector3(cylinder.RadiusX, 0.0f, 0.0f);
+            axes[1] = MakeVector3(0.0f, halfHeight, 0.0f);
+            axes[2] = MakeVector3(0.0f, 0.0f, cylinder.RadiusZ);
+            break;
+        case Cylinder::Axis::Z:
+            axes[0] = MakeVector3(cylinder.RadiusX, 0.0f, 0.0f);
+            axes[1] = MakeVector3(0.0f, 0.0f, halfHeight);
+            axes[2] = MakeVector3(0.0f, cylinder.RadiusZ, 0.0f);
+            break;
+        }
+        auto rotation = Matrix3x3(ToMatrix(cylinder.Rotation));
+        this->SubmitShape(Shape::CYLINDER, rotation * axes, cylinder.Center, color);
     }
 
     void DebugBuffer::Submit(const Capsule& capsule, const Vector4& color)
@@ -426,83 +548,102 @@ namespace MxEngine
 
     void DebugBuffer::Submit(const Rectangle& rectangle, const Vector4& color)
     {
-        std::array points = {
-            rectangle.Center + rectangle.Rotation * Vector3(-0.5f * rectangle.Width, 0.0f, +0.5f * rectangle.Height),      // Left top
-            rectangle.Center + rectangle.Rotation * Vector3(+0.5f * rectangle.Width, 0.0f, +0.5f * rectangle.Height),      // Right top
-            rectangle.Center + rectangle.Rotation * Vector3(+0.5f * rectangle.Width, 0.0f, -0.5f * rectangle.Height),      // Right bottom
-            rectangle.Center + rectangle.Rotation * Vector3(-0.5f * rectangle.Width, 0.0f, -0.5f * rectangle.Height),      // Left bottom
-        };
-
-        for (size_t i = 0; i < points.size() - 1; i++) {
-            auto pointFrom = points[i];
-            auto pointTo = points[i + 1];
+        auto rotation = Matrix3x3(ToMatrix(rectangle.Rotation));
+        auto halfSize = MakeVector3(0.5f * rectangle.Width, 1.0f, 0.5f * rectangle.Height);
+        this->SubmitShape(Shape::RECTANGLE, rotation * Matrix3x3(Scale(Matrix4x4(1.0f), halfSize)), rectangle.Center, color);
+    }
 
-            this->storage.push_back({ pointFrom, color });
-            this->storage.push_back({ pointTo, color });
-        }
+    void DebugBuffer::Submit(const Circle& circle, const Vector4& color)
+    {
+        auto rotation = Matrix3x3(ToMatrix(circle.Rotation));
+        this->SubmitShape(Shape::CIRCLE, rotation * circle.Radius, circle.Center, color);
+    }
 
-        this->storage.push_back({ points.back(), color });
-        this->storage.push_back({ points.front(), color });
+    void DebugBuffer::ClearBuffer()
+    {
+        this->storage.clear();
+        for (auto& shapeInstances : this->instances)
+            shapeInstances.clear();
     }
 
-    void DebugBuffer::Submit(const Circle& circle, const Vector4& color)
+    void DebugBuffer::SubmitInstances()
     {
-        constexpr std::array circlePoints =
+        size_t totalInstances = 0;
+        for (size_t i = 0; i < ShapeCount; i++)
         {
-            Vector3(0.0f, 0.0f, 1.0f),
-            Vector3(0.5f, 0.0f, RootThree<float>() * 0.5f),
-            Vector3(OneOverRootTwo<float>(), 0.0f, OneOverRootTwo<float>()),
-            Vector3(RootThree<float>() * 0.5f, 0.0f, 0.5f),
-            Vector3(1.0f, 0.0f, 0.0f),
-            Vector3(RootThree<float>() * 0.5f, 0.0f, -0.5f),
-            Vector3(OneOverRootTwo<float>(), 0, -OneOverRootTwo<float>()),
-            Vector3(0.5f, 0.0f, -RootThree<float>() * 0.5f),
-            Vector3(0.0f, 0.0f, -1.0f),
-            Vector3(-0.5f, 0.0f, -RootThree<float>() * 0.5f),
-            Vector3(-OneOverRootTwo<float>(), 0.0f, -OneOverRootTwo<float>()),
-            Vector3(-RootThree<float>() * 0.5f, 0.0f, -0.5f),
-            Vector3(-1.0f, 0.0f, 0.0f),
-            Vector3(-RootThree<float>() * 0.5f, 0.0f, 0.5f),
-            Vector3(-OneOverRootTwo<float>(), 0.0f, OneOverRootTwo<float>()),
-            Vector3(-0.5f, 0.0f, RootThree<float>() * 0.5f),
-        };
+            this->shapeBatches[i].BaseInstance = totalInstances;
+            this->shapeBatches[i].InstanceCount = this->instances[i].size();
+            totalInstances += this->instances[i].size();
+        }
+        if (totalInstances == 0) return;
 
-        std::array<Vector3, circlePoints.size()> circleArray;
-        for (size_t i = 0; i < circlePoints.size(); i++)
+        auto allocation = StreamBufferAllocator::Allocate(totalInstances * sizeof(ShapeInstance), sizeof(ShapeInstance));
+        this->isInstanceStreamed = allocation.IsValid();
+        if (this->isInstanceStreamed)
         {
-            circleArray[i] = circle.Center + circle.Rotation * circlePoints[i] * circle.Radius;
+            for (size_t i = 0; i < ShapeCount; i++)
+            {
+                auto& batch = this->shapeBatches[i];
+                std::memcpy(allocation.Data + batch.BaseInstance * sizeof(ShapeInstance), this->instances[i].data(), batch.InstanceCount * sizeof(ShapeInstance));
+                batch.BaseInstance += allocation.Offset / sizeof(ShapeInstance);
+            }
+            this->LinkStreamBuffer();
         }
+        else
+        {
+            // shapes are packed one after another into the first instance array
+            auto& packed = this->instances.front();
+            for (size_t i = 1; i < ShapeCount; i++)
+                packed.insert(packed.end(), this->instances[i].begin(), this->instances[i].end());
 
-        for (size_t i = 0; i < circleArray.size() - 1; i++) {
-            auto pointFrom = circleArray[i];
-            auto pointTo = circleArray[i + 1];
+            size_t size = packed.size() * sizeof(ShapeInstance) / sizeof(float);
+            this->instanceVBO->BufferDataWithResize((float*)packed.data(), size);
+        }
+    }
+
+    void DebugBuffer::SubmitBuffer()
+    {
+        this->SubmitInstances();
 
-            this->storage.push_back({ pointFrom, color });
-            this->storage.push_back({ pointTo, color });
+        // allocation is aligned to vertex size, so it can be drawn from stream buffer by vertex offset
+        auto allocation = StreamBufferAllocator::Allocate(this->storage.size() * sizeof(Point), sizeof(Point));
+        this->isStreamed = allocation.IsValid();
+        if (this->isStreamed)
+        {
+            std::memcpy(allocation.Data, this->storage.data(), allocation.Size);
+            this->LinkStreamBuffer();
+            this->vertexOffset = allocation.Offset / sizeof(Point);
+        }
+        else
+        {
+            size_t size = this->GetSize() * sizeof(Point) / sizeof(float);
+            this->VBO->BufferDataWithResize((float*)this->storage.data(), size);
+            this->vertexOffset = 0;
         }
+    }
 
-        this->storage.push_back({ circleArray.back(), color });
-        this->storage.push_back({ circleArray.front(), color });
+    size_t DebugBuffer::GetSize() const
+    {
+        return this->storage.size();
     }
 
-    void DebugBuffer::ClearBuffer()
+    size_t DebugBuffer::GetVertexOffset() const
     {
-        this->storage.clear();
+        return this->vertexOffset;
     }
 
-    void DebugBuffer::SubmitBuffer()
+    VertexArrayHandle DebugBuffer::GetVAO() const
     {
-        size_t size = this->GetSize() * sizeof(Point) / sizeof(float);
-        this->VBO->BufferDataWithResize((float*)this->storage.data(), size);
+        return this->isStreamed ? this->streamVAO : this->VAO;
     }
 
-    size_t DebugBuffer::GetSize() const
+    VertexArrayHandle DebugBuffer::GetInstancedVAO() const
     {
-        return this->storage.size();
+        return this->isInstanceStreamed ? this->shapeStreamVAO : this->shapeVAO;
     }
 
-    VertexArrayHandle DebugBuffer::GetVAO() const
+    ArrayView<const DebugShapeBatch> DebugBuffer::GetShapeBatches() const
     {
-        return this->VAO;
+        return ArrayView<const DebugShapeBatch>(this->shapeBatches.data(), this->shapeBatches.size());
     }
-}
\ No newline at end of file
+}
@@ -43,6 +43,14 @@ namespace MxEngine
     class Rectangle;
     class Circle;
 
+    struct DebugShapeBatch
+    {
+        size_t VertexOffset;
+        size_t VertexCount;
+        size_t BaseInstance;
+        size_t InstanceCount;
+    };
+
     class DebugBuffer
     {
         struct Point
@@ -51,12 +59,51 @@ namespace MxEngine
             Vector4 color;
         };
 
+        struct ShapeInstance
+        {
+            Matrix3x4 ModelRows;
+            Vector4 Color;
+        };
+
+        enum class Shape : uint8_t
+        {
+            BOX,
+            SPHERE,
+            CONE,
+            FRUSTRUM,
+            CYLINDER,
+            RECTANGLE,
+            CIRCLE,
+
+            COUNT
+        };
+        constexpr static size_t ShapeCount = (size_t)Shape::COUNT;
+
         using FrontendStorage = MxVector<Point>;
+        using InstanceStorage = MxVector<ShapeInstance>;
 
         VertexBufferHandle VBO;
         VertexArrayHandle VAO;
+        // references stream buffer and is relinked each time stream buffer is recreated
+        VertexArrayHandle streamVAO;
+        unsigned int streamBufferId = 0;
+        size_t vertexOffset = 0;
+        bool isStreamed = false;
+
+        // unit shapes are uploaded once, each submitted shape is only a transform and color
+        VertexBufferHandle shapeVBO;
+        VertexBufferHandle instanceVBO;
+        VertexArrayHandle shapeVAO;
+        VertexArrayHandle shapeStreamVAO;
+        bool isInstanceStreamed = false;
+        std::array<DebugShapeBatch, ShapeCount> shapeBatches{ };
 
         FrontendStorage storage;
+        std::array<InstanceStorage, ShapeCount> instances;
+
+        void LinkStreamBuffer();
+        void SubmitInstances();
+        void SubmitShape(Shape shape, const Matrix3x3& basis, const Vector3& origin, const Vector4& color);
     public:
         bool DrawAsScreenOverlay = false;
 
@@ -75,6 +122,9 @@ namespace MxEngine
         void ClearBuffer(); 
         void SubmitBuffer();
         size_t GetSize() const;
+        size_t GetVertexOffset() const;
         VertexArrayHandle GetVAO() const;
+        VertexArrayHandle GetInstancedVAO() const;
+        ArrayView<const DebugShapeBatch> GetShapeBatches() const;
     };
 }
\ No newline at end of file
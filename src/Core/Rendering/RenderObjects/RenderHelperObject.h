@@ -38,11 +38,12 @@ namespace MxEngine
     protected:
         size_t vertexOffset, vertexCount;
         size_t indexOffset, indexCount;
+        IndexFormat indexFormat = IndexFormat::UINT32;
         VertexArrayHandle VAO;
     public:
         RenderHelperObject() = default;
-        RenderHelperObject(size_t vertexOffset, size_t vertexCount, size_t indexOffset, size_t indexCount, VertexArrayHandle vao)
-            : vertexOffset(vertexOffset), vertexCount(vertexCount), indexOffset(indexOffset), indexCount(indexCount), VAO(std::move(vao)) { }
+        RenderHelperObject(size_t vertexOffset, size_t vertexCount, size_t indexOffset, size_t indexCount, IndexFormat indexFormat, VertexArrayHandle vao)
+            : vertexOffset(vertexOffset), vertexCount(vertexCount), indexOffset(indexOffset), indexCount(indexCount), indexFormat(indexFormat), VAO(std::move(vao)) { }
 
         VertexArrayHandle GetVAO() const;
         VertexBufferHandle GetVBO() const;
@@ -51,5 +52,6 @@ namespace MxEngine
         size_t GetVertexCount() const { return this->vertexCount; }        
         size_t GetIndexOffset() const { return this->indexOffset; }
         size_t GetVertexOffset() const { return this->vertexOffset; }
+        IndexFormat GetIndexFormat() const { return this->indexFormat; }
     };
 }
\ No newline at end of file
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "RenderHelperObject.h"
+#include "Core/Resources/BufferAllocator.h"
 
 namespace MxEngine
 {
@@ -48,23 +49,28 @@ namespace MxEngine
     class SpotLightInstancedObject : public RenderHelperObject
     {
         VertexBufferHandle instancedVBO;
+        unsigned int vboId = 0;
+        unsigned int iboId = 0;
     public:
         MxVector<SpotLightBaseData> Instances;
 
         SpotLightInstancedObject() = default;
 
-        SpotLightInstancedObject(size_t vertexOffset, size_t vertexCount, size_t indexOffset, size_t indexCount)
-            : RenderHelperObject(vertexOffset, vertexCount, indexOffset, indexCount, Factory<VertexArray>::Create())
+        SpotLightInstancedObject(size_t vertexOffset, size_t vertexCount, size_t indexOffset, size_t indexCount, IndexFormat indexFormat)
+            : RenderHelperObject(vertexOffset, vertexCount, indexOffset, indexCount, indexFormat, Factory<VertexArray>::Create())
         {
             this->instancedVBO = Factory<VertexBuffer>::Create(nullptr, 0, UsageType::STATIC_DRAW);
+            this->LinkVertexArray();
+        }
 
-            std::array vertexLayout = {
-                VertexAttribute::Entry<Vector3>(), // position
-                VertexAttribute::Entry<Vector2>(), // texture uv
-                VertexAttribute::Entry<Vector3>(), // normal
-                VertexAttribute::Entry<Vector3>(), // tangent
-                VertexAttribute::Entry<Vector3>(), // bitangent
-            };
+        // shared vertex and index buffers are replaced when they grow, so vertex array is recreated if their handles changed
+        void LinkVertexArray()
+        {
+            auto VBO = this->GetVBO();
+            auto IBO = this->GetIBO();
+            if (this->vboId == VBO->GetNativeHandle() && this->iboId == IBO->GetNativeHandle()) return;
+
+            auto vertexLayout = BufferAllocator::GetVertexLayout();
             std::array instanceLayout = {
                 VertexAttribute::Entry<Matrix4x4>(), // transform
                 VertexAttribute::Entry<Vector4>(),   // position + inner angle
@@ -72,11 +78,19 @@ namespace MxEngine
                 VertexAttribute::Entry<Vector4>(),   // color + ambient
             };
 
-            VAO->AddVertexLayout(*this->GetVBO(), vertexLayout, VertexAttributeInputRate::PER_VERTEX);
+            *this->VAO = VertexArray();
+            VAO->AddVertexLayout(*VBO, vertexLayout, VertexAttributeInputRate::PER_VERTEX);
             VAO->AddVertexLayout(*this->instancedVBO, instanceLayout, VertexAttributeInputRate::PER_INSTANCE);
-            this->VAO->LinkIndexBuffer(*this->GetIBO());
+            this->VAO->LinkIndexBuffer(*IBO);
+
+            this->vboId = VBO->GetNativeHandle();
+            this->iboId = IBO->GetNativeHandle();
         }
 
-        void SubmitToVBO() { instancedVBO->BufferDataWithResize((float*)this->Instances.data(), this->Instances.size() * SpotLightBaseData::Size); }
+        void SubmitToVBO()
+        {
+            this->LinkVertexArray();
+            instancedVBO->BufferDataWithResize((float*)this->Instances.data(), this->Instances.size() * SpotLightBaseData::Size);
+        }
     };
 }
\ No newline at end of file
@@ -32,12 +32,20 @@
 #include "RenderObjects/RectangleObject.h"
 #include "RenderObjects/SkyboxObject.h"
 #include "RenderObjects/RenderHelperObject.h"
+#include "RenderObjects/DebugBuffer.h"
 #include "RenderObjects/PointLightInstancedObject.h"
 #include "RenderObjects/SpotLightInstancedObject.h"
 #include "RenderUtilities/RenderStatistics.h"
+#include "RenderUtilities/RenderSortKey.h"
+#include "RenderUtilities/IndirectCommandBuilder.h"
+#include "RenderUtilities/ShadowMapCache.h"
+#include "RenderUtilities/LightClusterBuilder.h"
+#include "RenderUtilities/OcclusionCuller.h"
+#include "RenderUtilities/MeshletCuller.h"
 #include "Core/Resources/ACESCurve.h"
 #include "Core/Resources/Material.h"
 #include "Utilities/String/String.h"
+#include "Utilities/Sort/DepthSort.h"
 
 namespace MxEngine
 {
@@ -53,6 +61,9 @@ namespace MxEngine
     {
         VertexArrayHandle VAO;
         size_t VertexCount;
+        size_t VertexOffset;
+        VertexArrayHandle InstancedVAO;
+        MxVector<DebugShapeBatch> ShapeBatches;
     };
 
     struct CameraUnit
@@ -82,6 +93,8 @@ namespace MxEngine
 
         float Gamma;
         float AspectRatio;
+        float ZNear;
+        float ZFar;
 
         bool IsPerspective;
         bool RenderToTexture;
@@ -104,6 +117,7 @@ namespace MxEngine
         TextureHandle DefaultBlackMap;
         TextureHandle DefaultGreyMap;
         TextureHandle DefaultShadowMap;
+        TextureHandle ShadowAtlas;
         TextureHandle AverageWhiteTexture;
         TextureHandle DownSampleTexture;
         TextureHandle EnvironmentBRDFLUT;
@@ -112,6 +126,13 @@ namespace MxEngine
 
         VertexArrayHandle RenderVAO;
         ShaderStorageBufferHandle RenderSSBO;
+        IndirectBufferHandle IndirectCommandBuffer;
+        ShaderStorageBufferHandle IndirectDrawSSBO;
+        ShaderStorageBufferHandle IndirectMaterialSSBO;
+        ShaderStorageBufferHandle ClusteredPointLightSSBO;
+        ShaderStorageBufferHandle ClusteredSpotLightSSBO;
+        ShaderStorageBufferHandle LightClusterSSBO;
+        ShaderStorageBufferHandle LightIndexSSBO;
 
         FrameBufferHandle DepthFrameBuffer;
         FrameBufferHandle PostProcessFrameBuffer;
@@ -129,11 +150,17 @@ namespace MxEngine
         uint8_t MainCameraIndex;
         bool OverlayDebugDraws;
         bool RenderToDefaultFrameBuffer;
+        bool HasDefaultFrameBuffer;
+        bool UseIndirectDrawing;
+        bool UseClusteredLighting;
+        bool UseOcclusionCulling;
     };
 
     struct DirectionalLightUnit
     {
         TextureHandle ShadowMap;
+        TextureHandle StaticShadowMap;
+        ShadowCacheState ShadowState;
         std::array<Matrix4x4, 3> ProjectionMatrices;
         std::array<Matrix4x4, 3> BiasedProjectionMatrices;
         Vector3 Direction;
@@ -145,12 +172,19 @@ namespace MxEngine
     struct PointLightUnit : PointLightBaseData
     {
         CubeMapHandle ShadowMap;
+        CubeMapHandle StaticShadowMap;
+        ShadowCacheState ShadowState;
+        size_t LightKey;
         Matrix4x4 ProjectionMatrices[6];
     };
 
     struct SpotLightUnit : SpotLightBaseData
     {
         TextureHandle ShadowMap;
+        TextureHandle StaticShadowMap;
+        ShadowCacheState ShadowState;
+        ShadowAtlasTile ShadowTile;
+        size_t LightKey;
         Matrix4x4 ProjectionMatrix;
         Matrix4x4 BiasedProjectionMatrix;
     };
@@ -164,6 +198,14 @@ namespace MxEngine
         PointLightInstancedObject PointLightsInstanced;
         RenderHelperObject PointLight;
         RenderHelperObject SpotLight;
+        ShadowMapCache ShadowCache;
+        ShadowAtlasScheduler ShadowScheduler;
+        LightClusterBuilder ClusterBuilder;
+        LightClusterGrid Clusters;
+        MxVector<ClusteredPointLight> ClusteredPointLights;
+        MxVector<ClusteredSpotLight> ClusteredSpotLights;
+        MxVector<ShadowAtlasRequest> ShadowRequests;
+        MxVector<ShadowAtlasDecision> ShadowDecisions;
     };
 
     struct RenderGroup
@@ -175,25 +217,39 @@ namespace MxEngine
 
     struct RenderUnit
     {
+        uint64_t SortKey;
         size_t MaterialIndex;
         size_t VertexOffset;
         size_t VertexCount;
         size_t IndexOffset;
         size_t IndexCount;
+        IndexFormat IndexType;
+        // range in RenderPipeline::MeshletUnits, empty if unit is culled only as a whole
+        size_t MeshletOffset;
+        size_t MeshletCount;
         
         Matrix4x4 ModelMatrix;
         Matrix3x3 NormalMatrix;
 
         Vector3 MinAABB, MaxAABB;
+        bool IsStatic;
         #if defined(MXENGINE_DEBUG)
         const char* DebugName;
         #endif
     };
 
+    struct RenderDrawCommand
+    {
+        uint64_t SortKey;
+        uint32_t UnitIndex;
+        uint32_t GroupIndex;
+    };
+
     struct RenderList
     {
         MxVector<RenderGroup> Groups;
         MxVector<size_t> UnitsIndex;
+        MxVector<RenderDrawCommand> DrawCommands;
     };
 
     struct ParticleSystemUnit
@@ -205,12 +261,22 @@ namespace MxEngine
         size_t InvocationCount;
         size_t MaterialIndex;
         bool IsRelative;
+        bool IsSimulatedOnCPU;
+    };
+
+    struct OcclusionSystem
+    {
+        OcclusionCuller Culler;
+        MxVector<OccluderInstance> Occluders;
+        // non-zero for render units hidden behind occluders from currently rendered camera
+        MxVector<uint8_t> OccludedUnits;
     };
 
     struct RenderPipeline
     {
         EnvironmentUnit Environment;
         LightingSystem Lighting;
+        OcclusionSystem Occlusion;
 
         RenderList ShadowCasters;
         RenderList MaskedShadowCasters;
@@ -218,11 +284,23 @@ namespace MxEngine
         RenderList MaskedObjects;
         RenderList OpaqueObjects;
         MxVector<RenderUnit> RenderUnits;
+        MxVector<RenderDrawCommand> SortScratch;
+        IndirectDrawList IndirectDraws;
+        MxVector<IndirectMaterialData> IndirectMaterials;
 
         MxVector<ParticleSystemUnit> OpaqueParticleSystems;
         MxVector<ParticleSystemUnit> TransparentParticleSystems;
+        MxVector<ParticleSystemUnit> ParticleSortScratch;
+        // kept between frames, so depth sorting can reuse previous order
+        DepthSorter TransparentObjectsOrder;
+        DepthSorter OpaqueParticlesOrder;
+        DepthSorter TransparentParticlesOrder;
         MxVector<Material> MaterialUnits;
+        MxVector<Meshlet> MeshletUnits;
+        MxVector<MeshletDrawRange> MeshletRanges;
         MxVector<CameraUnit> Cameras;
         RenderStatistics Statistics;
+        // set when draw commands of submitted units are built, possibly on another thread
+        bool IsPrepared = false;
     };
 }
\ No newline at end of file
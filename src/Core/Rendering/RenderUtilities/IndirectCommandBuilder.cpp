@@ -0,0 +1,155 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "IndirectCommandBuilder.h"
+#include "Core/Rendering/RenderPipeline.h"
+#include "Core/BoundingObjects/FrustrumCuller.h"
+
+namespace MxEngine
+{
+    void IndirectDrawList::Clear()
+    {
+        this->Commands.clear();
+        this->DrawData.clear();
+        this->Batches.clear();
+        this->CulledCount = 0;
+        this->OccludedCount = 0;
+        this->CulledMeshletCount = 0;
+    }
+
+    IndirectCommandBuilder::IndirectCommandBuilder(const RenderList& objects, ArrayView<RenderUnit> renderUnits, ArrayView<Material> materials, ArrayView<Meshlet> meshlets)
+        : objects(objects), renderUnits(renderUnits), materials(materials), meshlets(meshlets)
+    {
+    }
+
+    void IndirectCommandBuilder::Build(const FrustrumCuller& culler, const Vector3& viewPosition, ArrayView<uint8_t> occludedUnits, IndirectDrawList& result) const
+    {
+        result.Clear();
+        result.Commands.reserve(this->objects.DrawCommands.size());
+        result.DrawData.reserve(this->objects.DrawCommands.size());
+
+        for (const auto& drawCommand : this->objects.DrawCommands)
+        {
+            const auto& group = this->objects.Groups[drawCommand.GroupIndex];
+            const auto& unit = this->renderUnits[drawCommand.UnitIndex];
+            bool isInstanced = group.InstanceCount > 0;
+
+            if (!isInstanced && !culler.IsAABBVisible(unit.MinAABB, unit.MaxAABB))
+            {
+                result.CulledCount++;
+                continue;
+            }
+            if (!isInstanced && drawCommand.UnitIndex < occludedUnits.size() && occludedUnits[drawCommand.UnitIndex])
+            {
+                result.OccludedCount++;
+                continue;
+            }
+
+            // whole unit is drawn as single range unless it has meshlets
+            result.MeshletRanges.clear();
+            if (!isInstanced && unit.MeshletCount > 0)
+            {
+                ArrayView<Meshlet> unitMeshlets(this->meshlets.data() + unit.MeshletOffset, unit.MeshletCount);
+                result.CulledMeshletCount += MeshletCuller::Cull(unitMeshlets, unit.ModelMatrix, unit.IndexOffset, culler, viewPosition, result.MeshletRanges);
+                if (result.MeshletRanges.empty())
+                {
+                    result.CulledCount++;
+                    continue;
+                }
+            }
+            else
+            {
+                result.MeshletRanges.push_back(MeshletDrawRange{ unit.IndexOffset, unit.IndexCount });
+            }
+
+            // one multi-draw call consumes single index type, so 16-bit and 32-bit meshes cannot share a batch
+            bool startsNewBatch = result.Batches.empty() ||
+                result.Batches.back().IndexType != unit.IndexType ||
+                !HasSameTextures(this->materials[result.Batches.back().MaterialIndex], this->materials[unit.MaterialIndex]);
+
+            if (startsNewBatch)
+            {
+                auto& batch = result.Batches.emplace_back();
+                batch.CommandOffset = result.Commands.size();
+                batch.CommandCount = 0;
+                batch.MaterialIndex = unit.MaterialIndex;
+                batch.IndexType = unit.IndexType;
+            }
+
+            for (const auto& range : result.MeshletRanges)
+            {
+                result.Batches.back().CommandCount++;
+
+                // non-instanced objects are drawn as one instance of default instance data, which is always at offset 0
+                auto& command = result.Commands.emplace_back();
+                command.IndexCount = (uint32_t)range.IndexCount;
+                command.InstanceCount = isInstanced ? (uint32_t)group.InstanceCount : 1;
+                command.FirstIndex = (uint32_t)range.IndexOffset;
+                command.BaseVertex = (int32_t)unit.VertexOffset;
+                command.BaseInstance = isInstanced ? (uint32_t)group.BaseInstance : 0;
+
+                // draw data is fetched by draw index, so it is duplicated for each range of unit
+                auto& drawData = result.DrawData.emplace_back();
+                drawData.ModelMatrix = unit.ModelMatrix;
+                drawData.NormalMatrix[0] = Vector4(unit.NormalMatrix[0], 0.0f);
+                drawData.NormalMatrix[1] = Vector4(unit.NormalMatrix[1], 0.0f);
+                drawData.NormalMatrix[2] = Vector4(unit.NormalMatrix[2], 0.0f);
+                drawData.MaterialIndex = (uint32_t)unit.MaterialIndex;
+            }
+        }
+    }
+
+    void IndirectCommandBuilder::PackMaterials(ArrayView<Material> materials, MxVector<IndirectMaterialData>& result)
+    {
+        result.resize(materials.size());
+        for (size_t i = 0; i < materials.size(); i++)
+        {
+            const auto& material = materials[i];
+            auto& packed = result[i];
+
+            packed.BaseColor = material.BaseColor;
+            packed.Transparency = material.Transparency;
+            packed.UVMultipliers = material.UVMultipliers;
+            packed.Displacement = material.Displacement;
+            packed.Emission = material.Emission;
+            packed.Roughness = material.RoughnessFactor;
+            packed.Metallic = material.MetallicFactor;
+        }
+    }
+
+    bool IndirectCommandBuilder::HasSameTextures(const Material& m1, const Material& m2)
+    {
+        return m1.AlbedoMap == m2.AlbedoMap &&
+            m1.MetallicMap == m2.MetallicMap &&
+            m1.RoughnessMap == m2.RoughnessMap &&
+            m1.EmissiveMap == m2.EmissiveMap &&
+            m1.NormalMap == m2.NormalMap &&
+            m1.HeightMap == m2.HeightMap &&
+            m1.AmbientOcclusionMap == m2.AmbientOcclusionMap;
+    }
+}
@@ -0,0 +1,111 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Utilities/Array/ArrayView.h"
+#include "Utilities/Math/Math.h"
+#include "Platform/OpenGL/IndirectBuffer.h"
+#include "MeshletCuller.h"
+
+namespace MxEngine
+{
+    class Material;
+    class FrustrumCuller;
+    struct RenderList;
+    struct RenderUnit;
+
+    // per-draw data, read in shaders by draw index. Layout matches std430 (mat3 columns are padded to vec4)
+    struct IndirectDrawData
+    {
+        Matrix4x4 ModelMatrix;
+        Vector4 NormalMatrix[3];
+        uint32_t MaterialIndex;
+        uint32_t Padding[3];
+    };
+
+    // material parameters which are set as uniforms in non-indirect path. Layout matches std430
+    struct IndirectMaterialData
+    {
+        Vector3 BaseColor;
+        float Transparency;
+        Vector2 UVMultipliers;
+        float Displacement;
+        float Emission;
+        float Roughness;
+        float Metallic;
+        float Padding[2];
+    };
+
+    static_assert(sizeof(IndirectDrawData) == 128, "IndirectDrawData must match std430 layout");
+    static_assert(sizeof(IndirectMaterialData) == 48, "IndirectMaterialData must match std430 layout");
+
+    // commands in range [CommandOffset, CommandOffset + CommandCount) share material textures and are submitted with one draw call
+    struct IndirectDrawBatch
+    {
+        size_t CommandOffset;
+        size_t CommandCount;
+        size_t MaterialIndex;
+        IndexFormat IndexType;
+    };
+
+    struct IndirectDrawList
+    {
+        MxVector<DrawIndicesIndirectCommand> Commands;
+        MxVector<IndirectDrawData> DrawData;
+        MxVector<IndirectDrawBatch> Batches;
+        size_t CulledCount = 0;
+        size_t OccludedCount = 0;
+        size_t CulledMeshletCount = 0;
+        MxVector<MeshletDrawRange> MeshletRanges;
+
+        void Clear();
+    };
+
+    /*!
+    builds indirect draw commands from already sorted render list. Works only with CPU data, so it does not require graphic context
+    consecutive visible units which use same material textures are merged into one batch, as textures are the only state which
+    can not be fetched by draw index without bindless extensions
+    */
+    class IndirectCommandBuilder
+    {
+        const RenderList& objects;
+        ArrayView<RenderUnit> renderUnits;
+        ArrayView<Material> materials;
+        ArrayView<Meshlet> meshlets;
+    public:
+        IndirectCommandBuilder(const RenderList& objects, ArrayView<RenderUnit> renderUnits, ArrayView<Material> materials, ArrayView<Meshlet> meshlets);
+
+        // occludedUnits is indexed by render unit and may be empty if occlusion culling is disabled
+        // units with meshlets emit one command per visible range of clusters, all sharing unit draw data
+        void Build(const FrustrumCuller& culler, const Vector3& viewPosition, ArrayView<uint8_t> occludedUnits, IndirectDrawList& result) const;
+
+        static void PackMaterials(ArrayView<Material> materials, MxVector<IndirectMaterialData>& result);
+        static bool HasSameTextures(const Material& m1, const Material& m2);
+    };
+}
@@ -0,0 +1,270 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "LightClusterBuilder.h"
+#include "Utilities/Threading/WorkerPool.h"
+
+#include <array>
+#include <algorithm>
+#include <limits>
+
+namespace MxEngine
+{
+    constexpr size_t ClusterCountXY = LightClusterBuilder::ClusterCountX * LightClusterBuilder::ClusterCountY;
+
+    void LightClusterGrid::Clear()
+    {
+        this->Clusters.clear();
+        this->LightIndices.clear();
+        this->VisibleLightCount = 0;
+    }
+
+    size_t LightClusterBuilder::GetClusterIndex(size_t x, size_t y, size_t z)
+    {
+        return (z * ClusterCountY + y) * ClusterCountX + x;
+    }
+
+    size_t LightClusterBuilder::GetSliceIndex(float depth, const LightClusterGrid& grid)
+    {
+        if (depth <= 0.0f) return 0;
+        float slice = std::log(depth) * grid.SliceScale + grid.SliceBias;
+        return (size_t)Clamp(slice, 0.0f, float(ClusterCountZ - 1));
+    }
+
+    void LightClusterBuilder::GetSpotLightBounds(const ClusteredSpotLight& spotLight, Vector3& center, float& radius)
+    {
+        // light intensity falls to zero at half of max distance (see spotlight shader), so light occupies cone of this height
+        float distance = Length(spotLight.Direction);
+        float height = 0.5f * distance;
+        Vector3 direction = spotLight.Direction / Max(distance, 0.0001f);
+        float cosAngle = Clamp(spotLight.OuterCos, 0.0001f, 1.0f);
+
+        if (cosAngle >= 0.70710678f)
+        {
+            // narrow cone: sphere passes through apex and base circle
+            radius = height / (2.0f * cosAngle * cosAngle);
+            center = spotLight.Position + direction * radius;
+        }
+        else
+        {
+            // wide cone: sphere around base circle, but never larger than sphere around apex
+            float sinAngle = std::sqrt(1.0f - cosAngle * cosAngle);
+            float baseRadius = height * sinAngle / cosAngle;
+            if (baseRadius < height)
+            {
+                radius = baseRadius;
+                center = spotLight.Position + direction * height;
+            }
+            else
+            {
+                radius = height;
+                center = spotLight.Position;
+            }
+        }
+    }
+
+    void LightClusterBuilder::SetCamera(const Matrix4x4& viewProjection, float zNear, float zFar)
+    {
+        this->viewProjection = viewProjection;
+        this->zNear = Max(zNear, 0.0001f);
+        this->zFar = Max(zFar, this->zNear * 1.01f);
+    }
+
+    LightClusterBuilder::LightRange LightClusterBuilder::ComputeLightRange(const Vector3& center, float radius, const LightClusterGrid& grid) const
+    {
+        LightRange range{ };
+        range.IsVisible = false;
+
+        // for perspective projection clip-space w is equal to view-space depth
+        float depth = (this->viewProjection * Vector4(center, 1.0f)).w;
+        if (depth + radius < this->zNear || depth - radius > this->zFar) return range;
+
+        range.MinZ = (uint8_t)GetSliceIndex(Max(depth - radius, this->zNear), grid);
+        range.MaxZ = (uint8_t)GetSliceIndex(Min(depth + radius, this->zFar), grid);
+
+        Vector2 minNDC{ -1.0f, -1.0f };
+        Vector2 maxNDC{ 1.0f, 1.0f };
+
+        // projected corners of bounding box enclose projected sphere, if all of them are in front of camera
+        bool isBehindCamera = false;
+        Vector2 minCorner{ std::numeric_limits<float>::max() };
+        Vector2 maxCorner{ std::numeric_limits<float>::lowest() };
+        for (size_t i = 0; i < 8 && !isBehindCamera; i++)
+        {
+            Vector3 corner = center + radius * Vector3(
+                (i & 1) ? 1.0f : -1.0f,
+                (i & 2) ? 1.0f : -1.0f,
+                (i & 4) ? 1.0f : -1.0f
+            );
+            Vector4 projected = this->viewProjection * Vector4(corner, 1.0f);
+            if (projected.w <= this->zNear * 0.5f)
+            {
+                isBehindCamera = true;
+                break;
+            }
+            Vector2 ndc = Vector2(projected) / projected.w;
+            minCorner = VectorMin(minCorner, ndc);
+            maxCorner = VectorMax(maxCorner, ndc);
+        }
+
+        if (!isBehindCamera)
+        {
+            if (maxCorner.x < -1.0f || maxCorner.y < -1.0f || minCorner.x > 1.0f || minCorner.y > 1.0f) return range;
+            minNDC = VectorMax(minNDC, minCorner);
+            maxNDC = VectorMin(maxNDC, maxCorner);
+        }
+
+        auto ToCluster = [](float ndc, size_t clusterCount)
+        {
+            float cluster = (ndc * 0.5f + 0.5f) * float(clusterCount);
+            return (uint8_t)Clamp(cluster, 0.0f, float(clusterCount - 1));
+        };
+
+        range.MinX = ToCluster(minNDC.x, ClusterCountX);
+        range.MaxX = ToCluster(maxNDC.x, ClusterCountX);
+        range.MinY = ToCluster(minNDC.y, ClusterCountY);
+        range.MaxY = ToCluster(maxNDC.y, ClusterCountY);
+        range.IsVisible = true;
+        return range;
+    }
+
+    void LightClusterBuilder::FillSlice(size_t slice, size_t pointLightCount, LightClusterGrid& grid)
+    {
+        auto* records = grid.Clusters.data() + GetClusterIndex(0, 0, slice);
+        auto& indices = this->sliceIndices[slice];
+
+        std::array<uint32_t, ClusterCountXY> pointCursors;
+        std::array<uint32_t, ClusterCountXY> spotCursors;
+        std::fill(records, records + ClusterCountXY, LightClusterRecord{ 0, 0, 0, 0 });
+
+        auto ForEachClusterOfSlice = [this, slice](auto&& func)
+        {
+            for (size_t i = 0; i < this->lightRanges.size(); i++)
+            {
+                const auto& range = this->lightRanges[i];
+                if (!range.IsVisible || slice < range.MinZ || slice > range.MaxZ) continue;
+
+                for (size_t y = range.MinY; y <= range.MaxY; y++)
+                {
+                    for (size_t x = range.MinX; x <= range.MaxX; x++)
+                        func(i, y * ClusterCountX + x);
+                }
+            }
+        };
+
+        ForEachClusterOfSlice([records, pointLightCount](size_t light, size_t cluster)
+        {
+            if (light < pointLightCount)
+                records[cluster].PointLightCount++;
+            else
+                records[cluster].SpotLightCount++;
+        });
+
+        // offsets are relative to slice until slices are merged in Build()
+        uint32_t offset = 0;
+        for (size_t cluster = 0; cluster < ClusterCountXY; cluster++)
+        {
+            auto& record = records[cluster];
+            record.Offset = offset;
+            pointCursors[cluster] = offset;
+            spotCursors[cluster] = offset + record.PointLightCount;
+            offset += record.PointLightCount + record.SpotLightCount;
+        }
+        indices.resize(offset);
+
+        ForEachClusterOfSlice([&indices, &pointCursors, &spotCursors, pointLightCount](size_t light, size_t cluster)
+        {
+            if (light < pointLightCount)
+                indices[pointCursors[cluster]++] = (uint32_t)light;
+            else
+                indices[spotCursors[cluster]++] = uint32_t(light - pointLightCount);
+        });
+    }
+
+    void LightClusterBuilder::Build(ArrayView<ClusteredPointLight> pointLights, ArrayView<ClusteredSpotLight> spotLights, LightClusterGrid& grid)
+    {
+        float logDepthRange = std::log(this->zFar / this->zNear);
+        grid.SliceScale = float(ClusterCountZ) / logDepthRange;
+        grid.SliceBias = -float(ClusterCountZ) * std::log(this->zNear) / logDepthRange;
+        grid.Clusters.resize(ClusterCount);
+
+        size_t pointLightCount = pointLights.size();
+        this->lightRanges.resize(pointLights.size() + spotLights.size());
+        ParallelFor(this->lightRanges.size(), 256, [this, &pointLights, &spotLights, &grid, pointLightCount](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                if (i < pointLightCount)
+                {
+                    const auto& light = pointLights[i];
+                    this->lightRanges[i] = this->ComputeLightRange(light.Position, light.Radius, grid);
+                }
+                else
+                {
+                    Vector3 center;
+                    float radius;
+                    GetSpotLightBounds(spotLights[i - pointLightCount], center, radius);
+                    this->lightRanges[i] = this->ComputeLightRange(center, radius, grid);
+                }
+            }
+        });
+
+        this->sliceIndices.resize(ClusterCountZ);
+        ParallelFor(ClusterCountZ, 1, [this, &grid, pointLightCount](size_t begin, size_t end)
+        {
+            for (size_t slice = begin; slice < end; slice++)
+                this->FillSlice(slice, pointLightCount, grid);
+        });
+
+        this->sliceOffsets.resize(ClusterCountZ);
+        uint32_t totalIndexCount = 0;
+        for (size_t slice = 0; slice < ClusterCountZ; slice++)
+        {
+            this->sliceOffsets[slice] = totalIndexCount;
+            totalIndexCount += (uint32_t)this->sliceIndices[slice].size();
+        }
+
+        grid.LightIndices.resize(totalIndexCount);
+        ParallelFor(ClusterCountZ, 1, [this, &grid](size_t begin, size_t end)
+        {
+            for (size_t slice = begin; slice < end; slice++)
+            {
+                uint32_t baseOffset = this->sliceOffsets[slice];
+                const auto& indices = this->sliceIndices[slice];
+                std::copy(indices.begin(), indices.end(), grid.LightIndices.begin() + baseOffset);
+
+                auto* records = grid.Clusters.data() + GetClusterIndex(0, 0, slice);
+                for (size_t cluster = 0; cluster < ClusterCountXY; cluster++)
+                    records[cluster].Offset += baseOffset;
+            }
+        });
+
+        grid.VisibleLightCount = (size_t)std::count_if(this->lightRanges.begin(), this->lightRanges.end(),
+            [](const LightRange& range) { return range.IsVisible; });
+    }
+}
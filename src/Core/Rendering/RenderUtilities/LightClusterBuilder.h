@@ -0,0 +1,118 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Utilities/Array/ArrayView.h"
+#include "Utilities/Math/Math.h"
+#include "Utilities/STL/MxVector.h"
+
+namespace MxEngine
+{
+    // point light data, read in clustered lighting shader. Layout matches std430
+    struct ClusteredPointLight
+    {
+        Vector3 Position;
+        float Radius;
+        Vector3 Color;
+        float AmbientIntensity;
+    };
+
+    // spot light data, read in clustered lighting shader. Layout matches std430
+    struct ClusteredSpotLight
+    {
+        Vector3 Position;
+        float InnerCos;
+        Vector3 Direction; // normalized direction scaled by max distance
+        float OuterCos;
+        Vector3 Color;
+        float AmbientIntensity;
+    };
+
+    // light index list of one cluster: point light indices go first, spot light indices follow them
+    struct LightClusterRecord
+    {
+        uint32_t Offset;
+        uint32_t PointLightCount;
+        uint32_t SpotLightCount;
+        uint32_t Padding;
+    };
+
+    static_assert(sizeof(ClusteredPointLight) == 32, "ClusteredPointLight must match std430 layout");
+    static_assert(sizeof(ClusteredSpotLight) == 48, "ClusteredSpotLight must match std430 layout");
+    static_assert(sizeof(LightClusterRecord) == 16, "LightClusterRecord must match std430 layout");
+
+    struct LightClusterGrid
+    {
+        MxVector<LightClusterRecord> Clusters;
+        MxVector<uint32_t> LightIndices;
+        // slice = log(depth) * SliceScale + SliceBias, see GetSliceIndex()
+        float SliceScale = 0.0f;
+        float SliceBias = 0.0f;
+        size_t VisibleLightCount = 0;
+
+        void Clear();
+    };
+
+    /*!
+    assigns lights to clusters of view frustum (froxels). Frustum is split uniformly in screen space and exponentially in depth,
+    light bounding spheres are projected once and then inserted into each cluster they overlap. Work is spread over WorkerPool
+    class works only with CPU data, so it does not require graphic context
+    */
+    class LightClusterBuilder
+    {
+        struct LightRange
+        {
+            uint8_t MinX, MaxX, MinY, MaxY, MinZ, MaxZ;
+            bool IsVisible;
+        };
+
+        MxVector<LightRange> lightRanges;
+        MxVector<MxVector<uint32_t>> sliceIndices;
+        MxVector<uint32_t> sliceOffsets;
+
+        Matrix4x4 viewProjection{ 1.0f };
+        float zNear = 0.1f;
+        float zFar = 1000.0f;
+
+        LightRange ComputeLightRange(const Vector3& center, float radius, const LightClusterGrid& grid) const;
+        void FillSlice(size_t slice, size_t pointLightCount, LightClusterGrid& grid);
+    public:
+        constexpr static size_t ClusterCountX = 16;
+        constexpr static size_t ClusterCountY = 9;
+        constexpr static size_t ClusterCountZ = 24;
+        constexpr static size_t ClusterCount = ClusterCountX * ClusterCountY * ClusterCountZ;
+
+        void SetCamera(const Matrix4x4& viewProjection, float zNear, float zFar);
+        void Build(ArrayView<ClusteredPointLight> pointLights, ArrayView<ClusteredSpotLight> spotLights, LightClusterGrid& grid);
+
+        static size_t GetClusterIndex(size_t x, size_t y, size_t z);
+        static size_t GetSliceIndex(float depth, const LightClusterGrid& grid);
+        static void GetSpotLightBounds(const ClusteredSpotLight& spotLight, Vector3& center, float& radius);
+    };
+}
@@ -0,0 +1,73 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "MeshletCuller.h"
+#include "Core/BoundingObjects/FrustrumCuller.h"
+
+namespace MxEngine
+{
+    size_t MeshletCuller::Cull(ArrayView<Meshlet> meshlets, const Matrix4x4& modelMatrix, size_t baseIndexOffset,
+        const FrustrumCuller& culler, const Vector3& viewPosition, MxVector<MeshletDrawRange>& result)
+    {
+        result.clear();
+
+        Vector3 axisX = Vector3(modelMatrix[0]), axisY = Vector3(modelMatrix[1]), axisZ = Vector3(modelMatrix[2]);
+        float maxScale = std::sqrt(Max(Length2(axisX), Max(Length2(axisY), Length2(axisZ))));
+        // affine transform keeps every point on the same side of triangle planes, unless it mirrors the mesh and flips winding
+        bool useConeCulling = Dot(Cross(axisX, axisY), axisZ) > 0.0f;
+        Vector3 objectViewPosition = Vector3(Inverse(modelMatrix) * Vector4(viewPosition, 1.0f));
+
+        size_t culledCount = 0;
+        for (const auto& meshlet : meshlets)
+        {
+            Vector3 center = Vector3(modelMatrix * Vector4(meshlet.Bounds.Center, 1.0f));
+            bool isVisible = culler.IsSphereVisible(center, meshlet.Bounds.Radius * maxScale) &&
+                !(useConeCulling && MeshletCuller::IsBackFacing(meshlet, objectViewPosition));
+
+            if (!isVisible)
+            {
+                culledCount++;
+                continue;
+            }
+
+            size_t offset = baseIndexOffset + meshlet.IndexOffset;
+            if (!result.empty() && result.back().IndexOffset + result.back().IndexCount == offset)
+                result.back().IndexCount += meshlet.IndexCount;
+            else
+                result.push_back(MeshletDrawRange{ offset, meshlet.IndexCount });
+        }
+        return culledCount;
+    }
+
+    bool MeshletCuller::IsBackFacing(const Meshlet& meshlet, const Vector3& viewPosition)
+    {
+        auto direction = meshlet.ConeApex - viewPosition;
+        float distance = Length(direction);
+        return distance > 0.0f && Dot(direction, meshlet.ConeAxis) >= meshlet.ConeCutoff * distance;
+    }
+}
@@ -0,0 +1,57 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Utilities/Array/ArrayView.h"
+#include "Core/Resources/MeshData.h"
+
+namespace MxEngine
+{
+    class FrustrumCuller;
+
+    struct MeshletDrawRange
+    {
+        size_t IndexOffset;
+        size_t IndexCount;
+    };
+
+    /*!
+    CPU culling of submesh meshlets against camera frustrum and their normal cones
+    visible meshlets which follow each other in index buffer are merged into one draw range
+    */
+    class MeshletCuller
+    {
+    public:
+        // meshlet bounds are in object space of modelMatrix, resulting ranges are offset by baseIndexOffset. Returns number of culled meshlets
+        static size_t Cull(ArrayView<Meshlet> meshlets, const Matrix4x4& modelMatrix, size_t baseIndexOffset,
+            const FrustrumCuller& culler, const Vector3& viewPosition, MxVector<MeshletDrawRange>& result);
+        // viewPosition must be in object space of meshlet
+        static bool IsBackFacing(const Meshlet& meshlet, const Vector3& viewPosition);
+    };
+}
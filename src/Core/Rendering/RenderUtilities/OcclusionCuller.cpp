@@ -0,0 +1,389 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "OcclusionCuller.h"
+#include "Library/Mesh/MeshSimplifier.h"
+#include "Utilities/Threading/WorkerPool.h"
+#include "Utilities/Profiler/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MXENGINE_OCCLUSION_USE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace MxEngine
+{
+    // Sutherland-Hodgman clipping of triangle by w >= zNear plane. Result is polygon of up to 4 vertecies
+    size_t ClipByNearPlane(const Vector4 (&triangle)[3], Vector4 (&result)[4], float zNear)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < 3; i++)
+        {
+            const Vector4& current = triangle[i];
+            const Vector4& next = triangle[(i + 1) % 3];
+            float currentDistance = current.w - zNear;
+            float nextDistance = next.w - zNear;
+
+            if (currentDistance >= 0.0f)
+                result[count++] = current;
+            if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+                result[count++] = current + (next - current) * (currentDistance / (currentDistance - nextDistance));
+        }
+        return count;
+    }
+
+    void OcclusionCuller::SetupTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, MxVector<TriangleSetup>& triangles) const
+    {
+        float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+        if (std::abs(area) < 1e-6f) return;
+
+        // occluders are rasterized two-sided, so triangle is always made counter-clockwise
+        const Vector3* v[3] = { &v0, &v1, &v2 };
+        if (area < 0.0f)
+        {
+            std::swap(v[1], v[2]);
+            area = -area;
+        }
+
+        float minX = std::min({ v0.x, v1.x, v2.x }), maxX = std::max({ v0.x, v1.x, v2.x });
+        float minY = std::min({ v0.y, v1.y, v2.y }), maxY = std::max({ v0.y, v1.y, v2.y });
+
+        // pixels are sampled at their centers
+        TriangleSetup setup;
+        setup.MinX = (int32_t)std::ceil(std::max(minX - 0.5f, 0.0f));
+        setup.MinY = (int32_t)std::ceil(std::max(minY - 0.5f, 0.0f));
+        setup.MaxX = (int32_t)std::floor(std::min(maxX - 0.5f, float(this->width - 1)));
+        setup.MaxY = (int32_t)std::floor(std::min(maxY - 0.5f, float(this->height - 1)));
+        if (setup.MinX > setup.MaxX || setup.MinY > setup.MaxY) return;
+
+        setup.DepthA = setup.DepthB = setup.DepthC = 0.0f;
+        float invArea = 1.0f / area;
+        for (size_t i = 0; i < 3; i++)
+        {
+            const Vector3& a = *v[i];
+            const Vector3& b = *v[(i + 1) % 3];
+            // edge function divided by area is barycentric coordinate of vertex opposite to the edge
+            const Vector3& opposite = *v[(i + 2) % 3];
+
+            setup.EdgeA[i] = a.y - b.y;
+            setup.EdgeB[i] = b.x - a.x;
+            setup.EdgeC[i] = -(setup.EdgeA[i] * a.x + setup.EdgeB[i] * a.y);
+
+            setup.DepthA += setup.EdgeA[i] * opposite.z * invArea;
+            setup.DepthB += setup.EdgeB[i] * opposite.z * invArea;
+            setup.DepthC += setup.EdgeC[i] * opposite.z * invArea;
+        }
+        triangles.push_back(setup);
+    }
+
+    void OcclusionCuller::SetupTriangles(const OccluderInstance& occluder, MxVector<TriangleSetup>& triangles) const
+    {
+        const auto& geometry = *occluder.Geometry;
+        Matrix4x4 transform = this->viewProjection * occluder.Transform;
+
+        MxVector<Vector4> clipPositions(geometry.Positions.size());
+        for (size_t i = 0; i < geometry.Positions.size(); i++)
+            clipPositions[i] = transform * Vector4(geometry.Positions[i], 1.0f);
+
+        auto ToScreen = [this](const Vector4& clip)
+        {
+            float invW = 1.0f / clip.w;
+            return Vector3(
+                (clip.x * invW * 0.5f + 0.5f) * float(this->width),
+                (clip.y * invW * 0.5f + 0.5f) * float(this->height),
+                invW
+            );
+        };
+
+        for (size_t i = 0; i + 2 < geometry.Indicies.size(); i += 3)
+        {
+            Vector4 triangle[3] = {
+                clipPositions[geometry.Indicies[i + 0]],
+                clipPositions[geometry.Indicies[i + 1]],
+                clipPositions[geometry.Indicies[i + 2]],
+            };
+            Vector4 polygon[4];
+            size_t vertexCount = ClipByNearPlane(triangle, polygon, this->nearPlane);
+            if (vertexCount < 3) continue;
+
+            Vector3 v0 = ToScreen(polygon[0]);
+            Vector3 v1 = ToScreen(polygon[1]);
+            Vector3 v2 = ToScreen(polygon[2]);
+            this->SetupTriangle(v0, v1, v2, triangles);
+            if (vertexCount == 4)
+                this->SetupTriangle(v0, v2, ToScreen(polygon[3]), triangles);
+        }
+    }
+
+    void OcclusionCuller::RasterizeRows(size_t beginRow, size_t endRow)
+    {
+        for (const auto& triangles : this->occluderTriangles)
+        {
+            for (const auto& t : triangles)
+            {
+                int32_t minY = std::max(t.MinY, (int32_t)beginRow);
+                int32_t maxY = std::min(t.MaxY, (int32_t)endRow - 1);
+
+                for (int32_t y = minY; y <= maxY; y++)
+                {
+                    float* row = this->depthBuffer.data() + (size_t)y * this->width;
+                    float py = float(y) + 0.5f;
+
+                    #if defined(MXENGINE_OCCLUSION_USE_SSE)
+                    const __m128 zero = _mm_setzero_ps();
+                    const __m128 laneOffset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+                    const __m128 edgeA0 = _mm_set1_ps(t.EdgeA[0]), edgeRow0 = _mm_set1_ps(t.EdgeB[0] * py + t.EdgeC[0]);
+                    const __m128 edgeA1 = _mm_set1_ps(t.EdgeA[1]), edgeRow1 = _mm_set1_ps(t.EdgeB[1] * py + t.EdgeC[1]);
+                    const __m128 edgeA2 = _mm_set1_ps(t.EdgeA[2]), edgeRow2 = _mm_set1_ps(t.EdgeB[2] * py + t.EdgeC[2]);
+                    const __m128 depthA = _mm_set1_ps(t.DepthA), depthRow = _mm_set1_ps(t.DepthB * py + t.DepthC);
+
+                    // width is multiple of 4, so aligned block never crosses row end
+                    for (int32_t x = t.MinX & ~3; x <= t.MaxX; x += 4)
+                    {
+                        __m128 px = _mm_add_ps(_mm_set1_ps(float(x)), laneOffset);
+                        __m128 e0 = _mm_add_ps(_mm_mul_ps(edgeA0, px), edgeRow0);
+                        __m128 e1 = _mm_add_ps(_mm_mul_ps(edgeA1, px), edgeRow1);
+                        __m128 e2 = _mm_add_ps(_mm_mul_ps(edgeA2, px), edgeRow2);
+                        __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+                        if (_mm_movemask_ps(inside) == 0) continue;
+
+                        __m128 depth = _mm_add_ps(_mm_mul_ps(depthA, px), depthRow);
+                        __m128 current = _mm_loadu_ps(row + x);
+                        __m128 nearest = _mm_max_ps(current, depth);
+                        _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+                    }
+                    #else
+                    for (int32_t x = t.MinX; x <= t.MaxX; x++)
+                    {
+                        float px = float(x) + 0.5f;
+                        bool inside =
+                            t.EdgeA[0] * px + t.EdgeB[0] * py + t.EdgeC[0] >= 0.0f &&
+                            t.EdgeA[1] * px + t.EdgeB[1] * py + t.EdgeC[1] >= 0.0f &&
+                            t.EdgeA[2] * px + t.EdgeB[2] * py + t.EdgeC[2] >= 0.0f;
+                        if (!inside) continue;
+
+                        float depth = t.DepthA * px + t.DepthB * py + t.DepthC;
+                        row[x] = std::max(row[x], depth);
+                    }
+                    #endif
+                }
+            }
+        }
+    }
+
+    void OcclusionCuller::Init(size_t width, size_t height)
+    {
+        MX_ASSERT(width > 0 && height > 0);
+        this->width = (width + 3) & ~size_t(3);
+        this->height = height;
+        this->depthBuffer.resize(this->width * this->height);
+        this->Clear();
+    }
+
+    void OcclusionCuller::Clear()
+    {
+        std::fill(this->depthBuffer.begin(), this->depthBuffer.end(), 0.0f);
+        this->triangleCount = 0;
+    }
+
+    void OcclusionCuller::RenderOccluders(const Matrix4x4& viewProjection, float zNear, const MxVector<OccluderInstance>& occluders)
+    {
+        this->Clear();
+        if (this->depthBuffer.empty()) return;
+
+        this->viewProjection = viewProjection;
+        this->nearPlane = zNear;
+        this->occluderTriangles.resize(occluders.size());
+
+        ParallelFor(occluders.size(), 1, [this, &occluders](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                this->occluderTriangles[i].clear();
+                this->SetupTriangles(occluders[i], this->occluderTriangles[i]);
+            }
+        });
+
+        for (const auto& triangles : this->occluderTriangles)
+            this->triangleCount += triangles.size();
+        if (this->triangleCount == 0) return;
+
+        // each worker owns its own band of rows, so depth buffer can be written without synchronization
+        ParallelFor(this->height, 4, [this](size_t begin, size_t end)
+        {
+            this->RasterizeRows(begin, end);
+        });
+    }
+
+    bool OcclusionCuller::IsAABBVisible(const Vector3& minAABB, const Vector3& maxAABB) const
+    {
+        if (this->triangleCount == 0) return true;
+
+        float minX = std::numeric_limits<float>::max(), maxX = std::numeric_limits<float>::lowest();
+        float minY = std::numeric_limits<float>::max(), maxY = std::numeric_limits<float>::lowest();
+        float nearestDepth = 0.0f;
+        for (size_t i = 0; i < 8; i++)
+        {
+            Vector4 corner(
+                (i & 1) ? maxAABB.x : minAABB.x,
+                (i & 2) ? maxAABB.y : minAABB.y,
+                (i & 4) ? maxAABB.z : minAABB.z,
+                1.0f
+            );
+            Vector4 clip = this->viewProjection * corner;
+            // box crosses near plane, so it cannot be hidden by anything
+            if (clip.w <= this->nearPlane) return true;
+
+            float invW = 1.0f / clip.w;
+            float x = (clip.x * invW * 0.5f + 0.5f) * float(this->width);
+            float y = (clip.y * invW * 0.5f + 0.5f) * float(this->height);
+            minX = std::min(minX, x); maxX = std::max(maxX, x);
+            minY = std::min(minY, y); maxY = std::max(maxY, y);
+            nearestDepth = std::max(nearestDepth, invW);
+        }
+
+        // boxes outside of the screen are left to frustrum culling
+        if (maxX < 0.0f || maxY < 0.0f || minX >= float(this->width) || minY >= float(this->height)) return true;
+
+        // depth buffer is sampled at pixel centers, so rectangle is extended by one pixel to reduce false culling on occluder edges
+        int32_t x0 = (int32_t)std::floor(std::max(minX - 1.0f, 0.0f));
+        int32_t y0 = (int32_t)std::floor(std::max(minY - 1.0f, 0.0f));
+        int32_t x1 = (int32_t)std::floor(std::min(maxX + 1.0f, float(this->width - 1)));
+        int32_t y1 = (int32_t)std::floor(std::min(maxY + 1.0f, float(this->height - 1)));
+
+        for (int32_t y = y0; y <= y1; y++)
+        {
+            const float* row = this->depthBuffer.data() + (size_t)y * this->width;
+
+            #if defined(MXENGINE_OCCLUSION_USE_SSE)
+            const __m128 laneIndex = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+            const __m128 boxDepth = _mm_set1_ps(nearestDepth);
+            const __m128 first = _mm_set1_ps(float(x0)), last = _mm_set1_ps(float(x1));
+            for (int32_t x = x0 & ~3; x <= x1; x += 4)
+            {
+                __m128 lane = _mm_add_ps(_mm_set1_ps(float(x)), laneIndex);
+                __m128 inRange = _mm_and_ps(_mm_cmpge_ps(lane, first), _mm_cmple_ps(lane, last));
+                __m128 isVisible = _mm_cmple_ps(_mm_loadu_ps(row + x), boxDepth);
+                if (_mm_movemask_ps(_mm_and_ps(inRange, isVisible)) != 0) return true;
+            }
+            #else
+            for (int32_t x = x0; x <= x1; x++)
+            {
+                if (row[x] <= nearestDepth) return true;
+            }
+            #endif
+        }
+        return false;
+    }
+
+    size_t OcclusionCuller::GetWidth() const
+    {
+        return this->width;
+    }
+
+    size_t OcclusionCuller::GetHeight() const
+    {
+        return this->height;
+    }
+
+    size_t OcclusionCuller::GetRasterizedTriangleCount() const
+    {
+        return this->triangleCount;
+    }
+
+    const MxVector<float>& OcclusionCuller::GetDepthBuffer() const
+    {
+        return this->depthBuffer;
+    }
+
+    OccluderGeometry OccluderCache::MakeOccluderGeometry(const SubMesh& submesh)
+    {
+        auto vertecies = submesh.Data.GetVerteciesFromGPU();
+        auto indicies = submesh.Data.GetIndiciesFromGPU();
+
+        // error is kept small, so simplified occluder does not noticeably come in front of source surface
+        size_t targetIndexCount = std::min(indicies.size() / 12, OccluderCache::MaxOccluderTriangles) * 3;
+        indicies = MeshSimplifier::Simplify(vertecies, indicies, targetIndexCount, 0.002f);
+        MeshSimplifier::CompactVertecies(vertecies, indicies);
+
+        OccluderGeometry geometry;
+        geometry.Positions.reserve(vertecies.size());
+        for (const auto& vertex : vertecies)
+            geometry.Positions.push_back(vertex.Position);
+        geometry.Indicies = std::move(indicies);
+        return geometry;
+    }
+
+    void OccluderCache::BeginFrame()
+    {
+        this->currentFrame++;
+    }
+
+    void OccluderCache::EndFrame()
+    {
+        for (auto it = this->entries.begin(); it != this->entries.end();)
+        {
+            if (it->second.LastUsedFrame + OccluderCache::EntryLifetime < this->currentFrame)
+                it = this->entries.erase(it);
+            else
+                it++;
+        }
+    }
+
+    void OccluderCache::Invalidate()
+    {
+        this->entries.clear();
+    }
+
+    const MxVector<OccluderGeometry>& OccluderCache::GetOccluders(const MeshHandle& mesh)
+    {
+        // handles are reused by factory, so entry may belong to already destroyed mesh
+        auto& entry = this->entries[mesh.GetHandle()];
+        bool isOutdated = entry.MeshUUID != mesh.GetUUID() ||
+            entry.VertexCount != mesh->GetTotalVerteciesCount() ||
+            entry.IndexCount != mesh->GetTotalIndiciesCount() ||
+            entry.SubMeshes.size() != mesh->GetSubMeshes().size();
+
+        if (isOutdated)
+        {
+            MAKE_SCOPE_PROFILER("OccluderCache::MakeOccluderGeometry()");
+            entry.MeshUUID = mesh.GetUUID();
+            entry.VertexCount = mesh->GetTotalVerteciesCount();
+            entry.IndexCount = mesh->GetTotalIndiciesCount();
+            entry.SubMeshes.clear();
+            for (const auto& submesh : mesh->GetSubMeshes())
+                entry.SubMeshes.push_back(OccluderCache::MakeOccluderGeometry(submesh));
+        }
+        entry.LastUsedFrame = this->currentFrame;
+        return entry.SubMeshes;
+    }
+}
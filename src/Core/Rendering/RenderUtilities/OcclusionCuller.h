@@ -0,0 +1,120 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Core/Resources/AssetManager.h"
+#include "Utilities/Math/Math.h"
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/STL/MxHashMap.h"
+
+namespace MxEngine
+{
+    // simplified triangle list of one submesh, used only for software depth rasterization
+    struct OccluderGeometry
+    {
+        MxVector<Vector3> Positions;
+        MxVector<uint32_t> Indicies;
+    };
+
+    struct OccluderInstance
+    {
+        const OccluderGeometry* Geometry;
+        Matrix4x4 Transform;
+    };
+
+    /*!
+    software occlusion culler. Occluders are rasterized on CPU worker threads into low resolution depth buffer,
+    which is later used to conservatively test bounding boxes of render units. Depth is stored as 1 / w, so cleared buffer is zero
+    and nearest occluder always has largest value. Only perspective projections are supported
+    */
+    class OcclusionCuller
+    {
+        struct TriangleSetup
+        {
+            int32_t MinX, MaxX, MinY, MaxY;
+            // edge functions are positive inside the triangle: A * x + B * y + C
+            float EdgeA[3], EdgeB[3], EdgeC[3];
+            // 1 / w plane in screen space
+            float DepthA, DepthB, DepthC;
+        };
+
+        MxVector<float> depthBuffer;
+        MxVector<MxVector<TriangleSetup>> occluderTriangles;
+        Matrix4x4 viewProjection = Matrix4x4(1.0f);
+        float nearPlane = 0.0f;
+        size_t width = 0, height = 0;
+        size_t triangleCount = 0;
+
+        void SetupTriangles(const OccluderInstance& occluder, MxVector<TriangleSetup>& triangles) const;
+        void SetupTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, MxVector<TriangleSetup>& triangles) const;
+        void RasterizeRows(size_t beginRow, size_t endRow);
+    public:
+        // width is rounded up to multiple of 4, as depth buffer is processed 4 pixels at once
+        void Init(size_t width, size_t height);
+        void Clear();
+        void RenderOccluders(const Matrix4x4& viewProjection, float zNear, const MxVector<OccluderInstance>& occluders);
+        // returns false only if box is fully hidden behind rasterized occluders
+        bool IsAABBVisible(const Vector3& minAABB, const Vector3& maxAABB) const;
+
+        size_t GetWidth() const;
+        size_t GetHeight() const;
+        size_t GetRasterizedTriangleCount() const;
+        const MxVector<float>& GetDepthBuffer() const;
+    };
+
+    /*!
+    keeps simplified occluder geometry of meshes between frames. Geometry is built from mesh data read back from GPU,
+    so it is generated once per mesh and removed when mesh is not used as occluder for a long time
+    */
+    class OccluderCache
+    {
+        struct CacheEntry
+        {
+            UUID MeshUUID;
+            size_t VertexCount = 0;
+            size_t IndexCount = 0;
+            MxVector<OccluderGeometry> SubMeshes;
+            size_t LastUsedFrame = 0;
+        };
+
+        MxHashMap<size_t, CacheEntry> entries;
+        size_t currentFrame = 0;
+
+        static OccluderGeometry MakeOccluderGeometry(const SubMesh& submesh);
+    public:
+        constexpr static size_t MaxOccluderTriangles = 2048;
+        constexpr static size_t EntryLifetime = 600;
+
+        void BeginFrame();
+        void EndFrame();
+        void Invalidate();
+        // returns occluder geometry for each submesh of mesh, in the same order as mesh submeshes
+        const MxVector<OccluderGeometry>& GetOccluders(const MeshHandle& mesh);
+    };
+}
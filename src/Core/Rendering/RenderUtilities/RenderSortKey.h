@@ -0,0 +1,91 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace MxEngine
+{
+    /*!
+    render units are sorted by 64-bit key before drawing to minimize state changes between consecutive draw calls.
+    most significant fields are the most expensive to change, so units with same pass, shader and material end up adjacent.
+    layout (from high bits to low): | pass: 4 | shader: 8 | material: 20 | mesh: 20 | depth: 12 |
+    */
+    namespace RenderSortKey
+    {
+        constexpr size_t DepthBits = 12;
+        constexpr size_t MeshBits = 20;
+        constexpr size_t MaterialBits = 20;
+        constexpr size_t ShaderBits = 8;
+        constexpr size_t PassBits = 4;
+
+        constexpr size_t DepthShift = 0;
+        constexpr size_t MeshShift = DepthShift + DepthBits;
+        constexpr size_t MaterialShift = MeshShift + MeshBits;
+        constexpr size_t ShaderShift = MaterialShift + MaterialBits;
+        constexpr size_t PassShift = ShaderShift + ShaderBits;
+
+        static_assert(PassShift + PassBits == 64, "sort key must cover all 64 bits");
+
+        constexpr uint64_t Mask(size_t bits) { return (uint64_t(1) << bits) - 1; }
+
+        constexpr uint64_t DepthMask = Mask(DepthBits) << DepthShift;
+        constexpr uint64_t MaxDepthBucket = Mask(DepthBits);
+
+        constexpr uint64_t Make(uint64_t pass, uint64_t shader, uint64_t material, uint64_t mesh, uint64_t depth)
+        {
+            return
+                ((pass     & Mask(PassBits))     << PassShift)     |
+                ((shader   & Mask(ShaderBits))   << ShaderShift)   |
+                ((material & Mask(MaterialBits)) << MaterialShift) |
+                ((mesh     & Mask(MeshBits))     << MeshShift)     |
+                ((depth    & Mask(DepthBits))    << DepthShift);
+        }
+
+        constexpr uint64_t WithDepth(uint64_t key, uint64_t depth)
+        {
+            return (key & ~DepthMask) | ((depth & Mask(DepthBits)) << DepthShift);
+        }
+
+        constexpr uint64_t GetPass(uint64_t key) { return (key >> PassShift) & Mask(PassBits); }
+        constexpr uint64_t GetShader(uint64_t key) { return (key >> ShaderShift) & Mask(ShaderBits); }
+        constexpr uint64_t GetMaterial(uint64_t key) { return (key >> MaterialShift) & Mask(MaterialBits); }
+        constexpr uint64_t GetMesh(uint64_t key) { return (key >> MeshShift) & Mask(MeshBits); }
+        constexpr uint64_t GetDepth(uint64_t key) { return (key >> DepthShift) & Mask(DepthBits); }
+
+        // folds arbitrary 64-bit value into a well-distributed hash, used to compress resource ids into key fields
+        constexpr uint64_t HashCombine(uint64_t seed, uint64_t value)
+        {
+            value *= 0x9E3779B97F4A7C15ull;
+            value ^= value >> 32;
+            return (seed ^ value) * 0xBF58476D1CE4E5B9ull;
+        }
+    }
+}
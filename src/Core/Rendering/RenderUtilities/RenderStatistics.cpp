@@ -0,0 +1,136 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "RenderStatistics.h"
+#include "Utilities/Json/Json.h"
+#include "Core/Macro/Macro.h"
+
+namespace MxEngine
+{
+    constexpr std::array<const char*, RenderStatistics::CounterCount> CounterNames = {
+        "draw calls",
+        "indirect draws",
+        "drawn vertecies",
+        "drawn triangles",
+        "drawn objects",
+        "culled objects",
+        "culled meshlets",
+        "occluded objects",
+        "occluder triangles",
+        "texture binds",
+        "texture binds requested",
+        "material switches",
+        "material switches requested",
+        "renders to framebuffer",
+        "shadow casts",
+        "culled from shadow cast",
+        "cached shadow maps",
+        "rendered shadow maps",
+        "postponed shadow maps",
+        "clustered lights",
+        "cluster light indices",
+    };
+    static_assert(CounterNames.back() != nullptr, "every render counter must have a name");
+
+    void RenderStatistics::ResetAll()
+    {
+        if (this->hasFrameData)
+        {
+            if (this->history.size() < HistorySize)
+                this->history.push_back(this->counters);
+            else
+                this->history[this->historyHead] = this->counters;
+
+            this->historyHead = (this->historyHead + 1) % HistorySize;
+            this->recordedFrames++;
+        }
+        this->counters.fill(0);
+        this->hasFrameData = false;
+    }
+
+    void RenderStatistics::ClearHistory()
+    {
+        this->history.clear();
+        this->historyHead = 0;
+        this->recordedFrames = 0;
+    }
+
+    size_t RenderStatistics::GetHistorySize() const
+    {
+        return this->history.size();
+    }
+
+    const RenderStatistics::FrameCounters& RenderStatistics::GetHistoryFrame(size_t index) const
+    {
+        MX_ASSERT(index < this->history.size());
+        // until ring buffer is full, the oldest frame is the first one
+        size_t oldest = this->history.size() < HistorySize ? 0 : this->historyHead;
+        return this->history[(oldest + index) % this->history.size()];
+    }
+
+    void RenderStatistics::ExportToCSV(File& file) const
+    {
+        size_t firstFrame = this->recordedFrames - this->history.size();
+
+        file << "frame";
+        for (const char* name : CounterNames)
+            file << ',' << name;
+        file << '\n';
+
+        for (size_t i = 0; i < this->history.size(); i++)
+        {
+            file << firstFrame + i;
+            for (size_t value : this->GetHistoryFrame(i))
+                file << ',' << value;
+            file << '\n';
+        }
+    }
+
+    void RenderStatistics::ExportToJson(File& file) const
+    {
+        JsonFile json;
+        json["first frame"] = this->recordedFrames - this->history.size();
+        json["frame count"] = this->history.size();
+
+        auto& counters = json["counters"];
+        for (size_t counter = 0; counter < CounterCount; counter++)
+        {
+            auto& values = counters[CounterNames[counter]];
+            values = JsonFile::array();
+            for (size_t i = 0; i < this->history.size(); i++)
+                values.push_back(this->GetHistoryFrame(i)[counter]);
+        }
+        SaveJson(file, json);
+    }
+
+    const char* RenderStatistics::GetCounterName(RenderCounter counter)
+    {
+        MX_ASSERT(counter < RenderCounter::COUNT);
+        return CounterNames[(size_t)counter];
+    }
+}
@@ -26,30 +26,84 @@
 // OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-#include "Utilities/STL/MxHashMap.h"
+#pragma once
+
+#include "Utilities/STL/MxVector.h"
+#include <array>
 #include <cstddef>
+#include <cstdint>
 
 namespace MxEngine
 {
-    #if !defined(MXENGINE_SHIPPING)
-    class RenderStatistics
+    class File;
+
+    // all counters gathered by renderer. Names are listed in the same order in RenderStatistics.cpp
+    enum class RenderCounter : uint8_t
     {
-        MxHashMap<const char*, size_t> statistics;
+        DRAW_CALLS,
+        INDIRECT_DRAWS,
+        DRAWN_VERTECIES,
+        DRAWN_TRIANGLES,
+        DRAWN_OBJECTS,
+        CULLED_OBJECTS,
+        CULLED_MESHLETS,
+        OCCLUDED_OBJECTS,
+        OCCLUDER_TRIANGLES,
+        TEXTURE_BINDS,
+        TEXTURE_BINDS_REQUESTED,
+        MATERIAL_SWITCHES,
+        MATERIAL_SWITCHES_REQUESTED,
+        RENDERS_TO_FRAMEBUFFER,
+        SHADOW_CASTS,
+        CULLED_FROM_SHADOW_CAST,
+        CACHED_SHADOW_MAPS,
+        RENDERED_SHADOW_MAPS,
+        POSTPONED_SHADOW_MAPS,
+        CLUSTERED_LIGHTS,
+        CLUSTER_LIGHT_INDICES,
 
-    public:
-        void AddEntry(const char* entryName, size_t incrementValue) { this->statistics[entryName] += incrementValue; }
-        void ResetAll() { for (auto it = statistics.begin(); it != statistics.end(); it++) { it->second = 0; } }
-        const auto& GetEntries() const { return this->statistics; }
+        COUNT
     };
-    #else
+
+    /*!
+    per-frame renderer counters, stored in flat array indexed by RenderCounter. When frame is reset, its counters are moved
+    into ring buffer which keeps last HistorySize frames, so they can be inspected or exported after a run
+    in shipping builds counters are never incremented
+    */
     class RenderStatistics
     {
-        MxHashMap<const char*, size_t> statistics;
-
     public:
-        void AddEntry(const char* entryName, size_t incrementValue) { }
-        void ResetAll() { }
-        const auto& GetEntries() const { return this->statistics; }
+        constexpr static size_t CounterCount = (size_t)RenderCounter::COUNT;
+        constexpr static size_t HistorySize = 512;
+        using FrameCounters = std::array<size_t, CounterCount>;
+    private:
+        FrameCounters counters{ };
+        MxVector<FrameCounters> history;
+        size_t historyHead = 0;
+        size_t recordedFrames = 0;
+        bool hasFrameData = false;
+    public:
+        void AddEntry(RenderCounter counter, size_t incrementValue)
+        {
+            #if !defined(MXENGINE_SHIPPING)
+            this->counters[(size_t)counter] += incrementValue;
+            this->hasFrameData = true;
+            #endif
+        }
+
+        size_t GetCounter(RenderCounter counter) const { return this->counters[(size_t)counter]; }
+        const FrameCounters& GetCounters() const { return this->counters; }
+
+        // stores counters of finished frame in history and zeroes them
+        void ResetAll();
+        void ClearHistory();
+        size_t GetHistorySize() const;
+        // frames are indexed from the oldest one
+        const FrameCounters& GetHistoryFrame(size_t index) const;
+
+        void ExportToCSV(File& file) const;
+        void ExportToJson(File& file) const;
+
+        static const char* GetCounterName(RenderCounter counter);
     };
-    #endif
-}
\ No newline at end of file
+}
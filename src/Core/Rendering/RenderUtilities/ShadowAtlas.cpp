@@ -0,0 +1,294 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "ShadowAtlas.h"
+#include "Core/Macro/Macro.h"
+#include "Utilities/Math/Math.h"
+
+#include <algorithm>
+#include <array>
+
+namespace MxEngine
+{
+    void ShadowAtlasAllocator::Init(size_t atlasSize, size_t minTileSize)
+    {
+        MX_ASSERT(FloorToPow2(atlasSize) == atlasSize && FloorToPow2(minTileSize) == minTileSize);
+        MX_ASSERT(minTileSize <= atlasSize);
+
+        this->atlasSize = atlasSize;
+        this->minTileSize = minTileSize;
+        this->freeTiles.resize(Log2(atlasSize / minTileSize) + 1);
+        this->Reset();
+    }
+
+    void ShadowAtlasAllocator::Reset()
+    {
+        for (auto& tiles : this->freeTiles)
+            tiles.clear();
+
+        if (!this->freeTiles.empty())
+            this->freeTiles.front().push_back(ShadowAtlasTile{ 0, 0, (uint32_t)this->atlasSize });
+    }
+
+    size_t ShadowAtlasAllocator::GetLevel(size_t tileSize) const
+    {
+        size_t level = 0;
+        while ((this->atlasSize >> (level + 1)) >= tileSize && level + 1 < this->freeTiles.size())
+            level++;
+        return level;
+    }
+
+    bool ShadowAtlasAllocator::SplitLevel(size_t level)
+    {
+        if (!this->freeTiles[level].empty()) return true;
+        if (level == 0 || !this->SplitLevel(level - 1)) return false;
+
+        auto parent = this->freeTiles[level - 1].back();
+        this->freeTiles[level - 1].pop_back();
+
+        uint32_t half = parent.Size / 2;
+        auto& tiles = this->freeTiles[level];
+        // pushed in reversed order, so tiles are taken from top-left corner first
+        tiles.push_back(ShadowAtlasTile{ parent.X + half, parent.Y + half, half });
+        tiles.push_back(ShadowAtlasTile{ parent.X,        parent.Y + half, half });
+        tiles.push_back(ShadowAtlasTile{ parent.X + half, parent.Y,        half });
+        tiles.push_back(ShadowAtlasTile{ parent.X,        parent.Y,        half });
+        return true;
+    }
+
+    ShadowAtlasTile ShadowAtlasAllocator::Allocate(size_t tileSize)
+    {
+        if (this->freeTiles.empty() || tileSize > this->atlasSize) return ShadowAtlasTile{ };
+
+        size_t level = this->GetLevel(tileSize);
+        if (!this->SplitLevel(level)) return ShadowAtlasTile{ };
+
+        auto tile = this->freeTiles[level].back();
+        this->freeTiles[level].pop_back();
+        return tile;
+    }
+
+    void ShadowAtlasAllocator::Free(const ShadowAtlasTile& tile)
+    {
+        if (!tile.IsValid()) return;
+
+        auto current = tile;
+        size_t level = this->GetLevel(current.Size);
+        while (level > 0)
+        {
+            uint32_t parentSize = current.Size * 2;
+            ShadowAtlasTile parent{ current.X - current.X % parentSize, current.Y - current.Y % parentSize, parentSize };
+
+            // tile can be merged only if all three of its siblings are free
+            auto& tiles = this->freeTiles[level];
+            std::array<size_t, 3> siblingIndices{ };
+            size_t siblingCount = 0;
+            for (size_t i = 0; i < tiles.size() && siblingCount < siblingIndices.size(); i++)
+            {
+                bool isSibling = tiles[i].X - tiles[i].X % parentSize == parent.X && tiles[i].Y - tiles[i].Y % parentSize == parent.Y;
+                if (isSibling) siblingIndices[siblingCount++] = i;
+            }
+            if (siblingCount != siblingIndices.size()) break;
+
+            // erase from the back, so indices stay valid
+            for (auto it = siblingIndices.rbegin(); it != siblingIndices.rend(); it++)
+            {
+                std::swap(tiles[*it], tiles.back());
+                tiles.pop_back();
+            }
+            current = parent;
+            level--;
+        }
+        this->freeTiles[level].push_back(current);
+    }
+
+    size_t ShadowAtlasAllocator::GetAtlasSize() const
+    {
+        return this->atlasSize;
+    }
+
+    size_t ShadowAtlasAllocator::GetMinTileSize() const
+    {
+        return this->minTileSize;
+    }
+
+    size_t ShadowAtlasAllocator::GetFreeArea() const
+    {
+        size_t area = 0;
+        for (const auto& tiles : this->freeTiles)
+        {
+            for (const auto& tile : tiles)
+                area += (size_t)tile.Size * tile.Size;
+        }
+        return area;
+    }
+
+    void ShadowAtlasScheduler::Init(size_t atlasSize, size_t minTileSize, size_t maxTileSize)
+    {
+        this->allocator.Init(atlasSize, minTileSize);
+        this->maxTileSize = Clamp(maxTileSize, minTileSize, atlasSize);
+        this->lights.clear();
+    }
+
+    void ShadowAtlasScheduler::Reset()
+    {
+        this->allocator.Reset();
+        this->lights.clear();
+    }
+
+    size_t ShadowAtlasScheduler::GetDesiredTileSize(float screenCoverage) const
+    {
+        // tile side is proportional to light size on screen, so texel density stays roughly the same
+        float desiredSize = (float)this->maxTileSize * std::sqrt(Clamp(screenCoverage, 0.0f, 1.0f));
+
+        size_t tileSize = this->allocator.GetMinTileSize();
+        while (tileSize * 2 <= this->maxTileSize && float(tileSize * 2) <= desiredSize)
+            tileSize *= 2;
+        return tileSize;
+    }
+
+    ShadowAtlasTile ShadowAtlasScheduler::AllocateTile(size_t desiredSize)
+    {
+        // if atlas is full, light gets smaller tile instead of no shadows at all
+        for (size_t size = desiredSize; size >= this->allocator.GetMinTileSize(); size /= 2)
+        {
+            auto tile = this->allocator.Allocate(size);
+            if (tile.IsValid()) return tile;
+        }
+        return ShadowAtlasTile{ };
+    }
+
+    void ShadowAtlasScheduler::AllocateTiles(const MxVector<ShadowAtlasRequest>& requests, MxVector<ShadowAtlasDecision>& decisions)
+    {
+        this->currentFrame++;
+        decisions.assign(requests.size(), ShadowAtlasDecision{ });
+
+        this->order.resize(requests.size());
+        for (size_t i = 0; i < this->order.size(); i++)
+            this->order[i] = i;
+        std::stable_sort(this->order.begin(), this->order.end(), [&requests](size_t i1, size_t i2)
+        {
+            return requests[i1].ScreenCoverage > requests[i2].ScreenCoverage;
+        });
+
+        // release tiles which became too small or too large. Shrinking is delayed to avoid reallocating tile each frame
+        for (const auto& request : requests)
+        {
+            auto& state = this->lights[request.LightKey];
+            state.LastSeenFrame = this->currentFrame;
+            if (!state.Tile.IsValid()) continue;
+
+            size_t desiredSize = this->GetDesiredTileSize(request.ScreenCoverage);
+            bool keepTile = request.NeedsTile && desiredSize <= state.Tile.Size && desiredSize * 4 > state.Tile.Size;
+            if (!keepTile)
+            {
+                this->allocator.Free(state.Tile);
+                state.Tile = ShadowAtlasTile{ };
+                state.HasContent = false;
+            }
+        }
+
+        for (auto it = this->lights.begin(); it != this->lights.end();)
+        {
+            if (it->second.LastSeenFrame != this->currentFrame)
+            {
+                this->allocator.Free(it->second.Tile);
+                it = this->lights.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+
+        for (size_t index : this->order)
+        {
+            const auto& request = requests[index];
+            auto& state = this->lights[request.LightKey];
+            if (request.NeedsTile && !state.Tile.IsValid())
+            {
+                state.Tile = this->AllocateTile(this->GetDesiredTileSize(request.ScreenCoverage));
+                state.HasContent = false;
+            }
+            decisions[index].Tile = state.Tile;
+        }
+    }
+
+    void ShadowAtlasScheduler::ScheduleUpdates(const MxVector<ShadowAtlasRequest>& requests, MxVector<ShadowAtlasDecision>& decisions)
+    {
+        MX_ASSERT(requests.size() == decisions.size() && requests.size() == this->order.size());
+
+        size_t updateCount = 0;
+        auto UpdateLight = [this, &decisions, &updateCount](size_t index, LightState& state)
+        {
+            state.HasContent = true;
+            state.LastUpdateFrame = this->currentFrame;
+            decisions[index].IsUpdated = true;
+            updateCount++;
+        };
+
+        // lights are visited from the largest to the smallest, so near lights take budget first
+        this->farLights.clear();
+        for (size_t index : this->order)
+        {
+            const auto& request = requests[index];
+            auto& state = this->lights[request.LightKey];
+            if (request.NeedsTile && !state.Tile.IsValid()) continue;
+
+            // content of newly allocated shadow map is undefined, so it is rendered regardless of budget
+            if (!state.HasContent)
+                UpdateLight(index, state);
+            else if (!request.IsDirty)
+                continue;
+            else if (request.ScreenCoverage < this->FarLightCoverage)
+                this->farLights.push_back(index);
+            else if (updateCount < this->UpdateBudget)
+                UpdateLight(index, state);
+        }
+
+        // far lights are refreshed round-robin: the least recently updated lights go first
+        std::stable_sort(this->farLights.begin(), this->farLights.end(), [this, &requests](size_t i1, size_t i2)
+        {
+            return this->lights[requests[i1].LightKey].LastUpdateFrame < this->lights[requests[i2].LightKey].LastUpdateFrame;
+        });
+
+        for (size_t index : this->farLights)
+        {
+            if (updateCount >= this->UpdateBudget) break;
+
+            auto& state = this->lights[requests[index].LightKey];
+            if (this->currentFrame - state.LastUpdateFrame >= this->FarLightUpdatePeriod)
+                UpdateLight(index, state);
+        }
+    }
+
+    const ShadowAtlasAllocator& ShadowAtlasScheduler::GetAllocator() const
+    {
+        return this->allocator;
+    }
+}
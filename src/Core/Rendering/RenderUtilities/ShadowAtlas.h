@@ -0,0 +1,123 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/STL/MxHashMap.h"
+
+namespace MxEngine
+{
+    struct ShadowAtlasTile
+    {
+        uint32_t X = 0;
+        uint32_t Y = 0;
+        uint32_t Size = 0;
+
+        bool IsValid() const { return this->Size != 0; }
+        bool operator==(const ShadowAtlasTile& other) const { return this->X == other.X && this->Y == other.Y && this->Size == other.Size; }
+        bool operator!=(const ShadowAtlasTile& other) const { return !(*this == other); }
+    };
+
+    /*!
+    quad-tree (buddy) allocator of square power-of-two tiles inside square shadow atlas
+    freed tiles are merged back with their siblings, so atlas does not fragment over time
+    */
+    class ShadowAtlasAllocator
+    {
+        MxVector<MxVector<ShadowAtlasTile>> freeTiles; // indexed by level, level 0 is the whole atlas
+        size_t atlasSize = 0;
+        size_t minTileSize = 0;
+
+        size_t GetLevel(size_t tileSize) const;
+        bool SplitLevel(size_t level);
+    public:
+        void Init(size_t atlasSize, size_t minTileSize);
+        void Reset();
+
+        ShadowAtlasTile Allocate(size_t tileSize);
+        void Free(const ShadowAtlasTile& tile);
+
+        size_t GetAtlasSize() const;
+        size_t GetMinTileSize() const;
+        size_t GetFreeArea() const;
+    };
+
+    struct ShadowAtlasRequest
+    {
+        size_t LightKey;
+        float ScreenCoverage; // approximate fraction of viewport covered by light bounds, in range [0, 1]
+        bool NeedsTile;       // false for lights which have own shadow map (i.e. point light cubemaps)
+        bool IsDirty;
+    };
+
+    struct ShadowAtlasDecision
+    {
+        ShadowAtlasTile Tile;
+        bool IsUpdated = false;
+    };
+
+    /*!
+    assigns atlas tiles to shadowed lights and decides which shadow maps are updated this frame
+    tile size is chosen by light screen coverage. Near and large lights are updated first while per-frame budget allows,
+    lights with small coverage are considered far and refreshed round-robin not more often than every FarLightUpdatePeriod frames
+    class works only with CPU data, so it does not require graphic context
+    */
+    class ShadowAtlasScheduler
+    {
+        struct LightState
+        {
+            ShadowAtlasTile Tile;
+            size_t LastUpdateFrame = 0;
+            size_t LastSeenFrame = 0;
+            bool HasContent = false;
+        };
+
+        ShadowAtlasAllocator allocator;
+        MxHashMap<size_t, LightState> lights;
+        MxVector<size_t> order;
+        MxVector<size_t> farLights;
+        size_t maxTileSize = 0;
+        size_t currentFrame = 0;
+
+        size_t GetDesiredTileSize(float screenCoverage) const;
+        ShadowAtlasTile AllocateTile(size_t desiredSize);
+    public:
+        size_t UpdateBudget = 4;
+        size_t FarLightUpdatePeriod = 8;
+        float FarLightCoverage = 0.01f;
+
+        void Init(size_t atlasSize, size_t minTileSize, size_t maxTileSize);
+        void Reset();
+
+        void AllocateTiles(const MxVector<ShadowAtlasRequest>& requests, MxVector<ShadowAtlasDecision>& decisions);
+        void ScheduleUpdates(const MxVector<ShadowAtlasRequest>& requests, MxVector<ShadowAtlasDecision>& decisions);
+
+        const ShadowAtlasAllocator& GetAllocator() const;
+    };
+}
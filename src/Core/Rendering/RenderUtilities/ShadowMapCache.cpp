@@ -0,0 +1,171 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "ShadowMapCache.h"
+
+namespace MxEngine
+{
+    bool IsSameSize(const TextureHandle& layer, const TextureHandle& shadowMap, size_t layerSize)
+    {
+        return layer->GetWidth() == layerSize && layer->GetFormat() == shadowMap->GetFormat();
+    }
+
+    bool IsSameSize(const CubeMapHandle& layer, const CubeMapHandle& shadowMap, size_t layerSize)
+    {
+        return layer->GetWidth() == layerSize;
+    }
+
+    void MakeStaticLayer(TextureHandle& layer, const TextureHandle& shadowMap, size_t layerSize)
+    {
+        layer = Factory<Texture>::Create();
+        layer->LoadDepth((int)layerSize, (int)layerSize, shadowMap->GetFormat());
+        layer->SetInternalEngineTag(MXENGINE_MAKE_INTERNAL_TAG("static shadow layer"));
+    }
+
+    void MakeStaticLayer(CubeMapHandle& layer, const CubeMapHandle& shadowMap, size_t layerSize)
+    {
+        layer = Factory<CubeMap>::Create();
+        layer->LoadDepth((int)layerSize, (int)layerSize);
+        layer->SetInternalEngineTag(MXENGINE_MAKE_INTERNAL_TAG("static shadow layer"));
+    }
+
+    ShadowCacheState MaxState(ShadowCacheState s1, ShadowCacheState s2)
+    {
+        return (uint8_t)s1 > (uint8_t)s2 ? s1 : s2;
+    }
+
+    template<typename THandle>
+    ShadowCacheState ShadowMapCache::UpdateEntry(CacheEntry<THandle>& entry, const THandle& shadowMap, size_t layerSize, uint64_t lightHash, const ShadowCasterHash& casters, THandle& staticLayer)
+    {
+        // handles are reused by factory, so entry may belong to already destroyed shadow map
+        bool isNewEntry = entry.ShadowMap != shadowMap || entry.LastUsedFrame + 1 != this->currentFrame;
+        bool isLightChanged = entry.LightHash != lightHash;
+        bool isStaticChanged = entry.Casters.Static != casters.Static;
+        bool isDynamicChanged = entry.Casters.Dynamic != casters.Dynamic || !casters.IsTracked;
+
+        ShadowCacheState state = ShadowCacheState::CLEAN;
+        if (isNewEntry || isLightChanged || isStaticChanged)
+            state = ShadowCacheState::DIRTY;
+        else if (isDynamicChanged)
+            state = this->SplitStaticCasters ? ShadowCacheState::DYNAMIC_DIRTY : ShadowCacheState::DIRTY;
+
+        if (!isNewEntry)
+            state = MaxState(state, entry.PendingState);
+
+        if (this->SplitStaticCasters)
+        {
+            if (!entry.StaticLayer.IsValid() || !IsSameSize(entry.StaticLayer, shadowMap, layerSize))
+            {
+                MakeStaticLayer(entry.StaticLayer, shadowMap, layerSize);
+                state = ShadowCacheState::DIRTY;
+            }
+            staticLayer = entry.StaticLayer;
+        }
+        else
+        {
+            entry.StaticLayer = { };
+        }
+
+        entry.ShadowMap = shadowMap;
+        entry.LightHash = lightHash;
+        entry.Casters = casters;
+        entry.LastUsedFrame = this->currentFrame;
+        entry.PendingState = ShadowCacheState::CLEAN;
+        return state;
+    }
+
+    void ShadowMapCache::BeginFrame()
+    {
+        this->currentFrame++;
+    }
+
+    void ShadowMapCache::EndFrame()
+    {
+        // remove entries of lights which were not submitted this frame, so their static layers are freed
+        auto RemoveUnused = [frame = this->currentFrame](auto& entries)
+        {
+            for (auto it = entries.begin(); it != entries.end();)
+            {
+                if (it->second.LastUsedFrame != frame)
+                    it = entries.erase(it);
+                else
+                    it++;
+            }
+        };
+        RemoveUnused(this->textureEntries);
+        RemoveUnused(this->cubeMapEntries);
+        RemoveUnused(this->atlasEntries);
+    }
+
+    void ShadowMapCache::Invalidate()
+    {
+        this->textureEntries.clear();
+        this->cubeMapEntries.clear();
+        this->atlasEntries.clear();
+    }
+
+    ShadowCacheState ShadowMapCache::Update(const TextureHandle& shadowMap, uint64_t lightHash, const ShadowCasterHash& casters, TextureHandle& staticLayer)
+    {
+        staticLayer = { };
+        if (!this->IsEnabled) return ShadowCacheState::DIRTY;
+
+        auto& entry = this->textureEntries[shadowMap.GetHandle()];
+        return this->UpdateEntry(entry, shadowMap, shadowMap->GetWidth(), lightHash, casters, staticLayer);
+    }
+
+    ShadowCacheState ShadowMapCache::Update(const CubeMapHandle& shadowMap, uint64_t lightHash, const ShadowCasterHash& casters, CubeMapHandle& staticLayer)
+    {
+        staticLayer = { };
+        if (!this->IsEnabled) return ShadowCacheState::DIRTY;
+
+        auto& entry = this->cubeMapEntries[shadowMap.GetHandle()];
+        return this->UpdateEntry(entry, shadowMap, shadowMap->GetWidth(), lightHash, casters, staticLayer);
+    }
+
+    ShadowCacheState ShadowMapCache::Update(size_t lightKey, const TextureHandle& atlas, const ShadowAtlasTile& tile, uint64_t lightHash, const ShadowCasterHash& casters, TextureHandle& staticLayer)
+    {
+        staticLayer = { };
+        if (!this->IsEnabled) return ShadowCacheState::DIRTY;
+
+        // static layer of atlas light covers only its tile
+        auto& entry = this->atlasEntries[lightKey];
+        return this->UpdateEntry(entry, atlas, tile.Size, lightHash, casters, staticLayer);
+    }
+
+    void ShadowMapCache::Postpone(const CubeMapHandle& shadowMap, ShadowCacheState state)
+    {
+        auto it = this->cubeMapEntries.find(shadowMap.GetHandle());
+        if (it != this->cubeMapEntries.end()) it->second.PendingState = state;
+    }
+
+    void ShadowMapCache::Postpone(size_t lightKey, ShadowCacheState state)
+    {
+        auto it = this->atlasEntries.find(lightKey);
+        if (it != this->atlasEntries.end()) it->second.PendingState = state;
+    }
+}
@@ -0,0 +1,93 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Platform/GraphicAPI.h"
+#include "Utilities/STL/MxHashMap.h"
+#include "ShadowAtlas.h"
+
+namespace MxEngine
+{
+    enum class ShadowCacheState : uint8_t
+    {
+        CLEAN,         // shadow map is up to date and can be reused
+        DYNAMIC_DIRTY, // only dynamic casters changed, static layer can be copied into shadow map
+        DIRTY,         // shadow map (and static layer if used) must be fully regenerated
+    };
+
+    struct ShadowCasterHash
+    {
+        uint64_t Static = 0;
+        uint64_t Dynamic = 0;
+        // false if some dynamic casters can not be tracked (i.e. non-static instances), so they must be redrawn each frame
+        bool IsTracked = true;
+    };
+
+    /*!
+    keeps state of shadow maps from previous frames and decides which of them must be regenerated
+    light is considered clean if its projection did not change and all casters inside its bounds are the same as in last frame
+    optionally static casters are rendered into separate static layer, which is copied into shadow map before dynamic casters are drawn
+    */
+    class ShadowMapCache
+    {
+        template<typename THandle>
+        struct CacheEntry
+        {
+            THandle ShadowMap;
+            THandle StaticLayer;
+            uint64_t LightHash = 0;
+            ShadowCasterHash Casters;
+            size_t LastUsedFrame = 0;
+            ShadowCacheState PendingState = ShadowCacheState::CLEAN;
+        };
+
+        MxHashMap<size_t, CacheEntry<TextureHandle>> textureEntries;
+        MxHashMap<size_t, CacheEntry<CubeMapHandle>> cubeMapEntries;
+        MxHashMap<size_t, CacheEntry<TextureHandle>> atlasEntries;
+        size_t currentFrame = 0;
+
+        template<typename THandle>
+        ShadowCacheState UpdateEntry(CacheEntry<THandle>& entry, const THandle& shadowMap, size_t layerSize, uint64_t lightHash, const ShadowCasterHash& casters, THandle& staticLayer);
+    public:
+        bool IsEnabled = true;
+        bool SplitStaticCasters = false;
+
+        void BeginFrame();
+        void EndFrame();
+        void Invalidate();
+
+        ShadowCacheState Update(const TextureHandle& shadowMap, uint64_t lightHash, const ShadowCasterHash& casters, TextureHandle& staticLayer);
+        ShadowCacheState Update(const CubeMapHandle& shadowMap, uint64_t lightHash, const ShadowCasterHash& casters, CubeMapHandle& staticLayer);
+        ShadowCacheState Update(size_t lightKey, const TextureHandle& atlas, const ShadowAtlasTile& tile, uint64_t lightHash, const ShadowCasterHash& casters, TextureHandle& staticLayer);
+
+        // called for dirty lights which were not rendered this frame, so they are regenerated later
+        void Postpone(const CubeMapHandle& shadowMap, ShadowCacheState state);
+        void Postpone(size_t lightKey, ShadowCacheState state);
+    };
+}
@@ -31,6 +31,8 @@
 #include "Core/Rendering/RenderPipeline.h"
 #include "Core/BoundingObjects/FrustrumCuller.h"
 
+#include <cstring>
+
 namespace MxEngine
 {
     ShadowMapGenerator::ShadowMapGenerator(const RenderList& shadowCasters, ArrayView<RenderUnit> renderUnits, ArrayView<Material> materials)
@@ -47,24 +49,32 @@ namespace MxEngine
         Rendering::GetController().ToggleDepthClamp(false);
     }
 
-    void RenderUnitToDepthMap(const Shader& shader, size_t instanceCount, size_t baseInstance, const RenderUnit& unit, ArrayView<Material> materials)
+    void RenderUnitToDepthMap(const Shader& shader, size_t instanceCount, size_t baseInstance, const RenderUnit& unit, ArrayView<Material> materials, const Material* previousMaterial)
     {
-        shader.IgnoreNonExistingUniform("alphaCutoff");
-        shader.IgnoreNonExistingUniform("map_albedo");
-
+        auto& statistics = Rendering::GetController().GetRenderStatistics();
         const auto& material = materials[unit.MaterialIndex];
-        material.HeightMap->Bind(0);
-        material.AlbedoMap->Bind(1);
+
+        // shadow casters are sorted by material, so consecutive units usually share textures
+        statistics.AddEntry(RenderCounter::TEXTURE_BINDS_REQUESTED, 2);
+        if (previousMaterial == nullptr || previousMaterial->HeightMap != material.HeightMap)
+        {
+            material.HeightMap->Bind(0);
+            statistics.AddEntry(RenderCounter::TEXTURE_BINDS, 1);
+        }
+        if (previousMaterial == nullptr || previousMaterial->AlbedoMap != material.AlbedoMap)
+        {
+            material.AlbedoMap->Bind(1);
+            statistics.AddEntry(RenderCounter::TEXTURE_BINDS, 1);
+        }
+
         shader.SetUniform("alphaCutoff", 1.0f - material.Transparency);
         shader.SetUniform("displacement", material.Displacement);
         shader.SetUniform("uvMultipliers", material.UVMultipliers);
-        shader.SetUniform("map_height", material.HeightMap->GetBoundId());
-        shader.SetUniform("map_albedo", material.AlbedoMap->GetBoundId());
         shader.SetUniform("parentModel", unit.ModelMatrix);
         shader.SetUniform("parentNormal", unit.NormalMatrix);
 
-        Rendering::GetController().DrawIndices(RenderPrimitive::TRIANGLES, unit.IndexCount, unit.IndexOffset, unit.VertexOffset, instanceCount, baseInstance);
-        Rendering::GetController().GetRenderStatistics().AddEntry("shadow casts", 1);
+        Rendering::GetController().DrawIndices(RenderPrimitive::TRIANGLES, unit.IndexCount, unit.IndexOffset, unit.VertexOffset, instanceCount, baseInstance, unit.IndexType);
+        statistics.AddEntry(RenderCounter::SHADOW_CASTS, 1);
     }
 
     bool InOrthoFrustrum(const FrustrumCuller& culler, const Vector3& minAABB, const Vector3& maxAABB)
@@ -98,33 +108,120 @@ namespace MxEngine
     }
 
     template<typename CullFunc>
-    void CastShadowsPerUnit(const CullFunc& culler, const Shader& shader, const RenderUnit& unit, size_t instanceCount, size_t baseInstance, ArrayView<Material> materials)
+    bool CastShadowsPerUnit(const CullFunc& culler, const Shader& shader, const RenderUnit& unit, size_t instanceCount, size_t baseInstance, ArrayView<Material> materials, const Material* previousMaterial)
     {
         // do not cull instanced objects, as their position may differ
         bool culled = instanceCount == 0 && !culler(unit.MinAABB, unit.MaxAABB);
         if (!culled)
         {
-            RenderUnitToDepthMap(shader, instanceCount, baseInstance, unit, materials);
+            RenderUnitToDepthMap(shader, instanceCount, baseInstance, unit, materials, previousMaterial);
         }
         else
         {
-            Rendering::GetController().GetRenderStatistics().AddEntry("culled from shadow cast", 1);
+            Rendering::GetController().GetRenderStatistics().AddEntry(RenderCounter::CULLED_FROM_SHADOW_CAST, 1);
         }
+        return !culled;
+    }
+
+    enum class CasterFilter
+    {
+        ALL,
+        STATIC_ONLY,
+        DYNAMIC_ONLY,
+    };
+
+    CasterFilter GetCasterFilter(ShadowMapGenerator::LoadStoreOptions options)
+    {
+        if (options & ShadowMapGenerator::LoadStoreOptions::STATIC_LAYER) return CasterFilter::STATIC_ONLY;
+        if (options & ShadowMapGenerator::LoadStoreOptions::DYNAMIC_OVERLAY) return CasterFilter::DYNAMIC_ONLY;
+        return CasterFilter::ALL;
+    }
+
+    bool IsPassingFilter(CasterFilter filter, const RenderUnit& unit)
+    {
+        return filter == CasterFilter::ALL || unit.IsStatic == (filter == CasterFilter::STATIC_ONLY);
+    }
+
+    template<typename LightUnit>
+    bool IsShadowMapRequired(const LightUnit& light, ShadowMapGenerator::LoadStoreOptions options)
+    {
+        // static layer is rebuilt only if static casters or light itself changed
+        if (options & ShadowMapGenerator::LoadStoreOptions::STATIC_LAYER)
+            return light.ShadowState == ShadowCacheState::DIRTY;
+        return light.ShadowState != ShadowCacheState::CLEAN;
+    }
+
+    template<typename LightUnit>
+    const auto& GetShadowMapTarget(const LightUnit& light, ShadowMapGenerator::LoadStoreOptions options)
+    {
+        return (options & ShadowMapGenerator::LoadStoreOptions::STATIC_LAYER) ? light.StaticShadowMap : light.ShadowMap;
+    }
+
+    template<typename T>
+    uint64_t HashValue(uint64_t seed, const T& value)
+    {
+        static_assert(sizeof(T) % sizeof(uint32_t) == 0, "value size must be multiple of 4 bytes");
+
+        std::array<uint32_t, sizeof(T) / sizeof(uint32_t)> words;
+        std::memcpy(words.data(), &value, sizeof(T));
+        for (uint32_t word : words)
+            seed = RenderSortKey::HashCombine(seed, word);
+        return seed;
+    }
+
+    uint64_t HashShadowCaster(uint64_t seed, const RenderUnit& unit, const RenderGroup& group, const Material& material)
+    {
+        seed = HashValue(seed, unit.ModelMatrix);
+        seed = HashValue(seed, unit.IndexOffset);
+        seed = HashValue(seed, unit.IndexCount);
+        seed = HashValue(seed, (uint32_t)unit.IndexType);
+        seed = HashValue(seed, unit.VertexOffset);
+        seed = HashValue(seed, group.BaseInstance);
+        seed = HashValue(seed, group.InstanceCount);
+        seed = HashValue(seed, material.Transparency);
+        seed = HashValue(seed, material.Displacement);
+        seed = HashValue(seed, material.UVMultipliers);
+        seed = RenderSortKey::HashCombine(seed, material.HeightMap.GetHandle());
+        seed = RenderSortKey::HashCombine(seed, material.AlbedoMap.GetHandle());
+        return seed;
     }
 
     template<typename CullFunc>
-    void CastsShadowsPerGroup(const CullFunc& culler, const Shader& shader, const RenderList& shadowCasters, ArrayView<RenderUnit> units, ArrayView<Material> materials)
+    void HashShadowCasters(const CullFunc& culler, const RenderList& shadowCasters, ArrayView<RenderUnit> units, ArrayView<Material> materials, ShadowCasterHash& hash)
     {
-        size_t currentUnit = 0;
-        for (const auto& group : shadowCasters.Groups)
+        // hash must be computed for the same set of casters, which will be drawn (see CastShadowsPerUnit)
+        for (const auto& command : shadowCasters.DrawCommands)
         {
-            if (group.UnitCount == 0) continue;
+            const auto& group = shadowCasters.Groups[command.GroupIndex];
+            const RenderUnit& unit = units[command.UnitIndex];
+            bool isInstanced = group.InstanceCount > 0;
+            if (!isInstanced && !culler(unit.MinAABB, unit.MaxAABB)) continue;
 
-            for (size_t i = 0; i < group.UnitCount; i++, currentUnit++)
-            {
-                const RenderUnit& unit = units[shadowCasters.UnitsIndex[currentUnit]];
-                CastShadowsPerUnit(culler, shader, unit, group.InstanceCount, group.BaseInstance, materials);
-            }
+            // instance transforms are stored only on GPU, so dynamic instances can not be tracked
+            if (isInstanced && !unit.IsStatic) hash.IsTracked = false;
+
+            auto& target = unit.IsStatic ? hash.Static : hash.Dynamic;
+            target = HashShadowCaster(target, unit, group, materials[unit.MaterialIndex]);
+        }
+    }
+
+    template<typename CullFunc>
+    void CastsShadowsPerGroup(const CullFunc& culler, const Shader& shader, const RenderList& shadowCasters, ArrayView<RenderUnit> units, ArrayView<Material> materials, CasterFilter filter)
+    {
+        shader.IgnoreNonExistingUniform("alphaCutoff");
+        shader.IgnoreNonExistingUniform("map_albedo");
+        shader.SetUniform("map_height", 0);
+        shader.SetUniform("map_albedo", 1);
+
+        const Material* previousMaterial = nullptr;
+        for (const auto& command : shadowCasters.DrawCommands)
+        {
+            const auto& group = shadowCasters.Groups[command.GroupIndex];
+            const RenderUnit& unit = units[command.UnitIndex];
+            if (!IsPassingFilter(filter, unit)) continue;
+
+            if (CastShadowsPerUnit(culler, shader, unit, group.InstanceCount, group.BaseInstance, materials, previousMaterial))
+                previousMaterial = &materials[unit.MaterialIndex];
         }
     }
 
@@ -132,14 +229,19 @@ namespace MxEngine
     {
         auto& controller = Rendering::GetController();
 
+        auto filter = GetCasterFilter(options);
+
         shader.Bind();
         for (auto& directionalLight : directionalLights)
         {
+            if (!IsShadowMapRequired(directionalLight, options)) continue;
+
+            const auto& target = GetShadowMapTarget(directionalLight, options);
             if (options & LoadStoreOptions::LOAD)
-                controller.AttachDepthMapNoClear(directionalLight.ShadowMap);
+                controller.AttachDepthMapNoClear(target);
             else
-                controller.AttachDepthMap(directionalLight.ShadowMap);
-            size_t splitSize = directionalLight.ShadowMap->GetWidth() / directionalLight.ProjectionMatrices.size();
+                controller.AttachDepthMap(target);
+            size_t splitSize = target->GetWidth() / directionalLight.ProjectionMatrices.size();
 
             for (size_t i = 0; i < directionalLight.ProjectionMatrices.size(); i++)
             {
@@ -153,7 +255,7 @@ namespace MxEngine
                     return InOrthoFrustrum(culler, min, max);
                 };
 
-                CastsShadowsPerGroup(CullingFunction, shader, this->shadowCasters, this->renderUnits, this->materials);
+                CastsShadowsPerGroup(CullingFunction, shader, this->shadowCasters, this->renderUnits, this->materials, filter);
             }
 
         }
@@ -163,13 +265,26 @@ namespace MxEngine
     {
         auto& controller = Rendering::GetController();
 
+        auto filter = GetCasterFilter(options);
+
         shader.Bind();
         for (auto& spotLight : spotLights)
         {
-            if (options & LoadStoreOptions::LOAD)
-                controller.AttachDepthMapNoClear(spotLight.ShadowMap);
+            if (!IsShadowMapRequired(spotLight, options)) continue;
+
+            // static layer has size of light tile, while shadow map itself is shared atlas
+            const auto& target = GetShadowMapTarget(spotLight, options);
+            if (options & LoadStoreOptions::STATIC_LAYER)
+            {
+                if (options & LoadStoreOptions::LOAD)
+                    controller.AttachDepthMapNoClear(target);
+                else
+                    controller.AttachDepthMap(target);
+            }
             else
-                controller.AttachDepthMap(spotLight.ShadowMap);
+            {
+                controller.AttachDepthMapTile(target, spotLight.ShadowTile, !(options & LoadStoreOptions::LOAD));
+            }
 
             shader.SetUniform("LightProjMatrix", spotLight.ProjectionMatrix);
 
@@ -178,7 +293,7 @@ namespace MxEngine
                 return InConeBounds(spotLight, min, max);
             };
 
-            CastsShadowsPerGroup(CullingFunction, shader, this->shadowCasters, this->renderUnits, this->materials);
+            CastsShadowsPerGroup(CullingFunction, shader, this->shadowCasters, this->renderUnits, this->materials, filter);
         }
     }
 
@@ -186,13 +301,18 @@ namespace MxEngine
     {
         auto& controller = Rendering::GetController();
 
+        auto filter = GetCasterFilter(options);
+
         shader.Bind();
         for (auto& pointLight : pointLights)
         {
+            if (!IsShadowMapRequired(pointLight, options)) continue;
+
+            const auto& target = GetShadowMapTarget(pointLight, options);
             if (options & LoadStoreOptions::LOAD)
-                controller.AttachDepthMapNoClear(pointLight.ShadowMap);
+                controller.AttachDepthMapNoClear(target);
             else
-                controller.AttachDepthMap(pointLight.ShadowMap);
+                controller.AttachDepthMap(target);
 
             shader.SetUniform("LightProjMatrix[0]", pointLight.ProjectionMatrices[0]);
             shader.SetUniform("LightProjMatrix[1]", pointLight.ProjectionMatrices[1]);
@@ -208,10 +328,63 @@ namespace MxEngine
                 return InSphereBounds(pointLight, min, max);
             };
 
-            CastsShadowsPerGroup(CullingFunction, shader, this->shadowCasters, this->renderUnits, this->materials);
+            CastsShadowsPerGroup(CullingFunction, shader, this->shadowCasters, this->renderUnits, this->materials, filter);
+        }
+    }
+
+    void ShadowMapGenerator::HashCastersFor(const DirectionalLightUnit& directionalLight, ShadowCasterHash& hash) const
+    {
+        for (const auto& projection : directionalLight.ProjectionMatrices)
+        {
+            auto CullingFunction = [culler = FrustrumCuller(projection)](const Vector3& min, const Vector3& max)
+            {
+                return InOrthoFrustrum(culler, min, max);
+            };
+            HashShadowCasters(CullingFunction, this->shadowCasters, this->renderUnits, this->materials, hash);
         }
     }
 
+    void ShadowMapGenerator::HashCastersFor(const PointLightUnit& pointLight, ShadowCasterHash& hash) const
+    {
+        auto CullingFunction = [&pointLight](const Vector3& min, const Vector3& max)
+        {
+            return InSphereBounds(pointLight, min, max);
+        };
+        HashShadowCasters(CullingFunction, this->shadowCasters, this->renderUnits, this->materials, hash);
+    }
+
+    void ShadowMapGenerator::HashCastersFor(const SpotLightUnit& spotLight, ShadowCasterHash& hash) const
+    {
+        auto CullingFunction = [&spotLight](const Vector3& min, const Vector3& max)
+        {
+            return InConeBounds(spotLight, min, max);
+        };
+        HashShadowCasters(CullingFunction, this->shadowCasters, this->renderUnits, this->materials, hash);
+    }
+
+    uint64_t ShadowMapGenerator::HashLight(const DirectionalLightUnit& directionalLight)
+    {
+        uint64_t hash = HashValue(0, directionalLight.ProjectionMatrices);
+        hash = HashValue(hash, directionalLight.ShadowMap->GetWidth());
+        return HashValue(hash, directionalLight.ShadowMap->GetHeight());
+    }
+
+    uint64_t ShadowMapGenerator::HashLight(const PointLightUnit& pointLight)
+    {
+        uint64_t hash = HashValue(0, pointLight.ProjectionMatrices);
+        hash = HashValue(hash, pointLight.Position);
+        hash = HashValue(hash, pointLight.Radius);
+        return HashValue(hash, pointLight.ShadowMap->GetWidth());
+    }
+
+    uint64_t ShadowMapGenerator::HashLight(const SpotLightUnit& spotLight)
+    {
+        uint64_t hash = HashValue(0, spotLight.ProjectionMatrix);
+        hash = HashValue(hash, spotLight.ShadowTile.X);
+        hash = HashValue(hash, spotLight.ShadowTile.Y);
+        return HashValue(hash, spotLight.ShadowTile.Size);
+    }
+
     ShadowMapGenerator::LoadStoreOptions operator|(ShadowMapGenerator::LoadStoreOptions options1, ShadowMapGenerator::LoadStoreOptions options2)
     {
         return ShadowMapGenerator::LoadStoreOptions(uint32_t(options1) | uint32_t(options2));
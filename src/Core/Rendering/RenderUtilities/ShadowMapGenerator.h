@@ -27,6 +27,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Utilities/Array/ArrayView.h"
+#include "ShadowMapCache.h"
 
 namespace MxEngine
 {
@@ -48,6 +49,8 @@ namespace MxEngine
         {
             CLEAR = 1 << 0, 
             LOAD = 1 << 1,
+            STATIC_LAYER = 1 << 2,    // draw only static casters into static layer of fully dirty lights
+            DYNAMIC_OVERLAY = 1 << 3, // draw only dynamic casters on top of shadow map of dirty lights
         };
 
         ShadowMapGenerator(const RenderList& shadowCasters, ArrayView<RenderUnit> renderUnits, ArrayView<Material> materials);
@@ -56,6 +59,14 @@ namespace MxEngine
         void GenerateFor(const Shader& shader, ArrayView<DirectionalLightUnit> directionalLights, LoadStoreOptions options);
         void GenerateFor(const Shader& shader, ArrayView<PointLightUnit> pointLights, LoadStoreOptions options);
         void GenerateFor(const Shader& shader, ArrayView<SpotLightUnit> spotLights, LoadStoreOptions options);
+
+        void HashCastersFor(const DirectionalLightUnit& directionalLight, ShadowCasterHash& hash) const;
+        void HashCastersFor(const PointLightUnit& pointLight, ShadowCasterHash& hash) const;
+        void HashCastersFor(const SpotLightUnit& spotLight, ShadowCasterHash& hash) const;
+
+        static uint64_t HashLight(const DirectionalLightUnit& directionalLight);
+        static uint64_t HashLight(const PointLightUnit& pointLight);
+        static uint64_t HashLight(const SpotLightUnit& spotLight);
     };
 
     ShadowMapGenerator::LoadStoreOptions operator|(ShadowMapGenerator::LoadStoreOptions options1, ShadowMapGenerator::LoadStoreOptions options2);
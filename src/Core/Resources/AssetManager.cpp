@@ -29,6 +29,7 @@
 #include "AssetManager.h"
 #include "Utilities/FileSystem/FileManager.h"
 #include "Core/Components/Rendering/MeshRenderer.h"
+#include "Library/Mesh/MeshSimplifier.h"
 
 namespace MxEngine
 {
@@ -269,6 +270,30 @@ namespace MxEngine
         return AssetManager::LoadMesh(FilePath(path));
     }
 
+    MeshHandle AssetManager::LoadMesh(StringId hash, const MeshLODConfig& lodConfig)
+    {
+        auto mesh = AssetManager::LoadMesh(hash);
+        mesh->SetLODs(MeshSimplifier::GenerateLODs(*mesh, lodConfig));
+        return mesh;
+    }
+
+    MeshHandle AssetManager::LoadMesh(const FilePath& path, const MeshLODConfig& lodConfig)
+    {
+        auto localPath = RegisterExternalFolder(path);
+        auto hash = FileManager::RegisterExternalResource(localPath);
+        return AssetManager::LoadMesh(hash, lodConfig);
+    }
+
+    MeshHandle AssetManager::LoadMesh(const MxString& path, const MeshLODConfig& lodConfig)
+    {
+        return AssetManager::LoadMesh(ToFilePath(path), lodConfig);
+    }
+
+    MeshHandle AssetManager::LoadMesh(const char* path, const MeshLODConfig& lodConfig)
+    {
+        return AssetManager::LoadMesh(FilePath(path), lodConfig);
+    }
+
     MxVector<MaterialHandle> AssetManager::LoadMaterials(StringId hash)
     {
         auto& path = FileManager::GetFilePath(hash);
@@ -40,6 +40,8 @@ namespace MxEngine
     MXENGINE_MAKE_FACTORY(Material);
     MXENGINE_MAKE_FACTORY(Mesh);
 
+    struct MeshLODConfig;
+
     class AssetManager
     {
     public:
@@ -80,6 +82,10 @@ namespace MxEngine
         static MeshHandle LoadMesh(const FilePath& path);
         static MeshHandle LoadMesh(const MxString& path);
         static MeshHandle LoadMesh(const char* path);
+        static MeshHandle LoadMesh(StringId hash, const MeshLODConfig& lodConfig);
+        static MeshHandle LoadMesh(const FilePath& path, const MeshLODConfig& lodConfig);
+        static MeshHandle LoadMesh(const MxString& path, const MeshLODConfig& lodConfig);
+        static MeshHandle LoadMesh(const char* path, const MeshLODConfig& lodConfig);
 
         static MxVector<MaterialHandle> LoadMaterials(StringId hash);
         static MxVector<MaterialHandle> LoadMaterials(const FilePath& path);
@@ -27,24 +27,72 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "BufferAllocator.h"
-#include "FreeListAllocator.h"
+#include "BufferAllocatorPool.h"
+#include "Vertex.h"
+#include "Core/Config/GlobalConfig.h"
+#include "Core/Components/Instancing/InstanceFactory.h"
 #include "Utilities/Logging/Logger.h"
+#include "Utilities/STL/MxVector.h"
 
 namespace MxEngine
 {
     struct BufferAllocatorImpl
     {
-        Allocators::FreeListAllocator AllocatorVBO;
-        Allocators::FreeListAllocator AllocatorIBO;
-        Allocators::FreeListAllocator AllocatorInstanceVBO;
-        Allocators::FreeListAllocator AllocatorSSBO;
+        BufferAllocatorPool PoolVBO;
+        BufferAllocatorPool PoolIBO;
+        BufferAllocatorPool PoolInstanceVBO;
+        BufferAllocatorPool PoolSSBO;
         VertexBufferHandle VBO;
         IndexBufferHandle IBO;
         VertexBufferHandle InstanceVBO;
         ShaderStorageBufferHandle SSBO;
         VertexArrayHandle VAO;
+
+        struct DeferredDeallocation
+        {
+            BufferAllocatorPool* Pool;
+            size_t Offset;
+        };
+        MxVector<DeferredDeallocation> DeferredDeallocations;
+        bool IsDeallocationDeferred = false;
     };
 
+    float BufferAllocatorStatistics::GetFragmentation() const
+    {
+        size_t freeSize = this->Capacity - this->AllocatedSize;
+        if (freeSize == 0) return 0.0f;
+        return 1.0f - float(this->LargestFreeBlock) / float(freeSize);
+    }
+
+    static void LinkVertexArray(VertexArray& vao, const VertexBuffer& vbo, const VertexBuffer& instanceVBO, const IndexBuffer& ibo)
+    {
+        auto vertexLayout = BufferAllocator::GetVertexLayout();
+        std::array instanceLayout = {
+            VertexAttribute::Entry<Matrix3x4>(),             // model rows
+            VertexAttribute::NormalizedEntry<VectorByte4>(), // color
+        };
+
+        vao.AddVertexLayout(vbo, vertexLayout, VertexAttributeInputRate::PER_VERTEX);
+        vao.AddVertexLayout(instanceVBO, instanceLayout, VertexAttributeInputRate::PER_INSTANCE);
+        vao.LinkIndexBuffer(ibo);
+    }
+
+    static void Deallocate(BufferAllocatorImpl& allocator, BufferAllocatorPool& pool, size_t offset)
+    {
+        if (allocator.IsDeallocationDeferred)
+            allocator.DeferredDeallocations.push_back({ &pool, offset });
+        else
+            pool.Deallocate(offset);
+    }
+
+    static void RelinkVertexArray(BufferAllocatorImpl& allocator)
+    {
+        // vertex array references buffer objects directly, so it must be recreated after their storage is replaced.
+        // other vertex arrays over shared buffers (i.e. light volumes) compare native handles and relink on their own
+        *allocator.VAO = VertexArray();
+        LinkVertexArray(*allocator.VAO, *allocator.VBO, *allocator.InstanceVBO, *allocator.IBO);
+    }
+
     void BufferAllocator::Init()
     {
         impl = new BufferAllocatorImpl();
@@ -67,71 +115,66 @@ namespace MxEngine
 
     void BufferAllocator::AllocateBuffers()
     {
-        impl->VBO = Factory<VertexBuffer>::Create(nullptr, 0, UsageType::DYNAMIC_COPY);
-        impl->IBO = Factory<IndexBuffer>::Create(nullptr, 0, UsageType::DYNAMIC_COPY);
-        impl->InstanceVBO = Factory<VertexBuffer>::Create(nullptr, 0, UsageType::DYNAMIC_COPY);
-        impl->SSBO = Factory<ShaderStorageBuffer>::Create((uint8_t*)nullptr, 0, UsageType::DYNAMIC_COPY);
+        // config sizes are in bytes, while allocators operate on buffer elements
+        size_t vboSize = GlobalConfig::GetVertexBufferSize() / sizeof(VertexBuffer::VertexScalar);
+        size_t iboSize = GlobalConfig::GetIndexBufferSize() / sizeof(IndexBuffer::IndexType);
+        size_t instanceVBOSize = GlobalConfig::GetInstanceBufferSize() / sizeof(VertexBuffer::VertexScalar);
+        size_t ssboSize = GlobalConfig::GetStorageBufferSize();
+
+        impl->VBO = Factory<VertexBuffer>::Create(nullptr, vboSize, UsageType::DYNAMIC_COPY);
+        impl->IBO = Factory<IndexBuffer>::Create(nullptr, iboSize, UsageType::DYNAMIC_COPY);
+        impl->InstanceVBO = Factory<VertexBuffer>::Create(nullptr, instanceVBOSize, UsageType::DYNAMIC_COPY);
+        impl->SSBO = Factory<ShaderStorageBuffer>::Create((uint8_t*)nullptr, ssboSize, UsageType::DYNAMIC_COPY);
         impl->VAO = Factory<VertexArray>::Create();
 
-        impl->AllocatorVBO.Init(0, [](size_t newSize)
+        // allocations keep their offsets on growth, so storage is copied once into new buffer which then replaces the old one
+        impl->PoolVBO.Init(vboSize, [](size_t newSize)
         {
-            auto copyVBO = Factory<VertexBuffer>::Create(nullptr, impl->VBO->GetSize(), UsageType::STREAM_COPY);
-            copyVBO->LoadFrom(*impl->VBO);
-            impl->VBO->Load(nullptr, newSize, UsageType::DYNAMIC_COPY);
-            impl->VBO->LoadFrom(*copyVBO);
+            size_t oldSize = impl->VBO->GetSize();
+            VertexBuffer newVBO(nullptr, newSize, UsageType::DYNAMIC_COPY);
+            newVBO.LoadFrom(*impl->VBO);
+            *impl->VBO = std::move(newVBO);
+            RelinkVertexArray(*impl);
+            impl->PoolVBO.OnRelocate(oldSize, newSize);
             MXLOG_DEBUG("MxEngine::BufferAllocator", "relocated vertex buffer storage to new memory with size: " + ToMxString(newSize));
         });
-        impl->AllocatorIBO.Init(0, [](size_t newSize)
+        impl->PoolIBO.Init(iboSize, [](size_t newSize)
         {
-            auto copyIBO = Factory<IndexBuffer>::Create(nullptr, impl->IBO->GetSize(), UsageType::STREAM_COPY);
-            copyIBO->LoadFrom(*impl->IBO);
-            impl->IBO->Load(nullptr, newSize, UsageType::DYNAMIC_COPY);
-            impl->IBO->LoadFrom(*copyIBO);
+            size_t oldSize = impl->IBO->GetSize();
+            IndexBuffer newIBO(nullptr, newSize, UsageType::DYNAMIC_COPY);
+            newIBO.LoadFrom(*impl->IBO);
+            *impl->IBO = std::move(newIBO);
+            RelinkVertexArray(*impl);
+            impl->PoolIBO.OnRelocate(oldSize, newSize);
             MXLOG_DEBUG("MxEngine::BufferAllocator", "relocated index buffer storage to new memory with size: " + ToMxString(newSize));
         });
-        impl->AllocatorInstanceVBO.Init(0, [](size_t newSize)
+        impl->PoolInstanceVBO.Init(instanceVBOSize, [](size_t newSize)
         {
-            auto copyInstanceVBO = Factory<VertexBuffer>::Create(nullptr, impl->InstanceVBO->GetSize(), UsageType::STREAM_COPY);
-            copyInstanceVBO->LoadFrom(*impl->InstanceVBO);
-            impl->InstanceVBO->Load(nullptr, newSize, UsageType::DYNAMIC_COPY);
-            impl->InstanceVBO->LoadFrom(*copyInstanceVBO);
+            size_t oldSize = impl->InstanceVBO->GetSize();
+            VertexBuffer newInstanceVBO(nullptr, newSize, UsageType::DYNAMIC_COPY);
+            newInstanceVBO.LoadFrom(*impl->InstanceVBO);
+            *impl->InstanceVBO = std::move(newInstanceVBO);
+            RelinkVertexArray(*impl);
+            impl->PoolInstanceVBO.OnRelocate(oldSize, newSize);
             MXLOG_DEBUG("MxEngine::BufferAllocator", "relocated instance vertex buffer storage to new memory with size: " + ToMxString(newSize));
         });
-        impl->AllocatorSSBO.Init(0, [](size_t newSize)
+        impl->PoolSSBO.Init(ssboSize, [](size_t newSize)
         {
-            auto copySSBO = Factory<ShaderStorageBuffer>::Create((uint8_t*)nullptr, impl->SSBO->GetByteSize(), UsageType::STREAM_COPY);
-            copySSBO->LoadFrom(*impl->SSBO);
-            impl->SSBO->Load<uint8_t>(nullptr, newSize, UsageType::DYNAMIC_COPY);
-            impl->SSBO->LoadFrom(*copySSBO);
+            // storage buffer is bound by handle before each use, so no relinking is required
+            size_t oldSize = impl->SSBO->GetByteSize();
+            ShaderStorageBuffer newSSBO((uint8_t*)nullptr, newSize, UsageType::DYNAMIC_COPY);
+            newSSBO.LoadFrom(*impl->SSBO);
+            *impl->SSBO = std::move(newSSBO);
+            impl->PoolSSBO.OnRelocate(oldSize, newSize);
             MXLOG_DEBUG("MxEngine::BufferAllocator", "relocated shader storage buffer storage to new memory with size: " + ToMxString(newSize));
         });
 
-        std::array vertexLayout = {
-            VertexAttribute::Entry<Vector3>(), // position
-            VertexAttribute::Entry<Vector2>(), // texture uv
-            VertexAttribute::Entry<Vector3>(), // normal
-            VertexAttribute::Entry<Vector3>(), // tangent
-            VertexAttribute::Entry<Vector3>(), // bitangent
-        };
-        std::array instanceLayout = {
-            VertexAttribute::Entry<Matrix4x4>(), // model
-            VertexAttribute::Entry<Matrix3x3>(), // normal
-            VertexAttribute::Entry<Vector3>(),   // color
-        };
+        LinkVertexArray(*impl->VAO, *impl->VBO, *impl->InstanceVBO, *impl->IBO);
 
-        impl->VAO->AddVertexLayout(*impl->VBO, vertexLayout, VertexAttributeInputRate::PER_VERTEX);
-        impl->VAO->AddVertexLayout(*impl->InstanceVBO, instanceLayout, VertexAttributeInputRate::PER_INSTANCE);
-        impl->VAO->LinkIndexBuffer(*impl->IBO);
-
-        struct
-        {
-            Matrix4x4 field1{ 1.0f };
-            Matrix3x3 field2{ 1.0f };
-            Vector3   field3{ 1.0f };
-        } DefaultInstance;
+        InstanceFactory::InstanceData DefaultInstance;
 
         // assume first allocation is with offset = 0
-        (void)impl->AllocatorInstanceVBO.Allocate(sizeof(DefaultInstance) / sizeof(float));
+        (void)impl->PoolInstanceVBO.Allocate(sizeof(DefaultInstance) / sizeof(float));
         impl->InstanceVBO->BufferSubData((float*)&DefaultInstance, sizeof(DefaultInstance) / sizeof(float));
     }
 
@@ -150,6 +193,33 @@ namespace MxEngine
         return impl->InstanceVBO;
     }
 
+    std::array<VertexAttribute, 5> BufferAllocator::GetVertexLayout()
+    {
+        // compressed layout keeps same number of attributes, so shader locations of other attributes do not depend on it
+        if (GlobalConfig::HasCompressedVertices())
+        {
+            return {
+                VertexAttribute::Entry<Vector3>(),                // position
+                VertexAttribute::Entry<VectorHalf2>(),            // texture uv
+                VertexAttribute::NormalizedEntry<VectorShort2>(), // octahedral normal
+                VertexAttribute::NormalizedEntry<VectorShort2>(), // octahedral tangent
+                VertexAttribute::NormalizedEntry<VectorShort2>(), // bitangent sign
+            };
+        }
+        return {
+            VertexAttribute::Entry<Vector3>(), // position
+            VertexAttribute::Entry<Vector2>(), // texture uv
+            VertexAttribute::Entry<Vector3>(), // normal
+            VertexAttribute::Entry<Vector3>(), // tangent
+            VertexAttribute::Entry<Vector3>(), // bitangent
+        };
+    }
+
+    size_t BufferAllocator::GetVertexSize()
+    {
+        return GlobalConfig::HasCompressedVertices() ? CompressedVertex::Size : Vertex::Size;
+    }
+
     VertexArrayHandle BufferAllocator::GetVAO()
     {
         return impl->VAO;
@@ -162,45 +232,78 @@ namespace MxEngine
 
     BufferAllocation BufferAllocator::AllocateInVBO(size_t sizeInFloats)
     {
-        size_t offset = impl->AllocatorVBO.Allocate(sizeInFloats);
+        size_t offset = impl->PoolVBO.Allocate(sizeInFloats);
         return BufferAllocation{ offset, sizeInFloats };
     }
 
     BufferAllocation BufferAllocator::AllocateInIBO(size_t sizeInIndices)
     {
-        size_t offset = impl->AllocatorIBO.Allocate(sizeInIndices);
+        size_t offset = impl->PoolIBO.Allocate(sizeInIndices);
         return BufferAllocation{ offset, sizeInIndices };
     }
 
     BufferAllocation BufferAllocator::AllocateInInstanceVBO(size_t sizeInInstances)
     {
-        size_t offset = impl->AllocatorInstanceVBO.Allocate(sizeInInstances);
+        size_t offset = impl->PoolInstanceVBO.Allocate(sizeInInstances);
         return BufferAllocation{ offset, sizeInInstances };
     }
 
     BufferAllocation BufferAllocator::AllocateInSSBO(size_t sizeInBytes)
     {
-        size_t offset = impl->AllocatorSSBO.Allocate(sizeInBytes);
+        size_t offset = impl->PoolSSBO.Allocate(sizeInBytes);
         return BufferAllocation{ offset, sizeInBytes };
     }
 
     void BufferAllocator::DeallocateInVBO(BufferAllocation allocation)
     {
-        impl->AllocatorVBO.Deallocate(allocation.Offset);
+        Deallocate(*impl, impl->PoolVBO, allocation.Offset);
     }
 
     void BufferAllocator::DeallocateInIBO(BufferAllocation allocation)
     {
-        impl->AllocatorIBO.Deallocate(allocation.Offset);
+        Deallocate(*impl, impl->PoolIBO, allocation.Offset);
     }
 
     void BufferAllocator::DeallocateInInstanceVBO(BufferAllocation allocation)
     {
-        impl->AllocatorInstanceVBO.Deallocate(allocation.Offset);
+        Deallocate(*impl, impl->PoolInstanceVBO, allocation.Offset);
     }
 
     void BufferAllocator::DeallocateInSSBO(BufferAllocation allocation)
     {
-        impl->AllocatorSSBO.Deallocate(allocation.Offset);
+        Deallocate(*impl, impl->PoolSSBO, allocation.Offset);
+    }
+
+    void BufferAllocator::BeginDeferredDeallocation()
+    {
+        impl->IsDeallocationDeferred = true;
+    }
+
+    void BufferAllocator::EndDeferredDeallocation()
+    {
+        impl->IsDeallocationDeferred = false;
+        for (const auto& deallocation : impl->DeferredDeallocations)
+            deallocation.Pool->Deallocate(deallocation.Offset);
+        impl->DeferredDeallocations.clear();
+    }
+
+    BufferAllocatorStatistics BufferAllocator::GetVBOStatistics()
+    {
+        return impl->PoolVBO.GetStatistics();
+    }
+
+    BufferAllocatorStatistics BufferAllocator::GetIBOStatistics()
+    {
+        return impl->PoolIBO.GetStatistics();
+    }
+
+    BufferAllocatorStatistics BufferAllocator::GetInstanceVBOStatistics()
+    {
+        return impl->PoolInstanceVBO.GetStatistics();
+    }
+
+    BufferAllocatorStatistics BufferAllocator::GetSSBOStatistics()
+    {
+        return impl->PoolSSBO.GetStatistics();
     }
 }
\ No newline at end of file
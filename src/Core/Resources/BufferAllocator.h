@@ -28,6 +28,8 @@
 
 #include "Platform/GraphicAPI.h"
 
+#include <array>
+
 namespace MxEngine
 {
     struct BufferAllocatorImpl;
@@ -38,6 +40,26 @@ namespace MxEngine
         const size_t Size;
     };
 
+    /*!
+    sizes are measured in elements of corresponding buffer: floats for vertex buffers, indices for index buffer and bytes for storage buffer
+    */
+    struct BufferAllocatorStatistics
+    {
+        size_t Capacity = 0;
+        size_t AllocatedSize = 0;
+        size_t AllocationCount = 0;
+        size_t TotalAllocations = 0;
+        size_t FreeBlockCount = 0;
+        size_t LargestFreeBlock = 0;
+        size_t RelocationCount = 0;
+        size_t RelocatedSize = 0;
+
+        /*!
+        \returns 0 if all free space is in one block, approaches 1 as free space is split into many small blocks
+        */
+        float GetFragmentation() const;
+    };
+
     class BufferAllocator
     {
         inline static BufferAllocatorImpl* impl;
@@ -52,6 +74,8 @@ namespace MxEngine
         static IndexBufferHandle GetIBO();
         static VertexBufferHandle GetInstanceVBO();
         static VertexArrayHandle GetVAO();
+        static std::array<VertexAttribute, 5> GetVertexLayout();
+        static size_t GetVertexSize();
         static ShaderStorageBufferHandle GetSSBO();
         static BufferAllocation AllocateInVBO(size_t sizeInFloats);
         static BufferAllocation AllocateInIBO(size_t sizeInIndices);
@@ -61,5 +85,17 @@ namespace MxEngine
         static void DeallocateInIBO(BufferAllocation allocation);
         static void DeallocateInInstanceVBO(BufferAllocation allocation);
         static void DeallocateInSSBO(BufferAllocation allocation);
+        /*!
+        starts deferring all deallocations, so ranges still referenced by collected frame are not reused until it is rendered
+        */
+        static void BeginDeferredDeallocation();
+        /*!
+        frees all deallocations deferred since last call to BeginDeferredDeallocation() and stops deferring new ones
+        */
+        static void EndDeferredDeallocation();
+        static BufferAllocatorStatistics GetVBOStatistics();
+        static BufferAllocatorStatistics GetIBOStatistics();
+        static BufferAllocatorStatistics GetInstanceVBOStatistics();
+        static BufferAllocatorStatistics GetSSBOStatistics();
     };
 }
\ No newline at end of file
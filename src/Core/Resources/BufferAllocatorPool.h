@@ -0,0 +1,116 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "BufferAllocator.h"
+#include "FreeListAllocator.h"
+#include "Utilities/Math/Math.h"
+#include "Utilities/STL/MxMap.h"
+
+#include <utility>
+
+namespace MxEngine
+{
+    /*!
+    free list allocator of one shared buffer, which also tracks its live allocations for statistics.
+    sizes and offsets are measured in buffer elements, allocations keep their offsets when buffer grows
+    */
+    struct BufferAllocatorPool
+    {
+        Allocators::FreeListAllocator Allocator;
+        // offset -> size of each live allocation, used only to compute statistics
+        MxMap<size_t, size_t> Allocations;
+        size_t Capacity = 0;
+        size_t AllocatedSize = 0;
+        size_t TotalAllocations = 0;
+        size_t RelocationCount = 0;
+        size_t RelocatedSize = 0;
+
+        // onGrow(newSize) is invoked when allocation does not fit, and must replace storage of buffer keeping its contents
+        template<typename GrowCallback>
+        void Init(size_t capacity, GrowCallback&& onGrow)
+        {
+            this->Capacity = capacity;
+            this->Allocator.Init(capacity, std::forward<GrowCallback>(onGrow));
+        }
+
+        size_t Allocate(size_t size)
+        {
+            size_t offset = this->Allocator.Allocate(size);
+            this->Allocations[offset] = size;
+            this->AllocatedSize += size;
+            this->TotalAllocations++;
+            return offset;
+        }
+
+        void Deallocate(size_t offset)
+        {
+            auto it = this->Allocations.find(offset);
+            if (it != this->Allocations.end())
+            {
+                this->AllocatedSize -= it->second;
+                this->Allocations.erase(it);
+            }
+            this->Allocator.Deallocate(offset);
+        }
+
+        void OnRelocate(size_t oldSize, size_t newSize)
+        {
+            this->Capacity = newSize;
+            this->RelocationCount++;
+            this->RelocatedSize += oldSize;
+        }
+
+        BufferAllocatorStatistics GetStatistics() const
+        {
+            BufferAllocatorStatistics statistics;
+            statistics.Capacity = this->Capacity;
+            statistics.AllocatedSize = this->AllocatedSize;
+            statistics.AllocationCount = this->Allocations.size();
+            statistics.TotalAllocations = this->TotalAllocations;
+            statistics.RelocationCount = this->RelocationCount;
+            statistics.RelocatedSize = this->RelocatedSize;
+
+            size_t blockBegin = 0;
+            auto AddFreeBlock = [&statistics](size_t begin, size_t end)
+            {
+                if (end <= begin) return;
+                statistics.FreeBlockCount++;
+                statistics.LargestFreeBlock = Max(statistics.LargestFreeBlock, end - begin);
+            };
+            for (const auto& [offset, size] : this->Allocations)
+            {
+                AddFreeBlock(blockBegin, offset);
+                blockBegin = offset + size;
+            }
+            AddFreeBlock(blockBegin, this->Capacity);
+            return statistics;
+        }
+    };
+}
@@ -35,6 +35,7 @@
 #include "Core/Resources/BufferAllocator.h"
 #include "Core/Components/Rendering/MeshRenderer.h"
 #include "Core/Runtime/Reflection.h"
+#include "Library/Mesh/MeshletBuilder.h"
 
 #include <algorithm>
 
@@ -44,6 +45,7 @@ namespace MxEngine
     void Mesh::LoadFromFile(const std::filesystem::path& filepath)
     {
         ObjectInfo objectInfo = ObjectLoader::Load(filepath);
+        this->lods.clear(); // LODs of previously loaded mesh are not valid anymore
 
         this->filepath = ToMxString(filepath);
         std::replace(this->filepath.begin(), this->filepath.end(), '\\', '/');
@@ -80,7 +82,7 @@ namespace MxEngine
         }
         // create CPU-side array for verticies and indicies, and GPU-size VBO/IBO
         MxVector<Vertex> verticies;
-        MxVector<IndexBuffer::IndexType> indicies;
+        MxVector<uint32_t> indicies;
         verticies.reserve(totalVerticies);
         indicies.reserve(totalIndicies);
         this->ReserveData(totalVerticies, totalIndicies);
@@ -93,9 +95,12 @@ namespace MxEngine
 
             MeshData meshData{
                 meshInfo.vertecies.size(), verticies.size() + this->vertexAllocation.Offset,
-                meshInfo.indicies.size(), indicies.size() + this->indexAllocation.Offset
+                meshInfo.indicies.size(), indicies.size() + this->indexAllocation.Offset,
+                this->indexFormat
             };
             meshData.UpdateBoundingGeometry(meshInfo.vertecies);
+            if (meshInfo.indicies.size() / 3 >= MeshletBuilder::MinTriangleCount)
+                meshData.SetMeshlets(MeshletBuilder::Build(meshInfo.vertecies, meshInfo.indicies));
 
             indicies.insert(indicies.end(), meshInfo.indicies.begin(), meshInfo.indicies.end());
             verticies.insert(verticies.end(), meshInfo.vertecies.begin(), meshInfo.vertecies.end());
@@ -103,16 +108,21 @@ namespace MxEngine
             this->AddSubMesh(materialId, std::move(meshData));
         }
         // load verticies and indicies to GPU
-        BufferAllocator::GetVBO()->BufferSubData((float*)verticies.data(), verticies.size() * Vertex::Size, this->vertexAllocation.Offset * Vertex::Size);
-        BufferAllocator::GetIBO()->BufferSubData(indicies.data(), indicies.size(), this->indexAllocation.Offset);
+        MeshData::BufferVertecies(verticies.data(), verticies.size(), this->vertexAllocation.Offset);
+        MeshData::BufferIndicies(indicies.data(), indicies.size(), this->indexAllocation.Offset, this->indexFormat);
 
         this->UpdateBoundingGeometry(); // use submeshes boundings to update mesh boundings
     }
 
     void Mesh::FreeBuffers()
     {
-        if (this->vertexAllocation.Size != 0) BufferAllocator::DeallocateInVBO({ this->vertexAllocation.Offset * Vertex::Size, this->vertexAllocation.Size * Vertex::Size });
-        if (this->indexAllocation.Size != 0) BufferAllocator::DeallocateInIBO({ this->indexAllocation.Offset, this->indexAllocation.Size });
+        if (this->vertexAllocation.Size != 0) BufferAllocator::DeallocateInVBO({ this->vertexAllocation.Offset * BufferAllocator::GetVertexSize(), this->vertexAllocation.Size * BufferAllocator::GetVertexSize() });
+        if (this->indexAllocation.Size != 0) BufferAllocator::DeallocateInIBO({ this->indexAllocation.Offset / this->GetIndiciesPerIBOElement(), this->indexAllocation.Size });
+    }
+
+    size_t Mesh::GetIndiciesPerIBOElement() const
+    {
+        return sizeof(IndexBuffer::IndexType) / IndexBuffer::GetIndexSize(this->indexFormat);
     }
 
     Mesh::Mesh()
@@ -147,13 +157,20 @@ namespace MxEngine
     {
         this->FreeBuffers();
 
-        auto vbo = BufferAllocator::AllocateInVBO(vertexCount * Vertex::Size);
-        auto ibo = BufferAllocator::AllocateInIBO(indexCount);
+        size_t vertexSize = BufferAllocator::GetVertexSize();
+        auto vbo = BufferAllocator::AllocateInVBO(vertexCount * vertexSize);
 
-        this->vertexAllocation.Offset = vbo.Offset / Vertex::Size;
-        this->vertexAllocation.Size = vbo.Size / Vertex::Size;
-        this->indexAllocation.Offset = ibo.Offset;
-        this->indexAllocation.Size = ibo.Size;
+        // submesh indicies are relative to its base vertex, so mesh vertex count bounds all of them.
+        // 16-bit indicies are packed in pairs into shared IBO and addressed in 16-bit units afterwards
+        bool fitsShortIndex = vertexCount <= (size_t)std::numeric_limits<IndexBuffer::ShortIndexType>::max() + 1;
+        this->indexFormat = fitsShortIndex ? IndexFormat::UINT16 : IndexFormat::UINT32;
+        size_t indiciesPerElement = this->GetIndiciesPerIBOElement();
+        auto ibo = BufferAllocator::AllocateInIBO((indexCount + indiciesPerElement - 1) / indiciesPerElement);
+
+        this->vertexAllocation.Offset = vbo.Offset / vertexSize;
+        this->vertexAllocation.Size = vbo.Size / vertexSize;
+        this->indexAllocation.Offset = ibo.Offset * indiciesPerElement;
+        this->indexAllocation.Size = indexCount;
     }
 
     void Mesh::UpdateBoundingGeometry()
@@ -201,6 +218,11 @@ namespace MxEngine
         return this->indexAllocation.Offset;
     }
 
+    IndexFormat Mesh::GetIndexFormat() const
+    {
+        return this->indexFormat;
+    }
+
     const MxString& Mesh::GetFilePath() const
     {
         return this->filepath;
@@ -253,6 +275,16 @@ namespace MxEngine
         this->subMeshTransforms.erase(this->subMeshTransforms.begin() + index);
     }
 
+    const Mesh::LODList& Mesh::GetLODs() const
+    {
+        return this->lods;
+    }
+
+    void Mesh::SetLODs(LODList lods)
+    {
+        this->lods = std::move(lods);
+    }
+
     MoveOnlyAllocation::MoveOnlyAllocation(MoveOnlyAllocation&& other) noexcept
     {
         this->Offset = other.Offset, this->Size = other.Size;
@@ -322,6 +354,14 @@ namespace MxEngine
             (
                 rttr::metadata(MetaInfo::FLAGS, MetaInfo::EDITABLE)
             )
+            .property_readonly("generated lods", &Mesh::GetLODs)
+            (
+                rttr::metadata(MetaInfo::FLAGS, MetaInfo::EDITABLE)
+            )
+            .property_readonly("lod error", &Mesh::LODError)
+            (
+                rttr::metadata(MetaInfo::FLAGS, MetaInfo::EDITABLE)
+            )
             .property("aabb", &Mesh::MeshAABB)
             (
                 rttr::metadata(MetaInfo::FLAGS, MetaInfo::SERIALIZABLE | MetaInfo::EDITABLE),
@@ -52,19 +52,25 @@ namespace MxEngine
     class Mesh
     {
         using SubMeshList = MxVector<SubMesh>;
+        using LODList = MxVector<Resource<Mesh, Factory<Mesh>>>;
         
         SubMeshList submeshes;
+        LODList lods;
         MxString filepath;
         MoveOnlyAllocation vertexAllocation;
         MoveOnlyAllocation indexAllocation;
+        IndexFormat indexFormat = IndexFormat::UINT32;
         MxVector<UniqueRef<Transform>> subMeshTransforms;
 
         template<typename FilePath>
         void LoadFromFile(const FilePath& filepath);
         void FreeBuffers();
+        size_t GetIndiciesPerIBOElement() const;
     public:
         AABB MeshAABB;
         BoundingSphere MeshBoundingSphere;
+        // max deviation from source mesh in object space. Known only for LODs generated by MeshSimplifier
+        float LODError = 0.0f;
 
         explicit Mesh();
         Mesh(Mesh&) = delete;
@@ -85,12 +91,15 @@ namespace MxEngine
         size_t GetTotalIndiciesCount() const;
         size_t GetBaseVerteciesOffset() const;
         size_t GetBaseIndiciesOffset() const;
+        IndexFormat GetIndexFormat() const;
         void SetSubMeshesInternal(const SubMeshList& submeshes);
         const SubMeshList& GetSubMeshes() const;
         const SubMesh& GetSubMeshByIndex(size_t index) const;
         SubMesh& GetSubMeshByIndex(size_t index);
         SubMesh& AddSubMesh(SubMesh::MaterialId materialId, MeshData data);
         void DeleteSubMeshByIndex(size_t index);
+        const LODList& GetLODs() const;
+        void SetLODs(LODList lods);
 
         const MxString& GetFilePath() const;
         void SetInternalEngineTag(const MxString& tag);
@@ -29,15 +29,17 @@
 #include "MeshData.h"
 #include "Core/Runtime/Reflection.h"
 #include "Core/Resources/BufferAllocator.h"
+#include "Core/Config/GlobalConfig.h"
 
 namespace MxEngine
 {
 
-    MeshData::MeshData(size_t vertexCount, size_t vertexOffset, size_t indexCount, size_t indexOffset)
-        : vertexCount(vertexCount), vertexOffset(vertexOffset), indexCount(indexCount), indexOffset(indexOffset)
+    MeshData::MeshData(size_t vertexCount, size_t vertexOffset, size_t indexCount, size_t indexOffset, IndexFormat indexFormat)
+        : vertexCount(vertexCount), vertexOffset(vertexOffset), indexCount(indexCount), indexOffset(indexOffset), indexFormat(indexFormat)
     {
-        MX_ASSERT((this->vertexCount + this->vertexOffset) * Vertex::Size <= this->GetVBO()->GetSize());
-        MX_ASSERT((this->indexCount + this->indexOffset) <= this->GetIBO()->GetSize());
+        MX_ASSERT((this->vertexCount + this->vertexOffset) * BufferAllocator::GetVertexSize() <= this->GetVBO()->GetSize());
+        MX_ASSERT((this->indexCount + this->indexOffset) * IndexBuffer::GetIndexSize(this->indexFormat) <= this->GetIBO()->GetByteSize());
+        MX_ASSERT(this->indexFormat == IndexFormat::UINT32 || this->vertexCount <= (size_t)std::numeric_limits<uint16_t>::max() + 1);
     }
 
     VertexBufferHandle MeshData::GetVBO() const
@@ -60,6 +62,11 @@ namespace MxEngine
         return this->indexOffset;
     }
 
+    IndexFormat MeshData::GetIndexFormat() const
+    {
+        return this->indexFormat;
+    }
+
     const AABB& MeshData::GetAABB() const
     {
         return this->boundingBox;
@@ -70,6 +77,16 @@ namespace MxEngine
         return this->boundingSphere;
     }
 
+    const MxVector<Meshlet>& MeshData::GetMeshlets() const
+    {
+        return this->meshlets;
+    }
+
+    void MeshData::SetMeshlets(MxVector<Meshlet> meshlets)
+    {
+        this->meshlets = std::move(meshlets);
+    }
+
     size_t MeshData::GetVerteciesCount() const
     {
         return this->vertexCount;
@@ -83,12 +100,48 @@ namespace MxEngine
     void MeshData::BufferVertecies(const VertexData& vertecies)
     {
         MX_ASSERT(vertecies.size() == this->vertexCount);
-        this->GetVBO()->BufferSubData((float*)vertecies.data(), this->vertexCount * Vertex::Size, this->vertexOffset * Vertex::Size);
+        MeshData::BufferVertecies(vertecies.data(), this->vertexCount, this->vertexOffset);
+    }
+
+    void MeshData::BufferVertecies(const Vertex* vertecies, size_t vertexCount, size_t vertexOffset)
+    {
+        auto VBO = BufferAllocator::GetVBO();
+        if (GlobalConfig::HasCompressedVertices())
+        {
+            MxVector<CompressedVertex> compressed(vertexCount);
+            for (size_t i = 0; i < vertexCount; i++)
+                compressed[i] = CompressedVertex::Compress(vertecies[i]);
+            VBO->BufferSubData((float*)compressed.data(), vertexCount * CompressedVertex::Size, vertexOffset * CompressedVertex::Size);
+        }
+        else
+        {
+            VBO->BufferSubData((float*)vertecies, vertexCount * Vertex::Size, vertexOffset * Vertex::Size);
+        }
     }
 
     void MeshData::BufferIndicies(const IndexData& indicies)
     {
-        this->GetIBO()->BufferSubData(indicies.data(), this->indexCount, this->indexOffset);
+        MX_ASSERT(indicies.size() == this->indexCount);
+        MeshData::BufferIndicies(indicies.data(), this->indexCount, this->indexOffset, this->indexFormat);
+    }
+
+    void MeshData::BufferIndicies(const uint32_t* indicies, size_t indexCount, size_t indexOffset, IndexFormat indexFormat)
+    {
+        auto IBO = BufferAllocator::GetIBO();
+        if (indexFormat == IndexFormat::UINT16)
+        {
+            MxVector<IndexBuffer::ShortIndexType> narrowed(indexCount);
+            for (size_t i = 0; i < indexCount; i++)
+            {
+                MX_ASSERT(indicies[i] <= std::numeric_limits<IndexBuffer::ShortIndexType>::max());
+                narrowed[i] = (IndexBuffer::ShortIndexType)indicies[i];
+            }
+            IBO->BufferSubData(narrowed.data(), indexCount, indexOffset);
+        }
+        else
+        {
+            IBO->BufferSubData(indicies, indexCount, indexOffset);
+        }
     }
 
     void MeshData::UpdateBoundingGeometry(const VertexData& vertecies)
@@ -117,14 +170,33 @@ namespace MxEngine
     MeshData::VertexData MeshData::GetVerteciesFromGPU() const
     {
         VertexData vertecies(this->GetVerteciesCount());
-        this->GetVBO()->GetBufferData((float*)vertecies.data(), vertecies.size() * Vertex::Size, this->GetVerteciesOffset() * Vertex::Size);
+        if (GlobalConfig::HasCompressedVertices())
+        {
+            MxVector<CompressedVertex> compressed(vertecies.size());
+            this->GetVBO()->GetBufferData((float*)compressed.data(), compressed.size() * CompressedVertex::Size, this->GetVerteciesOffset() * CompressedVertex::Size);
+            for (size_t i = 0; i < vertecies.size(); i++)
+                vertecies[i] = compressed[i].Decompress();
+        }
+        else
+        {
+            this->GetVBO()->GetBufferData((float*)vertecies.data(), vertecies.size() * Vertex::Size, this->GetVerteciesOffset() * Vertex::Size);
+        }
         return vertecies;
     }
 
     MeshData::IndexData MeshData::GetIndiciesFromGPU() const
     {
         IndexData indicies(this->GetIndiciesCount());
-        this->GetIBO()->GetBufferData(indicies.data(), indicies.size(), this->GetIndiciesOffset());
+        if (this->indexFormat == IndexFormat::UINT16)
+        {
+            MxVector<IndexBuffer::ShortIndexType> narrowed(indicies.size());
+            this->GetIBO()->GetBufferData(narrowed.data(), narrowed.size(), this->GetIndiciesOffset());
+            std::copy(narrowed.begin(), narrowed.end(), indicies.begin());
+        }
+        else
+        {
+            this->GetIBO()->GetBufferData(indicies.data(), indicies.size(), this->GetIndiciesOffset());
+        }
         return indicies;
     }
 
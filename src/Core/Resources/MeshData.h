@@ -35,6 +35,19 @@
 
 namespace MxEngine
 {
+    // contiguous range of submesh triangles with bounds for per-cluster culling, built by MeshletBuilder
+    struct Meshlet
+    {
+        BoundingSphere Bounds;
+        // all triangles are back-facing if dot(normalize(ConeApex - viewPosition), ConeAxis) >= ConeCutoff. Cutoff above 1 disables the test
+        Vector3 ConeApex;
+        Vector3 ConeAxis;
+        float ConeCutoff;
+        // relative to indicies of owning submesh
+        uint32_t IndexOffset;
+        uint32_t IndexCount;
+    };
+
     class MeshData
     {
     public:
@@ -46,20 +59,31 @@ namespace MxEngine
 
         size_t vertexCount, vertexOffset;
         size_t indexCount, indexOffset;
+        IndexFormat indexFormat;
+        MxVector<Meshlet> meshlets;
     public:
-        MeshData(size_t vertexCount, size_t vertexOffset, size_t indexCount, size_t indexOffset);
+        // indexOffset is measured in indicies of indexFormat, not in IBO elements
+        MeshData(size_t vertexCount, size_t vertexOffset, size_t indexCount, size_t indexOffset, IndexFormat indexFormat);
 
         VertexBufferHandle GetVBO() const;
         IndexBufferHandle GetIBO() const;
         size_t GetVerteciesOffset() const;
         size_t GetIndiciesOffset() const;
+        IndexFormat GetIndexFormat() const;
         const AABB& GetAABB() const;
         const BoundingSphere& GetBoundingSphere() const;
+        // empty if submesh is small enough to be culled as a whole
+        const MxVector<Meshlet>& GetMeshlets() const;
+        void SetMeshlets(MxVector<Meshlet> meshlets);
         
         size_t GetVerteciesCount() const;
         size_t GetIndiciesCount() const;
         void BufferVertecies(const VertexData& vertecies);
+        // vertecies are converted to compressed layout here if it is enabled in config
+        static void BufferVertecies(const Vertex* vertecies, size_t vertexCount, size_t vertexOffset);
         void BufferIndicies(const IndexData& indicies);
+        // indicies are narrowed to 16-bit here if mesh uses IndexFormat::UINT16
+        static void BufferIndicies(const uint32_t* indicies, size_t indexCount, size_t indexOffset, IndexFormat indexFormat);
         void UpdateBoundingGeometry(const VertexData& vertecies);
 
         VertexData GetVerteciesFromGPU() const;
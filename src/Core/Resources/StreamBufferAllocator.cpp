@@ -0,0 +1,177 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "StreamBufferAllocator.h"
+#include "Core/Config/GlobalConfig.h"
+#include "Platform/OpenGL/SyncFence.h"
+#include "Platform/NullAPI/NullGraphicAPI.h"
+#include "Utilities/Logging/Logger.h"
+
+#include <array>
+
+namespace MxEngine
+{
+    struct StreamBufferAllocatorImpl
+    {
+        VertexBufferHandle Buffer;
+        uint8_t* MappedMemory = nullptr;
+        std::array<SyncFence, StreamBufferAllocator::FrameCount> Fences;
+        size_t RegionSize = 0;
+        size_t CurrentRegion = 0;
+        size_t UsedSize = 0;
+        // includes allocations which did not fit into region, so it can be grown to required size
+        size_t RequestedSize = 0;
+        size_t StallCount = 0;
+        bool IsRegionAcquired = false;
+    };
+
+    static void CreateStreamBuffer(StreamBufferAllocatorImpl& allocator, size_t regionSize)
+    {
+        // immutable storage can not be resized, so new buffer object is created in place of the old one
+        *allocator.Buffer = VertexBuffer(nullptr, 0, UsageType::STREAM_DRAW);
+        allocator.MappedMemory = allocator.Buffer->LoadPersistentMapped(regionSize * StreamBufferAllocator::FrameCount);
+        allocator.RegionSize = allocator.MappedMemory != nullptr ? regionSize : 0;
+        allocator.CurrentRegion = 0;
+        allocator.UsedSize = 0;
+        allocator.IsRegionAcquired = false;
+
+        if (allocator.MappedMemory == nullptr)
+            MXLOG_WARNING("MxEngine::StreamBufferAllocator", "failed to map stream buffer, per-frame data will be uploaded directly");
+    }
+
+    void StreamBufferAllocator::Init()
+    {
+        impl = new StreamBufferAllocatorImpl();
+    }
+
+    void StreamBufferAllocator::Destroy()
+    {
+        delete impl;
+    }
+
+    StreamBufferAllocatorImpl* StreamBufferAllocator::GetImpl()
+    {
+        return impl;
+    }
+
+    void StreamBufferAllocator::Clone(StreamBufferAllocatorImpl* other)
+    {
+        impl = other;
+    }
+
+    void StreamBufferAllocator::AllocateBuffers()
+    {
+        impl->Buffer = Factory<VertexBuffer>::Create(nullptr, 0, UsageType::STREAM_DRAW);
+
+        // buffer storage is core since OpenGL 4.4
+        bool isSupported = GlobalConfig::GetGraphicAPIMajorVersion() * 10 + GlobalConfig::GetGraphicAPIMinorVersion() >= 44;
+        if (!isSupported && !NullGraphicAPI::IsInstalled())
+        {
+            MXLOG_INFO("MxEngine::StreamBufferAllocator", "persistent buffer mapping is not supported, stream buffer is disabled");
+            return;
+        }
+
+        size_t regionSize = Max(GlobalConfig::GetStreamBufferSize(), (size_t)1);
+        CreateStreamBuffer(*impl, regionSize);
+    }
+
+    bool StreamBufferAllocator::IsEnabled()
+    {
+        return impl->MappedMemory != nullptr;
+    }
+
+    VertexBufferHandle StreamBufferAllocator::GetBuffer()
+    {
+        return impl->Buffer;
+    }
+
+    StreamAllocation StreamBufferAllocator::Allocate(size_t byteSize, size_t alignment)
+    {
+        if (!IsEnabled() || byteSize == 0) return StreamAllocation{ };
+
+        // region is written for the first time this frame, so GPU must finish reading it FrameCount frames ago
+        if (!impl->IsRegionAcquired)
+        {
+            if (impl->Fences[impl->CurrentRegion].Wait())
+                impl->StallCount++;
+            impl->IsRegionAcquired = true;
+        }
+
+        impl->RequestedSize += byteSize;
+
+        size_t regionBegin = impl->CurrentRegion * impl->RegionSize;
+        size_t offset = (regionBegin + impl->UsedSize + alignment - 1) / alignment * alignment;
+        if (offset + byteSize > regionBegin + impl->RegionSize)
+            return StreamAllocation{ };
+
+        impl->UsedSize = offset + byteSize - regionBegin;
+        return StreamAllocation{ impl->MappedMemory + offset, offset, byteSize };
+    }
+
+    void StreamBufferAllocator::CopyToBuffer(const StreamAllocation& allocation, BufferBase& target, size_t targetByteOffset)
+    {
+        MX_ASSERT(allocation.IsValid());
+        target.CopySubDataFrom(*impl->Buffer, allocation.Offset, targetByteOffset, allocation.Size);
+    }
+
+    void StreamBufferAllocator::EndFrame()
+    {
+        if (!IsEnabled()) return;
+
+        if (impl->IsRegionAcquired)
+            impl->Fences[impl->CurrentRegion].Place();
+
+        if (impl->RequestedSize > impl->RegionSize)
+        {
+            // all regions may still be in use, so buffer can be replaced only when GPU is done with it
+            for (auto& fence : impl->Fences)
+                fence.Wait();
+
+            size_t regionSize = Max(impl->RegionSize * 2, impl->RequestedSize);
+            CreateStreamBuffer(*impl, regionSize);
+            MXLOG_DEBUG("MxEngine::StreamBufferAllocator", "grown stream buffer region to size: " + ToMxString(regionSize));
+        }
+        else
+        {
+            impl->CurrentRegion = (impl->CurrentRegion + 1) % FrameCount;
+            impl->UsedSize = 0;
+            impl->IsRegionAcquired = false;
+        }
+        impl->RequestedSize = 0;
+    }
+
+    size_t StreamBufferAllocator::GetRegionSize()
+    {
+        return impl->RegionSize;
+    }
+
+    size_t StreamBufferAllocator::GetStallCount()
+    {
+        return impl->StallCount;
+    }
+}
@@ -0,0 +1,75 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Platform/GraphicAPI.h"
+
+namespace MxEngine
+{
+    struct StreamBufferAllocatorImpl;
+
+    struct StreamAllocation
+    {
+        uint8_t* Data = nullptr;
+        // byte offset of allocation in stream buffer
+        size_t Offset = 0;
+        size_t Size = 0;
+
+        bool IsValid() const { return this->Data != nullptr; }
+    };
+
+    /*!
+    stream buffer allocator provides per-frame upload memory in persistently mapped buffer, so CPU can write data
+    which GPU may still read from previous frames without implicit driver synchronization.
+    buffer is split into FrameCount regions, each of them is guarded by fence placed at the end of the frame which used it.
+    if graphic api does not support persistent mapping or frame region is full, allocations are invalid and callers
+    must upload their data in usual way. Overflowed region is grown at the end of the frame
+    */
+    class StreamBufferAllocator
+    {
+        inline static StreamBufferAllocatorImpl* impl;
+    public:
+        constexpr static size_t FrameCount = 3;
+
+        static void Init();
+        static void Destroy();
+        static StreamBufferAllocatorImpl* GetImpl();
+        static void Clone(StreamBufferAllocatorImpl* other);
+        static void AllocateBuffers();
+
+        static bool IsEnabled();
+        static VertexBufferHandle GetBuffer();
+        static StreamAllocation Allocate(size_t byteSize, size_t alignment = 16);
+        static void CopyToBuffer(const StreamAllocation& allocation, BufferBase& target, size_t targetByteOffset);
+        static void EndFrame();
+
+        static size_t GetRegionSize();
+        static size_t GetStallCount();
+    };
+}
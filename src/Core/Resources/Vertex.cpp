@@ -0,0 +1,70 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Vertex.h"
+
+namespace MxEngine
+{
+    static VectorShort2 PackOctahedral(const Vector3& v)
+    {
+        auto encoded = EncodeOctahedral(v);
+        return VectorShort2(PackSnorm16(encoded.x), PackSnorm16(encoded.y));
+    }
+
+    static Vector3 UnpackOctahedral(const VectorShort2& v)
+    {
+        return DecodeOctahedral(MakeVector2(UnpackSnorm16(v.x), UnpackSnorm16(v.y)));
+    }
+
+    CompressedVertex CompressedVertex::Compress(const Vertex& vertex)
+    {
+        CompressedVertex result;
+        result.Position = vertex.Position;
+        result.TexCoord.x = PackHalf(vertex.TexCoord.x);
+        result.TexCoord.y = PackHalf(vertex.TexCoord.y);
+        result.Normal = PackOctahedral(vertex.Normal);
+        result.Tangent = PackOctahedral(vertex.Tangent);
+
+        float handedness = Dot(Cross(vertex.Normal, vertex.Tangent), vertex.Bitangent) < 0.0f ? -1.0f : 1.0f;
+        result.BitangentSign = VectorShort2(PackSnorm16(handedness), 0);
+        return result;
+    }
+
+    Vertex CompressedVertex::Decompress() const
+    {
+        Vertex result;
+        result.Position = this->Position;
+        result.TexCoord = MakeVector2(UnpackHalf(this->TexCoord.x), UnpackHalf(this->TexCoord.y));
+        result.Normal = UnpackOctahedral(this->Normal);
+        result.Tangent = UnpackOctahedral(this->Tangent);
+        auto bitangent = Cross(result.Normal, result.Tangent);
+        float length = Length(bitangent);
+        if (length > 0.0f) result.Bitangent = bitangent * (UnpackSnorm16(this->BitangentSign.x) / length);
+        return result;
+    }
+}
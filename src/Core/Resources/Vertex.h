@@ -42,4 +42,22 @@ namespace MxEngine
 
         constexpr static size_t Size = 3 + 2 + 3 + 3 + 3;
     };
+
+    /*!
+    compact GPU representation of Vertex. Texture coordinates are stored as half floats, normal and tangent are octahedral-encoded,
+    bitangent is restored in shader from normal and tangent, so only its direction sign is kept
+    */
+    struct CompressedVertex
+    {
+        Vector3 Position{ 0.0f };
+        VectorHalf2 TexCoord;
+        VectorShort2 Normal{ 0 };
+        VectorShort2 Tangent{ 0 };
+        VectorShort2 BitangentSign{ 0 };
+
+        constexpr static size_t Size = 3 + 1 + 1 + 1 + 1;
+
+        static CompressedVertex Compress(const Vertex& vertex);
+        Vertex Decompress() const;
+    };
 }
\ No newline at end of file
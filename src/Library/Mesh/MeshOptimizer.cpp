@@ -0,0 +1,359 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "MeshOptimizer.h"
+#include "MeshletBuilder.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+
+#include <algorithm>
+
+namespace MxEngine
+{
+    constexpr uint32_t InvalidOptimizerIndex = std::numeric_limits<uint32_t>::max();
+
+    // FIFO post-transform cache: vertex stays cached until cacheSize other vertecies are loaded after it
+    class VertexCacheSimulator
+    {
+        MxVector<size_t> timestamps;
+        size_t cacheSize;
+        size_t timestamp;
+    public:
+        VertexCacheSimulator(size_t vertexCount, size_t cacheSize)
+            : timestamps(vertexCount, 0), cacheSize(cacheSize), timestamp(cacheSize + 1) { }
+
+        size_t GetAge(uint32_t vertex) const
+        {
+            return this->timestamp - this->timestamps[vertex];
+        }
+
+        // returns true on cache miss
+        bool Access(uint32_t vertex)
+        {
+            if (this->GetAge(vertex) <= this->cacheSize) return false;
+            this->timestamps[vertex] = this->timestamp++;
+            return true;
+        }
+
+        size_t AccessTriangle(const MeshData::IndexData& indicies, size_t triangle)
+        {
+            return (size_t)this->Access(indicies[3 * triangle + 0]) +
+                (size_t)this->Access(indicies[3 * triangle + 1]) +
+                (size_t)this->Access(indicies[3 * triangle + 2]);
+        }
+
+        void Flush()
+        {
+            this->timestamp += this->cacheSize + 1;
+        }
+    };
+
+    // triangles using vertex v are Triangles[Offsets[v]] ... Triangles[Offsets[v + 1] - 1]
+    struct VertexTriangleAdjacency
+    {
+        MxVector<uint32_t> Offsets;
+        MxVector<uint32_t> Triangles;
+
+        VertexTriangleAdjacency(const MeshData::IndexData& indicies, size_t vertexCount)
+            : Offsets(vertexCount + 1, 0), Triangles(indicies.size())
+        {
+            for (uint32_t index : indicies)
+                this->Offsets[index + 1]++;
+            for (size_t i = 0; i < vertexCount; i++)
+                this->Offsets[i + 1] += this->Offsets[i];
+
+            MxVector<uint32_t> cursors(this->Offsets.begin(), this->Offsets.end() - 1);
+            for (size_t i = 0; i < indicies.size(); i++)
+                this->Triangles[cursors[indicies[i]]++] = uint32_t(i / 3);
+        }
+    };
+
+    void MeshOptimizer::OptimizeVertexCache(MeshData::IndexData& indicies, size_t vertexCount, size_t cacheSize)
+    {
+        MAKE_SCOPE_PROFILER("MeshOptimizer::OptimizeVertexCache()");
+        MX_ASSERT(indicies.size() % 3 == 0);
+
+        size_t triangleCount = indicies.size() / 3;
+        if (triangleCount == 0) return;
+
+        VertexTriangleAdjacency adjacency(indicies, vertexCount);
+        VertexCacheSimulator cache(vertexCount, cacheSize);
+        MxVector<uint32_t> liveTriangles(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++)
+            liveTriangles[i] = adjacency.Offsets[i + 1] - adjacency.Offsets[i];
+
+        MxVector<uint8_t> emitted(triangleCount, 0);
+        MxVector<uint32_t> deadEnd;
+        MxVector<uint32_t> candidates;
+        MeshData::IndexData result;
+        deadEnd.reserve(indicies.size());
+        result.reserve(indicies.size());
+
+        size_t cursor = 0;
+        uint32_t fanningVertex = indicies.front();
+        while (fanningVertex != InvalidOptimizerIndex)
+        {
+            // emit all remaining triangles around fanning vertex
+            candidates.clear();
+            for (uint32_t i = adjacency.Offsets[fanningVertex]; i < adjacency.Offsets[fanningVertex + 1]; i++)
+            {
+                uint32_t triangle = adjacency.Triangles[i];
+                if (emitted[triangle]) continue;
+                emitted[triangle] = 1;
+
+                for (size_t j = 0; j < 3; j++)
+                {
+                    uint32_t vertex = indicies[3 * triangle + j];
+                    result.push_back(vertex);
+                    deadEnd.push_back(vertex);
+                    candidates.push_back(vertex);
+                    liveTriangles[vertex]--;
+                    cache.Access(vertex);
+                }
+            }
+
+            // next fanning vertex is the oldest candidate which will still be in cache after its fan is emitted
+            fanningVertex = InvalidOptimizerIndex;
+            int bestPriority = -1;
+            for (uint32_t vertex : candidates)
+            {
+                if (liveTriangles[vertex] == 0) continue;
+
+                int priority = 0;
+                if (cache.GetAge(vertex) + 2 * liveTriangles[vertex] <= cacheSize)
+                    priority = (int)cache.GetAge(vertex);
+
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    fanningVertex = vertex;
+                }
+            }
+
+            // dead end: try recently used vertecies first, then any vertex with remaining triangles
+            while (fanningVertex == InvalidOptimizerIndex && !deadEnd.empty())
+            {
+                uint32_t vertex = deadEnd.back();
+                deadEnd.pop_back();
+                if (liveTriangles[vertex] > 0) fanningVertex = vertex;
+            }
+            while (fanningVertex == InvalidOptimizerIndex && cursor < vertexCount)
+            {
+                if (liveTriangles[cursor] > 0) fanningVertex = (uint32_t)cursor;
+                cursor++;
+            }
+        }
+        MX_ASSERT(result.size() == indicies.size());
+        indicies = std::move(result);
+    }
+
+    void MeshOptimizer::OptimizeOverdraw(MeshData::IndexData& indicies, const MeshData::VertexData& vertecies, float threshold, size_t cacheSize)
+    {
+        MAKE_SCOPE_PROFILER("MeshOptimizer::OptimizeOverdraw()");
+        MX_ASSERT(indicies.size() % 3 == 0);
+
+        size_t triangleCount = indicies.size() / 3;
+        if (triangleCount == 0) return;
+
+        // cluster starts where all vertecies of triangle miss cache, reordering such clusters does not affect ACMR
+        MxVector<size_t> hardBoundaries;
+        VertexCacheSimulator cache(vertecies.size(), cacheSize);
+        for (size_t i = 0; i < triangleCount; i++)
+        {
+            if (cache.AccessTriangle(indicies, i) == 3 || i == 0)
+                hardBoundaries.push_back(i);
+        }
+        hardBoundaries.push_back(triangleCount);
+
+        // hard clusters are split further once running ACMR of cluster gets within threshold of hard cluster ACMR
+        MxVector<size_t> clusters;
+        for (size_t c = 0; c + 1 < hardBoundaries.size(); c++)
+        {
+            size_t begin = hardBoundaries[c], end = hardBoundaries[c + 1];
+
+            size_t hardMisses = 0;
+            cache.Flush();
+            for (size_t i = begin; i < end; i++)
+                hardMisses += cache.AccessTriangle(indicies, i);
+            float maxACMR = float(hardMisses) / float(end - begin) * threshold;
+
+            size_t start = begin, misses = 0;
+            clusters.push_back(begin);
+            cache.Flush();
+            for (size_t i = begin; i + 1 < end; i++)
+            {
+                misses += cache.AccessTriangle(indicies, i);
+                if (float(misses) / float(i + 1 - start) <= maxACMR)
+                {
+                    start = i + 1, misses = 0;
+                    clusters.push_back(start);
+                    cache.Flush();
+                }
+            }
+        }
+        clusters.push_back(triangleCount);
+
+        // clusters facing away from mesh center are most likely to occlude others, so they are drawn first
+        struct ClusterInfo
+        {
+            Vector3 Normal = MakeVector3(0.0f);
+            Vector3 Centroid = MakeVector3(0.0f);
+            float Area = 0.0f;
+            float Score = 0.0f;
+        };
+        MxVector<ClusterInfo> clusterInfos(clusters.size() - 1);
+        Vector3 meshCenter = MakeVector3(0.0f);
+        float meshArea = 0.0f;
+
+        for (size_t c = 0; c < clusterInfos.size(); c++)
+        {
+            auto& info = clusterInfos[c];
+            for (size_t i = clusters[c]; i < clusters[c + 1]; i++)
+            {
+                const auto& p0 = vertecies[indicies[3 * i + 0]].Position;
+                const auto& p1 = vertecies[indicies[3 * i + 1]].Position;
+                const auto& p2 = vertecies[indicies[3 * i + 2]].Position;
+
+                auto normal = Cross(p1 - p0, p2 - p0); // length is twice triangle area
+                float area = Length(normal);
+                info.Normal += normal;
+                info.Centroid += (p0 + p1 + p2) * (area / 3.0f);
+                info.Area += area;
+            }
+            meshCenter += info.Centroid;
+            meshArea += info.Area;
+            if (info.Area > 0.0f) info.Centroid /= info.Area;
+        }
+        if (meshArea > 0.0f) meshCenter /= meshArea;
+
+        for (auto& info : clusterInfos)
+        {
+            float normalLength = Length(info.Normal);
+            if (normalLength > 0.0f)
+                info.Score = Dot(info.Centroid - meshCenter, info.Normal) / normalLength;
+        }
+
+        MxVector<uint32_t> clusterOrder(clusterInfos.size());
+        for (size_t i = 0; i < clusterOrder.size(); i++)
+            clusterOrder[i] = (uint32_t)i;
+        std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&clusterInfos](uint32_t c1, uint32_t c2)
+        {
+            return clusterInfos[c1].Score > clusterInfos[c2].Score;
+        });
+
+        MeshData::IndexData result;
+        result.reserve(indicies.size());
+        for (uint32_t c : clusterOrder)
+        {
+            result.insert(result.end(), indicies.begin() + 3 * clusters[c], indicies.begin() + 3 * clusters[c + 1]);
+        }
+        indicies = std::move(result);
+    }
+
+    void MeshOptimizer::OptimizeVertexFetch(MeshData::VertexData& vertecies, MeshData::IndexData& indicies)
+    {
+        MAKE_SCOPE_PROFILER("MeshOptimizer::OptimizeVertexFetch()");
+
+        // vertecies are placed in order of their first use by index buffer
+        MxVector<uint32_t> remap(vertecies.size(), InvalidOptimizerIndex);
+        uint32_t nextVertex = 0;
+        for (auto& index : indicies)
+        {
+            if (remap[index] == InvalidOptimizerIndex)
+                remap[index] = nextVertex++;
+            index = remap[index];
+        }
+        for (auto& index : remap)
+        {
+            if (index == InvalidOptimizerIndex)
+                index = nextVertex++;
+        }
+
+        MeshData::VertexData result(vertecies.size());
+        for (size_t i = 0; i < vertecies.size(); i++)
+            result[remap[i]] = vertecies[i];
+        vertecies = std::move(result);
+    }
+
+    void MeshOptimizer::Optimize(MeshData::VertexData& vertecies, MeshData::IndexData& indicies)
+    {
+        MeshOptimizer::OptimizeVertexCache(indicies, vertecies.size());
+        MeshOptimizer::OptimizeOverdraw(indicies, vertecies);
+        MeshOptimizer::OptimizeVertexFetch(vertecies, indicies);
+    }
+
+    void MeshOptimizer::OptimizeMesh(Mesh& mesh)
+    {
+        MAKE_SCOPE_PROFILER("MeshOptimizer::OptimizeMesh()");
+
+        for (size_t i = 0; i < mesh.GetSubMeshes().size(); i++)
+        {
+            auto& submesh = mesh.GetSubMeshByIndex(i);
+            auto vertecies = submesh.Data.GetVerteciesFromGPU();
+            auto indicies = submesh.Data.GetIndiciesFromGPU();
+
+            auto before = MeshOptimizer::AnalyzeVertexCache(indicies, vertecies.size());
+            MeshOptimizer::Optimize(vertecies, indicies);
+            auto after = MeshOptimizer::AnalyzeVertexCache(indicies, vertecies.size());
+
+            submesh.Data.BufferVertecies(vertecies);
+            submesh.Data.BufferIndicies(indicies);
+            // meshlets are ranges of index buffer, so they are rebuilt for new triangle order
+            if (!submesh.Data.GetMeshlets().empty())
+                submesh.Data.SetMeshlets(MeshletBuilder::Build(vertecies, indicies));
+
+            MXLOG_DEBUG("MxEngine::MeshOptimizer", MxFormat("optimized submesh {0} of {1}: ACMR {2} -> {3}, ATVR {4} -> {5}",
+                i, mesh.GetFilePath().c_str(), before.ACMR, after.ACMR, before.ATVR, after.ATVR));
+        }
+    }
+
+    VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const MeshData::IndexData& indicies, size_t vertexCount, size_t cacheSize)
+    {
+        VertexCacheStatistics statistics;
+        size_t triangleCount = indicies.size() / 3;
+        if (triangleCount == 0) return statistics;
+
+        VertexCacheSimulator cache(vertexCount, cacheSize);
+        MxVector<uint8_t> referenced(vertexCount, 0);
+        size_t uniqueVertecies = 0;
+        for (size_t i = 0; i < triangleCount; i++)
+        {
+            statistics.CacheMisses += cache.AccessTriangle(indicies, i);
+        }
+        for (uint32_t index : indicies)
+        {
+            uniqueVertecies += (size_t)(referenced[index] == 0);
+            referenced[index] = 1;
+        }
+
+        statistics.ACMR = float(statistics.CacheMisses) / float(triangleCount);
+        statistics.ATVR = float(statistics.CacheMisses) / float(uniqueVertecies);
+        return statistics;
+    }
+}
@@ -0,0 +1,64 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Core/Resources/AssetManager.h"
+
+namespace MxEngine
+{
+    struct VertexCacheStatistics
+    {
+        size_t CacheMisses = 0;
+        // average cache miss ratio: transformed vertecies per triangle, 0.5 is ideal for large regular meshes, 3.0 is worst
+        float ACMR = 0.0f;
+        // average transform to vertex ratio: transformed vertecies per unique vertex, 1.0 is ideal
+        float ATVR = 0.0f;
+    };
+
+    /*!
+    index and vertex reordering for GPU vertex cache, overdraw and vertex fetch locality
+    vertex cache ordering uses Tipsify (Sander et al.), overdraw ordering splits result into clusters
+    at cache flush points and sorts them front-to-back relative to mesh center. Geometry itself is never changed
+    */
+    class MeshOptimizer
+    {
+    public:
+        constexpr static size_t VertexCacheSize = 16;
+        constexpr static float OverdrawThreshold = 1.05f;
+
+        static void OptimizeVertexCache(MeshData::IndexData& indicies, size_t vertexCount, size_t cacheSize = VertexCacheSize);
+        // threshold is max allowed ACMR degradation of each cluster, indicies should be already cache optimized
+        static void OptimizeOverdraw(MeshData::IndexData& indicies, const MeshData::VertexData& vertecies, float threshold = OverdrawThreshold, size_t cacheSize = VertexCacheSize);
+        // unreferenced vertecies are kept at the end, so vertex count does not change
+        static void OptimizeVertexFetch(MeshData::VertexData& vertecies, MeshData::IndexData& indicies);
+        static void Optimize(MeshData::VertexData& vertecies, MeshData::IndexData& indicies);
+        static void OptimizeMesh(Mesh& mesh);
+        static VertexCacheStatistics AnalyzeVertexCache(const MeshData::IndexData& indicies, size_t vertexCount, size_t cacheSize = VertexCacheSize);
+    };
+}
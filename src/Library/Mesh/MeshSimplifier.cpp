@@ -0,0 +1,565 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace MxEngine
+{
+    // symmetric 4x4 matrix of plane equations accumulated for a position
+    struct Quadric
+    {
+        double A00 = 0.0, A01 = 0.0, A02 = 0.0, A03 = 0.0;
+        double A11 = 0.0, A12 = 0.0, A13 = 0.0;
+        double A22 = 0.0, A23 = 0.0;
+        double A33 = 0.0;
+        double Weight = 0.0;
+
+        void AddPlane(const Vector3& normal, float distance, double weight)
+        {
+            double x = normal.x, y = normal.y, z = normal.z, d = distance;
+            this->A00 += weight * x * x; this->A01 += weight * x * y; this->A02 += weight * x * z; this->A03 += weight * x * d;
+            this->A11 += weight * y * y; this->A12 += weight * y * z; this->A13 += weight * y * d;
+            this->A22 += weight * z * z; this->A23 += weight * z * d;
+            this->A33 += weight * d * d;
+        }
+
+        Quadric& operator+=(const Quadric& other)
+        {
+            this->A00 += other.A00; this->A01 += other.A01; this->A02 += other.A02; this->A03 += other.A03;
+            this->A11 += other.A11; this->A12 += other.A12; this->A13 += other.A13;
+            this->A22 += other.A22; this->A23 += other.A23;
+            this->A33 += other.A33;
+            this->Weight += other.Weight;
+            return *this;
+        }
+
+        double Evaluate(const Vector3& p) const
+        {
+            double x = p.x, y = p.y, z = p.z;
+            double result =
+                this->A00 * x * x + 2.0 * this->A01 * x * y + 2.0 * this->A02 * x * z + 2.0 * this->A03 * x +
+                this->A11 * y * y + 2.0 * this->A12 * y * z + 2.0 * this->A13 * y +
+                this->A22 * z * z + 2.0 * this->A23 * z +
+                this->A33;
+            return result > 0.0 ? result : 0.0;
+        }
+    };
+
+    enum class SimplifierVertexKind : uint8_t
+    {
+        MANIFOLD, // can be collapsed to any neighbour
+        BORDER,   // lies on border or attribute seam, can be collapsed only along it
+        LOCKED,   // corner of border or seam, never collapsed
+    };
+
+    struct SimplifierCollapse
+    {
+        uint32_t From;
+        uint32_t To;
+        float Error;
+    };
+
+    constexpr uint32_t InvalidSimplifierIndex = std::numeric_limits<uint32_t>::max();
+    // penalty for moving vertex away from border or seam, relative to error of triangle planes
+    constexpr float SimplifierBorderWeight = 10.0f;
+    // triangle normal must not rotate more than ~75 degrees during collapse
+    constexpr float SimplifierMaxNormalDeviation = 0.25f;
+
+    MxVector<uint32_t> WeldPositions(const MeshData::VertexData& vertecies, MxVector<Vector3>& positions)
+    {
+        MxVector<uint32_t> order(vertecies.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = (uint32_t)i;
+
+        auto IsLess = [&vertecies](uint32_t v1, uint32_t v2)
+        {
+            const auto& p1 = vertecies[v1].Position;
+            const auto& p2 = vertecies[v2].Position;
+            if (p1.x != p2.x) return p1.x < p2.x;
+            if (p1.y != p2.y) return p1.y < p2.y;
+            return p1.z < p2.z;
+        };
+        std::sort(order.begin(), order.end(), IsLess);
+
+        MxVector<uint32_t> positionIds(vertecies.size());
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            if (i == 0 || vertecies[order[i - 1]].Position != vertecies[order[i]].Position)
+                positions.push_back(vertecies[order[i]].Position);
+            positionIds[order[i]] = uint32_t(positions.size() - 1);
+        }
+        return positionIds;
+    }
+
+    void NormalizePositions(MxVector<Vector3>& positions)
+    {
+        if (positions.empty()) return;
+
+        Vector3 minCoords = positions.front();
+        Vector3 maxCoords = positions.front();
+        for (const auto& position : positions)
+        {
+            minCoords = VectorMin(minCoords, position);
+            maxCoords = VectorMax(maxCoords, position);
+        }
+
+        float extent = ComponentMax(maxCoords - minCoords);
+        float scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+        for (auto& position : positions)
+            position = (position - minCoords) * scale;
+    }
+
+    uint64_t MakeEdgeKey(uint32_t v1, uint32_t v2)
+    {
+        return ((uint64_t)v1 << 32) | (uint64_t)v2;
+    }
+
+    MxVector<uint64_t> CollectSortedEdges(const MeshData::IndexData& indicies)
+    {
+        MxVector<uint64_t> edges;
+        edges.reserve(indicies.size());
+        for (size_t i = 0; i < indicies.size(); i += 3)
+        {
+            for (size_t e = 0; e < 3; e++)
+                edges.push_back(MakeEdgeKey(indicies[i + e], indicies[i + (e + 1) % 3]));
+        }
+        std::sort(edges.begin(), edges.end());
+        return edges;
+    }
+
+    bool IsOpenEdge(const MxVector<uint64_t>& sortedEdges, uint32_t v1, uint32_t v2)
+    {
+        // edge is open if there is no opposite half-edge. Vertecies are compared by index, so seams are open too
+        return !std::binary_search(sortedEdges.begin(), sortedEdges.end(), MakeEdgeKey(v2, v1));
+    }
+
+    bool IsDegenerate(const uint32_t* triangle, const MxVector<uint32_t>& positionIds)
+    {
+        uint32_t p0 = positionIds[triangle[0]], p1 = positionIds[triangle[1]], p2 = positionIds[triangle[2]];
+        return p0 == p1 || p1 == p2 || p0 == p2;
+    }
+
+    void ComputeQuadrics(MxVector<Quadric>& quadrics, const MeshData::IndexData& indicies, const MxVector<uint32_t>& positionIds, const MxVector<Vector3>& positions)
+    {
+        auto edges = CollectSortedEdges(indicies);
+        for (size_t i = 0; i < indicies.size(); i += 3)
+        {
+            uint32_t p[3] = { positionIds[indicies[i + 0]], positionIds[indicies[i + 1]], positionIds[indicies[i + 2]] };
+            Vector3 normal = Cross(positions[p[1]] - positions[p[0]], positions[p[2]] - positions[p[0]]);
+            float doubleArea = Length(normal);
+            if (doubleArea == 0.0f) continue;
+            normal /= doubleArea;
+
+            float distance = -Dot(normal, positions[p[0]]);
+            for (size_t c = 0; c < 3; c++)
+            {
+                quadrics[p[c]].AddPlane(normal, distance, 0.5 * doubleArea);
+                quadrics[p[c]].Weight += 0.5 * doubleArea;
+            }
+
+            // add plane perpendicular to triangle for each open edge, so border and seams are not shrinked
+            for (size_t e = 0; e < 3; e++)
+            {
+                if (!IsOpenEdge(edges, indicies[i + e], indicies[i + (e + 1) % 3])) continue;
+
+                Vector3 edge = positions[p[(e + 1) % 3]] - positions[p[e]];
+                float edgeLength = Length(edge);
+                if (edgeLength == 0.0f) continue;
+
+                Vector3 edgeNormal = Normalize(Cross(edge, normal));
+                float edgeDistance = -Dot(edgeNormal, positions[p[e]]);
+                double weight = SimplifierBorderWeight * edgeLength * edgeLength;
+                quadrics[p[e]].AddPlane(edgeNormal, edgeDistance, weight);
+                quadrics[p[(e + 1) % 3]].AddPlane(edgeNormal, edgeDistance, weight);
+            }
+        }
+    }
+
+    void ClassifyPositions(MxVector<SimplifierVertexKind>& kinds, MxVector<uint32_t>& openNeighbours, const MeshData::IndexData& indicies, const MxVector<uint32_t>& positionIds)
+    {
+        // each position stores up to two neighbours it is connected to with open edges
+        std::fill(kinds.begin(), kinds.end(), SimplifierVertexKind::MANIFOLD);
+        std::fill(openNeighbours.begin(), openNeighbours.end(), InvalidSimplifierIndex);
+
+        auto AddOpenNeighbour = [&kinds, &openNeighbours](uint32_t position, uint32_t neighbour)
+        {
+            uint32_t* slots = &openNeighbours[2 * position];
+            if (slots[0] == neighbour || slots[1] == neighbour) return;
+
+            if (slots[0] == InvalidSimplifierIndex)
+                slots[0] = neighbour;
+            else if (slots[1] == InvalidSimplifierIndex)
+                slots[1] = neighbour;
+            else
+                kinds[position] = SimplifierVertexKind::LOCKED;
+        };
+
+        auto edges = CollectSortedEdges(indicies);
+        for (size_t i = 0; i < indicies.size(); i += 3)
+        {
+            for (size_t e = 0; e < 3; e++)
+            {
+                uint32_t v1 = indicies[i + e], v2 = indicies[i + (e + 1) % 3];
+                if (!IsOpenEdge(edges, v1, v2)) continue;
+
+                AddOpenNeighbour(positionIds[v1], positionIds[v2]);
+                AddOpenNeighbour(positionIds[v2], positionIds[v1]);
+            }
+        }
+
+        for (size_t position = 0; position < kinds.size(); position++)
+        {
+            if (kinds[position] == SimplifierVertexKind::LOCKED || openNeighbours[2 * position] == InvalidSimplifierIndex) continue;
+            // open edges which do not form a chain through position mean its a corner
+            kinds[position] = openNeighbours[2 * position + 1] == InvalidSimplifierIndex ? SimplifierVertexKind::LOCKED : SimplifierVertexKind::BORDER;
+        }
+    }
+
+    void BuildAdjacency(MxVector<uint32_t>& offsets, MxVector<uint32_t>& triangles, const MeshData::IndexData& indicies, const MxVector<uint32_t>& positionIds, size_t positionCount)
+    {
+        offsets.assign(positionCount + 1, 0);
+        for (uint32_t index : indicies)
+            offsets[positionIds[index] + 1]++;
+        for (size_t i = 0; i < positionCount; i++)
+            offsets[i + 1] += offsets[i];
+
+        triangles.resize(indicies.size());
+        MxVector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indicies.size(); i++)
+            triangles[fill[positionIds[indicies[i]]]++] = uint32_t(i / 3);
+    }
+
+    MeshData::IndexData MeshSimplifier::Simplify(const MeshData::VertexData& vertecies, const MeshData::IndexData& indicies, size_t targetIndexCount, float maxError, float* resultError)
+    {
+        MAKE_SCOPE_PROFILER("MeshSimplifier::Simplify()");
+        MX_ASSERT(indicies.size() % 3 == 0);
+
+        if (resultError != nullptr) *resultError = 0.0f;
+
+        MxVector<Vector3> positions;
+        auto positionIds = WeldPositions(vertecies, positions);
+        NormalizePositions(positions);
+
+        MeshData::IndexData result;
+        result.reserve(indicies.size());
+        for (size_t i = 0; i < indicies.size(); i += 3)
+        {
+            if (!IsDegenerate(&indicies[i], positionIds))
+                result.insert(result.end(), indicies.begin() + i, indicies.begin() + i + 3);
+        }
+
+        MxVector<Quadric> quadrics(positions.size());
+        ComputeQuadrics(quadrics, result, positionIds, positions);
+
+        MxVector<SimplifierVertexKind> kinds(positions.size());
+        MxVector<uint32_t> openNeighbours(2 * positions.size());
+        MxVector<uint32_t> adjacencyOffsets, adjacency;
+        MxVector<SimplifierCollapse> collapses;
+        MxVector<uint8_t> locked(positions.size());
+        MxVector<std::pair<uint32_t, uint32_t>> wedgeMapping;
+        MxVector<uint32_t> fromNeighbours, toNeighbours;
+
+        size_t targetTriangleCount = targetIndexCount / 3;
+        size_t triangleCount = result.size() / 3;
+        float achievedError = 0.0f;
+
+        auto CollectNeighbours = [&](uint32_t position, MxVector<uint32_t>& neighbours)
+        {
+            neighbours.clear();
+            for (uint32_t t = adjacencyOffsets[position]; t < adjacencyOffsets[position + 1]; t++)
+            {
+                const uint32_t* triangle = &result[3 * adjacency[t]];
+                if (IsDegenerate(triangle, positionIds)) continue;
+                for (size_t c = 0; c < 3; c++)
+                {
+                    uint32_t neighbour = positionIds[triangle[c]];
+                    if (neighbour != position && std::find(neighbours.begin(), neighbours.end(), neighbour) == neighbours.end())
+                        neighbours.push_back(neighbour);
+                }
+            }
+        };
+
+        auto IsCollapseValid = [&](uint32_t from, uint32_t to)
+        {
+            wedgeMapping.clear();
+            size_t sharedTriangles = 0;
+
+            // each vertex at collapsed position must have a vertex with same attributes at target position
+            for (uint32_t t = adjacencyOffsets[from]; t < adjacencyOffsets[from + 1]; t++)
+            {
+                const uint32_t* triangle = &result[3 * adjacency[t]];
+                if (IsDegenerate(triangle, positionIds)) continue;
+
+                uint32_t fromVertex = InvalidSimplifierIndex, toVertex = InvalidSimplifierIndex;
+                for (size_t c = 0; c < 3; c++)
+                {
+                    if (positionIds[triangle[c]] == from) fromVertex = triangle[c];
+                    if (positionIds[triangle[c]] == to) toVertex = triangle[c];
+                }
+                if (toVertex == InvalidSimplifierIndex) continue;
+                sharedTriangles++;
+
+                auto it = std::find_if(wedgeMapping.begin(), wedgeMapping.end(), [fromVertex](const auto& p) { return p.first == fromVertex; });
+                if (it == wedgeMapping.end())
+                    wedgeMapping.emplace_back(fromVertex, toVertex);
+                else if (it->second != toVertex)
+                    return false;
+            }
+
+            for (uint32_t t = adjacencyOffsets[from]; t < adjacencyOffsets[from + 1]; t++)
+            {
+                const uint32_t* triangle = &result[3 * adjacency[t]];
+                if (IsDegenerate(triangle, positionIds)) continue;
+
+                Vector3 before[3], after[3];
+                bool hasTarget = false;
+                uint32_t fromVertex = InvalidSimplifierIndex;
+                for (size_t c = 0; c < 3; c++)
+                {
+                    uint32_t position = positionIds[triangle[c]];
+                    hasTarget |= position == to;
+                    if (position == from) fromVertex = triangle[c];
+                    before[c] = positions[position];
+                    after[c] = position == from ? positions[to] : positions[position];
+                }
+                if (hasTarget) continue;
+
+                auto IsSameVertex = [fromVertex](const auto& p) { return p.first == fromVertex; };
+                if (std::find_if(wedgeMapping.begin(), wedgeMapping.end(), IsSameVertex) == wedgeMapping.end())
+                    return false;
+
+                // reject collapses which flip or degenerate triangles
+                Vector3 normalBefore = Cross(before[1] - before[0], before[2] - before[0]);
+                Vector3 normalAfter = Cross(after[1] - after[0], after[2] - after[0]);
+                float lengths = Length(normalBefore) * Length(normalAfter);
+                if (lengths == 0.0f || Dot(normalBefore, normalAfter) < SimplifierMaxNormalDeviation * lengths)
+                    return false;
+            }
+
+            // link condition: positions connected to both ends must be exactly the ones opposite to collapsed edge
+            CollectNeighbours(from, fromNeighbours);
+            CollectNeighbours(to, toNeighbours);
+            size_t commonNeighbours = 0;
+            for (uint32_t neighbour : fromNeighbours)
+            {
+                if (neighbour != to && std::find(toNeighbours.begin(), toNeighbours.end(), neighbour) != toNeighbours.end())
+                    commonNeighbours++;
+            }
+            return sharedTriangles > 0 && commonNeighbours == sharedTriangles;
+        };
+
+        auto PerformCollapse = [&](uint32_t from, uint32_t to)
+        {
+            for (uint32_t t = adjacencyOffsets[from]; t < adjacencyOffsets[from + 1]; t++)
+            {
+                uint32_t* triangle = &result[3 * adjacency[t]];
+                if (IsDegenerate(triangle, positionIds)) continue;
+
+                bool hasTarget = false;
+                for (size_t c = 0; c < 3; c++)
+                    hasTarget |= positionIds[triangle[c]] == to;
+
+                for (size_t c = 0; c < 3; c++)
+                {
+                    if (positionIds[triangle[c]] != from) continue;
+                    auto vertex = triangle[c];
+                    triangle[c] = std::find_if(wedgeMapping.begin(), wedgeMapping.end(), [vertex](const auto& p) { return p.first == vertex; })->second;
+                }
+                if (hasTarget) triangleCount--;
+            }
+            quadrics[to] += quadrics[from];
+        };
+
+        // collapses are done in passes. Each pass recomputes topology and touches each position at most once
+        while (triangleCount > targetTriangleCount)
+        {
+            ClassifyPositions(kinds, openNeighbours, result, positionIds);
+            BuildAdjacency(adjacencyOffsets, adjacency, result, positionIds, positions.size());
+
+            collapses.clear();
+            for (size_t i = 0; i < result.size(); i++)
+            {
+                uint32_t from = positionIds[result[i]];
+                uint32_t to = positionIds[result[i - i % 3 + (i % 3 + 1) % 3]];
+
+                for (auto [p1, p2] : { std::pair{ from, to }, std::pair{ to, from } })
+                {
+                    if (kinds[p1] == SimplifierVertexKind::LOCKED) continue;
+                    if (kinds[p1] == SimplifierVertexKind::BORDER && openNeighbours[2 * p1] != p2 && openNeighbours[2 * p1 + 1] != p2) continue;
+
+                    Quadric quadric = quadrics[p1];
+                    quadric += quadrics[p2];
+                    float error = quadric.Weight > 0.0 ? (float)std::sqrt(quadric.Evaluate(positions[p2]) / quadric.Weight) : 0.0f;
+                    collapses.push_back(SimplifierCollapse{ p1, p2, error });
+                }
+            }
+            if (collapses.empty()) break;
+
+            std::sort(collapses.begin(), collapses.end(), [](const auto& c1, const auto& c2) { return c1.Error < c2.Error; });
+
+            // each collapse removes about two triangles. Cheap collapses above the goal may still be done, expensive ones wait for next pass
+            size_t collapseGoal = Max((triangleCount - targetTriangleCount) / 2, (size_t)1);
+            float passErrorLimit = Min(collapses[Min(collapseGoal, collapses.size() - 1)].Error * 1.5f, maxError);
+
+            std::fill(locked.begin(), locked.end(), 0);
+            size_t performedCollapses = 0;
+            for (const auto& collapse : collapses)
+            {
+                if (collapse.Error > passErrorLimit || triangleCount <= targetTriangleCount) break;
+                if (locked[collapse.From] || locked[collapse.To]) continue;
+                if (!IsCollapseValid(collapse.From, collapse.To)) continue;
+
+                PerformCollapse(collapse.From, collapse.To);
+                locked[collapse.From] = 1;
+                locked[collapse.To] = 1;
+                achievedError = Max(achievedError, collapse.Error);
+                performedCollapses++;
+            }
+
+            // remove triangles degenerated by collapses
+            size_t writeIndex = 0;
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                if (IsDegenerate(&result[i], positionIds)) continue;
+                for (size_t c = 0; c < 3; c++)
+                    result[writeIndex + c] = result[i + c];
+                writeIndex += 3;
+            }
+            result.resize(writeIndex);
+            triangleCount = result.size() / 3;
+
+            if (performedCollapses == 0) break;
+        }
+
+        if (resultError != nullptr) *resultError = achievedError;
+        return result;
+    }
+
+    void MeshSimplifier::CompactVertecies(MeshData::VertexData& vertecies, MeshData::IndexData& indicies)
+    {
+        MxVector<uint32_t> remap(vertecies.size(), InvalidSimplifierIndex);
+        MeshData::VertexData compacted;
+        compacted.reserve(vertecies.size());
+
+        for (auto& index : indicies)
+        {
+            if (remap[index] == InvalidSimplifierIndex)
+            {
+                remap[index] = (uint32_t)compacted.size();
+                compacted.push_back(vertecies[index]);
+            }
+            index = remap[index];
+        }
+        vertecies = std::move(compacted);
+    }
+
+    MeshHandle MeshSimplifier::SimplifyMesh(const Mesh& mesh, float triangleRatio, float maxError, float* resultError)
+    {
+        MAKE_SCOPE_PROFILER("MeshSimplifier::SimplifyMesh()");
+        MX_ASSERT(triangleRatio >= 0.0f && triangleRatio <= 1.0f);
+
+        MxVector<MeshData::VertexData> submeshVertecies;
+        MxVector<MeshData::IndexData> submeshIndicies;
+        size_t totalVertecies = 0, totalIndicies = 0;
+        float maxSubmeshError = 0.0f;
+
+        for (const auto& submesh : mesh.GetSubMeshes())
+        {
+            auto vertecies = submesh.Data.GetVerteciesFromGPU();
+            auto indicies = submesh.Data.GetIndiciesFromGPU();
+
+            size_t targetIndexCount = size_t(indicies.size() / 3 * triangleRatio) * 3;
+            float submeshError = 0.0f;
+            indicies = MeshSimplifier::Simplify(vertecies, indicies, targetIndexCount, maxError, &submeshError);
+            MeshSimplifier::CompactVertecies(vertecies, indicies);
+            MeshOptimizer::Optimize(vertecies, indicies);
+            // simplifier error is relative to submesh extent, convert it to object space
+            maxSubmeshError = Max(maxSubmeshError, submeshError * ComponentMax(submesh.Data.GetAABB().Length()));
+
+            totalVertecies += vertecies.size();
+            totalIndicies += indicies.size();
+            submeshVertecies.push_back(std::move(vertecies));
+            submeshIndicies.push_back(std::move(indicies));
+        }
+
+        auto lod = Factory<Mesh>::Create();
+        lod->ReserveData(totalVertecies, totalIndicies);
+
+        size_t vertexOffset = lod->GetBaseVerteciesOffset();
+        size_t indexOffset = lod->GetBaseIndiciesOffset();
+        for (size_t i = 0; i < submeshVertecies.size(); i++)
+        {
+            const auto& vertecies = submeshVertecies[i];
+            const auto& indicies = submeshIndicies[i];
+
+            MeshData meshData{ vertecies.size(), vertexOffset, indicies.size(), indexOffset, lod->GetIndexFormat() };
+            auto& submesh = lod->AddSubMesh(mesh.GetSubMeshByIndex(i).GetMaterialId(), std::move(meshData));
+            submesh.Data.BufferVertecies(vertecies);
+            submesh.Data.BufferIndicies(indicies);
+            submesh.Data.UpdateBoundingGeometry(vertecies);
+
+            vertexOffset += vertecies.size();
+            indexOffset += indicies.size();
+        }
+        lod->UpdateBoundingGeometry();
+        lod->LODError = maxSubmeshError;
+        lod->SetInternalEngineTag(MXENGINE_MAKE_INTERNAL_TAG("lod"));
+
+        if (resultError != nullptr) *resultError = maxSubmeshError;
+        return lod;
+    }
+
+    MxVector<MeshHandle> MeshSimplifier::GenerateLODs(const Mesh& mesh, const MeshLODConfig& config)
+    {
+        MAKE_SCOPE_PROFILER("MeshSimplifier::GenerateLODs()");
+        MAKE_SCOPE_TIMER("MxEngine::MeshSimplifier", "MeshSimplifier::GenerateLODs()");
+
+        MxVector<MeshHandle> lods;
+        size_t previousIndexCount = mesh.GetTotalIndiciesCount();
+        for (float ratio : config.TriangleRatios)
+        {
+            float error = 0.0f;
+            auto lod = MeshSimplifier::SimplifyMesh(mesh, ratio, config.MaxError, &error);
+
+            MXLOG_INFO("MxEngine::MeshSimplifier", MxFormat("generated LOD {0} for {1}: {2} -> {3} triangles, error: {4}",
+                lods.size() + 1, mesh.GetFilePath().c_str(), mesh.GetTotalIndiciesCount() / 3, lod->GetTotalIndiciesCount() / 3, error));
+
+            // error limit was reached, so less detailed LODs would be the same mesh
+            if (lod->GetTotalIndiciesCount() >= previousIndexCount) break;
+            previousIndexCount = lod->GetTotalIndiciesCount();
+            lods.push_back(std::move(lod));
+        }
+        return lods;
+    }
+}
@@ -0,0 +1,59 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Core/Resources/AssetManager.h"
+
+namespace MxEngine
+{
+    struct MeshLODConfig
+    {
+        // fraction of source triangles kept by each generated LOD, from the most detailed to the least detailed one
+        MxVector<float> TriangleRatios = { 0.5f, 0.25f, 0.125f };
+        // simplification of LOD stops early if error relative to mesh extent exceeds this value
+        float MaxError = 0.05f;
+    };
+
+    /*!
+    quadric error metric mesh simplifier based on half-edge collapses
+    vertecies are never moved, only removed, so all attributes of remaining vertecies are kept as is
+    vertecies sharing position but having different attributes (UV seams, hard normals) are collapsed together,
+    borders and seams can only be collapsed along themselves and are additionally penalized to keep their shape
+    */
+    class MeshSimplifier
+    {
+    public:
+        // resultError is relative to extent of vertecies
+        static MeshData::IndexData Simplify(const MeshData::VertexData& vertecies, const MeshData::IndexData& indicies, size_t targetIndexCount, float maxError, float* resultError = nullptr);
+        static void CompactVertecies(MeshData::VertexData& vertecies, MeshData::IndexData& indicies);
+        // resultError is in object space of mesh and is also stored in Mesh::LODError of result
+        static MeshHandle SimplifyMesh(const Mesh& mesh, float triangleRatio, float maxError, float* resultError = nullptr);
+        static MxVector<MeshHandle> GenerateLODs(const Mesh& mesh, const MeshLODConfig& config);
+    };
+}
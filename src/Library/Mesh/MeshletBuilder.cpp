@@ -0,0 +1,155 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "MeshletBuilder.h"
+#include "Utilities/Profiler/Profiler.h"
+
+namespace MxEngine
+{
+    MxVector<Meshlet> MeshletBuilder::Build(const MeshData::VertexData& vertecies, const MeshData::IndexData& indicies, size_t maxVertecies, size_t maxTriangles)
+    {
+        MAKE_SCOPE_PROFILER("MeshletBuilder::Build()");
+        MX_ASSERT(indicies.size() % 3 == 0);
+        MX_ASSERT(maxVertecies >= 3 && maxTriangles >= 1);
+
+        MxVector<Meshlet> meshlets;
+        // vertex is used by current meshlet if its stamp equals meshlet count
+        MxVector<uint32_t> vertexStamps(vertecies.size(), std::numeric_limits<uint32_t>::max());
+        size_t meshletBegin = 0, meshletVertecies = 0;
+
+        for (size_t i = 0; i < indicies.size(); i += 3)
+        {
+            uint32_t stamp = (uint32_t)meshlets.size();
+            size_t newVertecies = 0;
+            for (size_t j = 0; j < 3; j++)
+                newVertecies += (size_t)(vertexStamps[indicies[i + j]] != stamp);
+            // repeated index in degenerate triangle is counted twice, which only makes meshlet a bit smaller
+
+            size_t meshletTriangles = (i - meshletBegin) / 3;
+            if (meshletVertecies + newVertecies > maxVertecies || meshletTriangles + 1 > maxTriangles)
+            {
+                meshlets.push_back(MeshletBuilder::ComputeBounds(vertecies, indicies, meshletBegin, i - meshletBegin));
+                meshletBegin = i, meshletVertecies = 0;
+                stamp = (uint32_t)meshlets.size();
+            }
+
+            for (size_t j = 0; j < 3; j++)
+            {
+                uint32_t& vertexStamp = vertexStamps[indicies[i + j]];
+                meshletVertecies += (size_t)(vertexStamp != stamp);
+                vertexStamp = stamp;
+            }
+        }
+        if (meshletBegin < indicies.size())
+            meshlets.push_back(MeshletBuilder::ComputeBounds(vertecies, indicies, meshletBegin, indicies.size() - meshletBegin));
+
+        return meshlets;
+    }
+
+    Meshlet MeshletBuilder::ComputeBounds(const MeshData::VertexData& vertecies, const MeshData::IndexData& indicies, size_t indexOffset, size_t indexCount)
+    {
+        Meshlet meshlet;
+        meshlet.IndexOffset = (uint32_t)indexOffset;
+        meshlet.IndexCount = (uint32_t)indexCount;
+
+        AABB box{ vertecies[indicies[indexOffset]].Position, vertecies[indicies[indexOffset]].Position };
+        for (size_t i = indexOffset; i < indexOffset + indexCount; i++)
+        {
+            box.Min = VectorMin(box.Min, vertecies[indicies[i]].Position);
+            box.Max = VectorMax(box.Max, vertecies[indicies[i]].Position);
+        }
+        auto center = box.GetCenter();
+        float maxRadius = 0.0f;
+        for (size_t i = indexOffset; i < indexOffset + indexCount; i++)
+            maxRadius = Max(maxRadius, Length2(vertecies[indicies[i]].Position - center));
+        meshlet.Bounds = BoundingSphere(center, std::sqrt(maxRadius));
+
+        // cone axis is average of triangle normals, its spread is limited by the least aligned normal
+        auto axis = MakeVector3(0.0f);
+        for (size_t i = indexOffset; i < indexOffset + indexCount; i += 3)
+        {
+            const auto& p0 = vertecies[indicies[i + 0]].Position;
+            const auto& p1 = vertecies[indicies[i + 1]].Position;
+            const auto& p2 = vertecies[indicies[i + 2]].Position;
+            auto normal = Cross(p1 - p0, p2 - p0);
+            if (Length2(normal) > 0.0f) axis += Normalize(normal);
+        }
+
+        meshlet.ConeApex = center;
+        meshlet.ConeAxis = Length2(axis) > 0.0f ? Normalize(axis) : MakeVector3(0.0f, 1.0f, 0.0f);
+        meshlet.ConeCutoff = 2.0f;
+
+        float minDot = 1.0f;
+        for (size_t i = indexOffset; i < indexOffset + indexCount; i += 3)
+        {
+            const auto& p0 = vertecies[indicies[i + 0]].Position;
+            const auto& p1 = vertecies[indicies[i + 1]].Position;
+            const auto& p2 = vertecies[indicies[i + 2]].Position;
+            auto normal = Cross(p1 - p0, p2 - p0);
+            if (Length2(normal) > 0.0f) minDot = Min(minDot, Dot(Normalize(normal), meshlet.ConeAxis));
+        }
+        // cone is too wide to ever be fully back-facing, keep it disabled
+        if (minDot <= 0.1f) return meshlet;
+
+        // apex is moved back along axis until every triangle plane is in front of it
+        float maxT = 0.0f;
+        for (size_t i = indexOffset; i < indexOffset + indexCount; i += 3)
+        {
+            const auto& p0 = vertecies[indicies[i + 0]].Position;
+            const auto& p1 = vertecies[indicies[i + 1]].Position;
+            const auto& p2 = vertecies[indicies[i + 2]].Position;
+            auto normal = Cross(p1 - p0, p2 - p0);
+            if (Length2(normal) == 0.0f) continue;
+            normal = Normalize(normal);
+
+            float t = Dot(center - p0, normal) / Dot(meshlet.ConeAxis, normal);
+            maxT = Max(maxT, t);
+        }
+        meshlet.ConeApex = center - meshlet.ConeAxis * maxT;
+        meshlet.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+        return meshlet;
+    }
+
+    void MeshletBuilder::BuildMeshlets(Mesh& mesh)
+    {
+        MAKE_SCOPE_PROFILER("MeshletBuilder::BuildMeshlets()");
+
+        for (size_t i = 0; i < mesh.GetSubMeshes().size(); i++)
+        {
+            auto& submesh = mesh.GetSubMeshByIndex(i);
+            if (submesh.Data.GetIndiciesCount() / 3 < MeshletBuilder::MinTriangleCount)
+            {
+                submesh.Data.SetMeshlets({ });
+                continue;
+            }
+            auto vertecies = submesh.Data.GetVerteciesFromGPU();
+            auto indicies = submesh.Data.GetIndiciesFromGPU();
+            submesh.Data.SetMeshlets(MeshletBuilder::Build(vertecies, indicies));
+        }
+    }
+}
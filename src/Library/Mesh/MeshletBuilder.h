@@ -0,0 +1,52 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Core/Resources/AssetManager.h"
+
+namespace MxEngine
+{
+    /*!
+    splits submesh index buffer into meshlets by scanning triangles in order, so index buffer itself is not changed
+    and meshlet quality depends on its locality (loaded meshes are cache-optimized, see MeshOptimizer)
+    each meshlet gets bounding sphere for frustrum culling and normal cone for back-face culling
+    */
+    class MeshletBuilder
+    {
+    public:
+        constexpr static size_t MaxVertecies = 64;
+        constexpr static size_t MaxTriangles = 124;
+        // smaller submeshes are culled as a whole by their AABB
+        constexpr static size_t MinTriangleCount = 8 * MaxTriangles;
+
+        static MxVector<Meshlet> Build(const MeshData::VertexData& vertecies, const MeshData::IndexData& indicies, size_t maxVertecies = MaxVertecies, size_t maxTriangles = MaxTriangles);
+        static Meshlet ComputeBounds(const MeshData::VertexData& vertecies, const MeshData::IndexData& indicies, size_t indexOffset, size_t indexCount);
+        static void BuildMeshlets(Mesh& mesh);
+    };
+}
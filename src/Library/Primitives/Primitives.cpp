@@ -31,6 +31,7 @@
 #include "Utilities/FileSystem/FileManager.h"
 #include "Utilities/ObjectLoading/ObjectSaver.h"
 #include "Core/Config/GlobalConfig.h"
+#include "Library/Mesh/MeshOptimizer.h"
 
 namespace MxEngine
 {
@@ -49,13 +50,19 @@ namespace MxEngine
         return ToMxString(proximatePath);
     }
 
-    MeshHandle Primitives::CreateMesh(const MeshData::VertexData& vertecies, const MeshData::IndexData& indicies, const MxString& filename)
+    MeshHandle Primitives::CreateMesh(const MeshData::VertexData& sourceVertecies, const MeshData::IndexData& sourceIndicies, const MxString& filename)
     {
+        // generated primitives are emitted in construction order, so reorder them for vertex cache and overdraw
+        MeshData::VertexData vertecies = sourceVertecies;
+        MeshData::IndexData indicies = sourceIndicies;
+        MeshOptimizer::Optimize(vertecies, indicies);
+
         auto mesh = Factory<Mesh>::Create();
         mesh->ReserveData(vertecies.size(), indicies.size());
         MeshData meshData{
             mesh->GetTotalVerteciesCount(), mesh->GetBaseVerteciesOffset(),
-            mesh->GetTotalIndiciesCount(), mesh->GetBaseIndiciesOffset()
+            mesh->GetTotalIndiciesCount(), mesh->GetBaseIndiciesOffset(),
+            mesh->GetIndexFormat()
         };
 
         auto& submesh = mesh->AddSubMesh((SubMesh::MaterialId)0, std::move(meshData));
@@ -0,0 +1,219 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "GPUTimer.h"
+#include "Platform/OpenGL/GLUtilities.h"
+#include "Platform/NullAPI/NullGraphicAPI.h"
+#include "Core/Config/GlobalConfig.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Json/Json.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace MxEngine
+{
+    constexpr size_t InvalidQuery = std::numeric_limits<size_t>::max();
+
+    bool GPUTimerSession::CheckSupport()
+    {
+        if (this->isSupportChecked) return this->isSupported;
+        this->isSupportChecked = true;
+
+        // null api resolves every query immediately, so timer logic is still exercised by tests
+        if (NullGraphicAPI::IsInstalled()) return this->isSupported = true;
+
+        bool hasTimerQueries = GlobalConfig::GetGraphicAPIMajorVersion() * 10 + GlobalConfig::GetGraphicAPIMinorVersion() >= 33;
+        // driver may expose query api but report zero-width counter, in which case all timestamps are zero
+        GLint counterBits = 0;
+        if (hasTimerQueries)
+        {
+            GLCALL(glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &counterBits));
+        }
+
+        this->isSupported = counterBits > 0;
+        if (this->isSupported)
+            MXLOG_INFO("MxEngine::GPUTimer", "timestamp queries are supported, counter width: " + ToMxString(counterBits) + " bits");
+        else
+            MXLOG_WARNING("MxEngine::GPUTimer", "timestamp queries are not supported, gpu pass timings are disabled");
+        return this->isSupported;
+    }
+
+    size_t GPUTimerSession::AcquireQuery(FrameQueries& frame)
+    {
+        if (frame.UsedQueries == frame.Queries.size())
+        {
+            unsigned int query = 0;
+            GLCALL(glGenQueries(1, &query));
+            frame.Queries.push_back(query);
+        }
+        size_t index = frame.UsedQueries++;
+        GLCALL(glQueryCounter(frame.Queries[index], GL_TIMESTAMP));
+        return index;
+    }
+
+    void GPUTimerSession::ResolveFrame(FrameQueries& frame)
+    {
+        frame.IsPending = false;
+        if (frame.UsedQueries == 0) return;
+
+        // timestamps are written in submission order, so all results are ready if the last one is
+        GLint isAvailable = 0;
+        GLCALL(glGetQueryObjectiv(frame.Queries[frame.UsedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &isAvailable));
+        if (isAvailable == 0)
+        {
+            this->droppedFrames++;
+            return;
+        }
+
+        this->timings.clear();
+        for (const auto& pass : frame.Passes)
+        {
+            if (pass.EndQuery == InvalidQuery) continue;
+
+            GLuint64 begin = 0, end = 0;
+            GLCALL(glGetQueryObjectui64v(frame.Queries[pass.BeginQuery], GL_QUERY_RESULT, &begin));
+            GLCALL(glGetQueryObjectui64v(frame.Queries[pass.EndQuery], GL_QUERY_RESULT, &end));
+            float milliseconds = end > begin ? float(end - begin) * 1e-6f : 0.0f;
+
+            // passes are usually invoked several times per frame (i.e. once per camera), so their times are summed
+            auto it = std::find_if(this->timings.begin(), this->timings.end(),
+                [&pass](const GPUPassTiming& timing) { return timing.Name == pass.Name && timing.Depth == pass.Depth; });
+            if (it == this->timings.end())
+            {
+                this->timings.push_back(GPUPassTiming{ pass.Name, pass.Depth, 1, milliseconds });
+            }
+            else
+            {
+                it->CallCount++;
+                it->Milliseconds += milliseconds;
+            }
+        }
+        this->resolvedFrame = frame.FrameIndex;
+    }
+
+    void GPUTimerSession::BeginFrame()
+    {
+        if (!this->isEnabled || !this->CheckSupport()) return;
+
+        this->currentFrame++;
+        auto& frame = this->frames[this->currentFrame % FrameLatency];
+        if (frame.IsPending)
+            this->ResolveFrame(frame);
+
+        frame.UsedQueries = 0;
+        frame.Passes.clear();
+        frame.FrameIndex = this->currentFrame;
+        this->openPasses.clear();
+        this->isFrameStarted = true;
+    }
+
+    void GPUTimerSession::EndFrame()
+    {
+        if (!this->isFrameStarted) return;
+
+        auto& frame = this->frames[this->currentFrame % FrameLatency];
+        frame.IsPending = frame.UsedQueries > 0;
+        this->isFrameStarted = false;
+    }
+
+    void GPUTimerSession::BeginPass(const char* name)
+    {
+        if (!this->isFrameStarted) return;
+
+        auto& frame = this->frames[this->currentFrame % FrameLatency];
+        this->openPasses.push_back(frame.Passes.size());
+        frame.Passes.push_back(PassRecord{ name, this->openPasses.size() - 1, this->AcquireQuery(frame), InvalidQuery });
+    }
+
+    void GPUTimerSession::EndPass()
+    {
+        if (!this->isFrameStarted || this->openPasses.empty()) return;
+
+        auto& frame = this->frames[this->currentFrame % FrameLatency];
+        frame.Passes[this->openPasses.back()].EndQuery = this->AcquireQuery(frame);
+        this->openPasses.pop_back();
+    }
+
+    void GPUTimerSession::SetEnabled(bool value)
+    {
+        this->isEnabled = value;
+        if (!value)
+        {
+            // pending queries are never resolved, so their frames must not be read when timer is enabled again
+            this->EndFrame();
+            for (auto& frame : this->frames)
+                frame.IsPending = false;
+        }
+    }
+
+    bool GPUTimerSession::IsEnabled() const
+    {
+        return this->isEnabled;
+    }
+
+    bool GPUTimerSession::IsSupported() const
+    {
+        return this->isSupported;
+    }
+
+    const MxVector<GPUPassTiming>& GPUTimerSession::GetPassTimings() const
+    {
+        return this->timings;
+    }
+
+    size_t GPUTimerSession::GetResolvedFrameIndex() const
+    {
+        return this->resolvedFrame;
+    }
+
+    size_t GPUTimerSession::GetDroppedFrameCount() const
+    {
+        return this->droppedFrames;
+    }
+
+    void GPUTimerSession::ExportToJson(File& file) const
+    {
+        JsonFile json;
+        json["frame"] = this->resolvedFrame;
+        json["dropped frames"] = this->droppedFrames;
+
+        auto& passes = json["passes"];
+        passes = JsonFile::array();
+        for (const auto& timing : this->timings)
+        {
+            JsonFile pass;
+            pass["name"] = timing.Name;
+            pass["depth"] = timing.Depth;
+            pass["calls"] = timing.CallCount;
+            pass["milliseconds"] = timing.Milliseconds;
+            passes.push_back(std::move(pass));
+        }
+        SaveJson(file, json);
+    }
+}
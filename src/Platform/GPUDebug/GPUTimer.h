@@ -0,0 +1,133 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Core/Macro/Macro.h"
+#include "Utilities/STL/MxVector.h"
+#include <array>
+#include <cstdint>
+
+namespace MxEngine
+{
+    class File;
+
+    struct GPUPassTiming
+    {
+        const char* Name;
+        // nesting level of pass. Time of nested passes is also included into their parent
+        size_t Depth;
+        size_t CallCount;
+        float Milliseconds;
+    };
+
+    /*!
+    GPU timer session measures render passes with pairs of timestamp queries, so nested passes can be timed too.
+    queries of each frame are taken from one of FrameLatency pools and read back only when that pool is reused,
+    so CPU never waits for GPU. If results are still not available by then, measurements of that frame are dropped.
+    support is checked on first frame: timestamp queries require OpenGL 3.3 and a non-zero timestamp counter width,
+    which is not guaranteed by every driver (i.e. some Mesa software rasterizers). If they are not supported,
+    timer does not issue any queries and pass timings stay empty, so rendering is not affected
+    */
+    class GPUTimerSession
+    {
+    public:
+        constexpr static size_t FrameLatency = 4;
+    private:
+        struct PassRecord
+        {
+            const char* Name;
+            size_t Depth;
+            size_t BeginQuery;
+            size_t EndQuery;
+        };
+
+        struct FrameQueries
+        {
+            MxVector<unsigned int> Queries;
+            MxVector<PassRecord> Passes;
+            size_t UsedQueries = 0;
+            size_t FrameIndex = 0;
+            bool IsPending = false;
+        };
+
+        std::array<FrameQueries, FrameLatency> frames;
+        MxVector<size_t> openPasses;
+        MxVector<GPUPassTiming> timings;
+        size_t currentFrame = 0;
+        size_t resolvedFrame = 0;
+        size_t droppedFrames = 0;
+        bool isFrameStarted = false;
+        bool isEnabled = true;
+        bool isSupportChecked = false;
+        bool isSupported = false;
+
+        bool CheckSupport();
+        size_t AcquireQuery(FrameQueries& frame);
+        void ResolveFrame(FrameQueries& frame);
+    public:
+        void BeginFrame();
+        void EndFrame();
+        void BeginPass(const char* name);
+        void EndPass();
+
+        void SetEnabled(bool value);
+        bool IsEnabled() const;
+        // valid only after first frame was started, as support is checked lazily when graphic context exists
+        bool IsSupported() const;
+        // timings of the latest frame which results were read back, merged by pass name
+        const MxVector<GPUPassTiming>& GetPassTimings() const;
+        size_t GetResolvedFrameIndex() const;
+        size_t GetDroppedFrameCount() const;
+        void ExportToJson(File& file) const;
+    };
+
+    class GPUTimer
+    {
+        inline static GPUTimerSession impl;
+    public:
+        static GPUTimerSession& GetSession() { return impl; }
+        static void BeginFrame() { impl.BeginFrame(); }
+        static void EndFrame() { impl.EndFrame(); }
+        static void BeginPass(const char* name) { impl.BeginPass(name); }
+        static void EndPass() { impl.EndPass(); }
+    };
+
+    class GPUTimerScope
+    {
+    public:
+        GPUTimerScope(const char* name) { GPUTimer::BeginPass(name); }
+        ~GPUTimerScope() { GPUTimer::EndPass(); }
+    };
+
+    #if !defined(MXENGINE_SHIPPING)
+    #define MAKE_GPU_TIMER_SCOPE(name) GPUTimerScope MXENGINE_CONCAT(_gpuTimer, __LINE__)(name)
+    #else
+    #define MAKE_GPU_TIMER_SCOPE(name)
+    #endif
+}
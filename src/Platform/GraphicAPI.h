@@ -39,6 +39,7 @@
 #include "Platform/OpenGL/VertexArray.h"
 #include "Platform/OpenGL/VertexBuffer.h"
 #include "Platform/OpenGL/ShaderStorageBuffer.h"
+#include "Platform/OpenGL/IndirectBuffer.h"
 #include "Platform/OpenGL/ComputeShader.h"
 #include "Platform/OpenGL/VertexAttribute.h"
 
@@ -53,6 +54,7 @@ namespace MxEngine
     MXENGINE_MAKE_FACTORY(VertexArray);
     MXENGINE_MAKE_FACTORY(VertexBuffer);
     MXENGINE_MAKE_FACTORY(ShaderStorageBuffer);
+    MXENGINE_MAKE_FACTORY(IndirectBuffer);
     MXENGINE_MAKE_FACTORY(ComputeShader);
 
     #undef MAKE_FACTORY
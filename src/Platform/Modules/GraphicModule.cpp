@@ -33,6 +33,7 @@
 #include "Utilities/Profiler/Profiler.h"
 #include "Utilities/ImGui/ImGuiBase.h"
 #include "Utilities/FileSystem/FileManager.h"
+#include "Platform/NullAPI/NullGraphicAPI.h"
 
 #include <string>
 
@@ -45,7 +46,7 @@ namespace MxEngine
 
     void ImGuiStyleColorsMxEngineCustom();
 
-    void InitializeGLFW()
+    bool InitializeGLFW()
     {
         MAKE_SCOPE_PROFILER("OpenGL::InitGLFW");
         MAKE_SCOPE_TIMER("MxEngine::GLGraphicModule", "OpenGL::InitGLFW");
@@ -53,11 +54,7 @@ namespace MxEngine
             {
                 MXLOG_ERROR("OpenGL::InitGLFW", errorMessage);
             });
-        if (!glfwInit())
-        {
-            MXLOG_FATAL("OpenGL::InitGLFW", "OpenGL init failed");
-            return;
-        }
+        return glfwInit() == GLFW_TRUE;
     }
 
     void InitializeImGui(void* window)
@@ -73,7 +70,10 @@ namespace MxEngine
         imguiIO.ConfigDockingAlwaysTabBar = true;
 
         ImGui_ImplGlfw_InitForOpenGL(reinterpret_cast<GLFWwindow*>(window), true);
-        ImGui_ImplOpenGL3_Init(GetOpenGLShaderVersion().c_str());
+        if (GlobalConfig::HasNullGraphicAPI())
+            imguiIO.Fonts->Build(); // is done by OpenGL backend otherwise
+        else
+            ImGui_ImplOpenGL3_Init(GetOpenGLShaderVersion().c_str());
 
         switch (GlobalConfig::GetEditorStyle())
         {
@@ -102,9 +102,9 @@ namespace MxEngine
             MXLOG_FATAL("OpenGL::InitGLEW", "OpenGL init failed");
         }
 
-        GLCALL(const char* vendor = (const char*)glGetString(GL_VENDOR));
-        GLCALL(const char* renderer = (const char*)glGetString(GL_RENDERER));
-        GLCALL(const char* version = (const char*)glGetString(GL_VERSION));
+        GLCALL(const char* vendor = (const char*)GLLegacy.GetString(GL_VENDOR));
+        GLCALL(const char* renderer = (const char*)GLLegacy.GetString(GL_RENDERER));
+        GLCALL(const char* version = (const char*)GLLegacy.GetString(GL_VERSION));
 
         if (vendor != nullptr)   MXLOG_INFO("OpenGL::InitGLEW", "OpenGL vendor: " + MxString(vendor));
         if (renderer != nullptr) MXLOG_INFO("OpenGL::InitGLEW", "OpenGL renderer: " + MxString(renderer));
@@ -114,19 +114,46 @@ namespace MxEngine
     void InitializeDebug(void* window)
     {
         GLint flags;
-        GLCALL(glGetIntegerv(GL_CONTEXT_FLAGS, &flags));
+        GLCALL(GLLegacy.GetIntegerv(GL_CONTEXT_FLAGS, &flags));
         if (flags & GL_CONTEXT_FLAG_DEBUG_BIT)
         {
-            GLCALL(glEnable(GL_DEBUG_OUTPUT));
-            GLCALL(glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS));
+            GLCALL(GLLegacy.Enable(GL_DEBUG_OUTPUT));
+            GLCALL(GLLegacy.Enable(GL_DEBUG_OUTPUT_SYNCHRONOUS));
             GLCALL(glDebugMessageCallback(PrintDebugInformation, nullptr));
             GLCALL(glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE));
         }
     }
 
+    // result of glfw init with display server, checked when config is loaded
+    static bool IsGLFWInitialized = false;
+
     void GraphicModule::Init()
     {
-        InitializeGLFW();
+        // config is not loaded yet, so failure is not fatal: machine without display can still run in headless mode
+        IsGLFWInitialized = InitializeGLFW();
+        if (!IsGLFWInitialized)
+            MXLOG_ERROR("OpenGL::InitGLFW", "OpenGL init failed, only headless mode is available");
+    }
+
+    void GraphicModule::UseHeadlessMode(bool value)
+    {
+        if (!value)
+        {
+            if (!IsGLFWInitialized)
+                MXLOG_FATAL("OpenGL::InitGLFW", "OpenGL init failed");
+            return;
+        }
+
+        #if defined(GLFW_PLATFORM_NULL)
+        // restart glfw without connection to display server. Window hints are reset, so this must be called before window is configured
+        glfwTerminate();
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        IsGLFWInitialized = InitializeGLFW();
+        if (!IsGLFWInitialized)
+            MXLOG_FATAL("OpenGL::InitGLFW", "OpenGL init failed in headless mode");
+        #else
+        MXLOG_WARNING("OpenGL::InitGLFW", "glfw null platform is not supported, headless context still requires display server");
+        #endif
     }
 
     void* GraphicModule::GetImpl()
@@ -142,14 +169,18 @@ namespace MxEngine
 
     void GraphicModule::OnWindowCreate(WindowHandle window)
     {
-        InitializeGLEW(window);
+        if (GlobalConfig::HasNullGraphicAPI())
+            NullGraphicAPI::Install();
+        else
+            InitializeGLEW(window);
         InitializeImGui(window);
         InitializeDebug(window);
     }
 
     void GraphicModule::OnWindowUpdate(WindowHandle window)
     {
-        ImGui_ImplOpenGL3_NewFrame();
+        if (!GlobalConfig::HasNullGraphicAPI())
+            ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
         ImGuizmo::BeginFrame();
@@ -157,14 +188,17 @@ namespace MxEngine
 
     void GraphicModule::OnWindowDestroy(WindowHandle window)
     {
-        ImGui_ImplOpenGL3_Shutdown();
+        if (!GlobalConfig::HasNullGraphicAPI())
+            ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
     }
 
     void GraphicModule::OnRenderDraw()
     {
         ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        // there is no window to present ui to in headless mode
+        if (!GlobalConfig::IsHeadless())
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
     }
 
     void GraphicModule::Destroy()
@@ -35,6 +35,7 @@ namespace MxEngine
         using WindowHandle = void*;
     public:
         static void Init();
+        static void UseHeadlessMode(bool value = true);
         static void* GetImpl();
         static void Clone(void*);
         static void OnWindowCreate(WindowHandle window);
@@ -0,0 +1,358 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "NullGraphicAPI.h"
+#include "Platform/OpenGL/GLUtilities.h"
+#include "Utilities/Json/Json.h"
+#include "Utilities/Logging/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+namespace MxEngine
+{
+    // functions loaded by glew, which are replaced through glew function pointers
+    #define MXENGINE_NULL_GLEW_FUNCTIONS(X)\
+        X(ActiveTexture) X(AttachShader) X(BindBuffer) X(BindBufferBase) X(BindFramebuffer) X(BindRenderbuffer)\
+        X(BindVertexArray) X(BlitFramebuffer) X(BufferData) X(BufferStorage) X(BufferSubData)\
+        X(CheckFramebufferStatus) X(ClientWaitSync) X(ClipControl) X(CompileShader) X(CopyBufferSubData)\
+        X(CopyImageSubData) X(CreateProgram) X(CreateShader) X(DebugMessageCallback) X(DebugMessageControl)\
+        X(DeleteBuffers) X(DeleteFramebuffers) X(DeleteProgram) X(DeleteRenderbuffers) X(DeleteShader) X(DeleteSync)\
+        X(DeleteVertexArrays) X(DetachShader) X(DisableVertexAttribArray) X(DispatchCompute)\
+        X(DrawArraysInstancedBaseInstance) X(DrawBuffers) X(DrawElementsBaseVertex)\
+        X(DrawElementsInstancedBaseInstance) X(DrawElementsInstancedBaseVertexBaseInstance) X(EnableVertexAttribArray)\
+        X(FenceSync) X(FramebufferRenderbuffer) X(FramebufferTexture) X(FramebufferTexture2D) X(GenBuffers)\
+        X(GenFramebuffers) X(GenQueries) X(GenRenderbuffers) X(GenVertexArrays) X(GenerateMipmap) X(GetBufferSubData)\
+        X(GetProgramInfoLog) X(GetProgramiv) X(GetQueryObjectiv) X(GetQueryObjectui64v) X(GetShaderInfoLog)\
+        X(GetShaderiv) X(GetUniformLocation) X(LinkProgram) X(MapBufferRange) X(MemoryBarrier)\
+        X(MultiDrawElementsIndirect) X(PopDebugGroup) X(PushDebugGroup) X(QueryCounter)\
+        X(RenderbufferStorageMultisample) X(ShaderSource) X(Uniform1f) X(Uniform1i) X(Uniform2f) X(Uniform2i)\
+        X(Uniform3f) X(Uniform3i) X(Uniform4f) X(Uniform4i) X(UniformMatrix2fv) X(UniformMatrix3fv)\
+        X(UniformMatrix4fv) X(UseProgram) X(ValidateProgram) X(VertexAttrib1f) X(VertexAttrib2f) X(VertexAttrib3f)\
+        X(VertexAttrib4f) X(VertexAttribDivisor) X(VertexAttribIPointer) X(VertexAttribPointer)
+
+    // OpenGL 1.1 functions, which are replaced in GLLegacy table
+    #define MXENGINE_NULL_LEGACY_FUNCTIONS(X)\
+        X(BindTexture) X(BlendFunc) X(Clear) X(ClearColor) X(ClearDepth) X(ColorMask) X(CullFace) X(DeleteTextures)\
+        X(DepthFunc) X(DepthMask) X(Disable) X(DrawArrays) X(DrawBuffer) X(DrawElements) X(Enable) X(Finish) X(Flush)\
+        X(FrontFace) X(GenTextures) X(GetError) X(GetFloatv) X(GetIntegerv) X(GetString) X(GetTexImage)\
+        X(GetTexParameterfv) X(GetTexParameteriv) X(PixelStorei) X(Scissor) X(TexImage2D) X(TexParameterf)\
+        X(TexParameterfv) X(TexParameteri) X(TexParameteriv) X(Viewport)
+
+    #define MXENGINE_NULL_GL_FUNCTIONS(X) MXENGINE_NULL_GLEW_FUNCTIONS(X) MXENGINE_NULL_LEGACY_FUNCTIONS(X)
+
+    // names are suffixed, as some of them (i.e. MemoryBarrier) are defined as macros by system headers
+    #define MXENGINE_NULL_ENUM_ENTRY(name) name##Function,
+    #define MXENGINE_NULL_NAME_ENTRY(name) "gl" #name,
+
+    enum class GLFunction : size_t
+    {
+        MXENGINE_NULL_GL_FUNCTIONS(MXENGINE_NULL_ENUM_ENTRY)
+        COUNT
+    };
+
+    static const char* GLFunctionNames[] =
+    {
+        MXENGINE_NULL_GL_FUNCTIONS(MXENGINE_NULL_NAME_ENTRY)
+    };
+
+    template<GLFunction F>
+    struct FunctionTag { };
+
+    #define MXENGINE_NULL_TAG(name) FunctionTag<GLFunction::name##Function>
+
+    // size of command which is recorded with each call. Functions without specific overload have zero size
+
+    template<GLFunction F>
+    size_t NullCommandSize(FunctionTag<F>, ...) { return 0; }
+
+    size_t NullCommandSize(MXENGINE_NULL_TAG(DrawArrays), GLenum, GLint, GLsizei count) { return (size_t)count; }
+    size_t NullCommandSize(MXENGINE_NULL_TAG(DrawElements), GLenum, GLsizei count, GLenum, const void*) { return (size_t)count; }
+    size_t NullCommandSize(MXENGINE_NULL_TAG(DrawElementsBaseVertex), GLenum, GLsizei count, GLenum, const void*, GLint) { return (size_t)count; }
+    size_t NullCommandSize(MXENGINE_NULL_TAG(DrawArraysInstancedBaseInstance), GLenum, GLint, GLsizei count, GLsizei instances, GLuint) { return (size_t)count * (size_t)instances; }
+    size_t NullCommandSize(MXENGINE_NULL_TAG(DrawElementsInstancedBaseInstance), GLenum, GLsizei count, GLenum, const void*, GLsizei instances, GLuint) { return (size_t)count * (size_t)instances; }
+    size_t NullCommandSize(MXENGINE_NULL_TAG(DrawElementsInstancedBaseVertexBaseInstance), GLenum, GLsizei count, GLenum, const void*, GLsizei instances, GLint, GLuint) { return (size_t)count * (size_t)instances; }
+    // actual vertex count of indirect draws is stored in gpu buffer, so only number of draws is known
+    size_t NullCommandSize(MXENGINE_NULL_TAG(MultiDrawElementsIndirect), GLenum, GLenum, const void*, GLsizei drawCount, GLsizei) { return (size_t)drawCount; }
+    size_t NullCommandSize(MXENGINE_NULL_TAG(DispatchCompute), GLuint x, GLuint y, GLuint z) { return (size_t)x * (size_t)y * (size_t)z; }
+    size_t NullCommandSize(MXENGINE_NULL_TAG(BufferData), GLenum, GLsizeiptr size, const void*, GLenum) { return (size_t)size; }
+    size_t NullCommandSize(MXENGINE_NULL_TAG(BufferSubData), GLenum, GLintptr, GLsizeiptr size, const void*) { return (size_t)size; }
+    size_t NullCommandSize(MXENGINE_NULL_TAG(TexImage2D), GLenum, GLint, GLint, GLsizei width, GLsizei height, GLint, GLenum, GLenum, const void*) { return (size_t)width * (size_t)height; }
+
+    // behaviour of functions which return something. All others do nothing
+
+    template<GLFunction F>
+    void NullInvoke(FunctionTag<F>, ...) { }
+
+    void GenerateObjectIds(GLsizei count, GLuint* ids)
+    {
+        for (GLsizei i = 0; i < count; i++)
+            ids[i] = NullGraphicAPI::GetSession().GenerateObjectId();
+    }
+
+    void NullInvoke(MXENGINE_NULL_TAG(GenBuffers), GLsizei count, GLuint* ids) { GenerateObjectIds(count, ids); }
+    void NullInvoke(MXENGINE_NULL_TAG(GenFramebuffers), GLsizei count, GLuint* ids) { GenerateObjectIds(count, ids); }
+    void NullInvoke(MXENGINE_NULL_TAG(GenQueries), GLsizei count, GLuint* ids) { GenerateObjectIds(count, ids); }
+    void NullInvoke(MXENGINE_NULL_TAG(GenRenderbuffers), GLsizei count, GLuint* ids) { GenerateObjectIds(count, ids); }
+    void NullInvoke(MXENGINE_NULL_TAG(GenTextures), GLsizei count, GLuint* ids) { GenerateObjectIds(count, ids); }
+    void NullInvoke(MXENGINE_NULL_TAG(GenVertexArrays), GLsizei count, GLuint* ids) { GenerateObjectIds(count, ids); }
+    GLuint NullInvoke(MXENGINE_NULL_TAG(CreateProgram)) { return NullGraphicAPI::GetSession().GenerateObjectId(); }
+    GLuint NullInvoke(MXENGINE_NULL_TAG(CreateShader), GLenum) { return NullGraphicAPI::GetSession().GenerateObjectId(); }
+
+    GLenum NullInvoke(MXENGINE_NULL_TAG(GetError)) { return GL_NO_ERROR; }
+    GLenum NullInvoke(MXENGINE_NULL_TAG(CheckFramebufferStatus), GLenum) { return GL_FRAMEBUFFER_COMPLETE; }
+    GLint NullInvoke(MXENGINE_NULL_TAG(GetUniformLocation), GLuint, const GLchar*) { return 0; }
+
+    const GLubyte* NullInvoke(MXENGINE_NULL_TAG(GetString), GLenum name)
+    {
+        switch (name)
+        {
+        case GL_VENDOR:
+            return (const GLubyte*)"MxEngine";
+        case GL_RENDERER:
+            return (const GLubyte*)"Null Graphic API";
+        default:
+            return (const GLubyte*)"";
+        }
+    }
+
+    void NullInvoke(MXENGINE_NULL_TAG(GetShaderiv), GLuint, GLenum parameter, GLint* result)
+    {
+        *result = parameter == GL_COMPILE_STATUS ? GL_TRUE : 0;
+    }
+
+    void NullInvoke(MXENGINE_NULL_TAG(GetProgramiv), GLuint, GLenum parameter, GLint* result)
+    {
+        *result = (parameter == GL_LINK_STATUS || parameter == GL_VALIDATE_STATUS) ? GL_TRUE : 0;
+    }
+
+    void NullInvoke(MXENGINE_NULL_TAG(GetShaderInfoLog), GLuint, GLsizei bufferSize, GLsizei* length, GLchar* log)
+    {
+        if (length != nullptr) *length = 0;
+        if (bufferSize > 0) log[0] = '\0';
+    }
+
+    void NullInvoke(MXENGINE_NULL_TAG(GetProgramInfoLog), GLuint, GLsizei bufferSize, GLsizei* length, GLchar* log)
+    {
+        if (length != nullptr) *length = 0;
+        if (bufferSize > 0) log[0] = '\0';
+    }
+
+    void NullInvoke(MXENGINE_NULL_TAG(GetIntegerv), GLenum, GLint* result) { *result = 0; }
+    void NullInvoke(MXENGINE_NULL_TAG(GetFloatv), GLenum, GLfloat* result) { *result = 0.0f; }
+
+    void NullInvoke(MXENGINE_NULL_TAG(GetTexParameteriv), GLenum, GLenum, GLint* result) { *result = 0; }
+
+    void NullInvoke(MXENGINE_NULL_TAG(GetTexParameterfv), GLenum, GLenum parameter, GLfloat* result)
+    {
+        size_t count = parameter == GL_TEXTURE_BORDER_COLOR ? 4 : 1;
+        std::fill(result, result + count, 0.0f);
+    }
+
+    // queries are always available, so gpu timer resolves every frame with zero time
+    void NullInvoke(MXENGINE_NULL_TAG(GetQueryObjectiv), GLuint, GLenum parameter, GLint* result)
+    {
+        *result = parameter == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+    }
+
+    void NullInvoke(MXENGINE_NULL_TAG(GetQueryObjectui64v), GLuint, GLenum, GLuint64* result) { *result = 0; }
+
+    void NullInvoke(MXENGINE_NULL_TAG(GetBufferSubData), GLenum, GLintptr, GLsizeiptr size, void* data)
+    {
+        std::memset(data, 0, (size_t)size);
+    }
+
+    // persistently mapped buffers are written by engine directly, so they must be backed by real memory
+    void* NullInvoke(MXENGINE_NULL_TAG(MapBufferRange), GLenum, GLintptr, GLsizeiptr length, GLbitfield)
+    {
+        return NullGraphicAPI::GetSession().AllocateMappedMemory((size_t)length);
+    }
+
+    GLsync NullInvoke(MXENGINE_NULL_TAG(FenceSync), GLenum, GLbitfield) { return (GLsync)(uintptr_t)NullGraphicAPI::GetSession().GenerateObjectId(); }
+    GLenum NullInvoke(MXENGINE_NULL_TAG(ClientWaitSync), GLsync, GLbitfield, GLuint64) { return GL_ALREADY_SIGNALED; }
+
+    template<GLFunction F, typename FunctionPtr>
+    struct NullStub;
+
+    template<GLFunction F, typename R, typename... Args>
+    struct NullStub<F, R(GLAPIENTRY*)(Args...)>
+    {
+        static R GLAPIENTRY Invoke(Args... args)
+        {
+            NullGraphicAPI::GetSession().Record((size_t)F, NullCommandSize(FunctionTag<F>{ }, args...));
+            return NullInvoke(FunctionTag<F>{ }, args...);
+        }
+    };
+
+    template<GLFunction F, typename FunctionPtr>
+    void InstallNullStub(FunctionPtr& function)
+    {
+        function = &NullStub<F, FunctionPtr>::Invoke;
+    }
+
+    #define MXENGINE_NULL_INSTALL_GLEW_ENTRY(name) InstallNullStub<GLFunction::name##Function>(gl##name);
+    #define MXENGINE_NULL_INSTALL_LEGACY_ENTRY(name) InstallNullStub<GLFunction::name##Function>(GLLegacy.name);
+
+    void NullGraphicAPISession::Install()
+    {
+        if (this->isInstalled) return;
+
+        MXENGINE_NULL_GLEW_FUNCTIONS(MXENGINE_NULL_INSTALL_GLEW_ENTRY)
+        MXENGINE_NULL_LEGACY_FUNCTIONS(MXENGINE_NULL_INSTALL_LEGACY_ENTRY)
+
+        this->currentFrame.resize((size_t)GLFunction::COUNT);
+        for (size_t i = 0; i < this->currentFrame.size(); i++)
+            this->currentFrame[i] = NullFunctionStatistics{ GLFunctionNames[i], 0, 0 };
+        this->lastFrame = this->currentFrame;
+        this->isInstalled = true;
+
+        MXLOG_INFO("MxEngine::NullGraphicAPI", "null graphic api installed, graphic commands will not be executed");
+    }
+
+    bool NullGraphicAPISession::IsInstalled() const
+    {
+        return this->isInstalled;
+    }
+
+    void NullGraphicAPISession::BeginFrame()
+    {
+        if (!this->isInstalled) return;
+
+        std::swap(this->lastFrame, this->currentFrame);
+        for (auto& statistics : this->currentFrame)
+        {
+            statistics.CallCount = 0;
+            statistics.TotalSize = 0;
+        }
+        std::swap(this->lastCommands, this->currentCommands);
+        this->currentCommands.clear();
+    }
+
+    void NullGraphicAPISession::Record(size_t function, size_t size)
+    {
+        auto& statistics = this->currentFrame[function];
+        statistics.CallCount++;
+        statistics.TotalSize += size;
+
+        if (this->isRecording)
+            this->currentCommands.push_back(NullCommand{ statistics.Function, size });
+    }
+
+    unsigned int NullGraphicAPISession::GenerateObjectId()
+    {
+        return ++this->lastObjectId;
+    }
+
+    void* NullGraphicAPISession::AllocateMappedMemory(size_t byteSize)
+    {
+        // memory is never freed, but buffers are mapped only once on creation
+        auto& memory = this->mappedMemory.emplace_back(byteSize);
+        return memory.data();
+    }
+
+    void NullGraphicAPISession::SetCommandRecording(bool value)
+    {
+        this->isRecording = value;
+    }
+
+    bool NullGraphicAPISession::IsCommandRecording() const
+    {
+        return this->isRecording;
+    }
+
+    const MxVector<NullFunctionStatistics>& NullGraphicAPISession::GetFunctionStatistics() const
+    {
+        return this->lastFrame;
+    }
+
+    const MxVector<NullCommand>& NullGraphicAPISession::GetRecordedCommands() const
+    {
+        return this->lastCommands;
+    }
+
+    size_t NullGraphicAPISession::GetDrawCallCount() const
+    {
+        if (!this->isInstalled) return 0;
+
+        constexpr GLFunction DrawFunctions[] =
+        {
+            GLFunction::DrawArraysFunction,
+            GLFunction::DrawElementsFunction,
+            GLFunction::DrawElementsBaseVertexFunction,
+            GLFunction::DrawArraysInstancedBaseInstanceFunction,
+            GLFunction::DrawElementsInstancedBaseInstanceFunction,
+            GLFunction::DrawElementsInstancedBaseVertexBaseInstanceFunction,
+            GLFunction::MultiDrawElementsIndirectFunction,
+        };
+
+        size_t result = 0;
+        for (auto function : DrawFunctions)
+            result += this->lastFrame[(size_t)function].CallCount;
+        return result;
+    }
+
+    size_t NullGraphicAPISession::GetUploadedBytes() const
+    {
+        if (!this->isInstalled) return 0;
+
+        return this->lastFrame[(size_t)GLFunction::BufferDataFunction].TotalSize +
+               this->lastFrame[(size_t)GLFunction::BufferSubDataFunction].TotalSize;
+    }
+
+    void NullGraphicAPISession::ExportToJson(File& file) const
+    {
+        JsonFile json;
+        json["draw calls"] = this->GetDrawCallCount();
+        json["uploaded bytes"] = this->GetUploadedBytes();
+
+        auto& functions = json["functions"];
+        functions = JsonFile::array();
+        for (const auto& statistics : this->lastFrame)
+        {
+            if (statistics.CallCount == 0) continue;
+
+            JsonFile function;
+            function["name"] = statistics.Function;
+            function["calls"] = statistics.CallCount;
+            function["size"] = statistics.TotalSize;
+            functions.push_back(std::move(function));
+        }
+
+        auto& commands = json["commands"];
+        commands = JsonFile::array();
+        for (const auto& command : this->lastCommands)
+        {
+            JsonFile entry;
+            entry["name"] = command.Function;
+            entry["size"] = command.Size;
+            commands.push_back(std::move(entry));
+        }
+        SaveJson(file, json);
+    }
+}
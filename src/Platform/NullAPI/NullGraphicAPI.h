@@ -0,0 +1,94 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Utilities/STL/MxVector.h"
+
+namespace MxEngine
+{
+    class File;
+
+    struct NullCommand
+    {
+        const char* Function;
+        // number of vertices for draw calls, number of bytes for buffer uploads and number of texels for texture uploads
+        size_t Size;
+    };
+
+    struct NullFunctionStatistics
+    {
+        const char* Function;
+        size_t CallCount;
+        size_t TotalSize;
+    };
+
+    /*!
+    null graphic api replaces OpenGL entry points with stubs which only count and optionally record calls.
+    Platform objects (buffers, textures, shaders, framebuffers) still work as usual, but receive fake ids and never touch GPU,
+    so whole CPU side of render pipeline can be profiled without driver overhead or run on machines without GPU at all.
+    queries which engine depends on are answered as if everything succeeded (shaders are compiled, framebuffers are complete)
+    */
+    class NullGraphicAPISession
+    {
+        MxVector<NullFunctionStatistics> currentFrame;
+        MxVector<NullFunctionStatistics> lastFrame;
+        MxVector<NullCommand> currentCommands;
+        MxVector<NullCommand> lastCommands;
+        MxVector<MxVector<uint8_t>> mappedMemory;
+        unsigned int lastObjectId = 0;
+        bool isInstalled = false;
+        bool isRecording = false;
+    public:
+        void Install();
+        bool IsInstalled() const;
+        void BeginFrame();
+        void Record(size_t function, size_t size);
+        unsigned int GenerateObjectId();
+        void* AllocateMappedMemory(size_t byteSize);
+
+        void SetCommandRecording(bool value);
+        bool IsCommandRecording() const;
+        // statistics and commands of the latest finished frame
+        const MxVector<NullFunctionStatistics>& GetFunctionStatistics() const;
+        const MxVector<NullCommand>& GetRecordedCommands() const;
+        size_t GetDrawCallCount() const;
+        size_t GetUploadedBytes() const;
+        void ExportToJson(File& file) const;
+    };
+
+    class NullGraphicAPI
+    {
+        inline static NullGraphicAPISession impl;
+    public:
+        static NullGraphicAPISession& GetSession() { return impl; }
+        static void Install() { impl.Install(); }
+        static bool IsInstalled() { return impl.IsInstalled(); }
+        static void BeginFrame() { impl.BeginFrame(); }
+    };
+}
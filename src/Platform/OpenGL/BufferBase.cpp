@@ -37,6 +37,7 @@ namespace MxEngine
         GL_ARRAY_BUFFER,
         GL_ELEMENT_ARRAY_BUFFER,
         GL_SHADER_STORAGE_BUFFER,
+        GL_DRAW_INDIRECT_BUFFER,
     };
 
     GLenum UsageTypeToEnum[] = {
@@ -150,6 +151,27 @@ namespace MxEngine
         GLCALL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, other.GetByteSize()));
     }
 
+    void BufferBase::CopySubDataFrom(const BufferBase& other, size_t readByteOffset, size_t writeByteOffset, size_t byteSize)
+    {
+        MX_ASSERT(readByteOffset + byteSize <= other.GetByteSize());
+        MX_ASSERT(writeByteOffset + byteSize <= this->byteSize);
+        GLCALL(glBindBuffer(GL_COPY_READ_BUFFER, other.GetNativeHandle()));
+        GLCALL(glBindBuffer(GL_COPY_WRITE_BUFFER, this->id));
+        GLCALL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, readByteOffset, writeByteOffset, byteSize));
+    }
+
+    uint8_t* BufferBase::LoadPersistentMapped(size_t byteSize)
+    {
+        // coherent mapping makes writes visible to GPU without explicit flushes, so only fences are required
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        this->byteSize = byteSize;
+        this->Bind();
+        GLCALL(glBufferStorage(BufferTypeToEnum[(size_t)this->type], this->byteSize, nullptr, flags));
+        void* memory = nullptr;
+        GLCALL(memory = glMapBufferRange(BufferTypeToEnum[(size_t)this->type], 0, this->byteSize, flags));
+        return (uint8_t*)memory;
+    }
+
     void BufferBase::Load(BufferType type, const uint8_t* byteData, size_t byteSize, UsageType usage)
     {
         this->type = type;
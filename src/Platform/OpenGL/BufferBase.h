@@ -52,6 +52,7 @@ namespace MxEngine
         ARRAY,
         ELEMENT_ARRAY,
         SHADER_STORAGE,
+        DRAW_INDIRECT,
     };
 
     class BufferBase
@@ -81,6 +82,12 @@ namespace MxEngine
         size_t GetByteSize() const;
         void SetUsageType(UsageType usage);
         void LoadFrom(BufferBase& other);
+        void CopySubDataFrom(const BufferBase& other, size_t readByteOffset, size_t writeByteOffset, size_t byteSize);
+        /*!
+        replaces buffer storage with immutable one, which stays mapped for writing until buffer is destroyed
+        \returns pointer to mapped memory or nullptr if mapping failed
+        */
+        uint8_t* LoadPersistentMapped(size_t byteSize);
 
     protected:
         void Load(BufferType type, const uint8_t* byteData, size_t byteSize, UsageType usage);
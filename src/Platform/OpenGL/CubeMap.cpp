@@ -39,7 +39,7 @@ namespace MxEngine
     {
         if (id != 0)
         {
-            GLCALL(glDeleteTextures(1, &id));
+            GLCALL(GLLegacy.DeleteTextures(1, &id));
             MXLOG_DEBUG("OpenGL::CubeMap", "deleted cubemap with id = " + ToMxString(id));
         }
         id = 0;
@@ -48,7 +48,7 @@ namespace MxEngine
 
     CubeMap::CubeMap()
     {
-        GLCALL(glGenTextures(1, &id));
+        GLCALL(GLLegacy.GenTextures(1, &id));
         MXLOG_DEBUG("OpenGL::CubeMap", "created cubemap with id = " + ToMxString(id));
     }
 
@@ -72,16 +72,16 @@ namespace MxEngine
         this->width = img.GetWidth();
         this->height = img.GetHeight();
 
-        GLCALL(glBindTexture(GL_TEXTURE_CUBE_MAP, id));
+        GLCALL(GLLegacy.BindTexture(GL_TEXTURE_CUBE_MAP, id));
         for (size_t i = 0; i < 6; i++)
         {
-            GLCALL(glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + (GLenum)i, 0, GL_RGB,
+            GLCALL(GLLegacy.TexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + (GLenum)i, 0, GL_RGB,
                 (GLsizei)images[i].width(), (GLsizei)images[i].height() / (GLsizei)this->channels, 0, GL_RGBA, GL_UNSIGNED_BYTE, images[i].data()));
         }
 
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
 
         this->GenerateMipmaps();
     }
@@ -139,13 +139,13 @@ namespace MxEngine
     void CubeMap::Bind() const
     {
         GLCALL(glActiveTexture(GL_TEXTURE0 + this->activeId));
-        GLCALL(glBindTexture(GL_TEXTURE_CUBE_MAP, id));
+        GLCALL(GLLegacy.BindTexture(GL_TEXTURE_CUBE_MAP, id));
     }
 
     void CubeMap::Unbind() const
     {
         GLCALL(glActiveTexture(GL_TEXTURE0 + this->activeId));
-        GLCALL(glBindTexture(GL_TEXTURE_CUBE_MAP, 0));
+        GLCALL(GLLegacy.BindTexture(GL_TEXTURE_CUBE_MAP, 0));
     }
 
     CubeMap::BindableId CubeMap::GetNativeHandle() const
@@ -209,16 +209,16 @@ namespace MxEngine
             break;
         }
 
-        GLCALL(glBindTexture(GL_TEXTURE_CUBE_MAP, id));
+        GLCALL(GLLegacy.BindTexture(GL_TEXTURE_CUBE_MAP, id));
         for (size_t i = 0; i < images.size(); i++)
         {
-            GLCALL(glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + (GLenum)i, 0, GL_RGB,
+            GLCALL(GLLegacy.TexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + (GLenum)i, 0, GL_RGB,
                 (GLsizei)this->width, (GLsizei)this->height, 0, pixelFormat, pixelType, images[i].GetRawData()));
         }
 
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
         
         if (std::any_of(images.begin(), images.end(), [](const Image& slice) { return slice.GetRawData() != nullptr; }))
         {
@@ -226,8 +226,8 @@ namespace MxEngine
         }
         else
         {
-            GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-            GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+            GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+            GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
         }
     }
 
@@ -238,16 +238,16 @@ namespace MxEngine
         this->channels = 3;
         this->filepath = MXENGINE_MAKE_INTERNAL_TAG("raw");
 
-        GLCALL(glBindTexture(GL_TEXTURE_CUBE_MAP, id));
+        GLCALL(GLLegacy.BindTexture(GL_TEXTURE_CUBE_MAP, id));
         for (size_t i = 0; i < data.size(); i++)
         {
-            GLCALL(glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + (GLenum)i, 0, GL_RGB,
+            GLCALL(GLLegacy.TexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + (GLenum)i, 0, GL_RGB,
                 (GLsizei)this->width, (GLsizei)this->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data[i]));
         }
 
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
 
         if (std::any_of(data.begin(), data.end(), [](const uint8_t* slice) { return slice != nullptr; }))
         {
@@ -255,8 +255,8 @@ namespace MxEngine
         }
         else
         {
-            GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-            GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+            GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+            GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
         }
     }
 
@@ -267,22 +267,33 @@ namespace MxEngine
         this->filepath = MXENGINE_MAKE_INTERNAL_TAG("depth");
         this->channels = 1;
         
-        GLCALL(glBindTexture(GL_TEXTURE_CUBE_MAP, id));
+        GLCALL(GLLegacy.BindTexture(GL_TEXTURE_CUBE_MAP, id));
         for (size_t i = 0; i < 6; i++)
         {
-            GLCALL(glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + (GLenum)i, 0, GL_DEPTH_COMPONENT, 
+            GLCALL(GLLegacy.TexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + (GLenum)i, 0, GL_DEPTH_COMPONENT, 
                 width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr));
         }
 
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER));
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER));
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_BORDER));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_BORDER));
 
         float border[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-        GLCALL(glTexParameterfv(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BORDER_COLOR, border));
+        GLCALL(GLLegacy.TexParameterfv(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BORDER_COLOR, border));
 
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    }
+
+    void CubeMap::CopyTo(CubeMap& target) const
+    {
+        MX_ASSERT(this->width == target.width && this->height == target.height);
+        // cubemap faces are addressed as layers of depth 6
+        GLCALL(glCopyImageSubData(
+            this->id, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
+            target.id, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
+            (GLsizei)this->width, (GLsizei)this->height, 6
+        ));
     }
 
     const MxString& CubeMap::GetFilePath() const
@@ -318,20 +329,20 @@ namespace MxEngine
     void CubeMap::SetMaxLOD(size_t lod)
     {
         this->Bind(0);
-        GLCALL(glTexParameterf(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LOD, (float)lod));
+        GLCALL(GLLegacy.TexParameterf(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LOD, (float)lod));
     }
 
     void CubeMap::SetMinLOD(size_t lod)
     {
         this->Bind(0);
-        GLCALL(glTexParameterf(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_LOD, (float)lod));
+        GLCALL(GLLegacy.TexParameterf(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_LOD, (float)lod));
     }
 
     void CubeMap::GenerateMipmaps()
     {
         this->Bind(0);
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
-        GLCALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
         GLCALL(glGenerateMipmap(GL_TEXTURE_CUBE_MAP));
     }
 
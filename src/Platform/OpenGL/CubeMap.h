@@ -73,6 +73,7 @@ namespace MxEngine
         void Load(const std::array<Image, 6>& images);
         void Load(const std::array<uint8_t*, 6>& RawDataRGB, size_t width, size_t height);
         void LoadDepth(int width, int height);
+        void CopyTo(CubeMap& target) const;
         size_t GetWidth() const;
         size_t GetHeight() const;
         size_t GetChannelCount() const;
@@ -152,7 +152,7 @@ namespace MxEngine
     void FrameBuffer::UseOnlyDepth() const
     {
         this->Bind();
-        GLCALL(glDrawBuffer(GL_NONE));
+        GLCALL(GLLegacy.DrawBuffer(GL_NONE));
     }
 
     size_t FrameBuffer::GetWidth() const
@@ -37,11 +37,13 @@
 
 namespace MxEngine
 {
+    GLLegacyFunctions GLLegacy;
+
     static std::set<int> ExistingErrors = { 131154 };
 
     void GlClearErrors()
     {
-        while (glGetError() != GL_NO_ERROR);
+        while (GLLegacy.GetError() != GL_NO_ERROR);
     }
 
     void GlPushDebugGroup(const char* name)
@@ -57,7 +59,7 @@ namespace MxEngine
     bool GlLogCall(const char* function, const char* file, int line)
     {
         bool success = true;
-        while (GLenum error = glGetError())
+        while (GLenum error = GLLegacy.GetError())
         {
             success = false;
             if (ExistingErrors.find(error) != ExistingErrors.end())
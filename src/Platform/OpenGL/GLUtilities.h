@@ -37,6 +37,55 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+namespace MxEngine
+{
+    /*!
+    OpenGL 1.1 functions are exported by system library directly and are not loaded by glew.
+    engine calls them explicitly through GLLegacy table (i.e. GLLegacy.Clear(mask) instead of glClear(mask)),
+    so they can be replaced the same way as glew function pointers (see NullGraphicAPI).
+    gl* names themselves are never redefined, so third-party code which includes OpenGL headers is not affected
+    */
+    struct GLLegacyFunctions
+    {
+        decltype(&::glBindTexture)       BindTexture       = &::glBindTexture;
+        decltype(&::glBlendFunc)         BlendFunc         = &::glBlendFunc;
+        decltype(&::glClear)             Clear             = &::glClear;
+        decltype(&::glClearColor)        ClearColor        = &::glClearColor;
+        decltype(&::glClearDepth)        ClearDepth        = &::glClearDepth;
+        decltype(&::glColorMask)         ColorMask         = &::glColorMask;
+        decltype(&::glCullFace)          CullFace          = &::glCullFace;
+        decltype(&::glDeleteTextures)    DeleteTextures    = &::glDeleteTextures;
+        decltype(&::glDepthFunc)         DepthFunc         = &::glDepthFunc;
+        decltype(&::glDepthMask)         DepthMask         = &::glDepthMask;
+        decltype(&::glDisable)           Disable           = &::glDisable;
+        decltype(&::glDrawArrays)        DrawArrays        = &::glDrawArrays;
+        decltype(&::glDrawBuffer)        DrawBuffer        = &::glDrawBuffer;
+        decltype(&::glDrawElements)      DrawElements      = &::glDrawElements;
+        decltype(&::glEnable)            Enable            = &::glEnable;
+        decltype(&::glFinish)            Finish            = &::glFinish;
+        decltype(&::glFlush)             Flush             = &::glFlush;
+        decltype(&::glFrontFace)         FrontFace         = &::glFrontFace;
+        decltype(&::glGenTextures)       GenTextures       = &::glGenTextures;
+        decltype(&::glGetError)          GetError          = &::glGetError;
+        decltype(&::glGetFloatv)         GetFloatv         = &::glGetFloatv;
+        decltype(&::glGetIntegerv)       GetIntegerv       = &::glGetIntegerv;
+        decltype(&::glGetString)         GetString         = &::glGetString;
+        decltype(&::glGetTexImage)       GetTexImage       = &::glGetTexImage;
+        decltype(&::glGetTexParameterfv) GetTexParameterfv = &::glGetTexParameterfv;
+        decltype(&::glGetTexParameteriv) GetTexParameteriv = &::glGetTexParameteriv;
+        decltype(&::glPixelStorei)       PixelStorei       = &::glPixelStorei;
+        decltype(&::glScissor)           Scissor           = &::glScissor;
+        decltype(&::glTexImage2D)        TexImage2D        = &::glTexImage2D;
+        decltype(&::glTexParameterf)     TexParameterf     = &::glTexParameterf;
+        decltype(&::glTexParameterfv)    TexParameterfv    = &::glTexParameterfv;
+        decltype(&::glTexParameteri)     TexParameteri     = &::glTexParameteri;
+        decltype(&::glTexParameteriv)    TexParameteriv    = &::glTexParameteriv;
+        decltype(&::glViewport)          Viewport          = &::glViewport;
+    };
+
+    extern GLLegacyFunctions GLLegacy;
+}
+
 namespace MxEngine
 {
     #if defined(MXENGINE_DEBUG)
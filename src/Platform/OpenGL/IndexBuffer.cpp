@@ -40,6 +40,11 @@ namespace MxEngine
         return this->GetByteSize() / sizeof(IndexType);
     }
 
+    size_t IndexBuffer::GetIndexSize(IndexFormat format)
+    {
+        return format == IndexFormat::UINT16 ? sizeof(ShortIndexType) : sizeof(IndexType);
+    }
+
     void IndexBuffer::Load(const IndexType* data, size_t count, UsageType usage)
     {
         BufferBase::Load(BufferType::ELEMENT_ARRAY, (const uint8_t*)data, count * sizeof(IndexType), usage);
@@ -50,6 +55,11 @@ namespace MxEngine
         BufferBase::BufferSubData((const uint8_t*)data, count * sizeof(IndexType), offsetCount * sizeof(IndexType));
     }
 
+    void IndexBuffer::BufferSubData(const ShortIndexType* data, size_t count, size_t offsetCount)
+    {
+        BufferBase::BufferSubData((const uint8_t*)data, count * sizeof(ShortIndexType), offsetCount * sizeof(ShortIndexType));
+    }
+
     void IndexBuffer::BufferDataWithResize(const IndexType* data, size_t count)
     {
         BufferBase::BufferDataWithResize((const uint8_t*)data, count * sizeof(IndexType));
@@ -59,4 +69,9 @@ namespace MxEngine
     {
         BufferBase::GetBufferData((uint8_t*)data, count * sizeof(IndexType), offsetCount * sizeof(IndexType));
     }
+
+    void IndexBuffer::GetBufferData(ShortIndexType* data, size_t count, size_t offsetCount) const
+    {
+        BufferBase::GetBufferData((uint8_t*)data, count * sizeof(ShortIndexType), offsetCount * sizeof(ShortIndexType));
+    }
 }
\ No newline at end of file
@@ -32,18 +32,28 @@
 
 namespace MxEngine
 {
+    enum class IndexFormat : uint8_t
+    {
+        UINT32 = 0,
+        UINT16,
+    };
+
     class IndexBuffer : public BufferBase
     {
     public:
         using IndexType = uint32_t;
+        using ShortIndexType = uint16_t;
 
         IndexBuffer(const IndexType* data, size_t count, UsageType usage);
         
         size_t GetSize() const;
+        static size_t GetIndexSize(IndexFormat format);
 
         void Load(const IndexType* data, size_t count, UsageType usage);
         void BufferSubData(const IndexType* data, size_t count, size_t offsetCount = 0);
+        void BufferSubData(const ShortIndexType* data, size_t count, size_t offsetCount = 0);
         void BufferDataWithResize(const IndexType* data, size_t count);
         void GetBufferData(IndexType* data, size_t count, size_t offsetCount = 0) const;
+        void GetBufferData(ShortIndexType* data, size_t count, size_t offsetCount = 0) const;
     };
 }
\ No newline at end of file
@@ -30,6 +30,7 @@
 #include "Utilities/Logging/Logger.h"
 #include "Platform/OpenGL/GLUtilities.h"
 #include "Platform/Modules/GraphicModule.h"
+#include "Platform/NullAPI/NullGraphicAPI.h"
 #include "Utilities/Profiler/Profiler.h"
 #include "Utilities/Format/Format.h"
 
@@ -68,6 +69,11 @@ namespace MxEngine
         GL_PATCHES,
     };
 
+    GLenum IndexFormatTable[] = {
+        GL_UNSIGNED_INT,
+        GL_UNSIGNED_SHORT,
+    };
+
     Renderer::Renderer()
     {
         this->clearMask |= GL_COLOR_BUFFER_BIT;
@@ -75,7 +81,7 @@ namespace MxEngine
 
     void Renderer::Clear() const
     {
-        GLCALL(glClear(clearMask));
+        GLCALL(GLLegacy.Clear(clearMask));
     }
 
     void Renderer::Flush() const
@@ -83,7 +89,7 @@ namespace MxEngine
         MAKE_SCOPE_PROFILER("Renderer::Flush");
         GraphicModule::OnRenderDraw();
 
-        glFlush();
+        GLLegacy.Flush();
     }
 
     void Renderer::Finish() const
@@ -91,19 +97,24 @@ namespace MxEngine
         MAKE_SCOPE_PROFILER("Renderer::Finish");
         GraphicModule::OnRenderDraw();
 
-        glFinish();
+        GLLegacy.Finish();
     }
 
     void Renderer::SetViewport(int x, int y, int width, int height) const
     {
-        GLCALL(glViewport(x, y, width, height));
+        GLCALL(GLLegacy.Viewport(x, y, width, height));
+    }
+
+    void Renderer::SetScissor(int x, int y, int width, int height) const
+    {
+        GLCALL(GLLegacy.Scissor(x, y, width, height));
     }
 
     Renderer& Renderer::UseClipDistance(size_t count)
     {
         for (size_t i = 0; i < count; i++)
         {
-            GLCALL(glEnable(GL_CLIP_DISTANCE0 + i));
+            GLCALL(GLLegacy.Enable(GL_CLIP_DISTANCE0 + i));
         }
         return *this;
     }
@@ -111,15 +122,15 @@ namespace MxEngine
     Renderer& Renderer::UseSeamlessCubeMaps(bool value)
     {
         if (value)
-            glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+            GLLegacy.Enable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
         else
-            glDisable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+            GLLegacy.Disable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
         return *this;
     }
 
     void Renderer::DrawVertices(RenderPrimitive primitive, size_t vertexCount, size_t vertexOffset)
     {
-        GLCALL(glDrawArrays(PrimitiveTable[(size_t)primitive], (GLint)vertexOffset, (GLsizei)vertexCount));
+        GLCALL(GLLegacy.DrawArrays(PrimitiveTable[(size_t)primitive], (GLint)vertexOffset, (GLsizei)vertexCount));
     }
 
     void Renderer::DrawVerticesInstanced(RenderPrimitive primitive, size_t vertexCount, size_t vertexOffset, size_t instanceCount, size_t baseInstance)
@@ -133,61 +144,72 @@ namespace MxEngine
         ));
     }
 
-    void Renderer::DrawIndices(RenderPrimitive primitive, size_t indexCount, size_t indexOffset)
+    void Renderer::DrawIndices(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, IndexFormat format)
     {
-        GLCALL(glDrawElements(
+        GLCALL(GLLegacy.DrawElements(
             PrimitiveTable[(size_t)primitive],
             indexCount,
-            GetGLType<IndexBuffer::IndexType>(),
-            (const void*)(indexOffset * sizeof(IndexBuffer::IndexType))
+            IndexFormatTable[(size_t)format],
+            (const void*)(indexOffset * IndexBuffer::GetIndexSize(format))
         ));
     }
 
-    void Renderer::DrawIndicesInstanced(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t instanceCount, size_t baseInstance)
+    void Renderer::DrawIndicesInstanced(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t instanceCount, size_t baseInstance, IndexFormat format)
     {
         GLCALL(glDrawElementsInstancedBaseInstance(
             PrimitiveTable[(size_t)primitive], 
             indexCount, 
-            GetGLType<IndexBuffer::IndexType>(), 
-            (const void*)(indexOffset * sizeof(IndexBuffer::IndexType)), 
+            IndexFormatTable[(size_t)format], 
+            (const void*)(indexOffset * IndexBuffer::GetIndexSize(format)), 
             instanceCount,
             baseInstance
         ));
     }
 
-    void Renderer::DrawIndicesBaseVertex(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t baseVertex)
+    void Renderer::DrawIndicesBaseVertex(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t baseVertex, IndexFormat format)
     {
         GLCALL(glDrawElementsBaseVertex(
             PrimitiveTable[(size_t)primitive],
             indexCount,
-            GetGLType<IndexBuffer::IndexType>(),
-            (const void*)(indexOffset * sizeof(IndexBuffer::IndexType)),
+            IndexFormatTable[(size_t)format],
+            (const void*)(indexOffset * IndexBuffer::GetIndexSize(format)),
             baseVertex
         ));
     }
 
-    void Renderer::DrawIndicesBaseVertexInstanced(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t baseVertex, size_t instanceCount, size_t baseInstance)
+    void Renderer::DrawIndicesBaseVertexInstanced(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t baseVertex, size_t instanceCount, size_t baseInstance, IndexFormat format)
     {
         GLCALL(glDrawElementsInstancedBaseVertexBaseInstance(
             PrimitiveTable[(size_t)primitive],
             indexCount,
-            GetGLType<IndexBuffer::IndexType>(),
-            (const void*)(indexOffset * sizeof(IndexBuffer::IndexType)),
+            IndexFormatTable[(size_t)format],
+            (const void*)(indexOffset * IndexBuffer::GetIndexSize(format)),
             instanceCount,
             baseVertex,
             baseInstance
         ));
     }
 
+    void Renderer::DrawIndicesIndirect(RenderPrimitive primitive, size_t commandOffset, size_t commandCount, IndexFormat format)
+    {
+        GLCALL(glMultiDrawElementsIndirect(
+            PrimitiveTable[(size_t)primitive],
+            IndexFormatTable[(size_t)format],
+            (const void*)(commandOffset * sizeof(IndirectBuffer::CommandType)),
+            (GLsizei)commandCount,
+            0
+        ));
+    }
+
     Renderer& Renderer::UseColorMask(bool r, bool g, bool b, bool a)
     {
-        GLCALL(glColorMask(r, g, b, a));
+        GLCALL(GLLegacy.ColorMask(r, g, b, a));
         return *this;
     }
 
     Renderer& Renderer::UseDepthBufferMask(bool value)
     {
-        GLCALL(glDepthMask(value));
+        GLCALL(GLLegacy.DepthMask(value));
         return *this;
     }
 
@@ -195,12 +217,12 @@ namespace MxEngine
     {
         if (value)
         {
-            GLCALL(glEnable(GL_MULTISAMPLE));
+            GLCALL(GLLegacy.Enable(GL_MULTISAMPLE));
             MXLOG_DEBUG("OpenGL::Renderer", "native multisampling is enabled");
         }
         else
         {
-            GLCALL(glDisable(GL_MULTISAMPLE));
+            GLCALL(GLLegacy.Disable(GL_MULTISAMPLE));
             MXLOG_DEBUG("OpenGL::Renderer", "native multisampling is disabled");
         }
         return *this;
@@ -211,12 +233,12 @@ namespace MxEngine
         depthBufferEnabled = value;
         if (value)
         {
-            GLCALL(glEnable(GL_DEPTH_TEST));
+            GLCALL(GLLegacy.Enable(GL_DEPTH_TEST));
             clearMask |= GL_DEPTH_BUFFER_BIT;
         }
         else
         {
-            GLCALL(glDisable(GL_DEPTH_TEST));
+            GLCALL(GLLegacy.Disable(GL_DEPTH_TEST));
             clearMask &= ~GL_DEPTH_BUFFER_BIT;
         }
         return *this;
@@ -226,11 +248,24 @@ namespace MxEngine
     {
         if (value)
         {
-            GLCALL(glEnable(GL_DEPTH_CLAMP));
+            GLCALL(GLLegacy.Enable(GL_DEPTH_CLAMP));
         }
         else
         {
-            GLCALL(glDisable(GL_DEPTH_CLAMP));
+            GLCALL(GLLegacy.Disable(GL_DEPTH_CLAMP));
+        }
+        return *this;
+    }
+
+    Renderer& Renderer::UseScissorTest(bool value)
+    {
+        if (value)
+        {
+            GLCALL(GLLegacy.Enable(GL_SCISSOR_TEST));
+        }
+        else
+        {
+            GLCALL(GLLegacy.Disable(GL_SCISSOR_TEST));
         }
         return *this;
     }
@@ -239,13 +274,13 @@ namespace MxEngine
     {
         if (value)
         {
-            GLCALL(glClearDepth(0.0f));
+            GLCALL(GLLegacy.ClearDepth(0.0f));
             GLCALL(glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE));
             this->UseDepthFunction(DepthFunction::GREATER_EQUAL);
         }
         else
         {
-            GLCALL(glClearDepth(1.0f));
+            GLCALL(GLLegacy.ClearDepth(1.0f));
             GLCALL(glClipControl(GL_LOWER_LEFT, GL_NEGATIVE_ONE_TO_ONE));
             this->UseDepthFunction(DepthFunction::LESS);
         }
@@ -265,7 +300,7 @@ namespace MxEngine
 
     Renderer& Renderer::UseDepthFunction(DepthFunction function)
     {
-        GLCALL(glDepthFunc(depthFuncTable[(size_t)function]));
+        GLCALL(GLLegacy.DepthFunc(depthFuncTable[(size_t)function]));
         return *this;
     }
 
@@ -274,31 +309,31 @@ namespace MxEngine
         // culling 
         if (value)
         {
-            GLCALL(glEnable(GL_CULL_FACE));
+            GLCALL(GLLegacy.Enable(GL_CULL_FACE));
         }
         else
         {
-            GLCALL(glDisable(GL_CULL_FACE));
+            GLCALL(GLLegacy.Disable(GL_CULL_FACE));
         }
 
         // point order
         if (counterClockWise)
         {
-            GLCALL(glFrontFace(GL_CCW));
+            GLCALL(GLLegacy.FrontFace(GL_CCW));
         }
         else
         {
-            GLCALL(glFrontFace(GL_CW));
+            GLCALL(GLLegacy.FrontFace(GL_CW));
         }
 
         // back / front culling
         if (cullBack)
         {
-            GLCALL(glCullFace(GL_BACK));
+            GLCALL(GLLegacy.CullFace(GL_BACK));
         }
         else
         {
-            GLCALL(glCullFace(GL_FRONT));
+            GLCALL(GLLegacy.CullFace(GL_FRONT));
         }
 
         return *this;
@@ -306,7 +341,7 @@ namespace MxEngine
 
     Renderer& Renderer::UseClearColor(float r, float g, float b, float a)
     {
-        GLCALL(glClearColor(r, g, b, a));
+        GLCALL(GLLegacy.ClearColor(r, g, b, a));
         return *this;
     }
 
@@ -314,25 +349,31 @@ namespace MxEngine
     {
         if (src == BlendFactor::NONE || dist == BlendFactor::NONE)
         {
-            GLCALL(glDisable(GL_BLEND));
+            GLCALL(GLLegacy.Disable(GL_BLEND));
         }
         else
         {
-            GLCALL(glEnable(GL_BLEND));
-            GLCALL(glBlendFunc(BlendTable[(size_t)src], BlendTable[(size_t)dist]));
+            GLCALL(GLLegacy.Enable(GL_BLEND));
+            GLCALL(GLLegacy.BlendFunc(BlendTable[(size_t)src], BlendTable[(size_t)dist]));
         }
         return *this;
     }
 
+    bool IsExtensionSupported(const char* name)
+    {
+        // there is no context to query extensions from, but null graphic api accepts any call
+        return NullGraphicAPI::IsInstalled() || glfwExtensionSupported(name);
+    }
+
     Renderer& Renderer::UseAnisotropicFiltering(float factor)
     {
-        if (!glfwExtensionSupported("GL_EXT_texture_filter_anisotropic"))
+        if (!IsExtensionSupported("GL_EXT_texture_filter_anisotropic"))
         {
             MXLOG_WARNING("OpenGL::Renderer", "anisotropic filtering is not supported on your device");
         }
         else
         {
-            GLCALL(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, factor));
+            GLCALL(GLLegacy.TexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, factor));
             MXLOG_DEBUG("OpenGL::Renderer", "set anisotropic filtering factor to " + ToMxString((int)factor) + "x");
         }
         return *this;
@@ -340,13 +381,13 @@ namespace MxEngine
 
     float Renderer::GetLargestAnisotropicFactor() const
     {
-        if (!glfwExtensionSupported("GL_EXT_texture_filter_anisotropic"))
+        if (!IsExtensionSupported("GL_EXT_texture_filter_anisotropic"))
         {
             MXLOG_WARNING("OpenGL::Renderer", "anisotropic filtering is not supported");
             return 0.0f;
         }
         float factor;
-        GLCALL(glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &factor));
+        GLCALL(GLLegacy.GetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &factor));
         return factor;
     }
 
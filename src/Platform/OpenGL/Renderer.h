@@ -86,11 +86,12 @@ namespace MxEngine
         Renderer();
 
         void DrawVertices(RenderPrimitive primitive, size_t vertexCount, size_t vertexOffset);
-        void DrawIndices(RenderPrimitive primitive, size_t indexCount, size_t indexOffset);
+        void DrawIndices(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, IndexFormat format = IndexFormat::UINT32);
         void DrawVerticesInstanced(RenderPrimitive primitive, size_t vertexCount, size_t vertexOffset, size_t instanceCount, size_t baseInstance);
-        void DrawIndicesInstanced(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t instanceCount, size_t baseInstance);
-        void DrawIndicesBaseVertex(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t baseVertex);
-        void DrawIndicesBaseVertexInstanced(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t baseVertex, size_t instanceCount, size_t baseInstance);
+        void DrawIndicesInstanced(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t instanceCount, size_t baseInstance, IndexFormat format = IndexFormat::UINT32);
+        void DrawIndicesBaseVertex(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t baseVertex, IndexFormat format = IndexFormat::UINT32);
+        void DrawIndicesBaseVertexInstanced(RenderPrimitive primitive, size_t indexCount, size_t indexOffset, size_t baseVertex, size_t instanceCount, size_t baseInstance, IndexFormat format = IndexFormat::UINT32);
+        void DrawIndicesIndirect(RenderPrimitive primitive, size_t commandOffset, size_t commandCount, IndexFormat format = IndexFormat::UINT32);
 
         void SetDefaultVertexAttribute(size_t index, float v) const;
         void SetDefaultVertexAttribute(size_t index, const Vector2& vec) const;
@@ -102,6 +103,7 @@ namespace MxEngine
         void Flush() const;
         void Finish() const;
         void SetViewport(int x, int y, int width, int height) const;
+        void SetScissor(int x, int y, int width, int height) const;
         Renderer& UseClipDistance(size_t count);
         Renderer& UseSeamlessCubeMaps(bool value = true);
         Renderer& UseColorMask(bool r, bool g, bool b, bool a);
@@ -109,6 +111,7 @@ namespace MxEngine
         Renderer& UseSampling(bool value = true);
         Renderer& UseDepthBuffer(bool value = true);
         Renderer& UseDepthClamp(bool value = true);
+        Renderer& UseScissorTest(bool value = true);
         Renderer& UseReversedDepth(bool value = true);
         Renderer& UseDepthFunction(DepthFunction function);
         Renderer& UseCulling(bool value = true, bool counterClockWise = true, bool cullBack = true);
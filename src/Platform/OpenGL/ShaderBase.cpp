@@ -170,9 +170,13 @@ namespace MxEngine
         GLCALL(ShaderId shaderId = glCreateShader((GLenum)type));
 
         ShaderPreprocessor preprocessor(sourceCode);
+        preprocessor.LoadIncludes(path.parent_path());
+
+        // vertex layout is shared by all meshes, so shaders select how to decode attributes at compile time
+        if (GlobalConfig::HasCompressedVertices())
+            preprocessor.EmitPrefixLine("#define MXENGINE_COMPRESSED_VERTICES");
 
         auto modifiedSourceCode = preprocessor
-            .LoadIncludes(path.parent_path())
             .EmitPrefixLine(ShaderBase::GetShaderVersionString())
             .GetResult();
 
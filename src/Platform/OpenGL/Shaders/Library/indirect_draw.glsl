@@ -0,0 +1,26 @@
+struct DrawData
+{
+    mat4 model;
+    mat3 normal;
+    uint materialIndex;
+};
+
+struct MaterialData
+{
+    vec4 baseColor_transparency;
+    vec2 uvMultipliers;
+    float displacement;
+    float emmisive;
+    float roughness;
+    float metallic;
+};
+
+layout(std430, binding = 1) readonly buffer IndirectDrawData
+{
+    DrawData draws[];
+};
+
+layout(std430, binding = 2) readonly buffer IndirectMaterialData
+{
+    MaterialData materials[];
+};
@@ -0,0 +1,14 @@
+mat4 getInstanceModel(mat3x4 modelRows)
+{
+    return transpose(mat4(modelRows[0], modelRows[1], modelRows[2], vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+}
+
+mat3 getInstanceNormalMatrix(mat4 model)
+{
+    // uniform scale does not change normal directions, so inverse can be skipped (same as Transform::GetNormalMatrix)
+    mat3 m = mat3(model);
+    vec3 scale2 = vec3(dot(m[0], m[0]), dot(m[1], m[1]), dot(m[2], m[2]));
+    if (all(lessThan(abs(scale2 - scale2.xxx), vec3(0.0001f * scale2.x))))
+        return m;
+    return transpose(inverse(m));
+}
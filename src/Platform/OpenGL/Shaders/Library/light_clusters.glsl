@@ -0,0 +1,50 @@
+struct ClusteredPointLight
+{
+    vec4 position_radius;
+    vec4 color_ambient;
+};
+
+struct ClusteredSpotLight
+{
+    vec4 position_innerAngle;
+    vec4 direction_outerAngle; // direction is scaled by max distance
+    vec4 color_ambient;
+};
+
+struct LightCluster
+{
+    uint offset;
+    uint pointLightCount;
+    uint spotLightCount;
+    uint padding;
+};
+
+layout(std430, binding = 3) readonly buffer ClusteredPointLightData
+{
+    ClusteredPointLight pointLights[];
+};
+
+layout(std430, binding = 4) readonly buffer ClusteredSpotLightData
+{
+    ClusteredSpotLight spotLights[];
+};
+
+layout(std430, binding = 5) readonly buffer LightClusterData
+{
+    LightCluster clusters[];
+};
+
+layout(std430, binding = 6) readonly buffer LightIndexData
+{
+    uint lightIndices[];
+};
+
+uniform ivec3 clusterCount;
+uniform vec2 clusterSliceParameters; // log(depth) * x + y gives depth slice
+
+uint getClusterIndex(vec2 texcoord, float depth)
+{
+    ivec2 xy = clamp(ivec2(texcoord * vec2(clusterCount.xy)), ivec2(0), clusterCount.xy - ivec2(1));
+    int z = clamp(int(log(max(depth, 0.0001)) * clusterSliceParameters.x + clusterSliceParameters.y), 0, clusterCount.z - 1);
+    return uint((z * clusterCount.y + xy.y) * clusterCount.x + xy.x);
+}
@@ -0,0 +1,16 @@
+float calcPointLightIntensity(float lightDistance, float radius)
+{
+    float attenuation = clamp(1.0f - pow(lightDistance / radius, 4.0f), 0.0, 1.0);
+    float intensity = attenuation * attenuation / (lightDistance * lightDistance + 1.0f);
+    return isnan(lightDistance) || radius < lightDistance ? 0.0f : intensity;
+}
+
+float calcSpotLightIntensity(vec3 lightPath, vec3 direction, float innerAngle, float outerAngle, float maxDistance)
+{
+    float lightDistance = length(lightPath);
+    float fragAngle = dot(normalize(lightPath), -direction);
+    float epsilon = innerAngle - outerAngle;
+    float angleIntensity = pow(clamp((fragAngle - outerAngle) / epsilon, 0.0, 1.0), 2.0);
+    float intensity = angleIntensity * angleIntensity / (lightDistance * lightDistance + 1.0);
+    return intensity * max(1.0 - pow(2.0 * lightDistance / maxDistance, 4.0), 0.0);
+}
@@ -0,0 +1,36 @@
+#if defined(MXENGINE_COMPRESSED_VERTICES)
+#define VERTEX_VECTOR vec2
+#else
+#define VERTEX_VECTOR vec3
+#endif
+
+vec3 decodeOctahedral(vec2 e)
+{
+    vec3 v = vec3(e.xy, 1.0f - abs(e.x) - abs(e.y));
+    if (v.z < 0.0f)
+    {
+        vec2 signs = vec2(e.x >= 0.0f ? 1.0f : -1.0f, e.y >= 0.0f ? 1.0f : -1.0f);
+        v.xy = (1.0f - abs(e.yx)) * signs;
+    }
+    return normalize(v);
+}
+
+vec3 decodeVertexVector(vec3 v)
+{
+    return v;
+}
+
+vec3 decodeVertexVector(vec2 v)
+{
+    return decodeOctahedral(v);
+}
+
+vec3 decodeVertexBitangent(vec3 bitangent, vec3 normal, vec3 tangent)
+{
+    return bitangent;
+}
+
+vec3 decodeVertexBitangent(vec2 bitangentSign, vec3 normal, vec3 tangent)
+{
+    return cross(normal, tangent) * bitangentSign.x;
+}
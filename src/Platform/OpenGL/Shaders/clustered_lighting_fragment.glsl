@@ -0,0 +1,48 @@
+#include "Library/fragment_utils.glsl"
+#include "Library/lighting.glsl"
+#include "Library/local_lights.glsl"
+#include "Library/light_clusters.glsl"
+
+out vec4 OutColor;
+in vec2 TexCoord;
+
+uniform sampler2D albedoTex;
+uniform sampler2D normalTex;
+uniform sampler2D materialTex;
+uniform sampler2D depthTex;
+
+uniform Camera camera;
+
+void main()
+{
+    FragmentInfo fragment = getFragmentInfo(TexCoord, albedoTex, normalTex, materialTex, depthTex, camera.invViewProjMatrix);
+    vec3 viewDirection = normalize(camera.position - fragment.position);
+
+    // for perspective projection clip-space w is equal to view-space depth (see LightClusterBuilder)
+    float depth = (camera.viewProjMatrix * vec4(fragment.position, 1.0)).w;
+    LightCluster cluster = clusters[getClusterIndex(TexCoord, depth)];
+
+    vec3 totalColor = vec3(0.0);
+    uint index = cluster.offset;
+    for (uint i = 0; i < cluster.pointLightCount; i++, index++)
+    {
+        ClusteredPointLight light = pointLights[lightIndices[index]];
+        vec3 lightPath = light.position_radius.xyz - fragment.position;
+        float intensity = calcPointLightIntensity(length(lightPath), light.position_radius.w);
+        if (intensity <= 0.0) continue;
+        totalColor += calculateLighting(fragment, viewDirection, lightPath, intensity * light.color_ambient.rgb, light.color_ambient.a, 1.0);
+    }
+
+    for (uint i = 0; i < cluster.spotLightCount; i++, index++)
+    {
+        ClusteredSpotLight light = spotLights[lightIndices[index]];
+        vec3 lightPath = light.position_innerAngle.xyz - fragment.position;
+        float maxDistance = length(light.direction_outerAngle.xyz);
+        vec3 direction = light.direction_outerAngle.xyz / maxDistance;
+        float intensity = calcSpotLightIntensity(lightPath, direction, light.position_innerAngle.w, light.direction_outerAngle.w, maxDistance);
+        if (intensity <= 0.0) continue;
+        totalColor += calculateLighting(fragment, viewDirection, lightPath, intensity * light.color_ambient.rgb, light.color_ambient.a, 1.0);
+    }
+
+    OutColor = vec4(totalColor, 1.0);
+}
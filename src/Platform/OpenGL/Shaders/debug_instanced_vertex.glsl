@@ -0,0 +1,15 @@
+#include "Library/instancing.glsl"
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in mat3x4 modelRows;
+layout(location = 4) in vec4 color;
+
+uniform mat4 ViewProjMatrix;
+
+out vec4 Color;
+
+void main()
+{
+    gl_Position = ViewProjMatrix * getInstanceModel(modelRows) * position;
+    Color = color;
+}
\ No newline at end of file
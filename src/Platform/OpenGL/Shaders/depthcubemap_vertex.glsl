@@ -1,10 +1,11 @@
 #include "Library/displacement.glsl"
+#include "Library/instancing.glsl"
+#include "Library/vertex_format.glsl"
 
 layout(location = 0)  in vec4 position;
 layout(location = 1)  in vec2 texCoord;
-layout(location = 2)  in vec3 normal;
-layout(location = 5)  in mat4 model;
-layout(location = 9)  in mat3 normalMatrix;
+layout(location = 2)  in VERTEX_VECTOR vertexNormal;
+layout(location = 5)  in mat3x4 modelRows;
 
 uniform float displacement;
 uniform vec2 uvMultipliers;
@@ -16,6 +17,10 @@ out vec2 VertexTexCoord;
 
 void main()
 {
+    mat4 model = getInstanceModel(modelRows);
+    mat3 normalMatrix = getInstanceNormalMatrix(model);
+    vec3 normal = decodeVertexVector(vertexNormal);
+
     VertexTexCoord = texCoord * uvMultipliers;
 
     vec4 modelPos = parentModel * model * position;
@@ -0,0 +1,58 @@
+#include "Library/fragment_utils.glsl"
+#include "Library/indirect_draw.glsl"
+layout(early_fragment_tests) in;
+
+in VSout
+{
+    vec2 TexCoord;
+    vec3 Normal;
+    vec3 RenderColor;
+    mat3 TBN;
+    vec3 Position;
+    flat uint MaterialIndex;
+} fsin;
+
+layout(location = 0) out vec4 OutAlbedo;
+layout(location = 1) out vec4 OutNormal;
+layout(location = 2) out vec4 OutMaterial;
+
+uniform sampler2D map_albedo;
+uniform sampler2D map_roughness;
+uniform sampler2D map_metallic;
+uniform sampler2D map_emmisive;
+uniform sampler2D map_normal;
+uniform sampler2D map_occlusion;
+uniform float gamma;
+
+vec3 calcNormal(vec2 texcoord, mat3 TBN, sampler2D normalMap)
+{
+    vec3 normal;
+    normal.xy = texture(normalMap, texcoord).rg;
+    normal.xy = 2.0 * normal.xy - 1.0;
+    normal.z = sqrt(1.0 - dot(normal.xy, normal.xy));
+    return TBN * normal;
+}
+
+void main()
+{
+    MaterialData material = materials[fsin.MaterialIndex];
+    vec2 TexCoord = material.uvMultipliers * fsin.TexCoord;
+
+    vec3 normal = calcNormal(TexCoord, fsin.TBN, map_normal);
+
+    vec3 albedoTex = texture(map_albedo, TexCoord).rgb;
+    float occlusion = texture(map_occlusion, TexCoord).r;
+    float emmisiveTex = texture(map_emmisive, TexCoord).r;
+    float metallicTex = texture(map_metallic, TexCoord).r;
+    float roughnessTex = texture(map_roughness, TexCoord).r;
+
+    float emmisive = material.emmisive * emmisiveTex;
+    float roughness = material.roughness * roughnessTex;
+    float metallic = material.metallic * metallicTex;
+
+    vec3 albedo = pow(fsin.RenderColor * albedoTex, vec3(gamma));
+
+    OutAlbedo = vec4(fsin.RenderColor * albedo, emmisive / (emmisive + 1.0f));
+    OutNormal = vec4(0.5f * normal + 0.5f, 1.0f);
+    OutMaterial = vec4(occlusion, roughness, metallic, 1.0f);
+}
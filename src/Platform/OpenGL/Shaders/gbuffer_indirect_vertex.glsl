@@ -0,0 +1,59 @@
+#include "Library/common_utils.glsl"
+#include "Library/displacement.glsl"
+#include "Library/instancing.glsl"
+#include "Library/vertex_format.glsl"
+#include "Library/indirect_draw.glsl"
+
+layout(location = 0)  in vec4 position;
+layout(location = 1)  in vec2 texCoord;
+layout(location = 2)  in VERTEX_VECTOR vertexNormal;
+layout(location = 3)  in VERTEX_VECTOR vertexTangent;
+layout(location = 4)  in VERTEX_VECTOR vertexBitangent;
+layout(location = 5)  in mat3x4 modelRows;
+layout(location = 8)  in vec3 renderColor;
+
+uniform Camera camera;
+uniform int drawOffset;
+uniform sampler2D map_height;
+
+out VSout
+{
+    vec2 TexCoord;
+    vec3 Normal;
+    vec3 RenderColor;
+    mat3 TBN;
+    vec3 Position;
+    flat uint MaterialIndex;
+} vsout;
+
+void main()
+{
+    mat4 model = getInstanceModel(modelRows);
+    mat3 normalMatrix = getInstanceNormalMatrix(model);
+    vec3 normal = decodeVertexVector(vertexNormal);
+    vec3 tangent = decodeVertexVector(vertexTangent);
+    vec3 bitangent = decodeVertexBitangent(vertexBitangent, normal, tangent);
+
+    DrawData draw = draws[drawOffset + gl_DrawID];
+    MaterialData material = materials[draw.materialIndex];
+
+    vec4 modelPos = draw.model * model * position;
+    mat3 normalSpaceMatrix = draw.normal * normalMatrix;
+
+    vec3 T = normalize(vec3(normalSpaceMatrix * tangent));
+    vec3 B = normalize(vec3(normalSpaceMatrix * bitangent));
+    vec3 N = normalize(vec3(normalSpaceMatrix * normal));
+
+    vsout.TBN = mat3(T, B, N);
+    vsout.Normal = N;
+    vsout.RenderColor = material.baseColor_transparency.rgb * renderColor;
+    vsout.MaterialIndex = draw.materialIndex;
+
+    float displacementFactor = getDisplacement(material.uvMultipliers * texCoord, material.uvMultipliers, map_height, material.displacement);
+
+    modelPos.xyz += vsout.Normal * displacementFactor;
+    vsout.Position = modelPos.xyz;
+    vsout.TexCoord = texCoord;
+
+    gl_Position = camera.viewProjMatrix * modelPos;
+}
@@ -1,15 +1,16 @@
 #include "Library/common_utils.glsl"
 #include "Library/displacement.glsl"
+#include "Library/instancing.glsl"
+#include "Library/vertex_format.glsl"
 
 
 layout(location = 0)  in vec4 position;
 layout(location = 1)  in vec2 texCoord;
-layout(location = 2)  in vec3 normal;
-layout(location = 3)  in vec3 tangent;
-layout(location = 4)  in vec3 bitangent;
-layout(location = 5)  in mat4 model;
-layout(location = 9)  in mat3 normalMatrix;
-layout(location = 12) in vec3 renderColor;
+layout(location = 2)  in VERTEX_VECTOR vertexNormal;
+layout(location = 3)  in VERTEX_VECTOR vertexTangent;
+layout(location = 4)  in VERTEX_VECTOR vertexBitangent;
+layout(location = 5)  in mat3x4 modelRows;
+layout(location = 8)  in vec3 renderColor;
 
 uniform Camera camera;
 uniform float displacement;
@@ -30,6 +31,12 @@ out VSout
 
 void main()
 {
+    mat4 model = getInstanceModel(modelRows);
+    mat3 normalMatrix = getInstanceNormalMatrix(model);
+    vec3 normal = decodeVertexVector(vertexNormal);
+    vec3 tangent = decodeVertexVector(vertexTangent);
+    vec3 bitangent = decodeVertexBitangent(vertexBitangent, normal, tangent);
+
     vec4 modelPos = parentModel * model * position;
     mat3 normalSpaceMatrix = parentNormal * normalMatrix;
 
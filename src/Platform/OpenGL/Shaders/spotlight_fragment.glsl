@@ -1,5 +1,6 @@
 #include "Library/fragment_utils.glsl"
 #include "Library/lighting.glsl"
+#include "Library/local_lights.glsl"
 
 out vec4 OutColor;
 
@@ -30,29 +31,25 @@ struct SpotLight
 
 uniform mat4 worldToLightTransform;
 uniform bool castsShadows;
+uniform vec4 shadowMapLimits;
 uniform sampler2D lightDepthMap;
 uniform Camera camera;
 uniform vec2 viewportSize;
 
-vec3 calcColorUnderSpotLight(FragmentInfo fragment, SpotLight light, vec3 viewDirection, vec3 fragLightSpace, sampler2D map_shadow, bool computeShadow)
+vec3 calcColorUnderSpotLight(FragmentInfo fragment, SpotLight light, vec3 viewDirection, vec3 fragLightSpace, sampler2D map_shadow, vec4 textureLimitsXY, bool computeShadow)
 {
     vec3 lightPath = light.position - fragment.position;
-    float lightDistance = length(lightPath);
 
     float shadowFactor = 1.0;
     if (computeShadow)
     {
-        const vec3 TEXTURE_BIAS = vec3(0.001, 0.001, 0.002);
-        const vec4 textureLimitsXY = vec4(TEXTURE_BIAS.x, 1.0 - TEXTURE_BIAS.x, TEXTURE_BIAS.y, 1.0 - TEXTURE_BIAS.y);
-        float s = calcShadowFactor2D(fragLightSpace, map_shadow, textureLimitsXY, TEXTURE_BIAS.z);
+        // shadow map is a tile of shared atlas, limits are computed on CPU side
+        const float DEPTH_BIAS = 0.002;
+        float s = calcShadowFactor2D(fragLightSpace, map_shadow, textureLimitsXY, DEPTH_BIAS);
         if (s != -1.0) shadowFactor = s;
     }
 
-    float fragAngle = dot(normalize(lightPath), -light.direction);
-    float epsilon = light.innerAngle - light.outerAngle;
-    float angleIntensity = pow(clamp((fragAngle - light.outerAngle) / epsilon, 0.0, 1.0), 2.0);
-    float intensity = angleIntensity * angleIntensity / (lightDistance * lightDistance + 1.0);
-    intensity *= max(1.0 - pow(2.0 * lightDistance / light.maxDistance, 4.0), 0.0);
+    float intensity = calcSpotLightIntensity(lightPath, light.direction, light.innerAngle, light.outerAngle, light.maxDistance);
 
     return calculateLighting(fragment, viewDirection, lightPath, intensity * light.color.rgb, light.color.a, shadowFactor);
 }
@@ -75,7 +72,7 @@ void main()
 
     vec4 fragLightSpace = worldToLightTransform * vec4(fragment.position, 1.0f);
     fragLightSpace.xyz /= fragLightSpace.w;
-    vec3 totalColor = calcColorUnderSpotLight(fragment, light, viewDirection, fragLightSpace.xyz, lightDepthMap, castsShadows);
+    vec3 totalColor = calcColorUnderSpotLight(fragment, light, viewDirection, fragLightSpace.xyz, lightDepthMap, shadowMapLimits, castsShadows);
 
     OutColor = vec4(totalColor, 1.0f);
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "SyncFence.h"
+#include "GLUtilities.h"
+
+namespace MxEngine
+{
+    void SyncFence::FreeFence()
+    {
+        if (this->sync != nullptr)
+        {
+            GLCALL(glDeleteSync((GLsync)this->sync));
+            this->sync = nullptr;
+        }
+    }
+
+    SyncFence::~SyncFence()
+    {
+        this->FreeFence();
+    }
+
+    SyncFence::SyncFence(SyncFence&& other) noexcept
+    {
+        this->sync = other.sync;
+        other.sync = nullptr;
+    }
+
+    SyncFence& SyncFence::operator=(SyncFence&& other) noexcept
+    {
+        this->FreeFence();
+        this->sync = other.sync;
+        other.sync = nullptr;
+        return *this;
+    }
+
+    void SyncFence::Place()
+    {
+        this->FreeFence();
+        GLCALL(this->sync = (void*)glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    }
+
+    bool SyncFence::IsPlaced() const
+    {
+        return this->sync != nullptr;
+    }
+
+    bool SyncFence::Wait()
+    {
+        if (this->sync == nullptr) return false;
+
+        constexpr GLuint64 timeoutNanoseconds = 1000000; // 1 ms
+        bool waited = false;
+        GLenum result = GL_TIMEOUT_EXPIRED;
+        // commands must be flushed on first wait, otherwise fence may never be signaled
+        GLCALL(result = glClientWaitSync((GLsync)this->sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0));
+        while (result == GL_TIMEOUT_EXPIRED)
+        {
+            waited = true;
+            GLCALL(result = glClientWaitSync((GLsync)this->sync, 0, timeoutNanoseconds));
+        }
+
+        this->FreeFence();
+        return waited;
+    }
+}
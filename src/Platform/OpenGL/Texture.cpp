@@ -70,7 +70,7 @@ namespace MxEngine
     {
         if (id != 0)
         {
-            GLCALL(glDeleteTextures(1, &id));
+            GLCALL(GLLegacy.DeleteTextures(1, &id));
             MXLOG_DEBUG("OpenGL::Texture", "deleted texture with id = " + ToMxString(id));
         }
         id = 0;
@@ -79,7 +79,7 @@ namespace MxEngine
 
     Texture::Texture()
     {
-        GLCALL(glGenTextures(1, &id));
+        GLCALL(GLLegacy.GenTextures(1, &id));
         MXLOG_DEBUG("OpenGL::Texture", "created texture with id = " + ToMxString(id));
     }
 
@@ -170,8 +170,8 @@ namespace MxEngine
             break;
         }
 
-        GLCALL(glBindTexture(GL_TEXTURE_2D, id));
-        GLCALL(glTexImage2D(GL_TEXTURE_2D, 0, formatTable[(int)this->format], (GLsizei)width, (GLsizei)height, 0, pixelFormat, pixelType, image.GetRawData()));
+        GLCALL(GLLegacy.BindTexture(GL_TEXTURE_2D, id));
+        GLCALL(GLLegacy.TexImage2D(GL_TEXTURE_2D, 0, formatTable[(int)this->format], (GLsizei)width, (GLsizei)height, 0, pixelFormat, pixelType, image.GetRawData()));
 
         if (image.GetRawData() != nullptr)
         {
@@ -179,8 +179,8 @@ namespace MxEngine
         }
         else
         {
-            GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-            GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+            GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+            GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
         }
     }
 
@@ -221,8 +221,8 @@ namespace MxEngine
             break;
         }
 
-        GLCALL(glBindTexture(GL_TEXTURE_2D, id));
-        GLCALL(glTexImage2D(GL_TEXTURE_2D, 0, formatTable[(int)this->format], (GLsizei)width, (GLsizei)height, 0, dataChannels, type, data));
+        GLCALL(GLLegacy.BindTexture(GL_TEXTURE_2D, id));
+        GLCALL(GLLegacy.TexImage2D(GL_TEXTURE_2D, 0, formatTable[(int)this->format], (GLsizei)width, (GLsizei)height, 0, dataChannels, type, data));
 
         if (data != nullptr)
         {
@@ -230,8 +230,8 @@ namespace MxEngine
         }
         else
         {
-            GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-            GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+            GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+            GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
         }
     }
 
@@ -252,23 +252,34 @@ namespace MxEngine
 
         GLenum type = this->IsFloatingPoint() ? GL_FLOAT : GL_UNSIGNED_BYTE;
 
-        GLCALL(glTexImage2D(GL_TEXTURE_2D, 0, formatTable[(int)this->format], width, height, 0, GL_DEPTH_COMPONENT, type, nullptr));
+        GLCALL(GLLegacy.TexImage2D(GL_TEXTURE_2D, 0, formatTable[(int)this->format], width, height, 0, GL_DEPTH_COMPONENT, type, nullptr));
         this->SetBorderColor(MakeVector4(1.0f));
 
-        GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-        GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    }
+
+    void Texture::CopyTo(Texture& target, size_t targetX, size_t targetY) const
+    {
+        MX_ASSERT(targetX + this->width <= target.width && targetY + this->height <= target.height);
+        MX_ASSERT(this->textureType == target.textureType && this->format == target.format);
+        GLCALL(glCopyImageSubData(
+            this->id, this->textureType, 0, 0, 0, 0,
+            target.id, target.textureType, 0, (GLint)targetX, (GLint)targetY, 0,
+            (GLsizei)this->width, (GLsizei)this->height, 1
+        ));
     }
 
     void Texture::SetMaxLOD(size_t lod)
     {
         this->Bind(0);
-        GLCALL(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_LOD, (float)lod));
+        GLCALL(GLLegacy.TexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_LOD, (float)lod));
     }
 
     void Texture::SetMinLOD(size_t lod)
     {
         this->Bind(0);
-        GLCALL(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_LOD, (float)lod));
+        GLCALL(GLLegacy.TexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_LOD, (float)lod));
     }
 
     size_t Texture::GetMaxTextureLOD() const
@@ -307,16 +318,16 @@ namespace MxEngine
         }
 
         this->Bind(0);
-        GLCALL(glPixelStorei(GL_PACK_ALIGNMENT, 1));
-        GLCALL(glGetTexImage(this->textureType, 0, readFormat, type, (void*)result));
+        GLCALL(GLLegacy.PixelStorei(GL_PACK_ALIGNMENT, 1));
+        GLCALL(GLLegacy.GetTexImage(this->textureType, 0, readFormat, type, (void*)result));
         return Image(result, this->width, this->height, this->GetChannelCount(), this->IsFloatingPoint());
     }
 
     void Texture::GenerateMipmaps()
     {
         this->Bind(0);
-        GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
-        GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+        GLCALL(GLLegacy.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
         GLCALL(glGenerateMipmap(GL_TEXTURE_2D));
     }
 
@@ -324,14 +335,14 @@ namespace MxEngine
     {
         this->Bind(0);
         auto normalized = Clamp(color, MakeVector4(0.0f), MakeVector4(1.0f));
-        GLCALL(glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, &normalized[0]));
+        GLCALL(GLLegacy.TexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, &normalized[0]));
     }
 
     Vector4 Texture::GetBorderColor() const
     {
         Vector4 result = MakeVector4(0.0f);
         this->Bind(0);
-        GLCALL(glGetTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, &result[0]));
+        GLCALL(GLLegacy.GetTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, &result[0]));
         return result;
     }
     
@@ -449,7 +460,7 @@ namespace MxEngine
     {
         GLint result = 0;
         this->Bind(0);
-        GLCALL(glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, &result));
+        GLCALL(GLLegacy.GetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, &result));
         for (size_t i = 0; i < std::size(wrapTable); i++)
         {
             if (wrapTable[i] == result)
@@ -461,20 +472,20 @@ namespace MxEngine
     void Texture::SetWrapType(TextureWrap wrapType)
     {
         this->Bind(0);
-        GLCALL(glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, &wrapTable[(int)wrapType]));
-        GLCALL(glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, &wrapTable[(int)wrapType]));
+        GLCALL(GLLegacy.TexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, &wrapTable[(int)wrapType]));
+        GLCALL(GLLegacy.TexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, &wrapTable[(int)wrapType]));
     }
 
     void Texture::Bind() const
     {
         GLCALL(glActiveTexture(GL_TEXTURE0 + this->activeId));
-        GLCALL(glBindTexture(this->textureType, id));
+        GLCALL(GLLegacy.BindTexture(this->textureType, id));
     }
 
     void Texture::Unbind() const
     {
         GLCALL(glActiveTexture(GL_TEXTURE0 + this->activeId));
-        GLCALL(glBindTexture(this->textureType, 0));
+        GLCALL(GLLegacy.BindTexture(this->textureType, 0));
     }
 
     Texture::TextureBindId Texture::GetBoundId() const
@@ -111,6 +111,7 @@ namespace MxEngine
         void Load(RawDataPointer data, int width, int height, int channels, bool isFloating, TextureFormat format = TextureFormat::RGB);
         void Load(const Image& image, TextureFormat format = TextureFormat::RGB);
         void LoadDepth(int width, int height, TextureFormat format = TextureFormat::DEPTH);
+        void CopyTo(Texture& target, size_t targetX = 0, size_t targetY = 0) const;
         void SetMaxLOD(size_t lod);
         void SetMinLOD(size_t lod);
         size_t GetMaxTextureLOD() const;
@@ -105,7 +105,7 @@ namespace MxEngine
             {
                 // TODO: handle integer case with glVertexAttribIPointer
                 GLCALL(glEnableVertexAttribArray(this->attributeIndex));
-                GLCALL(glVertexAttribPointer(this->attributeIndex, element.components, (GLenum)element.type, GL_FALSE, stride, (void*)offset));
+                GLCALL(glVertexAttribPointer(this->attributeIndex, element.components, (GLenum)element.type, element.normalized ? GL_TRUE : GL_FALSE, stride, (void*)offset));
                 if (inputRate == VertexAttributeInputRate::PER_INSTANCE)
                 {
                     GLCALL(glVertexAttribDivisor(this->attributeIndex, 1));
@@ -80,6 +80,24 @@ namespace MxEngine
         return { GL_INT, 4, 1, sizeof(VectorInt4) };
     }
 
+    template<>
+    VertexAttribute VertexAttribute::Entry<VectorHalf2>()
+    {
+        return { GL_HALF_FLOAT, 2, 1, sizeof(VectorHalf2) };
+    }
+
+    template<>
+    VertexAttribute VertexAttribute::Entry<VectorShort2>()
+    {
+        return { GL_SHORT, 2, 1, sizeof(VectorShort2) };
+    }
+
+    template<>
+    VertexAttribute VertexAttribute::Entry<VectorByte4>()
+    {
+        return { GL_UNSIGNED_BYTE, 4, 1, sizeof(VectorByte4) };
+    }
+
     template<>
     VertexAttribute VertexAttribute::Entry<Matrix2x2>()
     {
@@ -92,6 +110,12 @@ namespace MxEngine
         return { GL_FLOAT, 3, 3, sizeof(Matrix3x3) };
     }
 
+    template<>
+    VertexAttribute VertexAttribute::Entry<Matrix3x4>()
+    {
+        return { GL_FLOAT, 4, 3, sizeof(Matrix3x4) };
+    }
+
     template<>
     VertexAttribute VertexAttribute::Entry<Matrix4x4>()
     {
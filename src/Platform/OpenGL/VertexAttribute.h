@@ -37,8 +37,18 @@ namespace MxEngine
         uint16_t components;
         uint16_t entries;
         size_t byteSize;
+        // integer components are mapped to [0, 1] or [-1, 1] range when read as floats in shader
+        bool normalized = false;
 
         template<typename T>
         static VertexAttribute Entry();
+
+        template<typename T>
+        static VertexAttribute NormalizedEntry()
+        {
+            auto entry = Entry<T>();
+            entry.normalized = true;
+            return entry;
+        }
     };
 }
\ No newline at end of file
@@ -81,6 +81,9 @@ namespace MxEngine
         this->mousePressed = other.mousePressed;
         this->mouseReleased = other.mouseReleased;
         this->cursorMode = other.cursorMode;
+        this->doubleBuffer = other.doubleBuffer;
+        this->headless = other.headless;
+        this->hasGraphicContext = other.hasGraphicContext;
         this->windowPosition = other.windowPosition;
 
         other.width = 0;
@@ -130,6 +133,11 @@ namespace MxEngine
         return this->window != nullptr;
     }
 
+    bool Window::IsHeadless() const
+    {
+        return this->headless;
+    }
+
     bool Window::IsOpen() const
     {
         if (this->window == nullptr)
@@ -152,7 +160,8 @@ namespace MxEngine
 
         glfwPollEvents();
 
-        if (this->doubleBuffer)
+        // offscreen context may have no surface to present
+        if (this->doubleBuffer && !this->headless)
             glfwSwapBuffers(this->window);
     }
 
@@ -296,6 +305,12 @@ namespace MxEngine
             MAKE_SCOPE_PROFILER("Window::Create");
             MAKE_SCOPE_TIMER("MxEngine::Window", "Window::Create");
             this->window = glfwCreateWindow(width, height, "", nullptr, nullptr);
+            if (this->window == nullptr && this->headless && this->hasGraphicContext)
+            {
+                MXLOG_WARNING("OpenGL::Window", "EGL offscreen context was not created, falling back to OSMesa");
+                glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+                this->window = glfwCreateWindow(width, height, "", nullptr, nullptr);
+            }
             if (this->window == nullptr)
             {
                 MXLOG_FATAL("OpenGL::InitGLFW", "glfw window was not created");
@@ -303,7 +318,8 @@ namespace MxEngine
             }
             // window events
             SwitchContext();
-            glfwSwapInterval(0);
+            if (!this->headless)
+                glfwSwapInterval(0);
             glfwSetWindowUserPointer(this->window, this);
             glfwSetKeyCallback(this->window, [](GLFWwindow* w, int key, int scancode, int action, int mods)
                 {
@@ -318,7 +334,7 @@ namespace MxEngine
                 });
             glfwSetWindowSizeCallback(window, [](GLFWwindow* w, int width, int height)
                 {
-                    glViewport(0, 0, width, height);
+                    GLLegacy.Viewport(0, 0, width, height);
                 });
             glfwSetMouseButtonCallback(window, [](GLFWwindow* w, int button, int action, int mods)
                 {
@@ -344,7 +360,8 @@ namespace MxEngine
 
     Window& Window::SwitchContext()
     {
-        glfwMakeContextCurrent(this->window);
+        if (this->hasGraphicContext)
+            glfwMakeContextCurrent(this->window);
         return *this;
     }
 
@@ -386,6 +403,26 @@ namespace MxEngine
         return *this;
     }
 
+    Window& Window::UseHeadlessMode(bool value)
+    {
+        // context is created offscreen (EGL surfaceless, or OSMesa as fallback) and never presented
+        // note that GraphicModule must also be switched to headless mode before, so glfw does not require display server
+        this->headless = value;
+        glfwWindowHint(GLFW_VISIBLE, !value);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, value ? GLFW_EGL_CONTEXT_API : GLFW_NATIVE_CONTEXT_API);
+        MXLOG_DEBUG("OpenGL::Window", "headless mode was set to: " + (MxString)BOOL_STRING(value));
+        return *this;
+    }
+
+    Window& Window::UseGraphicContext(bool value)
+    {
+        // window without context is used with null graphic api, which never calls into driver
+        this->hasGraphicContext = value;
+        glfwWindowHint(GLFW_CLIENT_API, value ? GLFW_OPENGL_API : GLFW_NO_API);
+        MXLOG_DEBUG("OpenGL::Window", "graphic context was set to: " + (MxString)BOOL_STRING(value));
+        return *this;
+    }
+
     std::array<int, 3> CursorType =
     {
         GLFW_CURSOR_NORMAL,
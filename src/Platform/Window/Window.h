@@ -56,6 +56,8 @@ namespace MxEngine
         bool anyKeyEvent = false;
         bool anyMouseEvent = false;
         bool doubleBuffer = false;
+        bool headless = false;
+        bool hasGraphicContext = true;
         Vector2 windowPosition{ 0.0f, 0.0f };
 
         void Destroy();
@@ -90,12 +92,15 @@ namespace MxEngine
         WindowHandle GetNativeHandle();
         EventDispatcherImpl<EventBase>& GetEventDispatcher();
         bool IsCreated() const;
+        bool IsHeadless() const;
         Window& Create();
         Window& Close();
         Window& SwitchContext();
         Window& UseTime(float time = 0.0f);
         Window& UseDebugging(bool value = true);
         Window& UseDoubleBuffering(bool value = true);
+        Window& UseHeadlessMode(bool value = true);
+        Window& UseGraphicContext(bool value = true);
         Window& UseCursorMode(CursorMode cursor);
         Window& UseCursorPosition(const Vector2& pos);
         Window& UseTitle(const MxString& title);
@@ -129,6 +129,26 @@ namespace MxEngine
             if (ImGui::Checkbox("overlay debug", &drawOverlay))
                 Rendering::SetDebugOverlay(drawOverlay);
 
+            auto cacheShadows = Rendering::IsShadowMapCachingEnabled();
+            if (ImGui::Checkbox("cache shadow maps", &cacheShadows))
+                Rendering::SetShadowMapCaching(cacheShadows);
+
+            auto splitStaticCasters = Rendering::IsStaticShadowCasterSplit();
+            if (ImGui::Checkbox("static shadow layer", &splitStaticCasters))
+                Rendering::SetStaticShadowCasterSplit(splitStaticCasters);
+
+            auto clusteredLighting = Rendering::IsClusteredLightingEnabled();
+            if (ImGui::Checkbox("clustered lighting", &clusteredLighting))
+                Rendering::SetClusteredLighting(clusteredLighting);
+
+            auto occlusionCulling = Rendering::IsOcclusionCullingEnabled();
+            if (ImGui::Checkbox("occlusion culling", &occlusionCulling))
+                Rendering::SetOcclusionCulling(occlusionCulling);
+
+            auto lodPixelError = Rendering::GetLODPixelError();
+            if (ImGui::DragFloat("lod pixel error", &lodPixelError, 0.1f, 0.0f, 100.0f))
+                Rendering::SetLODPixelError(lodPixelError);
+
             ImGui::TreePop();
         }
         if (ImGui::TreeNode("Logger"))
@@ -30,6 +30,8 @@
 #include "Utilities/ImGui/ImGuiBase.h"
 #include "Core/Application/Event.h"
 #include "Core/Events/FpsUpdateEvent.h"
+#include "Platform/GPUDebug/GPUTimer.h"
+#include "Utilities/FileSystem/File.h"
 
 namespace MxEngine::GUI
 {
@@ -47,5 +49,47 @@ namespace MxEngine::GUI
 
         ImGui::PlotLines("", fpsData.data(), (int)fpsData.size(), 0, name,
             FLT_MAX, FLT_MAX, { ImGui::GetWindowWidth() - 15.0f, (float)ProfilerGraphRecordSize + 15.0f });
+
+        // GPU timings are read back with a few frames of latency, so graph is updated only when new frame is resolved
+        static MxVector<float> gpuTimeData(ProfilerGraphRecordSize);
+        static size_t lastResolvedFrame = 0;
+        auto& gpuTimer = GPUTimer::GetSession();
+        const auto& timings = gpuTimer.GetPassTimings();
+        if (gpuTimer.GetResolvedFrameIndex() != lastResolvedFrame)
+        {
+            float frameTime = 0.0f;
+            for (const auto& timing : timings)
+            {
+                if (timing.Depth == 0) frameTime += timing.Milliseconds;
+            }
+            gpuTimeData.push_back(frameTime);
+            gpuTimeData.erase(gpuTimeData.begin());
+            lastResolvedFrame = gpuTimer.GetResolvedFrameIndex();
+        }
+
+        if (ImGui::TreeNode("gpu passes"))
+        {
+            ImGui::PlotLines("", gpuTimeData.data(), (int)gpuTimeData.size(), 0, "gpu frame time (ms)",
+                0.0f, FLT_MAX, { ImGui::GetWindowWidth() - 15.0f, (float)ProfilerGraphRecordSize + 15.0f });
+
+            if (!gpuTimer.IsSupported())
+                ImGui::Text("timestamp queries are not supported by graphic driver");
+
+            for (const auto& timing : timings)
+            {
+                ImGui::Text("%*s%s: %.3f ms (%d calls)", int(timing.Depth * 2), "", timing.Name, timing.Milliseconds, int(timing.CallCount));
+            }
+
+            bool isEnabled = gpuTimer.IsEnabled();
+            if (ImGui::Checkbox("enable gpu timer", &isEnabled))
+                gpuTimer.SetEnabled(isEnabled);
+            ImGui::SameLine();
+            if (ImGui::Button("export json"))
+            {
+                File file("gpu_pass_timings.json", File::WRITE);
+                gpuTimer.ExportToJson(file);
+            }
+            ImGui::TreePop();
+        }
     }
 }
\ No newline at end of file
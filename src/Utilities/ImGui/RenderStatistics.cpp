@@ -29,16 +29,54 @@
 #include "ImGuiBase.h"
 #include "RenderStatistics.h"
 #include "Core/Application/Rendering.h"
+#include "Core/Resources/BufferAllocator.h"
+#include "Utilities/FileSystem/File.h"
 
 namespace MxEngine::GUI
 {
+    void DrawBufferAllocatorStatistics(const char* name, const BufferAllocatorStatistics& statistics)
+    {
+        if (!ImGui::TreeNode(name)) return;
+
+        ImGui::Text("capacity: %d", int(statistics.Capacity));
+        ImGui::Text("allocated: %d in %d blocks", int(statistics.AllocatedSize), int(statistics.AllocationCount));
+        ImGui::Text("total allocations: %d", int(statistics.TotalAllocations));
+        ImGui::Text("free blocks: %d, largest: %d", int(statistics.FreeBlockCount), int(statistics.LargestFreeBlock));
+        ImGui::Text("fragmentation: %.2f", statistics.GetFragmentation());
+        ImGui::Text("relocations: %d, copied: %d", int(statistics.RelocationCount), int(statistics.RelocatedSize));
+
+        ImGui::TreePop();
+    }
+
     void DrawRenderStatistics(const char* name)
     {
-        auto& statistics = Rendering::GetController().GetRenderStatistics().GetEntries();
+        auto& statistics = Rendering::GetController().GetRenderStatistics();
 
-        for (auto entry = statistics.begin(); entry != statistics.end(); entry++)
+        for (size_t i = 0; i < RenderStatistics::CounterCount; i++)
         {
-            ImGui::Text("%s: %d", entry->first, int(entry->second));
+            auto counter = (RenderCounter)i;
+            ImGui::Text("%s: %d", RenderStatistics::GetCounterName(counter), int(statistics.GetCounter(counter)));
         }
+
+        ImGui::Text("recorded frames: %d", int(statistics.GetHistorySize()));
+        if (ImGui::Button("export csv"))
+        {
+            File file("render_statistics.csv", File::WRITE);
+            statistics.ExportToCSV(file);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("export json"))
+        {
+            File file("render_statistics.json", File::WRITE);
+            statistics.ExportToJson(file);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("clear history"))
+            statistics.ClearHistory();
+
+        DrawBufferAllocatorStatistics("vertex buffer", BufferAllocator::GetVBOStatistics());
+        DrawBufferAllocatorStatistics("index buffer", BufferAllocator::GetIBOStatistics());
+        DrawBufferAllocatorStatistics("instance buffer", BufferAllocator::GetInstanceVBOStatistics());
+        DrawBufferAllocatorStatistics("storage buffer", BufferAllocator::GetSSBOStatistics());
     }
 }
\ No newline at end of file
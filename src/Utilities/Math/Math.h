@@ -47,6 +47,15 @@ namespace MxEngine
     using VectorInt3 = glm::vec<3, int>;
     using VectorInt4 = glm::vec<4, int>;
 
+    using VectorByte4 = glm::vec<4, uint8_t>;
+    using VectorShort2 = glm::vec<2, int16_t>;
+
+    // pair of 16-bit floats. Used only as storage format, see PackHalf() and UnpackHalf()
+    struct VectorHalf2
+    {
+        uint16_t x = 0, y = 0;
+    };
+
     using Matrix2x2 = glm::mat2x2;
     using Matrix2x3 = glm::mat2x3;
     using Matrix3x3 = glm::mat3x3;
@@ -227,6 +236,26 @@ namespace MxEngine
         return glm::slerp(q1, q2, a);
     }
 
+    inline uint16_t PackHalf(float value)
+    {
+        return glm::packHalf1x16(value);
+    }
+
+    inline float UnpackHalf(uint16_t value)
+    {
+        return glm::unpackHalf1x16(value);
+    }
+
+    inline int16_t PackSnorm16(float value)
+    {
+        return (int16_t)glm::packSnorm1x16(value);
+    }
+
+    inline float UnpackSnorm16(int16_t value)
+    {
+        return glm::unpackSnorm1x16((uint16_t)value);
+    }
+
     template<typename Matrix>
     inline Matrix Transpose(const Matrix& mat)
     {
@@ -680,6 +709,44 @@ namespace MxEngine
         return Normalize(Cross(deltaPos1, deltaPos2));
     }
 
+    /*!
+    maps unit vector onto octahedron unfolded into square
+    \param v vector to encode, is not required to be normalized
+    \returns 2d vector with components in range [-1, 1]
+    */
+    inline Vector2 EncodeOctahedral(const Vector3& v)
+    {
+        float sum = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+        if (sum == 0.0f) return MakeVector2(0.0f);
+
+        Vector2 result = MakeVector2(v.x / sum, v.y / sum);
+        if (v.z < 0.0f)
+        {
+            // lower half of octahedron is folded over diagonals
+            result = MakeVector2(
+                (1.0f - std::abs(result.y)) * (result.x >= 0.0f ? 1.0f : -1.0f),
+                (1.0f - std::abs(result.x)) * (result.y >= 0.0f ? 1.0f : -1.0f)
+            );
+        }
+        return result;
+    }
+
+    /*!
+    restores vector encoded by EncodeOctahedral()
+    \param e 2d vector with components in range [-1, 1]
+    \returns normalized 3d vector
+    */
+    inline Vector3 DecodeOctahedral(const Vector2& e)
+    {
+        Vector3 v = MakeVector3(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+        if (v.z < 0.0f)
+        {
+            v.x = (1.0f - std::abs(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f);
+            v.y = (1.0f - std::abs(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f);
+        }
+        return Normalize(v);
+    }
+
     /*!
     creates rotation matrix from rottion angles applied as one-by-one
     \param xRot first  rotation applied around x-axis
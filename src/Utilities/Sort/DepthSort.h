@@ -0,0 +1,148 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "RadixSort.h"
+
+namespace MxEngine
+{
+    // maps float to unsigned integer with the same ordering, so floats can be sorted by integer radix sort
+    inline uint32_t ToSortableKey(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        // negative floats have all bits inverted, positive ones only have their sign bit set
+        uint32_t mask = uint32_t(-int32_t(bits >> 31)) | 0x80000000u;
+        return bits ^ mask;
+    }
+
+    /*!
+    sorts elements by float depth from back to front. Order of previous sort is used as initial guess, so if depths changed only
+    slightly since last call, bounded insertion sort finishes the job in almost linear time. Otherwise 32-bit radix sort is used.
+    sorter must be kept between frames to exploit coherence, and each sorted sequence should have its own sorter
+    */
+    class DepthSorter
+    {
+    public:
+        struct Entry
+        {
+            uint32_t Key;
+            uint32_t Index;
+        };
+    private:
+        MxVector<Entry> entries;
+        MxVector<Entry> scratch;
+        MxVector<uint32_t> keys;
+        MxVector<uint32_t> previousOrder;
+        bool isLastSortIncremental = false;
+
+        // returns false if sort needs more than maxMoves element moves. Entries are left as valid permutation in that case
+        bool TryInsertionSort(size_t maxMoves)
+        {
+            // cheap estimate of disorder. Each descent needs at least one move, so hopeless cases are rejected early
+            size_t descentCount = 0;
+            for (size_t i = 1; i < this->entries.size(); i++)
+                descentCount += this->entries[i - 1].Key > this->entries[i].Key;
+            if (descentCount > maxMoves / 4) return false;
+
+            for (size_t i = 1; i < this->entries.size(); i++)
+            {
+                Entry current = this->entries[i];
+                size_t j = i;
+                while (j > 0 && this->entries[j - 1].Key > current.Key)
+                {
+                    if (maxMoves == 0)
+                    {
+                        this->entries[j] = current;
+                        return false;
+                    }
+                    this->entries[j] = this->entries[j - 1];
+                    j--, maxMoves--;
+                }
+                this->entries[j] = current;
+            }
+            return true;
+        }
+    public:
+        /*!
+        computes back to front order of elements
+        \param count    number of elements in sorted sequence
+        \param getDepth functor with signature float(size_t index), returning depth of element
+        \returns entries in sorted order, each holding index of element in source sequence
+        */
+        template<typename DepthFunc>
+        const MxVector<Entry>& SortBackToFront(size_t count, DepthFunc&& getDepth)
+        {
+            // keys are inverted, so elements with largest depth go first
+            this->keys.resize(count);
+            for (size_t i = 0; i < count; i++)
+                this->keys[i] = ~ToSortableKey(getDepth(i));
+
+            bool hasPreviousOrder = this->previousOrder.size() == count;
+            this->entries.resize(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                uint32_t index = hasPreviousOrder ? this->previousOrder[i] : (uint32_t)i;
+                this->entries[i] = Entry{ this->keys[index], index };
+            }
+
+            this->isLastSortIncremental = hasPreviousOrder && this->TryInsertionSort(count);
+            if (!this->isLastSortIncremental)
+                RadixSort(this->entries, this->scratch, [](const Entry& entry) { return entry.Key; });
+
+            this->previousOrder.resize(count);
+            for (size_t i = 0; i < count; i++)
+                this->previousOrder[i] = this->entries[i].Index;
+
+            return this->entries;
+        }
+
+        /*!
+        reorders elements from back to front
+        \param values   elements to sort. Sorted in-place
+        \param scratch  temporary storage, swapped with values. Can be reused between calls to avoid allocations
+        \param getDepth functor with signature float(const T&), returning depth of element
+        */
+        template<typename T, typename DepthFunc>
+        void SortBackToFront(MxVector<T>& values, MxVector<T>& scratch, DepthFunc&& getDepth)
+        {
+            const auto& order = this->SortBackToFront(values.size(), [&values, &getDepth](size_t index) { return getDepth(values[index]); });
+
+            scratch.resize(values.size());
+            for (size_t i = 0; i < order.size(); i++)
+                scratch[i] = values[order[i].Index];
+            std::swap(values, scratch);
+        }
+
+        bool IsLastSortIncremental() const
+        {
+            return this->isLastSortIncremental;
+        }
+    };
+}
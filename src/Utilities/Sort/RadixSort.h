@@ -0,0 +1,111 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Utilities/STL/MxVector.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace MxEngine
+{
+    /*!
+    stable LSD radix sort over unsigned integer keys. Keys are extracted with user-provided functor and processed 8 bits per pass.
+    all histograms are gathered in a single read of the input, and passes in which all keys share the same digit are skipped,
+    so sorting keys which differ only in low bits costs one or two passes instead of sizeof(Key)
+    short sequences are sorted with std::stable_sort, as fixed cost of histograms dominates there (see benchmarks/Utilities/SortBenchmark.cpp)
+    \param values  elements to sort. Sorted in-place
+    \param scratch temporary storage, resized to values.size(). Can be reused between calls to avoid allocations
+    \param getKey  functor which returns unsigned integral key for an element
+    */
+    template<typename T, typename KeyFunc>
+    void RadixSort(MxVector<T>& values, MxVector<T>& scratch, KeyFunc&& getKey)
+    {
+        using Key = std::decay_t<decltype(getKey(std::declval<const T&>()))>;
+        static_assert(std::is_unsigned_v<Key>, "radix sort requires unsigned integral keys");
+        static_assert(std::is_trivially_copyable_v<T>, "radix sort requires trivially copyable elements");
+
+        constexpr size_t DigitBits = 8;
+        constexpr size_t BucketCount = 1 << DigitBits;
+        constexpr size_t PassCount = sizeof(Key);
+        constexpr size_t MinRadixSortCount = 1024;
+
+        const size_t count = values.size();
+        if (count < 2) return;
+        if (count < MinRadixSortCount)
+        {
+            std::stable_sort(values.begin(), values.end(), [&getKey](const T& v1, const T& v2) { return getKey(v1) < getKey(v2); });
+            return;
+        }
+
+        size_t histograms[PassCount][BucketCount];
+        std::memset(histograms, 0, sizeof(histograms));
+
+        for (size_t i = 0; i < count; i++)
+        {
+            Key key = getKey(values[i]);
+            for (size_t pass = 0; pass < PassCount; pass++)
+                histograms[pass][(key >> (pass * DigitBits)) & (BucketCount - 1)]++;
+        }
+
+        scratch.resize(count);
+        T* source = values.data();
+        T* destination = scratch.data();
+
+        for (size_t pass = 0; pass < PassCount; pass++)
+        {
+            auto& histogram = histograms[pass];
+            size_t shift = pass * DigitBits;
+
+            // all keys have same digit - order is already correct for this pass
+            Key firstDigit = (getKey(source[0]) >> shift) & (BucketCount - 1);
+            if (histogram[firstDigit] == count) continue;
+
+            size_t offset = 0;
+            for (size_t bucket = 0; bucket < BucketCount; bucket++)
+            {
+                size_t bucketSize = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketSize;
+            }
+
+            for (size_t i = 0; i < count; i++)
+            {
+                size_t digit = (getKey(source[i]) >> shift) & (BucketCount - 1);
+                destination[histogram[digit]++] = source[i];
+            }
+            std::swap(source, destination);
+        }
+
+        if (source != values.data())
+            std::memcpy(values.data(), source, count * sizeof(T));
+    }
+}
@@ -0,0 +1,73 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace MxEngine
+{
+    /*!
+    task thread is a single persistent thread which executes submitted tasks one by one in background
+    unlike worker pool, it is used to overlap long-running work with the calling thread, not to split data-parallel jobs
+    tasks must not use default worker pool, as it can be busy with jobs of the thread which submitted them
+    */
+    class TaskThread
+    {
+        using TaskFunction = std::function<void()>;
+
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable taskAvailable;
+        std::condition_variable taskFinished;
+
+        TaskFunction currentTask;
+        bool isBusy = false;
+        bool isStopping = false;
+
+        void WorkerLoop();
+    public:
+        TaskThread();
+        TaskThread(const TaskThread&) = delete;
+        TaskThread& operator=(const TaskThread&) = delete;
+        ~TaskThread();
+
+        /*!
+        starts task execution in background. If previous task is not finished yet, waits for it first
+        */
+        void Submit(TaskFunction task);
+        /*!
+        waits until submitted task is finished. Does nothing if no task is executing
+        */
+        void Wait();
+        bool IsBusy();
+    };
+}
@@ -0,0 +1,147 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "WorkerPool.h"
+#include "Core/Macro/Macro.h"
+
+#include <limits>
+
+namespace MxEngine
+{
+    // pool which tasks are executed by current thread, used to tell reentrant jobs from jobs of other threads
+    static thread_local const WorkerPool* CurrentTaskPool = nullptr;
+
+    WorkerPool::WorkerPool(size_t workerCount)
+    {
+        // hardware_concurrency() may return 0 if it is not computable, so default worker count wraps around
+        if (workerCount >= std::numeric_limits<unsigned int>::max())
+            workerCount = 0;
+
+        this->workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; i++)
+            this->workers.emplace_back([this]() { this->WorkerLoop(); });
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::unique_lock lock(this->mutex);
+            this->isStopping = true;
+        }
+        this->workAvailable.notify_all();
+        for (auto& worker : this->workers)
+            worker.join();
+    }
+
+    WorkerPool& WorkerPool::GetDefault()
+    {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    void WorkerPool::ExecuteTasks(const TaskFunction& job, size_t count)
+    {
+        CurrentTaskPool = this;
+        for (size_t task = this->nextTask++; task < count; task = this->nextTask++)
+            job(task);
+        CurrentTaskPool = nullptr;
+    }
+
+    void WorkerPool::WorkerLoop()
+    {
+        size_t lastGeneration = 0;
+        while (true)
+        {
+            const TaskFunction* job = nullptr;
+            size_t count = 0;
+            {
+                std::unique_lock lock(this->mutex);
+                this->workAvailable.wait(lock, [this, lastGeneration]() { return this->isStopping || this->jobGeneration != lastGeneration; });
+                if (this->isStopping) return;
+
+                lastGeneration = this->jobGeneration;
+                // job may be already finished by other threads before this one woke up
+                if (this->currentJob == nullptr) continue;
+                job = this->currentJob;
+                count = this->taskCount;
+                this->activeWorkers++;
+            }
+
+            this->ExecuteTasks(*job, count);
+
+            {
+                std::unique_lock lock(this->mutex);
+                this->activeWorkers--;
+            }
+            this->workFinished.notify_one();
+        }
+    }
+
+    void WorkerPool::Execute(size_t taskCount, const TaskFunction& job)
+    {
+        if (taskCount == 0) return;
+        if (this->workers.empty() || taskCount == 1)
+        {
+            for (size_t task = 0; task < taskCount; task++)
+                job(task);
+            return;
+        }
+
+        {
+            std::unique_lock lock(this->mutex);
+            if (CurrentTaskPool != this)
+                this->jobFinished.wait(lock, [this]() { return this->currentJob == nullptr; });
+            MX_ASSERT(this->currentJob == nullptr); // pool is not reentrant
+            this->currentJob = &job;
+            this->taskCount = taskCount;
+            this->nextTask = 0;
+            this->jobGeneration++;
+        }
+        this->workAvailable.notify_all();
+
+        this->ExecuteTasks(job, taskCount);
+
+        // job pointer must stay valid until all workers which took it leave ExecuteTasks
+        {
+            std::unique_lock lock(this->mutex);
+            this->workFinished.wait(lock, [this]() { return this->activeWorkers == 0; });
+            this->currentJob = nullptr;
+        }
+        this->jobFinished.notify_all();
+    }
+
+    size_t WorkerPool::GetWorkerCount() const
+    {
+        return this->workers.size();
+    }
+
+    size_t WorkerPool::GetThreadCount() const
+    {
+        return this->workers.size() + 1;
+    }
+}
@@ -0,0 +1,115 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Utilities/STL/MxVector.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+namespace MxEngine
+{
+    /*!
+    worker pool is a set of persistent threads which execute data-parallel jobs submitted by engine systems
+    job is split into tasks identified by index. Calling thread also takes tasks, so pool of size 0 executes everything inline
+    only one job can be executed at a time, so pool must not be used recursively from inside of a task
+    jobs submitted from other threads wait until current job is finished (i.e. simulation overlapping with frame preparation)
+    */
+    class WorkerPool
+    {
+        using TaskFunction = std::function<void(size_t)>;
+
+        MxVector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable workFinished;
+        std::condition_variable jobFinished;
+
+        const TaskFunction* currentJob = nullptr;
+        size_t taskCount = 0;
+        std::atomic<size_t> nextTask{ 0 };
+        size_t activeWorkers = 0;
+        size_t jobGeneration = 0;
+        bool isStopping = false;
+
+        void WorkerLoop();
+        void ExecuteTasks(const TaskFunction& job, size_t count);
+    public:
+        WorkerPool(size_t workerCount = std::thread::hardware_concurrency() - 1);
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+        ~WorkerPool();
+
+        /*!
+        gets engine-wide worker pool, created on first use
+        */
+        static WorkerPool& GetDefault();
+
+        /*!
+        executes job for each task index in range [0, taskCount) and waits until all tasks are finished
+        */
+        void Execute(size_t taskCount, const TaskFunction& job);
+        size_t GetWorkerCount() const;
+        size_t GetThreadCount() const;
+    };
+
+    /*!
+    splits range [0, count) into chunks of at least grainSize elements and processes them in parallel
+    \param function functor with signature void(size_t begin, size_t end)
+    */
+    template<typename Func>
+    void ParallelFor(size_t count, size_t grainSize, Func&& function)
+    {
+        if (count == 0) return;
+        auto& pool = WorkerPool::GetDefault();
+
+        size_t chunkSize = grainSize > 0 ? grainSize : 1;
+        // do not create more chunks than needed to load all threads a few times
+        size_t maxChunks = pool.GetThreadCount() * 4;
+        if ((count + chunkSize - 1) / chunkSize > maxChunks)
+            chunkSize = (count + maxChunks - 1) / maxChunks;
+        size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+        if (chunkCount == 1)
+        {
+            function(size_t(0), count);
+            return;
+        }
+
+        pool.Execute(chunkCount, [count, chunkSize, &function](size_t chunk)
+        {
+            size_t begin = chunk * chunkSize;
+            size_t end = begin + chunkSize < count ? begin + chunkSize : count;
+            function(begin, end);
+        });
+    }
+}
@@ -0,0 +1,147 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Core/Components/Instancing/InstanceFactory.h"
+
+#include <random>
+
+using namespace MxEngine;
+
+namespace
+{
+    using InstanceData = InstanceFactory::InstanceData;
+
+    Matrix4x4 MakeRandomAffineMatrix(std::mt19937& generator)
+    {
+        std::uniform_real_distribution<float> translation(-1000.0f, 1000.0f);
+        std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+        std::uniform_real_distribution<float> axis(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> scale(0.01f, 100.0f);
+
+        Matrix4x4 model = Translate(Matrix4x4(1.0f), MakeVector3(translation(generator), translation(generator), translation(generator)));
+        model = Rotate(model, angle(generator), Normalize(MakeVector3(axis(generator), axis(generator), axis(generator)) + MakeVector3(0.0f, 0.0f, 1.5f)));
+        return Scale(model, MakeVector3(scale(generator), scale(generator), scale(generator)));
+    }
+
+    // mirrors getInstanceModel() from Library/instancing.glsl: transpose(mat4(rows, vec4(0, 0, 0, 1))) * position
+    Vector4 TransformInShader(const InstanceData& data, const Vector4& position)
+    {
+        return MakeVector4(Dot(data.Model[0], position), Dot(data.Model[1], position), Dot(data.Model[2], position), position.w);
+    }
+}
+
+TEST(InstanceData, StoresAffineRowsOfModelMatrix)
+{
+    std::mt19937 generator(42);
+    Matrix4x4 model = MakeRandomAffineMatrix(generator);
+
+    InstanceData data;
+    InstanceFactory::PackInstanceData(model, MakeVector3(1.0f), data);
+    for (size_t row = 0; row < 3; row++)
+    {
+        for (size_t column = 0; column < 4; column++)
+            EXPECT_EQ(data.Model[row][column], model[column][row]);
+    }
+}
+
+TEST(InstanceData, ShaderReconstructsModelMatrix)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+    for (size_t i = 0; i < 1000; i++)
+    {
+        Matrix4x4 model = MakeRandomAffineMatrix(generator);
+        InstanceData data;
+        InstanceFactory::PackInstanceData(model, MakeVector3(1.0f), data);
+
+        // rows hold exact copies of matrix elements, so only rounding of matrix-vector product may differ
+        Vector4 position = MakeVector4(coordinate(generator), coordinate(generator), coordinate(generator), 1.0f);
+        Vector4 expected = model * position;
+        Vector4 reconstructed = TransformInShader(data, position);
+        float tolerance = 1e-5f * Max(Length(expected), 1.0f);
+        for (size_t component = 0; component < 4; component++)
+            EXPECT_NEAR(reconstructed[component], expected[component], tolerance);
+
+        Matrix4x4 unpacked;
+        Vector3 color;
+        InstanceFactory::UnpackInstanceData(data, unpacked, color);
+        for (size_t column = 0; column < 4; column++)
+        {
+            for (size_t row = 0; row < 4; row++)
+                EXPECT_EQ(unpacked[column][row], model[column][row]);
+        }
+    }
+}
+
+TEST(InstanceData, ColorRoundTripErrorIsHalfStep)
+{
+    constexpr size_t Steps = 4096;
+    constexpr float MaxError = 0.5f / 255.0f + 1e-6f;
+
+    float maxError = 0.0f;
+    for (size_t i = 0; i <= Steps; i++)
+    {
+        float value = (float)i / (float)Steps;
+        Vector3 color = MakeVector3(value, 1.0f - value, 0.5f * value);
+
+        InstanceData data;
+        InstanceFactory::PackInstanceData(Matrix4x4(1.0f), color, data);
+        EXPECT_EQ(data.Color.a, 255);
+
+        Matrix4x4 model;
+        Vector3 unpacked;
+        InstanceFactory::UnpackInstanceData(data, model, unpacked);
+        for (size_t component = 0; component < 3; component++)
+            maxError = Max(maxError, std::abs(unpacked[component] - color[component]));
+    }
+    EXPECT_LE(maxError, MaxError);
+}
+
+TEST(InstanceData, ColorStepsAreExact)
+{
+    for (size_t i = 0; i < 256; i++)
+    {
+        float value = (float)i / 255.0f;
+        InstanceData data;
+        InstanceFactory::PackInstanceData(Matrix4x4(1.0f), MakeVector3(value), data);
+        EXPECT_EQ(data.Color.r, i);
+        EXPECT_EQ(data.Color.g, i);
+        EXPECT_EQ(data.Color.b, i);
+    }
+}
+
+TEST(InstanceData, ColorIsClamped)
+{
+    InstanceData data;
+    InstanceFactory::PackInstanceData(Matrix4x4(1.0f), MakeVector3(-1.0f, 2.0f, 0.5f), data);
+    EXPECT_EQ(data.Color.r, 0);
+    EXPECT_EQ(data.Color.g, 255);
+    EXPECT_EQ(data.Color.b, 128);
+    EXPECT_EQ(data.Color.a, 255);
+}
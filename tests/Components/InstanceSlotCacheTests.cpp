@@ -0,0 +1,173 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Core/Components/Instancing/InstanceSlotCache.h"
+
+using namespace MxEngine;
+
+namespace
+{
+    // runs one update in the same two passes as InstanceFactory and returns resulting slot of each key
+    MxVector<size_t> UpdateSlots(InstanceSlotCache& cache, const MxVector<size_t>& keys, const MxVector<size_t>& lods, size_t lodCount, uint64_t version)
+    {
+        MxVector<size_t> lodCounts(lodCount, 0);
+        for (size_t lod : lods)
+            lodCounts[lod]++;
+        cache.BeginUpdate(keys.size(), lodCounts);
+
+        MxVector<size_t> slots(keys.size());
+        for (size_t i = 0; i < keys.size(); i++)
+            slots[i] = cache.TryKeepSlot(keys[i], lods[i]);
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            if (slots[i] == InstanceSlotCache::InvalidSlot)
+                slots[i] = cache.AcquireSlot(keys[i], lods[i]);
+            // version is unique for each key, as transform versions are
+            cache.UpdateSlotState(slots[i], version + keys[i], MakeVector3(1.0f));
+        }
+        return slots;
+    }
+
+    MxVector<size_t> MakeKeys(size_t count)
+    {
+        MxVector<size_t> keys(count);
+        for (size_t i = 0; i < count; i++)
+            keys[i] = i;
+        return keys;
+    }
+
+    void ExpectSlotsInBuckets(const MxVector<size_t>& slots, const MxVector<size_t>& lods, size_t lodCount)
+    {
+        MxVector<size_t> lodCounts(lodCount, 0);
+        for (size_t lod : lods)
+            lodCounts[lod]++;
+
+        MxVector<bool> used(slots.size(), false);
+        for (size_t i = 0; i < slots.size(); i++)
+        {
+            size_t begin = 0;
+            for (size_t lod = 0; lod < lods[i]; lod++)
+                begin += lodCounts[lod];
+            EXPECT_GE(slots[i], begin);
+            EXPECT_LT(slots[i], begin + lodCounts[lods[i]]);
+            EXPECT_FALSE(used[slots[i]]);
+            used[slots[i]] = true;
+        }
+    }
+}
+
+TEST(InstanceSlotCache, UnchangedInstancesAreNotDirty)
+{
+    InstanceSlotCache cache;
+    auto keys = MakeKeys(100);
+    MxVector<size_t> lods(keys.size(), 0);
+
+    auto first = UpdateSlots(cache, keys, lods, 1, 0);
+    EXPECT_EQ(cache.GetDirtySlotCount(), keys.size());
+
+    auto second = UpdateSlots(cache, keys, lods, 1, 0);
+    EXPECT_EQ(cache.GetDirtySlotCount(), 0);
+    EXPECT_EQ(first, second);
+}
+
+TEST(InstanceSlotCache, LODChangeDirtiesOnlyMovedSlots)
+{
+    InstanceSlotCache cache;
+    auto keys = MakeKeys(100);
+    MxVector<size_t> lods(keys.size());
+    for (size_t i = 0; i < lods.size(); i++)
+        lods[i] = i % 3;
+
+    auto first = UpdateSlots(cache, keys, lods, 3, 0);
+    ExpectSlotsInBuckets(first, lods, 3);
+
+    // instance moves from the first bucket to the last one, so the middle bucket shifts by one slot.
+    // Only the moved instance and the ones left outside of the shrunk first and shifted middle buckets get new slots
+    lods[0] = 2;
+    auto second = UpdateSlots(cache, keys, lods, 3, 0);
+    ExpectSlotsInBuckets(second, lods, 3);
+    EXPECT_EQ(cache.GetDirtySlotCount(), 3);
+
+    size_t movedCount = 0;
+    for (size_t i = 0; i < keys.size(); i++)
+        movedCount += first[i] != second[i];
+    EXPECT_EQ(movedCount, cache.GetDirtySlotCount());
+}
+
+TEST(InstanceSlotCache, RemovalDirtiesSingleSlot)
+{
+    InstanceSlotCache cache;
+    auto keys = MakeKeys(100);
+    MxVector<size_t> lods(keys.size(), 0);
+    UpdateSlots(cache, keys, lods, 1, 0);
+
+    // removed instance is replaced by the last one, as in lightweight instance storage
+    keys[10] = keys.back();
+    keys.pop_back();
+    lods.pop_back();
+    auto slots = UpdateSlots(cache, keys, lods, 1, 0);
+    ExpectSlotsInBuckets(slots, lods, 1);
+    EXPECT_EQ(cache.GetDirtySlotCount(), 1);
+}
+
+TEST(InstanceSlotCache, InvalidateDirtiesAllSlots)
+{
+    InstanceSlotCache cache;
+    auto keys = MakeKeys(50);
+    MxVector<size_t> lods(keys.size(), 0);
+    UpdateSlots(cache, keys, lods, 1, 0);
+
+    cache.Invalidate();
+    UpdateSlots(cache, keys, lods, 1, 0);
+    EXPECT_EQ(cache.GetDirtySlotCount(), keys.size());
+}
+
+TEST(InstanceSlotCache, MergesCloseDirtyRanges)
+{
+    InstanceSlotCache cache;
+    auto keys = MakeKeys(100);
+    MxVector<size_t> lods(keys.size(), 0);
+    UpdateSlots(cache, keys, lods, 1, 0);
+
+    // slots 10 and 15 are close enough to be uploaded together, slot 50 is not
+    cache.BeginUpdate(keys.size(), {});
+    for (size_t i = 0; i < keys.size(); i++)
+        cache.TryKeepSlot(keys[i], 0);
+    cache.UpdateSlotState(10, 1000, MakeVector3(1.0f));
+    cache.UpdateSlotState(15, 1000, MakeVector3(1.0f));
+    cache.UpdateSlotState(50, 1000, MakeVector3(1.0f));
+
+    MxVector<InstanceSlotCache::SlotRange> ranges;
+    cache.CollectDirtyRanges(8, ranges);
+    ASSERT_EQ(ranges.size(), 2);
+    EXPECT_EQ(ranges[0].Begin, 10);
+    EXPECT_EQ(ranges[0].End, 16);
+    EXPECT_EQ(ranges[1].Begin, 50);
+    EXPECT_EQ(ranges[1].End, 51);
+}
@@ -0,0 +1,154 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Core/Components/Instancing/LightweightInstanceStorage.h"
+
+using namespace MxEngine;
+
+namespace
+{
+    using Handle = LightweightInstanceStorage::Handle;
+
+    Handle AddAt(LightweightInstanceStorage& storage, float x)
+    {
+        return storage.Add(MakeVector3(x, 0.0f, 0.0f), Quaternion(MakeVector3(0.0f)), MakeVector3(1.0f));
+    }
+}
+
+TEST(LightweightInstanceStorage, RemoveMovesLastInstanceIntoFreedSlot)
+{
+    LightweightInstanceStorage storage;
+    Handle first = AddAt(storage, 1.0f);
+    Handle second = AddAt(storage, 2.0f);
+    Handle third = AddAt(storage, 3.0f);
+
+    storage.Remove(first);
+
+    // last instance takes place of removed one, so its handle must point to new packed index
+    ASSERT_EQ(storage.Size(), 2u);
+    EXPECT_EQ(storage.GetPosition(third).x, 3.0f);
+    EXPECT_EQ(storage.GetPosition(second).x, 2.0f);
+
+    Matrix4x4 model;
+    storage.GetMatrixAt(0, model);
+    EXPECT_EQ(model[3][0], 3.0f);
+    storage.GetMatrixAt(1, model);
+    EXPECT_EQ(model[3][0], 2.0f);
+
+    storage.Remove(third);
+    ASSERT_EQ(storage.Size(), 1u);
+    EXPECT_EQ(storage.GetPosition(second).x, 2.0f);
+}
+
+TEST(LightweightInstanceStorage, RemoveInvalidatesStaleHandle)
+{
+    LightweightInstanceStorage storage;
+    Handle first = AddAt(storage, 1.0f);
+    Handle second = AddAt(storage, 2.0f);
+    EXPECT_TRUE(storage.IsValid(first));
+
+    storage.Remove(first);
+    EXPECT_FALSE(storage.IsValid(first));
+    EXPECT_TRUE(storage.IsValid(second));
+
+    // freed handle index is reused, but with new generation
+    Handle reused = AddAt(storage, 3.0f);
+    EXPECT_EQ(reused.Index, first.Index);
+    EXPECT_NE(reused.Generation, first.Generation);
+    EXPECT_FALSE(storage.IsValid(first));
+    EXPECT_TRUE(storage.IsValid(reused));
+    EXPECT_EQ(storage.GetPosition(reused).x, 3.0f);
+}
+
+TEST(LightweightInstanceStorage, ClearInvalidatesAllHandles)
+{
+    LightweightInstanceStorage storage;
+    Handle first = AddAt(storage, 1.0f);
+    Handle second = AddAt(storage, 2.0f);
+
+    storage.Clear();
+    EXPECT_EQ(storage.Size(), 0u);
+    EXPECT_FALSE(storage.IsValid(first));
+    EXPECT_FALSE(storage.IsValid(second));
+
+    Handle third = AddAt(storage, 3.0f);
+    Handle fourth = AddAt(storage, 4.0f);
+    EXPECT_TRUE(storage.IsValid(third));
+    EXPECT_TRUE(storage.IsValid(fourth));
+    EXPECT_FALSE(storage.IsValid(first));
+    EXPECT_FALSE(storage.IsValid(second));
+}
+
+TEST(LightweightInstanceStorage, TracksVisibleCount)
+{
+    LightweightInstanceStorage storage;
+    Handle first = AddAt(storage, 1.0f);
+    Handle second = AddAt(storage, 2.0f);
+    Handle third = AddAt(storage, 3.0f);
+    EXPECT_EQ(storage.GetVisibleCount(), 3u);
+
+    storage.SetVisible(second, false);
+    storage.SetVisible(second, false); // repeated change must not be counted twice
+    EXPECT_EQ(storage.GetVisibleCount(), 2u);
+    EXPECT_FALSE(storage.IsVisible(second));
+
+    // removing hidden instance does not change visible count, removing visible one does
+    storage.Remove(second);
+    EXPECT_EQ(storage.GetVisibleCount(), 2u);
+    storage.Remove(first);
+    EXPECT_EQ(storage.GetVisibleCount(), 1u);
+    EXPECT_TRUE(storage.IsVisible(third));
+    EXPECT_TRUE(storage.IsVisibleAt(0));
+
+    storage.SetVisible(third, true);
+    EXPECT_EQ(storage.GetVisibleCount(), 1u);
+
+    storage.Clear();
+    EXPECT_EQ(storage.GetVisibleCount(), 0u);
+}
+
+TEST(LightweightInstanceStorage, MatrixIsSameAsTransformMatrix)
+{
+    Transform transform;
+    transform.SetPosition(MakeVector3(-12.5f, 3.0f, 40.0f));
+    transform.SetRotation(MakeVector3(30.0f, -75.0f, 120.0f));
+    transform.SetScale(MakeVector3(0.5f, 2.0f, 7.0f));
+
+    LightweightInstanceStorage storage;
+    (void)storage.Add(transform);
+
+    Matrix4x4 model;
+    storage.GetMatrixAt(0, model);
+    const Matrix4x4& expected = transform.GetMatrix();
+    for (size_t column = 0; column < 4; column++)
+    {
+        for (size_t row = 0; row < 4; row++)
+            EXPECT_NEAR(model[column][row], expected[column][row], 1e-4f) << "column " << column << ", row " << row;
+    }
+}
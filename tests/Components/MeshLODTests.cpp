@@ -0,0 +1,146 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Core/Components/Rendering/MeshLOD.h"
+
+using namespace MxEngine;
+
+namespace
+{
+    // LOD errors in object space, every next LOD is four times coarser
+    const MxVector<float> LODErrors = { 0.0f, 0.01f, 0.04f, 0.16f };
+
+    AABB MakeBox(const Vector3& center, float size)
+    {
+        return AABB{ center - MakeVector3(0.5f * size), center + MakeVector3(0.5f * size) };
+    }
+
+    LODSelectionInfo MakeOrthographicInfo(float pixelsPerUnit, float budget)
+    {
+        LODSelectionInfo info;
+        info.IsPerspective = false;
+        info.PixelsPerUnit = pixelsPerUnit;
+        info.PixelErrorBudget = budget;
+        info.Hysteresis = 0.25f;
+        return info;
+    }
+}
+
+TEST(MeshLOD, SelectsCoarsestLODWithinBudget)
+{
+    auto box = MakeBox(MakeVector3(0.0f), 1.0f);
+    // errors projected to screen are { 0, 1, 4, 16 } pixels
+    auto info = MakeOrthographicInfo(100.0f, 2.0f);
+
+    for (size_t currentLOD = 0; currentLOD < LODErrors.size(); currentLOD++)
+        EXPECT_EQ(MeshLOD::SelectLOD(LODErrors, currentLOD, box, box, info), 1) << "current LOD: " << currentLOD;
+
+    info.PixelErrorBudget = 100.0f;
+    EXPECT_EQ(MeshLOD::SelectLOD(LODErrors, 0, box, box, info), 3);
+    info.PixelErrorBudget = 0.1f;
+    EXPECT_EQ(MeshLOD::SelectLOD(LODErrors, 3, box, box, info), 0);
+}
+
+TEST(MeshLOD, KeepsCurrentLODInsideHysteresisBand)
+{
+    auto box = MakeBox(MakeVector3(0.0f), 1.0f);
+    // LOD 2 error is 4 pixels, which is inside of [budget * 0.75, budget * 1.25] band
+    auto info = MakeOrthographicInfo(100.0f, 4.5f);
+
+    EXPECT_EQ(MeshLOD::SelectLOD(LODErrors, 1, box, box, info), 1);
+    EXPECT_EQ(MeshLOD::SelectLOD(LODErrors, 2, box, box, info), 2);
+
+    info.Hysteresis = 0.0f;
+    EXPECT_EQ(MeshLOD::SelectLOD(LODErrors, 1, box, box, info), 2);
+    EXPECT_EQ(MeshLOD::SelectLOD(LODErrors, 2, box, box, info), 2);
+}
+
+TEST(MeshLOD, DoesNotFlickerWhenCameraJitters)
+{
+    auto box = MakeBox(MakeVector3(0.0f), 1.0f);
+    LODSelectionInfo info;
+    info.PixelsPerUnit = 1000.0f;
+    info.PixelErrorBudget = 1.0f;
+
+    // find distance where LOD switches, then move camera back and forth around it by a few percent
+    size_t lod = 0;
+    float switchDistance = 0.0f;
+    for (float distance = 1.0f; distance < 1000.0f && switchDistance == 0.0f; distance *= 1.01f)
+    {
+        info.ViewPosition = MakeVector3(0.0f, 0.0f, distance);
+        size_t next = MeshLOD::SelectLOD(LODErrors, lod, box, box, info);
+        if (next != lod) switchDistance = distance;
+        lod = next;
+    }
+    ASSERT_GT(switchDistance, 0.0f);
+
+    size_t switchCount = 0;
+    for (size_t frame = 0; frame < 100; frame++)
+    {
+        float jitter = (frame % 2 == 0) ? 0.97f : 1.03f;
+        info.ViewPosition = MakeVector3(0.0f, 0.0f, switchDistance * jitter);
+        size_t next = MeshLOD::SelectLOD(LODErrors, lod, box, box, info);
+        switchCount += next != lod;
+        lod = next;
+    }
+    EXPECT_EQ(switchCount, 0);
+}
+
+TEST(MeshLOD, CoarsensMonotonicallyWithDistance)
+{
+    auto box = MakeBox(MakeVector3(0.0f), 1.0f);
+    LODSelectionInfo info;
+    info.PixelsPerUnit = 1000.0f;
+
+    size_t lod = 0;
+    for (float distance = 0.0f; distance < 10000.0f; distance = distance * 1.1f + 0.1f)
+    {
+        info.ViewPosition = MakeVector3(0.0f, 0.0f, distance);
+        size_t next = MeshLOD::SelectLOD(LODErrors, lod, box, box, info);
+        EXPECT_GE(next, lod) << "distance: " << distance;
+        lod = next;
+    }
+    EXPECT_EQ(lod, LODErrors.size() - 1);
+
+    // viewer inside of object bounds always gets the most detailed LOD
+    info.ViewPosition = MakeVector3(0.1f, 0.0f, 0.0f);
+    EXPECT_EQ(MeshLOD::SelectLOD(LODErrors, lod, box, box, info), 0);
+}
+
+TEST(MeshLOD, AccountsForWorldScale)
+{
+    auto objectBox = MakeBox(MakeVector3(0.0f), 1.0f);
+    auto info = MakeOrthographicInfo(100.0f, 2.0f);
+
+    // scaled object has proportionally larger error on screen, so more detailed LOD is required
+    size_t unscaled = MeshLOD::SelectLOD(LODErrors, 0, objectBox, objectBox, info);
+    size_t scaled = MeshLOD::SelectLOD(LODErrors, 0, objectBox, MakeBox(MakeVector3(0.0f), 4.0f), info);
+    EXPECT_EQ(unscaled, 1);
+    EXPECT_EQ(scaled, 0);
+}
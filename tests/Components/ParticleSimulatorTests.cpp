@@ -0,0 +1,132 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Core/Components/Rendering/ParticleSimulator.h"
+
+#include <cstring>
+#include <random>
+
+using namespace MxEngine;
+
+namespace
+{
+    using Particle = ParticleSimulator::Particle;
+
+    // not a multiple of SIMD width or grain size, so padded tail of last chunk is simulated too
+    constexpr size_t ParticleCount = 10003;
+    constexpr size_t FrameCount = 300;
+    constexpr float TimeDelta = 1.0f / 60.0f;
+    constexpr float Lifetime = 1.5f;
+    const Vector3 Spawnpoint = MakeVector3(1.0f, 2.0f, 3.0f);
+
+    MxVector<Particle> MakeParticles(uint32_t seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+        MxVector<Particle> particles(ParticleCount);
+        for (auto& particle : particles)
+        {
+            auto direction = Normalize(MakeVector3(distribution(generator), distribution(generator), distribution(generator)));
+            particle.SpawnDistance = 0.5f * (distribution(generator) + 1.0f);
+            particle.Position = Spawnpoint + direction * particle.SpawnDistance;
+            particle.Velocity = direction * 2.0f;
+            particle.TimeAlive = 0.5f * (distribution(generator) + 1.0f);
+            particle.Size = 0.05f;
+            particle.AngularParams = MakeVector3(0.0f, 0.5f, 0.0f);
+        }
+        return particles;
+    }
+
+    // scalar step written directly after particle_compute.glsl
+    void SimulateReference(MxVector<Particle>& particles, float dt)
+    {
+        for (auto& particle : particles)
+        {
+            float angularSpeed = Length(particle.AngularParams);
+            auto axis = particle.AngularParams / angularSpeed;
+
+            particle.TimeAlive += dt;
+            particle.Position += particle.Velocity * dt;
+            auto radius = Normalize(particle.Position - Spawnpoint);
+            particle.Position += Cross(radius, axis) * angularSpeed * dt;
+
+            if (particle.TimeAlive > Lifetime)
+            {
+                particle.Position = Spawnpoint + Normalize(particle.Velocity) * particle.SpawnDistance;
+                particle.TimeAlive = 0.0f;
+            }
+        }
+    }
+
+    MxVector<Particle> Simulate(const MxVector<Particle>& particles, bool multithreaded)
+    {
+        ParticleSimulator simulator;
+        simulator.Load(particles);
+        for (size_t frame = 0; frame < FrameCount; frame++)
+            simulator.Simulate(TimeDelta, Lifetime, Spawnpoint, multithreaded);
+
+        MxVector<Particle> result;
+        simulator.Store(result);
+        return result;
+    }
+}
+
+TEST(ParticleSimulator, MultithreadedResultMatchesSingleThreaded)
+{
+    auto particles = MakeParticles(42);
+    auto multithreaded = Simulate(particles, true);
+    auto singleThreaded = Simulate(particles, false);
+
+    // particles are independent, so splitting work between threads must not change a single bit
+    ASSERT_EQ(multithreaded.size(), ParticleCount);
+    ASSERT_EQ(singleThreaded.size(), ParticleCount);
+    EXPECT_EQ(std::memcmp(multithreaded.data(), singleThreaded.data(), ParticleCount * sizeof(Particle)), 0);
+    EXPECT_EQ(std::memcmp(multithreaded.data(), Simulate(particles, true).data(), ParticleCount * sizeof(Particle)), 0);
+}
+
+TEST(ParticleSimulator, FollowsScalarReference)
+{
+    auto particles = MakeParticles(42);
+    auto simulated = Simulate(particles, true);
+
+    auto reference = particles;
+    for (size_t frame = 0; frame < FrameCount; frame++)
+        SimulateReference(reference, TimeDelta);
+
+    // SIMD path may round differently, but respawns must happen on the same frames
+    float maxPositionError = 0.0f;
+    for (size_t i = 0; i < ParticleCount; i++)
+    {
+        maxPositionError = Max(maxPositionError, Length(simulated[i].Position - reference[i].Position));
+        EXPECT_NEAR(simulated[i].TimeAlive, reference[i].TimeAlive, 1e-3f);
+        EXPECT_EQ(simulated[i].Size, reference[i].Size);
+    }
+    EXPECT_LE(maxPositionError, 1e-3f);
+}
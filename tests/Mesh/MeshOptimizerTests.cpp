@@ -0,0 +1,151 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Library/Mesh/MeshOptimizer.h"
+#include "TestMeshes.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+using namespace MxEngine;
+
+namespace
+{
+    using Triangle = std::array<uint32_t, 3>;
+
+    // reorders triangles randomly, as in meshes exported without any cache optimization
+    void ShuffleTriangles(MeshData::IndexData& indicies, uint32_t seed)
+    {
+        MxVector<Triangle> triangles(indicies.size() / 3);
+        for (size_t i = 0; i < triangles.size(); i++)
+            triangles[i] = { indicies[3 * i + 0], indicies[3 * i + 1], indicies[3 * i + 2] };
+
+        std::mt19937 generator(seed);
+        std::shuffle(triangles.begin(), triangles.end(), generator);
+
+        for (size_t i = 0; i < triangles.size(); i++)
+            std::copy(triangles[i].begin(), triangles[i].end(), indicies.begin() + 3 * i);
+    }
+
+    // triangles with rotated vertex order are the same, so each one is rotated to start from its smallest index
+    MxVector<Triangle> GetSortedTriangles(const MeshData::IndexData& indicies)
+    {
+        MxVector<Triangle> triangles(indicies.size() / 3);
+        for (size_t i = 0; i < triangles.size(); i++)
+        {
+            Triangle triangle = { indicies[3 * i + 0], indicies[3 * i + 1], indicies[3 * i + 2] };
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+            triangles[i] = triangle;
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+}
+
+TEST(MeshOptimizer, VertexCacheOrderImprovesShuffledGrid)
+{
+    MeshData::VertexData vertecies;
+    MeshData::IndexData indicies;
+    Tests::MakeGridMesh(64, vertecies, indicies);
+    ShuffleTriangles(indicies, 42);
+    auto shuffledTriangles = GetSortedTriangles(indicies);
+
+    auto before = MeshOptimizer::AnalyzeVertexCache(indicies, vertecies.size());
+    MeshOptimizer::OptimizeVertexCache(indicies, vertecies.size());
+    auto after = MeshOptimizer::AnalyzeVertexCache(indicies, vertecies.size());
+
+    EXPECT_EQ(GetSortedTriangles(indicies), shuffledTriangles);
+    // random order transforms almost every vertex of each triangle, while grid can reach ACMR close to 0.5
+    EXPECT_GT(before.ACMR, 2.0f);
+    EXPECT_LT(after.ACMR, 0.8f);
+    EXPECT_LT(after.ATVR, before.ATVR);
+    EXPECT_LT(after.ATVR, 1.6f);
+}
+
+TEST(MeshOptimizer, VertexCacheOrderImprovesShuffledSphere)
+{
+    MeshData::VertexData vertecies;
+    MeshData::IndexData indicies;
+    Tests::MakeSphereMesh(32, 64, vertecies, indicies);
+    ShuffleTriangles(indicies, 42);
+
+    auto before = MeshOptimizer::AnalyzeVertexCache(indicies, vertecies.size());
+    MeshOptimizer::OptimizeVertexCache(indicies, vertecies.size());
+    auto after = MeshOptimizer::AnalyzeVertexCache(indicies, vertecies.size());
+
+    EXPECT_LT(after.ACMR, before.ACMR);
+    EXPECT_LT(after.ATVR, before.ATVR);
+    EXPECT_LT(after.CacheMisses, before.CacheMisses);
+}
+
+TEST(MeshOptimizer, FullOptimizationKeepsGeometry)
+{
+    MeshData::VertexData vertecies;
+    MeshData::IndexData indicies;
+    Tests::MakeSphereMesh(16, 32, vertecies, indicies);
+    ShuffleTriangles(indicies, 7);
+    auto before = MeshOptimizer::AnalyzeVertexCache(indicies, vertecies.size());
+
+    // vertex fetch reordering renumbers vertecies, so triangles are compared by their positions
+    auto getTrianglePositions = [](const MeshData::VertexData& vertecies, const MeshData::IndexData& indicies)
+    {
+        MxVector<std::array<float, 9>> triangles(indicies.size() / 3);
+        for (size_t i = 0; i < indicies.size(); i++)
+        {
+            const auto& position = vertecies[indicies[i]].Position;
+            for (size_t component = 0; component < 3; component++)
+                triangles[i / 3][3 * (i % 3) + component] = position[component];
+        }
+        for (auto& triangle : triangles)
+        {
+            // rotate triangle to start from its lexicographically smallest vertex
+            size_t first = 0;
+            for (size_t vertex = 1; vertex < 3; vertex++)
+            {
+                if (std::lexicographical_compare(triangle.begin() + 3 * vertex, triangle.begin() + 3 * vertex + 3, triangle.begin() + 3 * first, triangle.begin() + 3 * first + 3))
+                    first = vertex;
+            }
+            std::rotate(triangle.begin(), triangle.begin() + 3 * first, triangle.end());
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    };
+    auto expected = getTrianglePositions(vertecies, indicies);
+
+    size_t vertexCount = vertecies.size();
+    MeshOptimizer::Optimize(vertecies, indicies);
+    auto after = MeshOptimizer::AnalyzeVertexCache(indicies, vertecies.size());
+
+    EXPECT_EQ(vertecies.size(), vertexCount);
+    EXPECT_EQ(getTrianglePositions(vertecies, indicies), expected);
+    // overdraw ordering may trade a little of cache efficiency, but result must still be much better than random order
+    EXPECT_LT(after.ACMR, before.ACMR);
+    EXPECT_LT(after.ATVR, before.ATVR);
+}
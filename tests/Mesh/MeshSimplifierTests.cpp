@@ -0,0 +1,145 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Library/Mesh/MeshSimplifier.h"
+#include "TestMeshes.h"
+
+using namespace MxEngine;
+
+namespace
+{
+    size_t CountDegenerateTriangles(const MeshData::VertexData& vertecies, const MeshData::IndexData& indicies)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < indicies.size(); i += 3)
+        {
+            const auto& p0 = vertecies[indicies[i + 0]].Position;
+            const auto& p1 = vertecies[indicies[i + 1]].Position;
+            const auto& p2 = vertecies[indicies[i + 2]].Position;
+            count += p0 == p1 || p1 == p2 || p0 == p2;
+        }
+        return count;
+    }
+}
+
+TEST(MeshSimplifier, ReachesTargetOnSphere)
+{
+    MeshData::VertexData vertecies;
+    MeshData::IndexData indicies;
+    Tests::MakeSphereMesh(32, 64, vertecies, indicies);
+
+    size_t targetIndexCount = indicies.size() / 4 / 3 * 3;
+    float error = -1.0f;
+    auto result = MeshSimplifier::Simplify(vertecies, indicies, targetIndexCount, 1.0f, &error);
+
+    ASSERT_EQ(result.size() % 3, 0);
+    EXPECT_LE(result.size(), targetIndexCount);
+    EXPECT_GT(result.size(), targetIndexCount / 2);
+    EXPECT_EQ(CountDegenerateTriangles(vertecies, result), 0);
+    for (uint32_t index : result)
+        ASSERT_LT(index, vertecies.size());
+
+    // sphere is curved, so removing three quarters of triangles must cost something, but still stay far below mesh extent
+    EXPECT_GT(error, 0.0f);
+    EXPECT_LT(error, 0.05f);
+}
+
+TEST(MeshSimplifier, ErrorGrowsWithReduction)
+{
+    MeshData::VertexData vertecies;
+    MeshData::IndexData indicies;
+    Tests::MakeSphereMesh(32, 64, vertecies, indicies);
+
+    float previousError = 0.0f;
+    size_t previousCount = indicies.size();
+    for (float ratio : { 0.5f, 0.25f, 0.125f, 0.0625f })
+    {
+        float error = 0.0f;
+        size_t targetIndexCount = size_t(indicies.size() / 3 * ratio) * 3;
+        auto result = MeshSimplifier::Simplify(vertecies, indicies, targetIndexCount, 1.0f, &error);
+
+        EXPECT_LT(result.size(), previousCount) << "ratio: " << ratio;
+        EXPECT_GE(error, previousError) << "ratio: " << ratio;
+        previousCount = result.size();
+        previousError = error;
+    }
+}
+
+TEST(MeshSimplifier, StopsAtErrorLimit)
+{
+    MeshData::VertexData vertecies;
+    MeshData::IndexData indicies;
+    Tests::MakeSphereMesh(32, 64, vertecies, indicies);
+
+    const float maxError = 0.001f;
+    float error = 0.0f;
+    auto result = MeshSimplifier::Simplify(vertecies, indicies, 0, maxError, &error);
+
+    EXPECT_LE(error, maxError);
+    EXPECT_GT(result.size(), indicies.size() / 10);
+    EXPECT_EQ(CountDegenerateTriangles(vertecies, result), 0);
+}
+
+TEST(MeshSimplifier, FlatGridCollapsesWithoutError)
+{
+    MeshData::VertexData vertecies;
+    MeshData::IndexData indicies;
+    Tests::MakeGridMesh(32, vertecies, indicies);
+
+    float error = -1.0f;
+    auto result = MeshSimplifier::Simplify(vertecies, indicies, 0, 0.01f, &error);
+
+    EXPECT_LT(error, 1e-5f);
+    EXPECT_LT(result.size(), indicies.size() / 10);
+    EXPECT_EQ(CountDegenerateTriangles(vertecies, result), 0);
+
+    // vertecies are only removed, never moved, so grid corners must survive to keep its outline
+    for (uint32_t corner : { 0u, 32u, 33u * 32u, 33u * 33u - 1u })
+        EXPECT_NE(std::find(result.begin(), result.end(), corner), result.end()) << "corner: " << corner;
+}
+
+TEST(MeshSimplifier, CompactsUnusedVertecies)
+{
+    MeshData::VertexData vertecies;
+    MeshData::IndexData indicies;
+    Tests::MakeSphereMesh(16, 32, vertecies, indicies);
+
+    auto simplified = MeshSimplifier::Simplify(vertecies, indicies, indicies.size() / 4 / 3 * 3, 1.0f);
+    auto compactedVertecies = vertecies;
+    auto compactedIndicies = simplified;
+    MeshSimplifier::CompactVertecies(compactedVertecies, compactedIndicies);
+
+    EXPECT_LT(compactedVertecies.size(), vertecies.size());
+    ASSERT_EQ(compactedIndicies.size(), simplified.size());
+    for (size_t i = 0; i < simplified.size(); i++)
+    {
+        ASSERT_LT(compactedIndicies[i], compactedVertecies.size());
+        EXPECT_EQ(compactedVertecies[compactedIndicies[i]].Position, vertecies[simplified[i]].Position);
+    }
+}
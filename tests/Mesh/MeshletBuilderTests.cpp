@@ -0,0 +1,161 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Library/Mesh/MeshletBuilder.h"
+#include "Core/Rendering/RenderUtilities/MeshletCuller.h"
+#include "TestMeshes.h"
+
+#include <unordered_set>
+
+using namespace MxEngine;
+
+namespace
+{
+    struct MeshletLimits
+    {
+        size_t MaxVertecies;
+        size_t MaxTriangles;
+    };
+
+    const MxVector<MeshletLimits> TestedLimits = {
+        { MeshletBuilder::MaxVertecies, MeshletBuilder::MaxTriangles },
+        { 16, 8 },
+        { 3, 1 },
+    };
+
+    Vector3 GetTriangleNormal(const MeshData::VertexData& vertecies, const MeshData::IndexData& indicies, size_t i)
+    {
+        const auto& p0 = vertecies[indicies[i + 0]].Position;
+        const auto& p1 = vertecies[indicies[i + 1]].Position;
+        const auto& p2 = vertecies[indicies[i + 2]].Position;
+        return Cross(p1 - p0, p2 - p0);
+    }
+}
+
+TEST(MeshletBuilder, RespectsVertexAndTriangleLimits)
+{
+    MeshData::VertexData vertecies;
+    MeshData::IndexData indicies;
+    Tests::MakeSphereMesh(32, 64, vertecies, indicies);
+
+    for (const auto& limits : TestedLimits)
+    {
+        auto meshlets = MeshletBuilder::Build(vertecies, indicies, limits.MaxVertecies, limits.MaxTriangles);
+        ASSERT_FALSE(meshlets.empty());
+        for (const auto& meshlet : meshlets)
+        {
+            EXPECT_EQ(meshlet.IndexCount % 3, 0);
+            EXPECT_GT(meshlet.IndexCount, 0);
+            EXPECT_LE(meshlet.IndexCount / 3, limits.MaxTriangles);
+
+            std::unordered_set<uint32_t> uniqueVertecies(indicies.begin() + meshlet.IndexOffset, indicies.begin() + meshlet.IndexOffset + meshlet.IndexCount);
+            EXPECT_LE(uniqueVertecies.size(), limits.MaxVertecies);
+        }
+    }
+}
+
+TEST(MeshletBuilder, CoversEveryIndexOnce)
+{
+    MeshData::VertexData vertecies;
+    MeshData::IndexData indicies;
+    Tests::MakeGridMesh(40, vertecies, indicies);
+
+    for (const auto& limits : TestedLimits)
+    {
+        auto meshlets = MeshletBuilder::Build(vertecies, indicies, limits.MaxVertecies, limits.MaxTriangles);
+        // meshlets are consecutive ranges of the unchanged index buffer
+        size_t expectedOffset = 0;
+        for (const auto& meshlet : meshlets)
+        {
+            EXPECT_EQ(meshlet.IndexOffset, expectedOffset);
+            expectedOffset += meshlet.IndexCount;
+        }
+        EXPECT_EQ(expectedOffset, indicies.size());
+    }
+}
+
+TEST(MeshletBuilder, BoundsContainAllVertecies)
+{
+    MeshData::VertexData vertecies;
+    MeshData::IndexData indicies;
+    Tests::MakeSphereMesh(32, 64, vertecies, indicies);
+
+    for (const auto& meshlet : MeshletBuilder::Build(vertecies, indicies))
+    {
+        for (size_t i = meshlet.IndexOffset; i < meshlet.IndexOffset + meshlet.IndexCount; i++)
+            EXPECT_LE(Length(vertecies[indicies[i]].Position - meshlet.Bounds.Center), meshlet.Bounds.Radius + 1e-5f);
+    }
+}
+
+TEST(MeshletBuilder, FlatPatchConeFacesAlongNormal)
+{
+    MeshData::VertexData vertecies;
+    MeshData::IndexData indicies;
+    Tests::MakeGridMesh(4, vertecies, indicies);
+
+    auto meshlet = MeshletBuilder::ComputeBounds(vertecies, indicies, 0, indicies.size());
+    EXPECT_NEAR(meshlet.ConeAxis.y, 1.0f, 1e-5f);
+    EXPECT_NEAR(meshlet.ConeCutoff, 0.0f, 1e-3f);
+
+    // grid faces up, so it is back-facing from any point below its plane and front-facing from any point above it
+    EXPECT_TRUE(MeshletCuller::IsBackFacing(meshlet, MakeVector3(0.5f, -1.0f, 0.5f)));
+    EXPECT_TRUE(MeshletCuller::IsBackFacing(meshlet, MakeVector3(10.0f, -0.1f, -3.0f)));
+    EXPECT_FALSE(MeshletCuller::IsBackFacing(meshlet, MakeVector3(0.5f, 1.0f, 0.5f)));
+    EXPECT_FALSE(MeshletCuller::IsBackFacing(meshlet, MakeVector3(10.0f, 0.1f, -3.0f)));
+}
+
+TEST(MeshletBuilder, ConeCullingIsConservative)
+{
+    MeshData::VertexData vertecies;
+    MeshData::IndexData indicies;
+    Tests::MakeSphereMesh(32, 64, vertecies, indicies);
+    auto meshlets = MeshletBuilder::Build(vertecies, indicies, 32, 16);
+
+    const MxVector<Vector3> viewPositions = {
+        MakeVector3(0.0f, 0.0f, 5.0f), MakeVector3(3.0f, 2.0f, -1.0f), MakeVector3(0.0f, -1.5f, 0.0f), MakeVector3(-20.0f, 0.5f, 0.5f),
+    };
+    for (const auto& viewPosition : viewPositions)
+    {
+        size_t backFacingCount = 0;
+        for (const auto& meshlet : meshlets)
+        {
+            if (!MeshletCuller::IsBackFacing(meshlet, viewPosition)) continue;
+            backFacingCount++;
+
+            // culled meshlet must not contain any triangle visible from view position
+            for (size_t i = meshlet.IndexOffset; i < meshlet.IndexOffset + meshlet.IndexCount; i += 3)
+            {
+                auto toView = viewPosition - vertecies[indicies[i]].Position;
+                EXPECT_LE(Dot(GetTriangleNormal(vertecies, indicies, i), toView), 1e-5f);
+            }
+        }
+        // sphere viewed from outside has about half of its meshlets facing away
+        EXPECT_GT(backFacingCount, meshlets.size() / 5);
+    }
+}
@@ -0,0 +1,182 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Core/Rendering/RenderPipeline.h"
+
+using namespace MxEngine;
+
+namespace
+{
+    struct IndirectScene
+    {
+        RenderList Objects;
+        MxVector<RenderUnit> Units;
+        MxVector<Material> Materials = MxVector<Material>(1);
+        MxVector<Meshlet> Meshlets;
+        FrustrumCuller Culler;
+
+        IndirectScene()
+        {
+            auto view = MakeViewMatrix(MakeVector3(0.0f, 0.0f, 10.0f), MakeVector3(0.0f), MakeVector3(0.0f, 1.0f, 0.0f));
+            auto projection = MakeOrthographicMatrix(-10.0f, 10.0f, -10.0f, 10.0f, 0.1f, 100.0f);
+            this->Culler = FrustrumCuller(projection * view);
+        }
+
+        size_t AddUnit(const Vector3& position, IndexFormat indexType = IndexFormat::UINT32)
+        {
+            RenderUnit unit{ };
+            unit.VertexOffset = this->Units.size() * 100;
+            unit.IndexOffset = this->Units.size() * 300;
+            unit.IndexCount = 36;
+            unit.IndexType = indexType;
+            unit.ModelMatrix = Matrix4x4(1.0f);
+            unit.NormalMatrix = Matrix3x3(1.0f);
+            unit.MinAABB = position - MakeVector3(0.5f);
+            unit.MaxAABB = position + MakeVector3(0.5f);
+            this->Units.push_back(unit);
+            return this->Units.size() - 1;
+        }
+
+        void AddDraw(size_t unitIndex, size_t baseInstance = 0, size_t instanceCount = 0)
+        {
+            this->Objects.Groups.push_back(RenderGroup{ baseInstance, instanceCount, 1 });
+            this->Objects.UnitsIndex.push_back(unitIndex);
+            this->Objects.DrawCommands.push_back(RenderDrawCommand{ 0, (uint32_t)unitIndex, (uint32_t)this->Objects.Groups.size() - 1 });
+        }
+
+        IndirectDrawList Build(ArrayView<uint8_t> occludedUnits = { })
+        {
+            IndirectDrawList result;
+            IndirectCommandBuilder builder(this->Objects, this->Units, this->Materials, this->Meshlets);
+            builder.Build(this->Culler, MakeVector3(0.0f, 0.0f, 10.0f), occludedUnits, result);
+            return result;
+        }
+    };
+}
+
+TEST(IndirectCommandBuilder, EmitsCommandPerVisibleUnit)
+{
+    IndirectScene scene;
+    scene.AddDraw(scene.AddUnit(MakeVector3(0.0f)));
+    scene.AddDraw(scene.AddUnit(MakeVector3(2.0f, 0.0f, 0.0f)));
+
+    auto result = scene.Build();
+
+    ASSERT_EQ(result.Commands.size(), 2);
+    ASSERT_EQ(result.DrawData.size(), 2);
+    for (size_t i = 0; i < result.Commands.size(); i++)
+    {
+        const auto& command = result.Commands[i];
+        const auto& unit = scene.Units[i];
+        EXPECT_EQ(command.IndexCount, unit.IndexCount);
+        EXPECT_EQ(command.FirstIndex, unit.IndexOffset);
+        EXPECT_EQ(command.BaseVertex, (int32_t)unit.VertexOffset);
+        EXPECT_EQ(command.InstanceCount, 1);
+        EXPECT_EQ(command.BaseInstance, 0);
+        EXPECT_EQ(result.DrawData[i].MaterialIndex, unit.MaterialIndex);
+    }
+
+    // same textures and index type, so everything goes to one multi-draw call
+    ASSERT_EQ(result.Batches.size(), 1);
+    EXPECT_EQ(result.Batches[0].CommandOffset, 0);
+    EXPECT_EQ(result.Batches[0].CommandCount, 2);
+    EXPECT_EQ(result.CulledCount, 0);
+}
+
+TEST(IndirectCommandBuilder, SkipsCulledAndOccludedUnits)
+{
+    IndirectScene scene;
+    size_t visible = scene.AddUnit(MakeVector3(0.0f));
+    size_t outside = scene.AddUnit(MakeVector3(1000.0f, 0.0f, 0.0f));
+    size_t occluded = scene.AddUnit(MakeVector3(-2.0f, 0.0f, 0.0f));
+    scene.AddDraw(visible);
+    scene.AddDraw(outside);
+    scene.AddDraw(occluded);
+
+    MxVector<uint8_t> occludedUnits(scene.Units.size(), 0);
+    occludedUnits[occluded] = 1;
+    auto result = scene.Build(occludedUnits);
+
+    ASSERT_EQ(result.Commands.size(), 1);
+    EXPECT_EQ(result.Commands[0].FirstIndex, scene.Units[visible].IndexOffset);
+    EXPECT_EQ(result.CulledCount, 1);
+    EXPECT_EQ(result.OccludedCount, 1);
+}
+
+TEST(IndirectCommandBuilder, InstancedGroupsAreNeverCulled)
+{
+    IndirectScene scene;
+    size_t unit = scene.AddUnit(MakeVector3(1000.0f, 0.0f, 0.0f));
+    scene.AddDraw(unit, 16, 8);
+
+    MxVector<uint8_t> occludedUnits(scene.Units.size(), 1);
+    auto result = scene.Build(occludedUnits);
+
+    ASSERT_EQ(result.Commands.size(), 1);
+    EXPECT_EQ(result.Commands[0].InstanceCount, 8);
+    EXPECT_EQ(result.Commands[0].BaseInstance, 16);
+    EXPECT_EQ(result.CulledCount, 0);
+    EXPECT_EQ(result.OccludedCount, 0);
+}
+
+TEST(IndirectCommandBuilder, IndexTypeChangeStartsNewBatch)
+{
+    IndirectScene scene;
+    scene.AddDraw(scene.AddUnit(MakeVector3(0.0f), IndexFormat::UINT32));
+    scene.AddDraw(scene.AddUnit(MakeVector3(1.0f, 0.0f, 0.0f), IndexFormat::UINT32));
+    scene.AddDraw(scene.AddUnit(MakeVector3(2.0f, 0.0f, 0.0f), IndexFormat::UINT16));
+
+    auto result = scene.Build();
+
+    ASSERT_EQ(result.Batches.size(), 2);
+    EXPECT_EQ(result.Batches[0].CommandCount, 2);
+    EXPECT_EQ(result.Batches[0].IndexType, IndexFormat::UINT32);
+    EXPECT_EQ(result.Batches[1].CommandOffset, 2);
+    EXPECT_EQ(result.Batches[1].CommandCount, 1);
+    EXPECT_EQ(result.Batches[1].IndexType, IndexFormat::UINT16);
+}
+
+TEST(IndirectCommandBuilder, PacksMaterialParameters)
+{
+    MxVector<Material> materials(2);
+    materials[1].BaseColor = MakeVector3(0.25f, 0.5f, 0.75f);
+    materials[1].RoughnessFactor = 0.1f;
+    materials[1].MetallicFactor = 0.9f;
+    materials[1].Emission = 3.0f;
+
+    MxVector<IndirectMaterialData> packed;
+    IndirectCommandBuilder::PackMaterials(materials, packed);
+
+    ASSERT_EQ(packed.size(), 2);
+    EXPECT_EQ(packed[1].BaseColor, materials[1].BaseColor);
+    EXPECT_FLOAT_EQ(packed[1].Roughness, 0.1f);
+    EXPECT_FLOAT_EQ(packed[1].Metallic, 0.9f);
+    EXPECT_FLOAT_EQ(packed[1].Emission, 3.0f);
+    EXPECT_FLOAT_EQ(packed[0].Roughness, materials[0].RoughnessFactor);
+}
@@ -0,0 +1,233 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Core/Rendering/RenderUtilities/LightClusterBuilder.h"
+
+#include <random>
+#include <set>
+
+using namespace MxEngine;
+
+namespace
+{
+    constexpr float ZNear = 0.1f;
+    constexpr float ZFar = 100.0f;
+
+    Matrix4x4 MakeTestViewProjection()
+    {
+        auto view = MakeViewMatrix(MakeVector3(0.0f), MakeVector3(0.0f, 0.0f, -1.0f), MakeVector3(0.0f, 1.0f, 0.0f));
+        auto projection = MakePerspectiveMatrix(Radians(65.0f), 16.0f / 9.0f, ZNear, ZFar);
+        return projection * view;
+    }
+
+    size_t GetClusterOfPoint(const Matrix4x4& viewProjection, const Vector3& point, const LightClusterGrid& grid)
+    {
+        auto projected = viewProjection * Vector4(point, 1.0f);
+        auto ToCluster = [](float ndc, size_t clusterCount)
+        {
+            return (size_t)Clamp((ndc * 0.5f + 0.5f) * float(clusterCount), 0.0f, float(clusterCount - 1));
+        };
+        size_t x = ToCluster(projected.x / projected.w, LightClusterBuilder::ClusterCountX);
+        size_t y = ToCluster(projected.y / projected.w, LightClusterBuilder::ClusterCountY);
+        size_t z = LightClusterBuilder::GetSliceIndex(projected.w, grid);
+        return LightClusterBuilder::GetClusterIndex(x, y, z);
+    }
+
+    bool ClusterHasPointLight(const LightClusterGrid& grid, size_t cluster, uint32_t light)
+    {
+        const auto& record = grid.Clusters[cluster];
+        for (uint32_t i = 0; i < record.PointLightCount; i++)
+        {
+            if (grid.LightIndices[record.Offset + i] == light) return true;
+        }
+        return false;
+    }
+
+    bool ClusterHasSpotLight(const LightClusterGrid& grid, size_t cluster, uint32_t light)
+    {
+        const auto& record = grid.Clusters[cluster];
+        for (uint32_t i = 0; i < record.SpotLightCount; i++)
+        {
+            if (grid.LightIndices[record.Offset + record.PointLightCount + i] == light) return true;
+        }
+        return false;
+    }
+
+    ClusteredPointLight MakePointLight(const Vector3& position, float radius)
+    {
+        return ClusteredPointLight{ position, radius, MakeVector3(1.0f), 0.0f };
+    }
+}
+
+TEST(LightClusterBuilder, SlicesCoverDepthRange)
+{
+    LightClusterBuilder builder;
+    LightClusterGrid grid;
+    builder.SetCamera(MakeTestViewProjection(), ZNear, ZFar);
+    builder.Build({ }, { }, grid);
+
+    EXPECT_EQ(grid.Clusters.size(), LightClusterBuilder::ClusterCount);
+    EXPECT_EQ(LightClusterBuilder::GetSliceIndex(ZNear, grid), 0);
+    EXPECT_EQ(LightClusterBuilder::GetSliceIndex(ZFar * 0.999f, grid), LightClusterBuilder::ClusterCountZ - 1);
+
+    size_t previousSlice = 0;
+    for (float depth = ZNear; depth < ZFar; depth *= 1.1f)
+    {
+        size_t slice = LightClusterBuilder::GetSliceIndex(depth, grid);
+        EXPECT_GE(slice, previousSlice);
+        previousSlice = slice;
+    }
+}
+
+TEST(LightClusterBuilder, AssignsLightToClusterOfItsCenter)
+{
+    auto viewProjection = MakeTestViewProjection();
+    LightClusterBuilder builder;
+    LightClusterGrid grid;
+    builder.SetCamera(viewProjection, ZNear, ZFar);
+
+    MxVector<ClusteredPointLight> pointLights = {
+        MakePointLight(MakeVector3(0.0f, 0.0f, -10.0f), 1.0f),
+        MakePointLight(MakeVector3(0.0f, 0.0f, 50.0f), 1.0f),   // behind camera
+        MakePointLight(MakeVector3(0.0f, 0.0f, -500.0f), 1.0f), // beyond far plane
+        MakePointLight(MakeVector3(300.0f, 0.0f, -10.0f), 1.0f), // outside of frustum side
+    };
+    builder.Build(pointLights, { }, grid);
+
+    EXPECT_EQ(grid.VisibleLightCount, 1);
+    size_t cluster = GetClusterOfPoint(viewProjection, pointLights[0].Position, grid);
+    EXPECT_TRUE(ClusterHasPointLight(grid, cluster, 0));
+    for (uint32_t index : grid.LightIndices)
+        EXPECT_EQ(index, 0);
+}
+
+TEST(LightClusterBuilder, SpotLightBoundsEncloseCone)
+{
+    for (float angle : { 5.0f, 30.0f, 44.0f, 46.0f, 60.0f, 85.0f })
+    {
+        ClusteredSpotLight light{ };
+        light.Position = MakeVector3(1.0f, 2.0f, 3.0f);
+        light.Direction = MakeVector3(0.0f, 0.0f, -20.0f);
+        light.OuterCos = std::cos(Radians(angle));
+
+        Vector3 center;
+        float radius = 0.0f;
+        LightClusterBuilder::GetSpotLightBounds(light, center, radius);
+
+        // light is visible up to half of its max distance, see GetSpotLightBounds()
+        float height = 0.5f * Length(light.Direction);
+        float baseRadius = height * std::tan(Radians(angle));
+        Vector3 baseCenter = light.Position + MakeVector3(0.0f, 0.0f, -height);
+        const float eps = 1e-3f;
+
+        EXPECT_LE(Length(light.Position - center), radius + eps) << "angle: " << angle;
+        EXPECT_LE(Length(baseCenter - center), radius + eps) << "angle: " << angle;
+        if (baseRadius < height)
+        {
+            EXPECT_LE(Length(baseCenter + MakeVector3(baseRadius, 0.0f, 0.0f) - center), radius + eps) << "angle: " << angle;
+            EXPECT_LE(Length(baseCenter - MakeVector3(0.0f, baseRadius, 0.0f) - center), radius + eps) << "angle: " << angle;
+        }
+        EXPECT_LE(radius, height + eps) << "angle: " << angle;
+    }
+}
+
+TEST(LightClusterBuilder, GridIsConsistentForRandomLights)
+{
+    auto viewProjection = MakeTestViewProjection();
+    LightClusterBuilder builder;
+    LightClusterGrid grid;
+    builder.SetCamera(viewProjection, ZNear, ZFar);
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> xy(-40.0f, 40.0f);
+    std::uniform_real_distribution<float> z(-90.0f, 5.0f);
+    std::uniform_real_distribution<float> size(0.5f, 8.0f);
+    std::uniform_real_distribution<float> angle(5.0f, 80.0f);
+
+    MxVector<ClusteredPointLight> pointLights;
+    MxVector<ClusteredSpotLight> spotLights;
+    for (size_t i = 0; i < 500; i++)
+        pointLights.push_back(MakePointLight(MakeVector3(xy(generator), xy(generator), z(generator)), size(generator)));
+    for (size_t i = 0; i < 200; i++)
+    {
+        ClusteredSpotLight light{ };
+        light.Position = MakeVector3(xy(generator), xy(generator), z(generator));
+        light.Direction = Normalize(MakeVector3(xy(generator), xy(generator), z(generator))) * size(generator) * 4.0f;
+        light.OuterCos = std::cos(Radians(angle(generator)));
+        spotLights.push_back(light);
+    }
+    builder.Build(pointLights, spotLights, grid);
+
+    size_t totalCount = 0;
+    for (const auto& record : grid.Clusters)
+    {
+        ASSERT_LE(record.Offset + record.PointLightCount + record.SpotLightCount, grid.LightIndices.size());
+        std::set<uint32_t> points, spots;
+        for (uint32_t i = 0; i < record.PointLightCount; i++)
+            points.insert(grid.LightIndices[record.Offset + i]);
+        for (uint32_t i = 0; i < record.SpotLightCount; i++)
+            spots.insert(grid.LightIndices[record.Offset + record.PointLightCount + i]);
+
+        // each light is listed in cluster at most once and indices refer to existing lights
+        EXPECT_EQ(points.size(), record.PointLightCount);
+        EXPECT_EQ(spots.size(), record.SpotLightCount);
+        if (!points.empty()) EXPECT_LT(*points.rbegin(), pointLights.size());
+        if (!spots.empty()) EXPECT_LT(*spots.rbegin(), spotLights.size());
+        totalCount += record.PointLightCount + record.SpotLightCount;
+    }
+    EXPECT_EQ(totalCount, grid.LightIndices.size());
+
+    // assignment is conservative: light always reaches the cluster of its center if center is inside frustum
+    for (uint32_t i = 0; i < pointLights.size(); i++)
+    {
+        auto projected = viewProjection * Vector4(pointLights[i].Position, 1.0f);
+        if (projected.w < ZNear || std::abs(projected.x) > projected.w || std::abs(projected.y) > projected.w) continue;
+        EXPECT_TRUE(ClusterHasPointLight(grid, GetClusterOfPoint(viewProjection, pointLights[i].Position, grid), i));
+    }
+    for (uint32_t i = 0; i < spotLights.size(); i++)
+    {
+        Vector3 center;
+        float radius = 0.0f;
+        LightClusterBuilder::GetSpotLightBounds(spotLights[i], center, radius);
+        auto projected = viewProjection * Vector4(center, 1.0f);
+        if (projected.w < ZNear || std::abs(projected.x) > projected.w || std::abs(projected.y) > projected.w) continue;
+        EXPECT_TRUE(ClusterHasSpotLight(grid, GetClusterOfPoint(viewProjection, center, grid), i));
+    }
+
+    // rebuilding from the same input produces identical grid, regardless of how work was split between threads
+    LightClusterGrid rebuilt;
+    builder.Build(pointLights, spotLights, rebuilt);
+    ASSERT_EQ(rebuilt.LightIndices, grid.LightIndices);
+    for (size_t i = 0; i < grid.Clusters.size(); i++)
+    {
+        EXPECT_EQ(rebuilt.Clusters[i].Offset, grid.Clusters[i].Offset);
+        EXPECT_EQ(rebuilt.Clusters[i].PointLightCount, grid.Clusters[i].PointLightCount);
+        EXPECT_EQ(rebuilt.Clusters[i].SpotLightCount, grid.Clusters[i].SpotLightCount);
+    }
+}
@@ -0,0 +1,142 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Core/Rendering/RenderUtilities/MeshletCuller.h"
+#include "Core/BoundingObjects/FrustrumCuller.h"
+
+using namespace MxEngine;
+
+namespace
+{
+    // camera at origin looking along -Z
+    FrustrumCuller MakeCuller()
+    {
+        auto view = MakeViewMatrix(MakeVector3(0.0f), MakeVector3(0.0f, 0.0f, -1.0f), MakeVector3(0.0f, 1.0f, 0.0f));
+        auto projection = MakePerspectiveMatrix(Radians(90.0f), 1.0f, 0.1f, 100.0f);
+        return FrustrumCuller(projection * view);
+    }
+
+    // cutoff above 1 disables cone test, as in meshlets with too wide normal cone
+    Meshlet MakeMeshlet(const Vector3& center, size_t index, const Vector3& coneAxis = MakeVector3(0.0f, 0.0f, 1.0f), float coneCutoff = 2.0f)
+    {
+        Meshlet meshlet;
+        meshlet.Bounds = BoundingSphere(center, 1.0f);
+        meshlet.ConeApex = center;
+        meshlet.ConeAxis = coneAxis;
+        meshlet.ConeCutoff = coneCutoff;
+        meshlet.IndexOffset = uint32_t(index * 30);
+        meshlet.IndexCount = 30;
+        return meshlet;
+    }
+}
+
+TEST(MeshletCuller, CullsMeshletsOutsideOfFrustrum)
+{
+    MxVector<Meshlet> meshlets = {
+        MakeMeshlet(MakeVector3(0.0f, 0.0f, -10.0f), 0),
+        MakeMeshlet(MakeVector3(0.0f, 0.0f, 10.0f), 1),
+        MakeMeshlet(MakeVector3(50.0f, 0.0f, -10.0f), 2),
+        MakeMeshlet(MakeVector3(0.0f, 0.0f, -200.0f), 3),
+        // intersects left frustrum plane x = z, so it stays visible
+        MakeMeshlet(MakeVector3(-10.5f, 0.0f, -10.0f), 4),
+    };
+
+    MxVector<MeshletDrawRange> ranges;
+    size_t culledCount = MeshletCuller::Cull(meshlets, Matrix4x4(1.0f), 0, MakeCuller(), MakeVector3(0.0f), ranges);
+    EXPECT_EQ(culledCount, 3);
+    ASSERT_EQ(ranges.size(), 2);
+    EXPECT_EQ(ranges[0].IndexOffset, 0);
+    EXPECT_EQ(ranges[0].IndexCount, 30);
+    EXPECT_EQ(ranges[1].IndexOffset, 120);
+    EXPECT_EQ(ranges[1].IndexCount, 30);
+}
+
+TEST(MeshletCuller, MergesConsecutiveVisibleMeshlets)
+{
+    MxVector<Meshlet> meshlets;
+    for (size_t i = 0; i < 4; i++)
+        meshlets.push_back(MakeMeshlet(MakeVector3(0.0f, 0.0f, -10.0f), i));
+
+    MxVector<MeshletDrawRange> ranges;
+    size_t culledCount = MeshletCuller::Cull(meshlets, Matrix4x4(1.0f), 600, MakeCuller(), MakeVector3(0.0f), ranges);
+    EXPECT_EQ(culledCount, 0);
+    ASSERT_EQ(ranges.size(), 1);
+    EXPECT_EQ(ranges[0].IndexOffset, 600);
+    EXPECT_EQ(ranges[0].IndexCount, 120);
+}
+
+TEST(MeshletCuller, CullsBackFacingMeshlets)
+{
+    // first meshlet faces the camera, second one faces away from it
+    MxVector<Meshlet> meshlets = {
+        MakeMeshlet(MakeVector3(0.0f, 0.0f, -10.0f), 0, MakeVector3(0.0f, 0.0f, 1.0f), 0.5f),
+        MakeMeshlet(MakeVector3(0.0f, 0.0f, -10.0f), 1, MakeVector3(0.0f, 0.0f, -1.0f), 0.5f),
+    };
+
+    MxVector<MeshletDrawRange> ranges;
+    size_t culledCount = MeshletCuller::Cull(meshlets, Matrix4x4(1.0f), 0, MakeCuller(), MakeVector3(0.0f), ranges);
+    EXPECT_EQ(culledCount, 1);
+    ASSERT_EQ(ranges.size(), 1);
+    EXPECT_EQ(ranges[0].IndexOffset, 0);
+
+    // cone test is done in object space, so moving the mesh behind the view position makes the other meshlet visible
+    auto model = Translate(Matrix4x4(1.0f), MakeVector3(0.0f, 0.0f, -20.0f));
+    auto behindView = MakeVector3(0.0f, 0.0f, -40.0f);
+    EXPECT_TRUE(MeshletCuller::IsBackFacing(meshlets[0], Vector3(Inverse(model) * Vector4(behindView, 1.0f))));
+    EXPECT_FALSE(MeshletCuller::IsBackFacing(meshlets[1], Vector3(Inverse(model) * Vector4(behindView, 1.0f))));
+}
+
+TEST(MeshletCuller, TransformsBoundsByModelMatrix)
+{
+    MxVector<Meshlet> meshlets = { MakeMeshlet(MakeVector3(0.0f, 0.0f, -10.0f), 0) };
+    MxVector<MeshletDrawRange> ranges;
+
+    auto translated = Translate(Matrix4x4(1.0f), MakeVector3(0.0f, 0.0f, 20.0f));
+    EXPECT_EQ(MeshletCuller::Cull(meshlets, translated, 0, MakeCuller(), MakeVector3(0.0f), ranges), 1);
+    EXPECT_TRUE(ranges.empty());
+
+    // sphere center is moved behind the camera to z = 2, but its scaled radius still reaches into frustrum
+    auto scaled = Scale(Translate(Matrix4x4(1.0f), MakeVector3(0.0f, 0.0f, 52.0f)), MakeVector3(5.0f));
+    EXPECT_EQ(MeshletCuller::Cull(meshlets, scaled, 0, MakeCuller(), MakeVector3(0.0f), ranges), 0);
+    EXPECT_EQ(ranges.size(), 1);
+
+    auto unscaled = Translate(Matrix4x4(1.0f), MakeVector3(0.0f, 0.0f, 12.0f));
+    EXPECT_EQ(MeshletCuller::Cull(meshlets, unscaled, 0, MakeCuller(), MakeVector3(0.0f), ranges), 1);
+}
+
+TEST(MeshletCuller, MirroredModelDisablesConeCulling)
+{
+    // mirroring flips triangle winding, so object space cones are not valid anymore
+    MxVector<Meshlet> meshlets = { MakeMeshlet(MakeVector3(0.0f, 0.0f, -10.0f), 0, MakeVector3(0.0f, 0.0f, -1.0f), 0.5f) };
+    auto mirrored = Scale(Matrix4x4(1.0f), MakeVector3(-1.0f, 1.0f, 1.0f));
+
+    MxVector<MeshletDrawRange> ranges;
+    EXPECT_EQ(MeshletCuller::Cull(meshlets, mirrored, 0, MakeCuller(), MakeVector3(0.0f), ranges), 0);
+    EXPECT_EQ(ranges.size(), 1);
+}
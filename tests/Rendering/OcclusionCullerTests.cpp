@@ -0,0 +1,155 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Core/Rendering/RenderUtilities/OcclusionCuller.h"
+
+using namespace MxEngine;
+
+namespace
+{
+    constexpr float ZNear = 0.1f;
+
+    // camera is at origin looking along -Z
+    Matrix4x4 MakeTestViewProjection()
+    {
+        auto view = MakeViewMatrix(MakeVector3(0.0f), MakeVector3(0.0f, 0.0f, -1.0f), MakeVector3(0.0f, 1.0f, 0.0f));
+        return MakePerspectiveMatrix(1.0f, 2.0f, ZNear, 1000.0f) * view;
+    }
+
+    // 10x10 wall facing camera at distance 10
+    OccluderGeometry MakeWall()
+    {
+        OccluderGeometry wall;
+        wall.Positions = {
+            MakeVector3(-5.0f, -5.0f, -10.0f), MakeVector3(5.0f, -5.0f, -10.0f),
+            MakeVector3(5.0f, 5.0f, -10.0f), MakeVector3(-5.0f, 5.0f, -10.0f),
+        };
+        wall.Indicies = { 0, 1, 2, 0, 2, 3 };
+        return wall;
+    }
+
+    // large floor under camera which crosses near plane
+    OccluderGeometry MakeFloor()
+    {
+        OccluderGeometry floor;
+        floor.Positions = {
+            MakeVector3(-50.0f, -1.0f, 5.0f), MakeVector3(50.0f, -1.0f, 5.0f),
+            MakeVector3(50.0f, -1.0f, -50.0f), MakeVector3(-50.0f, -1.0f, -50.0f),
+        };
+        floor.Indicies = { 0, 1, 2, 0, 2, 3 };
+        return floor;
+    }
+
+    bool IsBoxVisible(const OcclusionCuller& culler, const Vector3& center, float size)
+    {
+        return culler.IsAABBVisible(center - MakeVector3(0.5f * size), center + MakeVector3(0.5f * size));
+    }
+}
+
+TEST(OcclusionCuller, RoundsWidthToSIMDLanes)
+{
+    OcclusionCuller culler;
+    culler.Init(250, 100);
+    EXPECT_EQ(culler.GetWidth(), 252);
+    EXPECT_EQ(culler.GetHeight(), 100);
+    EXPECT_EQ(culler.GetDepthBuffer().size(), 252 * 100);
+}
+
+TEST(OcclusionCuller, EverythingIsVisibleWithoutOccluders)
+{
+    OcclusionCuller culler;
+    culler.Init(256, 128);
+    culler.RenderOccluders(MakeTestViewProjection(), ZNear, { });
+
+    EXPECT_EQ(culler.GetRasterizedTriangleCount(), 0);
+    EXPECT_TRUE(IsBoxVisible(culler, MakeVector3(0.0f, 0.0f, -20.0f), 2.0f));
+}
+
+TEST(OcclusionCuller, WallHidesBoxesBehindIt)
+{
+    auto wall = MakeWall();
+    MxVector<OccluderInstance> occluders = { OccluderInstance{ &wall, Matrix4x4(1.0f) } };
+
+    OcclusionCuller culler;
+    culler.Init(256, 128);
+    culler.RenderOccluders(MakeTestViewProjection(), ZNear, occluders);
+    EXPECT_EQ(culler.GetRasterizedTriangleCount(), 2);
+
+    EXPECT_FALSE(IsBoxVisible(culler, MakeVector3(0.0f, 0.0f, -20.0f), 2.0f)); // fully behind
+    EXPECT_TRUE(IsBoxVisible(culler, MakeVector3(0.0f, 0.0f, -5.0f), 2.0f));   // in front of wall
+    EXPECT_TRUE(IsBoxVisible(culler, MakeVector3(0.0f, 0.0f, -10.0f), 2.0f));  // intersects wall
+    EXPECT_TRUE(IsBoxVisible(culler, MakeVector3(10.0f, 0.0f, -20.0f), 4.0f)); // sticks out from behind wall edge
+    EXPECT_TRUE(IsBoxVisible(culler, MakeVector3(21.0f, 0.0f, -30.0f), 2.0f)); // beside wall
+    EXPECT_TRUE(IsBoxVisible(culler, MakeVector3(0.0f), 2.0f));                // crosses near plane
+}
+
+TEST(OcclusionCuller, ClipsOccludersCrossingNearPlane)
+{
+    auto floor = MakeFloor();
+    MxVector<OccluderInstance> occluders = { OccluderInstance{ &floor, Matrix4x4(1.0f) } };
+
+    OcclusionCuller culler;
+    culler.Init(256, 128);
+    culler.RenderOccluders(MakeTestViewProjection(), ZNear, occluders);
+
+    EXPECT_GT(culler.GetRasterizedTriangleCount(), 0);
+    EXPECT_FALSE(IsBoxVisible(culler, MakeVector3(0.0f, -4.0f, -20.0f), 2.0f));
+    EXPECT_TRUE(IsBoxVisible(culler, MakeVector3(11.0f, 1.0f, -20.0f), 2.0f));
+
+    // depth is stored as 1 / w, and clipped geometry never comes closer than near plane
+    for (float depth : culler.GetDepthBuffer())
+        ASSERT_LE(depth, 1.0f / ZNear + 1e-3f);
+}
+
+TEST(OcclusionCuller, DepthBufferIsDeterministic)
+{
+    auto wall = MakeWall();
+    auto floor = MakeFloor();
+    Matrix4x4 shifted(1.0f);
+    shifted[3] = Vector4(3.0f, 1.0f, -4.0f, 1.0f);
+
+    MxVector<OccluderInstance> occluders = {
+        OccluderInstance{ &wall, Matrix4x4(1.0f) },
+        OccluderInstance{ &floor, Matrix4x4(1.0f) },
+        OccluderInstance{ &wall, shifted },
+    };
+
+    OcclusionCuller culler;
+    culler.Init(320, 180);
+    culler.RenderOccluders(MakeTestViewProjection(), ZNear, occluders);
+    auto reference = culler.GetDepthBuffer();
+
+    // rows are split between worker threads, and nearest depth wins, so neither scheduling nor order may change result
+    culler.RenderOccluders(MakeTestViewProjection(), ZNear, occluders);
+    EXPECT_EQ(culler.GetDepthBuffer(), reference);
+
+    std::swap(occluders.front(), occluders.back());
+    culler.RenderOccluders(MakeTestViewProjection(), ZNear, occluders);
+    EXPECT_EQ(culler.GetDepthBuffer(), reference);
+}
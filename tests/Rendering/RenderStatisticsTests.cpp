@@ -0,0 +1,128 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Core/Rendering/RenderUtilities/RenderStatistics.h"
+#include "Utilities/FileSystem/File.h"
+
+#include <sstream>
+
+using namespace MxEngine;
+
+// counters are never incremented in shipping builds
+#if !defined(MXENGINE_SHIPPING)
+
+namespace
+{
+    // frame i has i draw calls, so each history entry tells which frame it came from
+    void RecordFrames(RenderStatistics& statistics, size_t firstFrame, size_t count)
+    {
+        for (size_t frame = firstFrame; frame < firstFrame + count; frame++)
+        {
+            statistics.AddEntry(RenderCounter::DRAW_CALLS, frame);
+            statistics.AddEntry(RenderCounter::DRAWN_OBJECTS, 2 * frame);
+            statistics.ResetAll();
+        }
+    }
+}
+
+TEST(RenderStatistics, KeepsFramesInOrderBeforeWrap)
+{
+    RenderStatistics statistics;
+    RecordFrames(statistics, 0, 10);
+
+    ASSERT_EQ(statistics.GetHistorySize(), 10);
+    for (size_t i = 0; i < 10; i++)
+        EXPECT_EQ(statistics.GetHistoryFrame(i)[(size_t)RenderCounter::DRAW_CALLS], i);
+}
+
+TEST(RenderStatistics, KeepsLastFramesOldestFirstAfterWrap)
+{
+    constexpr size_t ExtraFrames = 37;
+    RenderStatistics statistics;
+    RecordFrames(statistics, 0, RenderStatistics::HistorySize + ExtraFrames);
+
+    ASSERT_EQ(statistics.GetHistorySize(), RenderStatistics::HistorySize);
+    for (size_t i = 0; i < RenderStatistics::HistorySize; i++)
+    {
+        EXPECT_EQ(statistics.GetHistoryFrame(i)[(size_t)RenderCounter::DRAW_CALLS], ExtraFrames + i);
+        EXPECT_EQ(statistics.GetHistoryFrame(i)[(size_t)RenderCounter::DRAWN_OBJECTS], 2 * (ExtraFrames + i));
+    }
+}
+
+TEST(RenderStatistics, SkipsFramesWithoutData)
+{
+    RenderStatistics statistics;
+    RecordFrames(statistics, 0, 3);
+    statistics.ResetAll();
+    statistics.ResetAll();
+    EXPECT_EQ(statistics.GetHistorySize(), 3);
+    EXPECT_EQ(statistics.GetCounter(RenderCounter::DRAW_CALLS), 0);
+
+    statistics.ClearHistory();
+    EXPECT_EQ(statistics.GetHistorySize(), 0);
+}
+
+TEST(RenderStatistics, ExportsFrameNumbersAfterWrap)
+{
+    constexpr size_t ExtraFrames = 100;
+    RenderStatistics statistics;
+    RecordFrames(statistics, 0, RenderStatistics::HistorySize + ExtraFrames);
+
+    auto path = std::filesystem::temp_directory_path() / "mxengine_render_statistics_test.csv";
+    {
+        File file(path, File::WRITE);
+        ASSERT_TRUE(file.IsOpen());
+        statistics.ExportToCSV(file);
+    }
+
+    std::ifstream csv(path);
+    std::string line;
+    ASSERT_TRUE(std::getline(csv, line));
+    EXPECT_EQ(line.rfind("frame,", 0), 0);
+    EXPECT_NE(line.find(RenderStatistics::GetCounterName(RenderCounter::DRAW_CALLS)), std::string::npos);
+
+    size_t rowCount = 0;
+    while (std::getline(csv, line))
+    {
+        // first column is frame number, second one is draw call counter recorded for that frame
+        std::istringstream row(line);
+        size_t frame = 0, drawCalls = 0;
+        char separator = 0;
+        row >> frame >> separator >> drawCalls;
+        EXPECT_EQ(frame, ExtraFrames + rowCount);
+        EXPECT_EQ(drawCalls, ExtraFrames + rowCount);
+        rowCount++;
+    }
+    EXPECT_EQ(rowCount, RenderStatistics::HistorySize);
+
+    csv.close();
+    std::filesystem::remove(path);
+}
+
+#endif
@@ -0,0 +1,228 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Core/Rendering/RenderUtilities/ShadowAtlas.h"
+
+using namespace MxEngine;
+
+namespace
+{
+    bool AreOverlapping(const ShadowAtlasTile& t1, const ShadowAtlasTile& t2)
+    {
+        return t1.X < t2.X + t2.Size && t2.X < t1.X + t1.Size &&
+               t1.Y < t2.Y + t2.Size && t2.Y < t1.Y + t1.Size;
+    }
+
+    ShadowAtlasRequest MakeRequest(size_t key, float coverage, bool isDirty = true)
+    {
+        return ShadowAtlasRequest{ key, coverage, true, isDirty };
+    }
+
+    size_t CountUpdated(const MxVector<ShadowAtlasDecision>& decisions)
+    {
+        size_t count = 0;
+        for (const auto& decision : decisions)
+            count += decision.IsUpdated;
+        return count;
+    }
+}
+
+TEST(ShadowAtlasAllocator, FillsWholeAtlasWithoutOverlaps)
+{
+    ShadowAtlasAllocator allocator;
+    allocator.Init(1024, 128);
+
+    MxVector<ShadowAtlasTile> tiles;
+    for (size_t i = 0; i < 64; i++)
+    {
+        auto tile = allocator.Allocate(128);
+        ASSERT_TRUE(tile.IsValid());
+        EXPECT_EQ(tile.Size, 128);
+        EXPECT_LE(tile.X + tile.Size, 1024);
+        EXPECT_LE(tile.Y + tile.Size, 1024);
+        tiles.push_back(tile);
+    }
+
+    for (size_t i = 0; i < tiles.size(); i++)
+    {
+        for (size_t j = i + 1; j < tiles.size(); j++)
+            EXPECT_FALSE(AreOverlapping(tiles[i], tiles[j]));
+    }
+    EXPECT_EQ(allocator.GetFreeArea(), 0);
+    EXPECT_FALSE(allocator.Allocate(128).IsValid());
+}
+
+TEST(ShadowAtlasAllocator, RoundsTileSizeUp)
+{
+    ShadowAtlasAllocator allocator;
+    allocator.Init(1024, 128);
+
+    EXPECT_EQ(allocator.Allocate(300).Size, 512);
+    EXPECT_EQ(allocator.Allocate(16).Size, 128);
+    EXPECT_FALSE(allocator.Allocate(2048).IsValid());
+}
+
+TEST(ShadowAtlasAllocator, MergesFreedSiblings)
+{
+    ShadowAtlasAllocator allocator;
+    allocator.Init(1024, 128);
+
+    MxVector<ShadowAtlasTile> tiles;
+    tiles.push_back(allocator.Allocate(512));
+    for (size_t i = 0; i < 8; i++)
+        tiles.push_back(allocator.Allocate(128));
+    tiles.push_back(allocator.Allocate(256));
+
+    // free in mixed order, so merges happen both at the end and in the middle of sequence
+    for (size_t i = 0; i < tiles.size(); i += 2)
+        allocator.Free(tiles[i]);
+    EXPECT_FALSE(allocator.Allocate(1024).IsValid());
+    for (size_t i = 1; i < tiles.size(); i += 2)
+        allocator.Free(tiles[i]);
+
+    EXPECT_EQ(allocator.GetFreeArea(), 1024 * 1024);
+    auto whole = allocator.Allocate(1024);
+    EXPECT_TRUE(whole.IsValid());
+    EXPECT_EQ(whole, (ShadowAtlasTile{ 0, 0, 1024 }));
+}
+
+TEST(ShadowAtlasScheduler, TileSizeFollowsScreenCoverage)
+{
+    ShadowAtlasScheduler scheduler;
+    scheduler.Init(4096, 128, 1024);
+
+    MxVector<ShadowAtlasRequest> requests = { MakeRequest(1, 0.001f), MakeRequest(2, 1.0f), MakeRequest(3, 0.25f) };
+    MxVector<ShadowAtlasDecision> decisions;
+    scheduler.AllocateTiles(requests, decisions);
+
+    ASSERT_EQ(decisions.size(), 3);
+    EXPECT_EQ(decisions[0].Tile.Size, 128);
+    EXPECT_EQ(decisions[1].Tile.Size, 1024);
+    EXPECT_EQ(decisions[2].Tile.Size, 512);
+    EXPECT_FALSE(AreOverlapping(decisions[1].Tile, decisions[2].Tile));
+}
+
+TEST(ShadowAtlasScheduler, KeepsTileWhileCoverageIsStable)
+{
+    ShadowAtlasScheduler scheduler;
+    scheduler.Init(4096, 128, 1024);
+
+    MxVector<ShadowAtlasRequest> requests = { MakeRequest(1, 1.0f) };
+    MxVector<ShadowAtlasDecision> decisions;
+    scheduler.AllocateTiles(requests, decisions);
+    auto initialTile = decisions[0].Tile;
+
+    // shrinking by one level is tolerated to avoid reallocating tile on small camera movements
+    requests[0].ScreenCoverage = 0.3f;
+    scheduler.AllocateTiles(requests, decisions);
+    EXPECT_EQ(decisions[0].Tile, initialTile);
+
+    requests[0].ScreenCoverage = 0.01f;
+    scheduler.AllocateTiles(requests, decisions);
+    EXPECT_LT(decisions[0].Tile.Size, initialTile.Size);
+}
+
+TEST(ShadowAtlasScheduler, RespectsUpdateBudget)
+{
+    ShadowAtlasScheduler scheduler;
+    scheduler.Init(4096, 128, 512);
+    scheduler.UpdateBudget = 4;
+
+    MxVector<ShadowAtlasRequest> requests;
+    for (size_t i = 0; i < 10; i++)
+        requests.push_back(MakeRequest(i, 0.1f + 0.05f * i));
+    MxVector<ShadowAtlasDecision> decisions;
+
+    // first frame has no shadow map content, so everything is rendered regardless of budget
+    scheduler.AllocateTiles(requests, decisions);
+    scheduler.ScheduleUpdates(requests, decisions);
+    EXPECT_EQ(CountUpdated(decisions), requests.size());
+
+    scheduler.AllocateTiles(requests, decisions);
+    scheduler.ScheduleUpdates(requests, decisions);
+    EXPECT_EQ(CountUpdated(decisions), scheduler.UpdateBudget);
+    // the largest lights take budget first
+    for (size_t i = 0; i < requests.size(); i++)
+        EXPECT_EQ(decisions[i].IsUpdated, i >= requests.size() - scheduler.UpdateBudget);
+
+    for (auto& request : requests)
+        request.IsDirty = false;
+    scheduler.AllocateTiles(requests, decisions);
+    scheduler.ScheduleUpdates(requests, decisions);
+    EXPECT_EQ(CountUpdated(decisions), 0);
+}
+
+TEST(ShadowAtlasScheduler, RefreshesFarLightsRoundRobin)
+{
+    ShadowAtlasScheduler scheduler;
+    scheduler.Init(4096, 128, 512);
+    scheduler.UpdateBudget = 1;
+    scheduler.FarLightUpdatePeriod = 4;
+
+    MxVector<ShadowAtlasRequest> requests;
+    for (size_t i = 0; i < 3; i++)
+        requests.push_back(MakeRequest(i, 0.001f));
+    MxVector<ShadowAtlasDecision> decisions;
+
+    scheduler.AllocateTiles(requests, decisions);
+    scheduler.ScheduleUpdates(requests, decisions);
+
+    MxVector<size_t> updateCounts(requests.size(), 0);
+    const size_t frameCount = 24;
+    for (size_t frame = 0; frame < frameCount; frame++)
+    {
+        scheduler.AllocateTiles(requests, decisions);
+        scheduler.ScheduleUpdates(requests, decisions);
+        EXPECT_LE(CountUpdated(decisions), scheduler.UpdateBudget);
+        for (size_t i = 0; i < requests.size(); i++)
+            updateCounts[i] += decisions[i].IsUpdated;
+    }
+
+    // every far light is refreshed, but not more often than once per period
+    for (size_t count : updateCounts)
+    {
+        EXPECT_GT(count, 0);
+        EXPECT_LE(count, frameCount / scheduler.FarLightUpdatePeriod);
+    }
+}
+
+TEST(ShadowAtlasScheduler, ReleasesTilesOfRemovedLights)
+{
+    ShadowAtlasScheduler scheduler;
+    scheduler.Init(2048, 128, 1024);
+
+    MxVector<ShadowAtlasRequest> requests = { MakeRequest(1, 1.0f), MakeRequest(2, 1.0f) };
+    MxVector<ShadowAtlasDecision> decisions;
+    scheduler.AllocateTiles(requests, decisions);
+    EXPECT_EQ(scheduler.GetAllocator().GetFreeArea(), 2048 * 2048 - 2 * 1024 * 1024);
+
+    requests.clear();
+    scheduler.AllocateTiles(requests, decisions);
+    EXPECT_EQ(scheduler.GetAllocator().GetFreeArea(), 2048 * 2048);
+}
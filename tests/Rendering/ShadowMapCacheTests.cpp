@@ -0,0 +1,160 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Core/Rendering/RenderUtilities/ShadowMapCache.h"
+
+using namespace MxEngine;
+
+namespace
+{
+    // atlas lights are keyed by light, so cache decisions can be tested without creating any shadow maps
+    struct AtlasLight
+    {
+        size_t Key;
+        uint64_t LightHash;
+        ShadowCasterHash Casters;
+    };
+
+    AtlasLight MakeLight(size_t key)
+    {
+        return AtlasLight{ key, 100 + key, ShadowCasterHash{ 10 * key, 20 * key, true } };
+    }
+
+    ShadowCacheState Update(ShadowMapCache& cache, const AtlasLight& light)
+    {
+        TextureHandle staticLayer;
+        return cache.Update(light.Key, TextureHandle{ }, ShadowAtlasTile{ 0, 0, 256 }, light.LightHash, light.Casters, staticLayer);
+    }
+
+    ShadowCacheState RunFrame(ShadowMapCache& cache, const AtlasLight& light)
+    {
+        cache.BeginFrame();
+        auto state = Update(cache, light);
+        cache.EndFrame();
+        return state;
+    }
+}
+
+TEST(ShadowMapCache, UnchangedCastersAreCached)
+{
+    ShadowMapCache cache;
+    auto light = MakeLight(1);
+
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::DIRTY);
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::CLEAN);
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::CLEAN);
+}
+
+TEST(ShadowMapCache, ChangedCastersMakeLightDirty)
+{
+    ShadowMapCache cache;
+    auto light = MakeLight(1);
+    RunFrame(cache, light);
+
+    // moved dynamic caster
+    light.Casters.Dynamic++;
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::DIRTY);
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::CLEAN);
+
+    // moved static caster
+    light.Casters.Static++;
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::DIRTY);
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::CLEAN);
+
+    // moved light itself
+    light.LightHash++;
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::DIRTY);
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::CLEAN);
+}
+
+TEST(ShadowMapCache, UntrackedCastersAreAlwaysDirty)
+{
+    ShadowMapCache cache;
+    auto light = MakeLight(1);
+    light.Casters.IsTracked = false;
+
+    RunFrame(cache, light);
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::DIRTY);
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::DIRTY);
+}
+
+TEST(ShadowMapCache, PostponedLightStaysDirty)
+{
+    ShadowMapCache cache;
+    auto light = MakeLight(1);
+    RunFrame(cache, light);
+
+    // light became dirty, but was not rendered this frame
+    light.Casters.Dynamic++;
+    cache.BeginFrame();
+    auto state = Update(cache, light);
+    EXPECT_EQ(state, ShadowCacheState::DIRTY);
+    cache.Postpone(light.Key, state);
+    cache.EndFrame();
+
+    // casters are now the same as in last frame, but shadow map still holds old ones
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::DIRTY);
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::CLEAN);
+}
+
+TEST(ShadowMapCache, UnusedLightIsDropped)
+{
+    ShadowMapCache cache;
+    auto used = MakeLight(1);
+    auto unused = MakeLight(2);
+
+    cache.BeginFrame();
+    Update(cache, used);
+    Update(cache, unused);
+    cache.EndFrame();
+
+    // second light is not submitted for one frame, so its shadow map may be reused by other light meanwhile
+    RunFrame(cache, used);
+
+    cache.BeginFrame();
+    EXPECT_EQ(Update(cache, used), ShadowCacheState::CLEAN);
+    EXPECT_EQ(Update(cache, unused), ShadowCacheState::DIRTY);
+    cache.EndFrame();
+}
+
+TEST(ShadowMapCache, DisabledCacheAlwaysRegenerates)
+{
+    ShadowMapCache cache;
+    cache.IsEnabled = false;
+    auto light = MakeLight(1);
+
+    RunFrame(cache, light);
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::DIRTY);
+
+    // cache must start from scratch after invalidation
+    cache.IsEnabled = true;
+    RunFrame(cache, light);
+    cache.Invalidate();
+    EXPECT_EQ(RunFrame(cache, light), ShadowCacheState::DIRTY);
+}
@@ -0,0 +1,170 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Core/Resources/BufferAllocatorPool.h"
+#include "Utilities/STL/MxVector.h"
+
+#include <algorithm>
+
+using namespace MxEngine;
+
+namespace
+{
+    // growth callback may be stored as plain function pointer, so its state is kept outside of lambda
+    BufferAllocatorPool* grownPool = nullptr;
+    MxVector<size_t> growths;
+
+    void InitPool(BufferAllocatorPool& pool, size_t capacity)
+    {
+        grownPool = &pool;
+        growths.clear();
+        pool.Init(capacity, [](size_t newSize)
+        {
+            growths.push_back(newSize);
+            grownPool->OnRelocate(grownPool->Capacity, newSize);
+        });
+    }
+
+    struct Block
+    {
+        size_t Offset;
+        size_t Size;
+    };
+
+    void ExpectDisjoint(MxVector<Block> blocks, size_t capacity)
+    {
+        std::sort(blocks.begin(), blocks.end(), [](const Block& b1, const Block& b2) { return b1.Offset < b2.Offset; });
+        for (size_t i = 0; i < blocks.size(); i++)
+        {
+            EXPECT_LE(blocks[i].Offset + blocks[i].Size, capacity);
+            if (i > 0) EXPECT_LE(blocks[i - 1].Offset + blocks[i - 1].Size, blocks[i].Offset);
+        }
+    }
+}
+
+TEST(BufferAllocatorPool, AllocationsDoNotOverlap)
+{
+    BufferAllocatorPool pool;
+    InitPool(pool, 1000);
+
+    MxVector<Block> blocks;
+    for (size_t size : { 10, 250, 1, 64, 300, 7 })
+        blocks.push_back(Block{ pool.Allocate(size), size });
+
+    EXPECT_TRUE(growths.empty());
+    ExpectDisjoint(blocks, pool.Capacity);
+
+    auto statistics = pool.GetStatistics();
+    EXPECT_EQ(statistics.Capacity, 1000);
+    EXPECT_EQ(statistics.AllocatedSize, 632);
+    EXPECT_EQ(statistics.AllocationCount, 6);
+    EXPECT_EQ(statistics.TotalAllocations, 6);
+}
+
+TEST(BufferAllocatorPool, ReusesFreedBlock)
+{
+    BufferAllocatorPool pool;
+    InitPool(pool, 300);
+
+    size_t first = pool.Allocate(100);
+    size_t second = pool.Allocate(100);
+    size_t third = pool.Allocate(100);
+    pool.Deallocate(second);
+
+    // buffer is full except for freed block, so new allocation must take its place
+    size_t reused = pool.Allocate(100);
+    EXPECT_EQ(reused, second);
+    EXPECT_TRUE(growths.empty());
+    ExpectDisjoint({ { first, 100 }, { reused, 100 }, { third, 100 } }, pool.Capacity);
+
+    auto statistics = pool.GetStatistics();
+    EXPECT_EQ(statistics.AllocatedSize, 300);
+    EXPECT_EQ(statistics.AllocationCount, 3);
+    EXPECT_EQ(statistics.TotalAllocations, 4);
+}
+
+TEST(BufferAllocatorPool, GrowsFromEmptyKeepingAllocations)
+{
+    // zero initial size is the default of shared buffers, so every first allocation grows the pool
+    BufferAllocatorPool pool;
+    InitPool(pool, 0);
+
+    MxVector<Block> blocks;
+    size_t totalSize = 0;
+    for (size_t i = 0; i < 64; i++)
+    {
+        size_t size = 16 + (i * 37) % 200;
+        blocks.push_back(Block{ pool.Allocate(size), size });
+        totalSize += size;
+        ASSERT_FALSE(growths.empty());
+        ASSERT_LE(blocks.back().Offset + size, pool.Capacity);
+    }
+
+    // allocations keep their offsets when storage is replaced, so all of them must still be disjoint
+    ExpectDisjoint(blocks, pool.Capacity);
+    EXPECT_TRUE(std::is_sorted(growths.begin(), growths.end()));
+    EXPECT_EQ(pool.Capacity, growths.back());
+
+    auto statistics = pool.GetStatistics();
+    EXPECT_EQ(statistics.RelocationCount, growths.size());
+    EXPECT_EQ(statistics.AllocatedSize, totalSize);
+    EXPECT_GE(statistics.Capacity, totalSize);
+}
+
+TEST(BufferAllocatorPool, TracksFreeBlocks)
+{
+    BufferAllocatorPool pool;
+    InitPool(pool, 400);
+
+    MxVector<size_t> offsets;
+    for (size_t i = 0; i < 4; i++)
+        offsets.push_back(pool.Allocate(100));
+    std::sort(offsets.begin(), offsets.end());
+
+    auto statistics = pool.GetStatistics();
+    EXPECT_EQ(statistics.FreeBlockCount, 0);
+    EXPECT_FLOAT_EQ(statistics.GetFragmentation(), 0.0f);
+
+    // every second block is freed, so free space is split into two equal parts
+    pool.Deallocate(offsets[0]);
+    pool.Deallocate(offsets[2]);
+    statistics = pool.GetStatistics();
+    EXPECT_EQ(statistics.AllocatedSize, 200);
+    EXPECT_EQ(statistics.FreeBlockCount, 2);
+    EXPECT_EQ(statistics.LargestFreeBlock, 100);
+    EXPECT_FLOAT_EQ(statistics.GetFragmentation(), 0.5f);
+
+    pool.Deallocate(offsets[1]);
+    pool.Deallocate(offsets[3]);
+    statistics = pool.GetStatistics();
+    EXPECT_EQ(statistics.AllocationCount, 0);
+    EXPECT_EQ(statistics.FreeBlockCount, 1);
+    EXPECT_EQ(statistics.LargestFreeBlock, 400);
+    EXPECT_FLOAT_EQ(statistics.GetFragmentation(), 0.0f);
+}
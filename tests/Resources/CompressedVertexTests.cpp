@@ -0,0 +1,160 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Core/Resources/Vertex.h"
+#include "Utilities/STL/MxVector.h"
+
+using namespace MxEngine;
+
+namespace
+{
+    // encoder scales by 32767, so snorm16 step is 1 / 32767 (~3e-5) in octahedral space. Rounding to half of it per component
+    // is stretched at most about twice when mapped on sphere, so this leaves a safe margin
+    constexpr float MaxDirectionError = 1e-4f;
+    // half float keeps 11 significant bits, so relative rounding error is at most 2^-11
+    constexpr float MaxHalfRelativeError = 1.0f / 2048.0f;
+
+    // evenly distributed directions on unit sphere, with axis-aligned and diagonal ones added as octahedron edge cases
+    MxVector<Vector3> MakeDirections(size_t count)
+    {
+        MxVector<Vector3> directions;
+        const float goldenAngle = 3.14159265f * (3.0f - std::sqrt(5.0f));
+        for (size_t i = 0; i < count; i++)
+        {
+            float z = 1.0f - 2.0f * ((float)i + 0.5f) / (float)count;
+            float radius = std::sqrt(1.0f - z * z);
+            float angle = goldenAngle * (float)i;
+            directions.push_back(MakeVector3(radius * std::cos(angle), radius * std::sin(angle), z));
+        }
+        for (float x : { -1.0f, 0.0f, 1.0f })
+        {
+            for (float y : { -1.0f, 0.0f, 1.0f })
+            {
+                for (float z : { -1.0f, 0.0f, 1.0f })
+                {
+                    if (x != 0.0f || y != 0.0f || z != 0.0f)
+                        directions.push_back(Normalize(MakeVector3(x, y, z)));
+                }
+            }
+        }
+        return directions;
+    }
+
+    float AngleBetween(const Vector3& v1, const Vector3& v2)
+    {
+        // atan2 of cross and dot is precise for small angles, unlike acos of dot
+        return std::atan2(Length(Cross(v1, v2)), Dot(v1, v2));
+    }
+
+    Vector3 MakeOrthogonal(const Vector3& v)
+    {
+        Vector3 other = std::abs(v.x) < 0.9f ? MakeVector3(1.0f, 0.0f, 0.0f) : MakeVector3(0.0f, 1.0f, 0.0f);
+        return Normalize(Cross(v, other));
+    }
+
+    Vertex MakeVertex(const Vector3& normal, float handedness)
+    {
+        Vertex vertex;
+        vertex.Position = MakeVector3(1.5f, -2.25f, 1000.125f);
+        vertex.TexCoord = MakeVector2(0.25f, 0.75f);
+        vertex.Normal = normal;
+        vertex.Tangent = MakeOrthogonal(normal);
+        vertex.Bitangent = Cross(vertex.Normal, vertex.Tangent) * handedness;
+        return vertex;
+    }
+}
+
+TEST(CompressedVertex, NormalAndTangentErrorIsBounded)
+{
+    float maxNormalError = 0.0f;
+    float maxTangentError = 0.0f;
+    for (const auto& direction : MakeDirections(20000))
+    {
+        Vertex vertex = MakeVertex(direction, 1.0f);
+        Vertex decompressed = CompressedVertex::Compress(vertex).Decompress();
+
+        EXPECT_NEAR(Length(decompressed.Normal), 1.0f, 1e-5f);
+        EXPECT_NEAR(Length(decompressed.Tangent), 1.0f, 1e-5f);
+        maxNormalError = Max(maxNormalError, AngleBetween(vertex.Normal, decompressed.Normal));
+        maxTangentError = Max(maxTangentError, AngleBetween(vertex.Tangent, decompressed.Tangent));
+    }
+    EXPECT_LE(maxNormalError, MaxDirectionError);
+    EXPECT_LE(maxTangentError, MaxDirectionError);
+}
+
+TEST(CompressedVertex, BitangentKeepsHandedness)
+{
+    for (const auto& direction : MakeDirections(1000))
+    {
+        for (float handedness : { -1.0f, 1.0f })
+        {
+            Vertex vertex = MakeVertex(direction, handedness);
+            Vertex decompressed = CompressedVertex::Compress(vertex).Decompress();
+
+            EXPECT_GT(Dot(decompressed.Bitangent, vertex.Bitangent), 0.0f);
+            // bitangent is restored from normal and tangent, so its error is bounded by their errors
+            EXPECT_LE(AngleBetween(vertex.Bitangent, decompressed.Bitangent), 2.0f * MaxDirectionError);
+        }
+    }
+}
+
+TEST(CompressedVertex, TexCoordErrorIsBounded)
+{
+    constexpr size_t Steps = 10000;
+    float maxRelativeError = 0.0f;
+    for (size_t i = 0; i <= Steps; i++)
+    {
+        // covers both tiled coordinates and small ones near zero
+        float value = -16.0f + 32.0f * (float)i / (float)Steps;
+        Vertex vertex = MakeVertex(MakeVector3(0.0f, 0.0f, 1.0f), 1.0f);
+        vertex.TexCoord = MakeVector2(value, value * 0.001f);
+        Vertex decompressed = CompressedVertex::Compress(vertex).Decompress();
+
+        for (size_t component = 0; component < 2; component++)
+        {
+            float expected = vertex.TexCoord[component];
+            float error = std::abs(decompressed.TexCoord[component] - expected);
+            // values below smallest normal half are stored with fixed absolute precision
+            if (std::abs(expected) < 6.2e-5f)
+                EXPECT_LE(error, 3e-8f);
+            else
+                maxRelativeError = Max(maxRelativeError, error / std::abs(expected));
+        }
+    }
+    EXPECT_LE(maxRelativeError, MaxHalfRelativeError);
+}
+
+TEST(CompressedVertex, PositionIsExact)
+{
+    Vertex vertex = MakeVertex(MakeVector3(0.0f, 1.0f, 0.0f), -1.0f);
+    Vertex decompressed = CompressedVertex::Compress(vertex).Decompress();
+    EXPECT_EQ(decompressed.Position.x, vertex.Position.x);
+    EXPECT_EQ(decompressed.Position.y, vertex.Position.y);
+    EXPECT_EQ(decompressed.Position.z, vertex.Position.z);
+}
@@ -0,0 +1,106 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Core/Resources/MeshData.h"
+
+#include <cmath>
+
+namespace MxEngine::Tests
+{
+    // UV sphere of unit radius with duplicated seam column, so it has both closed surface and attribute seam
+    inline void MakeSphereMesh(size_t rings, size_t segments, MeshData::VertexData& vertecies, MeshData::IndexData& indicies)
+    {
+        const float pi = 3.14159265358979f;
+        vertecies.clear();
+        indicies.clear();
+        for (size_t ring = 0; ring <= rings; ring++)
+        {
+            float theta = pi * float(ring) / float(rings);
+            for (size_t segment = 0; segment <= segments; segment++)
+            {
+                float phi = 2.0f * pi * float(segment) / float(segments);
+                // pole and seam vertecies must share exactly the same position to be welded
+                float sinTheta = (ring == 0 || ring == rings) ? 0.0f : std::sin(theta);
+                float cosPhi = segment == segments ? 1.0f : std::cos(phi);
+                float sinPhi = segment == segments ? 0.0f : std::sin(phi);
+
+                Vertex vertex;
+                vertex.Position = MakeVector3(sinTheta * cosPhi, std::cos(theta), sinTheta * sinPhi);
+                vertex.Normal = vertex.Position;
+                vertex.TexCoord = Vector2(float(segment) / float(segments), float(ring) / float(rings));
+                vertecies.push_back(vertex);
+            }
+        }
+
+        for (size_t ring = 0; ring < rings; ring++)
+        {
+            for (size_t segment = 0; segment < segments; segment++)
+            {
+                uint32_t i0 = uint32_t(ring * (segments + 1) + segment);
+                uint32_t i1 = i0 + 1;
+                uint32_t i2 = i0 + uint32_t(segments + 1);
+                uint32_t i3 = i2 + 1;
+                // triangles touching poles would be degenerate
+                if (ring != 0) indicies.insert(indicies.end(), { i0, i1, i2 });
+                if (ring != rings - 1) indicies.insert(indicies.end(), { i1, i3, i2 });
+            }
+        }
+    }
+
+    // flat square grid in XZ plane with side of one unit, open borders on all sides
+    inline void MakeGridMesh(size_t cells, MeshData::VertexData& vertecies, MeshData::IndexData& indicies)
+    {
+        vertecies.clear();
+        indicies.clear();
+        for (size_t z = 0; z <= cells; z++)
+        {
+            for (size_t x = 0; x <= cells; x++)
+            {
+                Vertex vertex;
+                vertex.Position = MakeVector3(float(x) / float(cells), 0.0f, float(z) / float(cells));
+                vertex.Normal = MakeVector3(0.0f, 1.0f, 0.0f);
+                vertex.TexCoord = Vector2(vertex.Position.x, vertex.Position.z);
+                vertecies.push_back(vertex);
+            }
+        }
+
+        for (size_t z = 0; z < cells; z++)
+        {
+            for (size_t x = 0; x < cells; x++)
+            {
+                uint32_t i0 = uint32_t(z * (cells + 1) + x);
+                uint32_t i1 = i0 + 1;
+                uint32_t i2 = i0 + uint32_t(cells + 1);
+                uint32_t i3 = i2 + 1;
+                indicies.insert(indicies.end(), { i0, i2, i1, i1, i2, i3 });
+            }
+        }
+    }
+}
@@ -0,0 +1,171 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Utilities/Sort/DepthSort.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace MxEngine;
+
+namespace
+{
+    // same layout as render draw command: 64-bit key and payload, which shows whether sort is stable
+    struct KeyedValue
+    {
+        uint64_t Key;
+        uint32_t Index;
+    };
+
+    bool operator==(const KeyedValue& v1, const KeyedValue& v2)
+    {
+        return v1.Key == v2.Key && v1.Index == v2.Index;
+    }
+
+    MxVector<KeyedValue> MakeValues(size_t count, uint64_t keyMask, uint32_t seed)
+    {
+        std::mt19937_64 generator(seed);
+        MxVector<KeyedValue> values(count);
+        for (size_t i = 0; i < count; i++)
+            values[i] = KeyedValue{ generator() & keyMask, (uint32_t)i };
+        return values;
+    }
+
+    void ExpectSameAsStableSort(MxVector<KeyedValue> values)
+    {
+        auto expected = values;
+        std::stable_sort(expected.begin(), expected.end(), [](const KeyedValue& v1, const KeyedValue& v2) { return v1.Key < v2.Key; });
+
+        MxVector<KeyedValue> scratch;
+        RadixSort(values, scratch, [](const KeyedValue& value) { return value.Key; });
+        ASSERT_EQ(values.size(), expected.size());
+        for (size_t i = 0; i < values.size(); i++)
+            ASSERT_EQ(values[i], expected[i]) << "position: " << i;
+    }
+}
+
+TEST(RadixSort, MatchesStableSortOnRandomKeys)
+{
+    for (size_t count : { 0, 1, 2, 3, 255, 1023, 1024, 1025, 100000 })
+        ExpectSameAsStableSort(MakeValues(count, ~uint64_t(0), (uint32_t)count));
+}
+
+TEST(RadixSort, IsStableForDuplicatedKeys)
+{
+    ExpectSameAsStableSort(MakeValues(10000, 0xF, 1));
+    ExpectSameAsStableSort(MakeValues(10000, 0xF000000000000000ull, 2));
+    ExpectSameAsStableSort(MakeValues(10000, 0, 3));
+}
+
+TEST(RadixSort, HandlesKeysDifferingInFewBytes)
+{
+    // such inputs skip most of passes, so result may end up in scratch buffer and must be copied back
+    ExpectSameAsStableSort(MakeValues(5000, 0xFF, 4));
+    ExpectSameAsStableSort(MakeValues(5000, 0xFFFF, 5));
+    ExpectSameAsStableSort(MakeValues(5000, 0x00FF00FF00FF0000ull, 6));
+}
+
+TEST(RadixSort, SortsNarrowKeys)
+{
+    std::mt19937 generator(7);
+    MxVector<uint32_t> values(5000);
+    for (auto& value : values)
+        value = (uint32_t)generator();
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    MxVector<uint32_t> scratch;
+    RadixSort(values, scratch, [](uint32_t value) { return value; });
+    EXPECT_EQ(values, expected);
+
+    MxVector<uint8_t> bytes(values.begin(), values.end());
+    auto expectedBytes = bytes;
+    std::sort(expectedBytes.begin(), expectedBytes.end());
+    MxVector<uint8_t> byteScratch;
+    RadixSort(bytes, byteScratch, [](uint8_t value) { return value; });
+    EXPECT_EQ(bytes, expectedBytes);
+}
+
+TEST(DepthSort, SortableKeysPreserveFloatOrder)
+{
+    MxVector<float> floats = { -1e30f, -100.0f, -1.5f, -1e-30f, -0.0f, 0.0f, 1e-30f, 0.5f, 1.0f, 2.5f, 1e30f };
+    for (size_t i = 1; i < floats.size(); i++)
+        EXPECT_LE(ToSortableKey(floats[i - 1]), ToSortableKey(floats[i])) << floats[i - 1] << " vs " << floats[i];
+    EXPECT_LT(ToSortableKey(-1.5f), ToSortableKey(-1.0f));
+    EXPECT_LT(ToSortableKey(1.0f), ToSortableKey(1.5f));
+}
+
+TEST(DepthSort, SortsBackToFront)
+{
+    std::mt19937 generator(8);
+    std::uniform_real_distribution<float> distribution(-50.0f, 500.0f);
+    MxVector<float> depths(2000);
+    for (auto& depth : depths)
+        depth = distribution(generator);
+
+    DepthSorter sorter;
+    const auto& order = sorter.SortBackToFront(depths.size(), [&depths](size_t i) { return depths[i]; });
+    ASSERT_EQ(order.size(), depths.size());
+    EXPECT_FALSE(sorter.IsLastSortIncremental());
+
+    MxVector<uint8_t> isVisited(depths.size(), 0);
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        isVisited[order[i].Index]++;
+        if (i > 0) EXPECT_GE(depths[order[i - 1].Index], depths[order[i].Index]);
+    }
+    EXPECT_EQ(std::count(isVisited.begin(), isVisited.end(), 1), (ptrdiff_t)depths.size());
+}
+
+TEST(DepthSort, ReusesPreviousOrderForCoherentDepths)
+{
+    std::mt19937 generator(9);
+    std::uniform_real_distribution<float> distribution(0.0f, 100.0f);
+    std::uniform_real_distribution<float> jitter(-0.01f, 0.01f);
+    MxVector<float> depths(2000);
+    for (auto& depth : depths)
+        depth = distribution(generator);
+
+    DepthSorter sorter;
+    sorter.SortBackToFront(depths.size(), [&depths](size_t i) { return depths[i]; });
+
+    // camera moves slightly between frames, so only few elements change their places
+    for (auto& depth : depths)
+        depth += jitter(generator);
+    const auto& order = sorter.SortBackToFront(depths.size(), [&depths](size_t i) { return depths[i]; });
+    EXPECT_TRUE(sorter.IsLastSortIncremental());
+    for (size_t i = 1; i < order.size(); i++)
+        EXPECT_GE(depths[order[i - 1].Index], depths[order[i].Index]);
+
+    // completely new depths fall back to radix sort
+    for (auto& depth : depths)
+        depth = distribution(generator);
+    sorter.SortBackToFront(depths.size(), [&depths](size_t i) { return depths[i]; });
+    EXPECT_FALSE(sorter.IsLastSortIncremental());
+}
@@ -0,0 +1,128 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+#include "Utilities/Threading/WorkerPool.h"
+
+using namespace MxEngine;
+
+TEST(WorkerPool, ExecutesEveryTaskOnce)
+{
+    for (size_t workerCount : { 0, 1, 3 })
+    {
+        WorkerPool pool(workerCount);
+        for (size_t taskCount : { 1, 2, 7, 1000 })
+        {
+            MxVector<std::atomic<int>> counters(taskCount);
+            pool.Execute(taskCount, [&counters](size_t task) { counters[task]++; });
+            for (size_t i = 0; i < taskCount; i++)
+                EXPECT_EQ(counters[i].load(), 1) << "workers: " << workerCount << ", tasks: " << taskCount;
+        }
+    }
+}
+
+TEST(WorkerPool, RunsInlineWithoutWorkers)
+{
+    WorkerPool pool(0);
+    EXPECT_EQ(pool.GetWorkerCount(), 0);
+    EXPECT_EQ(pool.GetThreadCount(), 1);
+
+    auto caller = std::this_thread::get_id();
+    bool allInline = true;
+    pool.Execute(16, [&allInline, caller](size_t) { allInline &= std::this_thread::get_id() == caller; });
+    EXPECT_TRUE(allInline);
+}
+
+TEST(WorkerPool, HandlesManyConsecutiveJobs)
+{
+    WorkerPool pool(3);
+    std::atomic<size_t> sum{ 0 };
+    const size_t jobCount = 2000;
+    for (size_t job = 0; job < jobCount; job++)
+        pool.Execute(4, [&sum](size_t task) { sum += task + 1; });
+    EXPECT_EQ(sum.load(), jobCount * (1 + 2 + 3 + 4));
+}
+
+TEST(WorkerPool, SerializesJobsFromDifferentThreads)
+{
+    // simulation and frame preparation may submit jobs at the same time, so second job waits for the first one
+    WorkerPool pool(3);
+    std::atomic<size_t> sum{ 0 };
+    std::atomic<int> runningJobs{ 0 };
+    std::atomic<bool> hadOverlap{ false };
+    auto submitJobs = [&]()
+    {
+        for (size_t job = 0; job < 500; job++)
+        {
+            pool.Execute(8, [&](size_t task)
+            {
+                if (task == 0 && runningJobs++ != 0) hadOverlap = true;
+                sum += task + 1;
+                if (task == 0) runningJobs--;
+            });
+        }
+    };
+
+    std::thread other(submitJobs);
+    submitJobs();
+    other.join();
+    EXPECT_EQ(sum.load(), 2 * 500 * (8 * 9 / 2));
+    EXPECT_FALSE(hadOverlap.load());
+}
+
+TEST(ParallelFor, CoversRangeExactlyOnce)
+{
+    for (size_t count : { 1, 5, 64, 1000, 100003 })
+    {
+        for (size_t grainSize : { 0, 1, 16, 4096 })
+        {
+            MxVector<std::atomic<int>> visits(count);
+            std::atomic<size_t> chunkCount{ 0 };
+            ParallelFor(count, grainSize, [&visits, &chunkCount, count](size_t begin, size_t end)
+            {
+                EXPECT_LT(begin, end);
+                EXPECT_LE(end, count);
+                for (size_t i = begin; i < end; i++)
+                    visits[i]++;
+                chunkCount++;
+            });
+
+            for (size_t i = 0; i < count; i++)
+                ASSERT_EQ(visits[i].load(), 1) << "count: " << count << ", grain: " << grainSize;
+            // chunk count is limited to keep scheduling overhead low
+            EXPECT_LE(chunkCount.load(), WorkerPool::GetDefault().GetThreadCount() * 4);
+        }
+    }
+}
+
+TEST(ParallelFor, IgnoresEmptyRange)
+{
+    bool wasCalled = false;
+    ParallelFor(0, 1, [&wasCalled](size_t, size_t) { wasCalled = true; });
+    EXPECT_FALSE(wasCalled);
+}